@@ -49,6 +49,29 @@
 
 #define BLOCKWRITE_CONT   ("BWc")        // "BlockWrite chunk continue"
 
+// BlockRead response data formats, selected by the agent with the block format command
+#define BLOCK_FORMAT_HEX        (0)     // ASCII hex, 2 chars per byte - the default for agents that do not negotiate
+#define BLOCK_FORMAT_BINARY     (1)     // Raw bytes behind a length header, streamed a chunk at a time
+
+// A binary BlockRead response is | '$' | Data length | Data | Trailer
+//                                  1-byte   2-bytes
+// or, if the BR command carried a 4-byte length,
+//                                | '#' | Data length | Data | Trailer
+//                                  1-byte   4-bytes
+// The header is sent before all of the data has been read, so the trailer says whether it was read successfully.
+// Data that could not be read is sent as 0s.
+#define BLOCK_BINARY_MARKER         ('$')
+#define BLOCK_BINARY_LONG_MARKER    ('#')
+#define BLOCK_BINARY_OK             ('\n')
+#define BLOCK_BINARY_READ_FAILED    ('!')
+
+// A command whose opcode has OPCODE_SEQ_FLAG set ends in a 1-byte sequence number, and its response is preceded by
+// | SEQ_TAG | Sequence number |, so that the agent can send commands without waiting for the replies to earlier ones
+// and still match each reply to its command.  Commands are processed in the order they are received.
+#define OPCODE_SEQ_FLAG             (0x80)
+#define SEQ_NUM_LEN                 (1)
+#define SEQ_TAG                     ('@')
+
 
 /* Error Codes
  23 (WMT_INVALID_PARAMETER) - Encountered an unexpected null pointer in the server.
@@ -118,8 +141,26 @@
 #define REG_VAL_OFFSET  (8)
 // For BR only
 #define READ_LEN_OFFSET  (8)
+#define READ_LEN_LONG_PAYLOAD_LEN   (12)    // BR payload length when the read length field is 4 bytes
 // For BWc only
 #define REG_VAL_OFFSET_BWC  (3)
+// For BF only
+#define BLOCK_FORMAT_OFFSET (3)
+// For BA only
+#define BATCH_COUNT_OFFSET  (4)
+#define BATCH_OPS_OFFSET    (6)
+
+// Each batch op is | Op | Reg addr | Reg value |, where Reg value is ignored for reads
+//                   1-byte  4-bytes    4-bytes
+#define BATCH_OP_LEN        (9)
+#define BATCH_OP_READ       (0)
+#define BATCH_OP_WRITE      (1)
+// Longest reply to one op: 8 hex chars and ','
+#define BATCH_RESP_LEN      (9)
+
+#if ((BATCH_OPS_OFFSET + (BRIDGE_MAX_BATCH_OPS * BATCH_OP_LEN) + SEQ_NUM_LEN) > CMD_RESP_LENGTH_CHAR)
+    #error "Bridge command buffer too small for BRIDGE_MAX_BATCH_OPS"
+#endif
 
 
 /***********************************************************************************************************************
@@ -134,12 +175,6 @@ typedef struct
 
 typedef uint32_t (*bridge_command_handler_t)(unsigned char *cmd);
 
-typedef struct
-{
-    const uint8_t opcode;
-    bridge_command_handler_t handler;
-} bridge_command_handler_map_t;
-
 /***********************************************************************************************************************
  * LOCAL VARIABLES
  **********************************************************************************************************************/
@@ -157,6 +192,11 @@ static uint32_t bw_addr = 0;
 static uint32_t bw_data_collect_indx = 0;
 static size_t reg_sz = sizeof(uint32_t);
 
+static uint8_t block_format = BLOCK_FORMAT_HEX;
+// Set by handlers that have sent their own response
+static bool is_resp_sent = false;
+static const char hex_chars[] = "0123456789ABCDEF";
+
 static uint32_t handle_protocol_version(unsigned char *cmd);
 static uint32_t handle_info(unsigned char *cmd);
 static uint32_t handle_read(unsigned char *cmd);
@@ -170,27 +210,31 @@ static uint32_t handle_unsupported(unsigned char *cmd);
 static uint32_t handle_invalid(unsigned char *cmd);
 static uint32_t handle_current_device(unsigned char *cmd);
 static uint32_t handle_mcu_msg_format_version(unsigned char *cmd);
+static uint32_t handle_block_format(unsigned char *cmd);
+static uint32_t handle_batch(unsigned char *cmd);
 
 
-// An array of coded command Ids mapped to their handler functions
-static const bridge_command_handler_map_t command_handler_map[] =
+// Command handlers indexed by their coded command Id, so that dispatch is a single lookup
+static const bridge_command_handler_t command_handlers[] =
 {
-    {.opcode = 0x1,     .handler = handle_current_device},          // CurrentDevice
-    {.opcode = 0x2,     .handler = handle_protocol_version},        // ProtocolVersion
-    {.opcode = 0x3,     .handler = handle_info},                    // Info
-    {.opcode = 0x4,     .handler = handle_detect},                  // Detect
-    {.opcode = 0x5,     .handler = handle_read},                    // Read
-    {.opcode = 0x6,     .handler = handle_write},                   // Write
-    {.opcode = 0x7,     .handler = handle_blockread},               // BlockRead
-    {.opcode = 0x8,     .handler = handle_blockwrite_start},        // BlockWrite
-    {.opcode = 0x9,     .handler = handle_blockwrite_cont},
-    {.opcode = 0xa,     .handler = handle_blockwrite_end},
-    {.opcode = 0xb,     .handler = handle_unsupported},             // Device
-    {.opcode = 0xc,     .handler = handle_unsupported},             // DriverControl
-    {.opcode = 0xd,     .handler = handle_unsupported},             // ServiceMessage
-    {.opcode = 0xe,     .handler = handle_invalid},                 // ServiceAvailable
-    {.opcode = 0xf,     .handler = handle_unsupported},             // Shutdown
-    {.opcode = 0x10,    .handler = handle_mcu_msg_format_version}   // MCU msg format version
+    [0x1] = handle_current_device,          // CurrentDevice
+    [0x2] = handle_protocol_version,        // ProtocolVersion
+    [0x3] = handle_info,                    // Info
+    [0x4] = handle_detect,                  // Detect
+    [0x5] = handle_read,                    // Read
+    [0x6] = handle_write,                   // Write
+    [0x7] = handle_blockread,               // BlockRead
+    [0x8] = handle_blockwrite_start,        // BlockWrite
+    [0x9] = handle_blockwrite_cont,
+    [0xa] = handle_blockwrite_end,
+    [0xb] = handle_unsupported,             // Device
+    [0xc] = handle_unsupported,             // DriverControl
+    [0xd] = handle_unsupported,             // ServiceMessage
+    [0xe] = handle_invalid,                 // ServiceAvailable
+    [0xf] = handle_unsupported,             // Shutdown
+    [0x10] = handle_mcu_msg_format_version, // MCU msg format version
+    [0x11] = handle_block_format,           // BlockRead response format
+    [0x12] = handle_batch                   // Batch of Reads and Writes
 };
 
 /***********************************************************************************************************************
@@ -300,6 +344,60 @@ static uint32_t handle_write(unsigned char *u_cmd)
     return BRIDGE_STATUS_OK;
 }
 
+// Send a binary BlockRead response, reading the data from the device a chunk at a time into block_buffer and
+// sending each chunk before reading the next, so the length of the read is not limited by RAM.
+static uint32_t blockread_stream(char *cmd, uint32_t read_addr, uint32_t length, bool is_long_len)
+{
+    regmap_cp_config_t *cp = &(bridge.current_device->b);
+    uint8_t bytes_per_addr = (bridge.current_device->bytes_per_addr > 0) ? bridge.current_device->bytes_per_addr : 1;
+    uint32_t chunk_len = (length < BRIDGE_MAX_BLOCK_READ_BYTES) ? length : BRIDGE_MAX_BLOCK_READ_BYTES;
+    uint32_t ret = REGMAP_STATUS_OK;
+
+    // Read the first chunk before committing to a header, so that a device that cannot be read gets an error reply
+    if (chunk_len > 0)
+    {
+        ret = regmap_read_block(cp, read_addr, block_buffer, chunk_len);
+        if (ret != REGMAP_STATUS_OK)
+        {
+            sprintf(cmd, "%s", WMT_READ_FAILED);
+            return BRIDGE_STATUS_FAIL;
+        }
+    }
+
+    fputc(is_long_len ? BLOCK_BINARY_LONG_MARKER : BLOCK_BINARY_MARKER, bridge_write_file);
+    fputc(GET_BYTE_FROM_WORD(length, 0), bridge_write_file);
+    fputc(GET_BYTE_FROM_WORD(length, 1), bridge_write_file);
+    if (is_long_len)
+    {
+        fputc(GET_BYTE_FROM_WORD(length, 2), bridge_write_file);
+        fputc(GET_BYTE_FROM_WORD(length, 3), bridge_write_file);
+    }
+
+    while (chunk_len > 0)
+    {
+        fwrite(block_buffer, 1, chunk_len, bridge_write_file);
+
+        length -= chunk_len;
+        read_addr += chunk_len / bytes_per_addr;
+        chunk_len = (length < BRIDGE_MAX_BLOCK_READ_BYTES) ? length : BRIDGE_MAX_BLOCK_READ_BYTES;
+
+        if ((chunk_len > 0) && (ret == REGMAP_STATUS_OK))
+        {
+            ret = regmap_read_block(cp, read_addr, block_buffer, chunk_len);
+        }
+        if (ret != REGMAP_STATUS_OK)
+        {
+            // Keep to the length in the header
+            memset(block_buffer, 0, chunk_len);
+        }
+    }
+
+    fputc((ret == REGMAP_STATUS_OK) ? BLOCK_BINARY_OK : BLOCK_BINARY_READ_FAILED, bridge_write_file);
+    is_resp_sent = true;
+
+    return BRIDGE_STATUS_OK;
+}
+
 // User has executed a block-read command on WISCE/SCS.
 static uint32_t handle_blockread(unsigned char *u_cmd)
 {
@@ -323,11 +421,21 @@ static uint32_t handle_blockread(unsigned char *u_cmd)
     uint32_t read_addr;
     memcpy((void*)&read_addr, (void*)&u_cmd[REG_ADDR_OFFSET], sizeof(uint32_t));
 
-    // Get number of bytes to read
-    uint16_t block_read_length;
-    memcpy((void*)&block_read_length, (void*)&u_cmd[READ_LEN_OFFSET], sizeof(uint16_t));
+    // Get number of bytes to read - a 2-byte field, or 4 bytes from an agent reading more than 64kB
+    uint32_t block_read_length = 0;
+    uint16_t payload_len = (u_cmd[LENGTH_OFFSET] << 8) | u_cmd[LENGTH_OFFSET + 1];
+    bool is_long_len = (payload_len >= READ_LEN_LONG_PAYLOAD_LEN);
+    memcpy((void*)&block_read_length,
+           (void*)&u_cmd[READ_LEN_OFFSET],
+           is_long_len ? sizeof(uint32_t) : sizeof(uint16_t));
 
-    if (block_read_length > MAX_BLOCK_DATA_BYTES)
+    if (block_format == BLOCK_FORMAT_BINARY)
+    {
+        return blockread_stream(cmd, read_addr, block_read_length, is_long_len);
+    }
+
+    // The hex response is built whole in cmd_resp
+    if (block_read_length > BRIDGE_MAX_BLOCK_READ_BYTES)
     {
         sprintf(cmd, "%s", WMT_UNSUPPORTED);
         return BRIDGE_STATUS_FAIL;
@@ -343,13 +451,100 @@ static uint32_t handle_blockread(unsigned char *u_cmd)
     for(uint32_t i = 0; i < block_read_length; ++i)
     {
         // Convert each byte value into ASCII hex
-        sprintf(&cmd[i*2], "%02X", block_buffer[i]);
+        cmd[i*2] = hex_chars[block_buffer[i] >> 4];
+        cmd[(i*2) + 1] = hex_chars[block_buffer[i] & 0xF];
     }
     cmd[block_read_length*2] = '\0'; // Manually add null terminator
 
     return BRIDGE_STATUS_OK;
 }
 
+// Agent has batched a run of single register reads and writes from the client. Do them in order and reply with the
+// result of each, separated by ',': the value read as 8 hex chars, "Ok" for a write, or "ER" and the error code.
+static uint32_t handle_batch(unsigned char *u_cmd)
+{
+    char *cmd = (char*)u_cmd;
+    char *resp = cmd;
+    uint32_t ret;
+
+    // Get chip Id
+    uint8_t cmd_chip_num = *(uint8_t*)&u_cmd[CHIPID_OFFSET];
+    uint8_t device_index = cmd_chip_num - 1;
+    if (device_index < bridge.num_devices)
+    {
+        bridge.current_device = &(bridge.device_list[device_index]);
+    }
+    else
+    {
+        sprintf(cmd, "%s", WMT_NO_DEVICE);
+        return BRIDGE_STATUS_FAIL;
+    }
+
+    uint16_t payload_len, num_ops;
+    payload_len = u_cmd[LENGTH_OFFSET] << 8;
+    payload_len |= u_cmd[LENGTH_OFFSET+1];
+    memcpy((void*)&num_ops, (void*)&u_cmd[BATCH_COUNT_OFFSET], sizeof(uint16_t));
+
+    if ((num_ops == 0) || (num_ops > BRIDGE_MAX_BATCH_OPS) ||
+        (payload_len != (BATCH_OPS_OFFSET + (num_ops * BATCH_OP_LEN))))
+    {
+        sprintf(cmd, "%s", WMT_INVALID_COMMAND);
+        return BRIDGE_STATUS_FAIL;
+    }
+
+    /*
+     * The reply is built over the command.  The reply to op i ends before byte (i + 1) * BATCH_RESP_LEN, which is
+     * before op i + 1 starts, and op i itself is copied out before its reply is written.
+     */
+    for (uint16_t i = 0; i < num_ops; i++)
+    {
+        unsigned char *op = &u_cmd[BATCH_OPS_OFFSET + (i * BATCH_OP_LEN)];
+        uint8_t op_type = op[0];
+        uint32_t addr, val;
+
+        memcpy((void*)&addr, (void*)&op[1], sizeof(uint32_t));
+        memcpy((void*)&val, (void*)&op[5], sizeof(uint32_t));
+
+        if (i > 0)
+        {
+            *resp++ = ',';
+        }
+
+        if (op_type == BATCH_OP_READ)
+        {
+            ret = regmap_read(&(bridge.current_device->b), addr, &val);
+            if (ret != REGMAP_STATUS_OK)
+            {
+                resp += sprintf(resp, "%s%s", ERROR, WMT_READ_FAILED);
+                continue;
+            }
+
+            for (int8_t j = 7; j >= 0; j--)
+            {
+                *resp++ = hex_chars[(val >> (j * 4)) & 0xF];
+            }
+        }
+        else if (op_type == BATCH_OP_WRITE)
+        {
+            ret = regmap_write(&(bridge.current_device->b), addr, val);
+            if (ret != REGMAP_STATUS_OK)
+            {
+                resp += sprintf(resp, "%s%s", ERROR, GENERAL_FAILURE);
+                continue;
+            }
+
+            resp += sprintf(resp, "%s", WRITE_OK);
+        }
+        else
+        {
+            resp += sprintf(resp, "%s%s", ERROR, WMT_INVALID_COMMAND);
+        }
+    }
+    *resp = '\0';
+
+    return BRIDGE_STATUS_OK;
+}
+
 // User has executed a block-write command on WISCE/SCS.
 // The bridge agent breaks block-write commands into a series of messages, each carrying a chunk of register
 // values to be written to the hardware. Now we accumulate the messages into a single block write to be
@@ -543,11 +738,33 @@ static uint32_t handle_current_device(unsigned char *u_cmd)
 static uint32_t handle_mcu_msg_format_version(unsigned char *u_cmd)
 {
     char *cmd = (char*)u_cmd;
+
+    // Every agent asks for this when it connects, so an agent that does not negotiate the block format gets hex
+    block_format = BLOCK_FORMAT_HEX;
+
     sprintf(cmd, "%s", BRIDGE_MCU_MSG_FORMAT);
 
     return BRIDGE_STATUS_OK;
 }
 
+// Agent has asked for a BlockRead response format. Reply with the format now in use.
+static uint32_t handle_block_format(unsigned char *u_cmd)
+{
+    char *cmd = (char*)u_cmd;
+    uint8_t format = u_cmd[BLOCK_FORMAT_OFFSET];
+
+    if (format > BLOCK_FORMAT_BINARY)
+    {
+        sprintf(cmd, "%s", WMT_INVALID_PARAMETER);
+        return BRIDGE_STATUS_FAIL;
+    }
+
+    block_format = format;
+    sprintf(cmd, "%u", block_format);
+
+    return BRIDGE_STATUS_OK;
+}
+
 /***********************************************************************************************************************
  * API FUNCTIONS
  **********************************************************************************************************************/
@@ -650,14 +867,24 @@ void bridge_process(void)
         uint8_t opcode = cmd_resp[OPCODE_OFFSET];
         bridge_command_handler_t handler = NULL;
 
+        // Take the sequence number off the end of the command, so the handler sees the command as usual
+        if ((opcode & OPCODE_SEQ_FLAG) && (payload_len > (OPCODE_OFFSET + 1)))
+        {
+            opcode &= ~OPCODE_SEQ_FLAG;
+            payload_len -= SEQ_NUM_LEN;
+            cmd_resp[LENGTH_OFFSET] = (uint8_t) (payload_len >> 8);
+            cmd_resp[LENGTH_OFFSET + 1] = (uint8_t) payload_len;
+            cmd_resp[OPCODE_OFFSET] = opcode;
+
+            // Tag the response before the handler runs, as it may stream the response itself
+            fputc(SEQ_TAG, bridge_write_file);
+            fputc(cmd_resp[payload_len], bridge_write_file);
+        }
+
         // Find the correct handler for the bridge command
-        for (uint8_t k = 0; k < (sizeof(command_handler_map)/sizeof(bridge_command_handler_map_t)); k++)
+        if (opcode < (sizeof(command_handlers)/sizeof(bridge_command_handler_t)))
         {
-            if (opcode == command_handler_map[k].opcode)
-            {
-                handler = command_handler_map[k].handler;
-                break;
-            }
+            handler = command_handlers[opcode];
         }
 
         if (handler == NULL)
@@ -665,6 +892,7 @@ void bridge_process(void)
             handler = handle_unsupported;
         }
 
+        is_resp_sent = false;
         ret = handler(cmd_resp);
 
         if (ret != BRIDGE_STATUS_OK)
@@ -672,7 +900,7 @@ void bridge_process(void)
             // Handler returned an error so send an error msg back to bridge
             fprintf(bridge_write_file, "%s %s\n", ERROR, cmd_resp);
         }
-        else
+        else if (!is_resp_sent)  // Else the handler has streamed its response already
         {
             /* Handler returned OK so send the response back to bridge.
              * Again, the fprintf overrides the C std system call and uses multi-packet UART
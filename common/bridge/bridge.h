@@ -48,6 +48,9 @@ extern "C" {
 #define BRIDGE_REG_BYTES                        (4)
 #define BRIDGE_MAX_BLOCK_WRITE_BYTES            (BRIDGE_MAX_WISCE_REG_SPAN * BRIDGE_REG_BYTES)
 #define BRIDGE_MAX_BLOCK_READ_BYTES             (800)
+// Register reads and writes in one batch command, limited so that a sequence-numbered batch still fits the 1kB bridge
+// receive FIFO in the platform BSP
+#define BRIDGE_MAX_BATCH_OPS                    (112)
 #if (BRIDGE_MAX_BLOCK_WRITE_BYTES > BRIDGE_MAX_BLOCK_READ_BYTES)
     #define BRIDGE_BLOCK_BUFFER_LENGTH_BYTES    (BRIDGE_MAX_BLOCK_WRITE_BYTES)
 #else
@@ -70,6 +73,9 @@ typedef struct
     // WISCE/SCS will use this in their commands to target the correct device
     const char *dev_name_str;
     uint8_t bus_i2c_cs_address;
+    // bytes_per_addr is how many bytes of a block transfer each address step covers, used to split long block reads
+    // Eg 2 for Madera devices, where 32-bit memory words are 2 addresses apart. 0 is taken as 1
+    uint8_t bytes_per_addr;
     regmap_cp_config_t b;
 } bridge_device_t;
 
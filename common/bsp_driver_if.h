@@ -204,6 +204,42 @@ typedef struct
      */
     uint32_t (*set_timer)(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg);
 
+    /**
+     * Get the time since the BSP was initialized
+     *
+     * Used by drivers to measure how long operations take.  May be NULL if the platform has no millisecond clock.
+     *
+     * @return                  Time in milliseconds - wraps at 2^32
+     *
+     */
+    uint32_t (*get_time_ms)(void);
+
+    /**
+     * Get the time since the BSP was initialized, in microseconds
+     *
+     * Used by drivers to time control port transactions, which are too short for get_time_ms.  May be NULL if the
+     * platform has no microsecond clock.
+     *
+     * @return                  Time in microseconds - wraps at 2^32
+     *
+     */
+    uint32_t (*get_time_us)(void);
+
+    /**
+     * Wait for a number of microseconds
+     *
+     * Blocks the caller.  Used by drivers for delays shorter than set_timer can express.  May be NULL, in which case
+     * drivers round the delay up to whole milliseconds on set_timer.
+     *
+     * @param [in] duration_us      Time to wait in microseconds
+     *
+     * @return
+     * - BSP_STATUS_FAIL        if the platform cannot wait that long
+     * - BSP_STATUS_OK          otherwise
+     *
+     */
+    uint32_t (*delay_us)(uint32_t duration_us);
+
     /**
      * Reset I2C Port used for a specific device
      *
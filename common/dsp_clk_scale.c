@@ -0,0 +1,149 @@
+/**
+ * @file dsp_clk_scale.c
+ *
+ * @brief The DSP clock scaling policy module
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include "dsp_clk_scale.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Find the lowest level that runs a load within a percentage of its clock
+ *
+ * @return Index of the level, or the highest level if none does
+ *
+ */
+static uint32_t dsp_clk_scale_find_level(const dsp_clk_scale_config_t *config, uint32_t load_hz, uint32_t pct)
+{
+    uint32_t level;
+
+    for (level = 0; level < (config->n_levels - 1); level++)
+    {
+        if (((uint64_t) load_hz * 100) <= ((uint64_t) config->levels_hz[level] * pct))
+        {
+            break;
+        }
+    }
+
+    return level;
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Initialize DSP clock scaling policy state
+ *
+ */
+uint32_t dsp_clk_scale_init(dsp_clk_scale_t *scale, const dsp_clk_scale_config_t *config, uint32_t level)
+{
+    if ((config->levels_hz == NULL) || (config->n_levels == 0) || (level >= config->n_levels) ||
+        (config->up_pct > 100) || (config->down_pct >= config->up_pct))
+    {
+        return DSP_CLK_SCALE_STATUS_FAIL;
+    }
+
+    for (uint32_t i = 1; i < config->n_levels; i++)
+    {
+        if (config->levels_hz[i] <= config->levels_hz[i - 1])
+        {
+            return DSP_CLK_SCALE_STATUS_FAIL;
+        }
+    }
+
+    scale->config = *config;
+    scale->level = level;
+    scale->down_level = 0;
+    scale->down_count = 0;
+    scale->change_count = 0;
+
+    return DSP_CLK_SCALE_STATUS_OK;
+}
+
+/**
+ * Feed a load sample to the policy
+ *
+ */
+bool dsp_clk_scale_update(dsp_clk_scale_t *scale, uint32_t load_hz)
+{
+    uint32_t up_level = dsp_clk_scale_find_level(&(scale->config), load_hz, scale->config.up_pct);
+    uint32_t down_level;
+
+    // Step straight up to whatever the load needs
+    if (up_level > scale->level)
+    {
+        scale->level = up_level;
+        scale->down_count = 0;
+        scale->change_count++;
+        return true;
+    }
+
+    down_level = dsp_clk_scale_find_level(&(scale->config), load_hz, scale->config.down_pct);
+    if (down_level >= scale->level)
+    {
+        scale->down_count = 0;
+        return false;
+    }
+
+    // Only step down as far as every sample in the run allows
+    if ((scale->down_count == 0) || (down_level > scale->down_level))
+    {
+        scale->down_level = down_level;
+    }
+    scale->down_count++;
+
+    if (scale->down_count < scale->config.down_samples)
+    {
+        return false;
+    }
+
+    scale->level = scale->down_level;
+    scale->down_count = 0;
+    scale->change_count++;
+
+    return true;
+}
+
+/**
+ * Get the DSP clock chosen by the policy
+ *
+ */
+uint32_t dsp_clk_scale_get_hz(const dsp_clk_scale_t *scale)
+{
+    return scale->config.levels_hz[scale->level];
+}
@@ -0,0 +1,139 @@
+/**
+ * @file dsp_clk_scale.h
+ *
+ * @brief Functions and prototypes exported by the DSP clock scaling policy module
+ *
+ * The policy picks the lowest of a set of DSP clock frequencies that runs the firmware load with headroom.  It steps
+ * up as soon as the load needs it, and only steps down once the load has fit a lower clock for several samples in a
+ * row, so that a load near a threshold does not make the clock oscillate.  It does no control port activity, so it can
+ * be run on host against a simulated load.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef DSP_CLK_SCALE_H
+#define DSP_CLK_SCALE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup DSP_CLK_SCALE_STATUS_
+ * @brief Return values for all public API calls
+ *
+ * @{
+ */
+#define DSP_CLK_SCALE_STATUS_OK             (0)
+#define DSP_CLK_SCALE_STATUS_FAIL           (1)
+/** @} */
+
+/***********************************************************************************************************************
+ * MACROS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * DSP clock scaling policy configuration
+ */
+typedef struct
+{
+    const uint32_t *levels_hz;      ///< DSP clock frequencies to choose from in Hz, in ascending order
+    uint32_t n_levels;              ///< Number of entries in 'levels_hz'
+    uint32_t up_pct;                ///< Step up once the load is above this percentage of the current clock
+    uint32_t down_pct;              ///< Step down once the load fits within this percentage of a lower clock
+    uint32_t down_samples;          ///< Consecutive samples the load must fit a lower clock before stepping down
+} dsp_clk_scale_config_t;
+
+/**
+ * DSP clock scaling policy state
+ */
+typedef struct
+{
+    dsp_clk_scale_config_t config;  ///< Policy configuration
+    uint32_t level;                 ///< Index in 'levels_hz' of the current DSP clock
+    uint32_t down_level;            ///< Highest lower level the load has fit over the current run of samples
+    uint32_t down_count;            ///< Consecutive samples the load has fit a lower level
+    uint32_t change_count;          ///< DSP clock changes since dsp_clk_scale_init
+} dsp_clk_scale_t;
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Initialize DSP clock scaling policy state
+ *
+ * @param [in] scale            Pointer to policy state
+ * @param [in] config           Pointer to policy configuration - 'levels_hz' must remain valid
+ * @param [in] level            Index in 'levels_hz' of the DSP clock currently running
+ *
+ * @return
+ * - DSP_CLK_SCALE_STATUS_FAIL if:
+ *      - 'levels_hz' is empty or not in ascending order, or 'level' is out of range
+ *      - 'down_pct' is not below 'up_pct', or 'up_pct' is above 100
+ * - DSP_CLK_SCALE_STATUS_OK    otherwise
+ *
+ */
+uint32_t dsp_clk_scale_init(dsp_clk_scale_t *scale, const dsp_clk_scale_config_t *config, uint32_t level);
+
+/**
+ * Feed a load sample to the policy
+ *
+ * A load that needs more than the highest level runs at the highest level.
+ *
+ * @param [in] scale            Pointer to policy state
+ * @param [in] load_hz          DSP cycles per second the firmware needs
+ *
+ * @return true if the policy changed the DSP clock - call dsp_clk_scale_get_hz for the new clock
+ *
+ */
+bool dsp_clk_scale_update(dsp_clk_scale_t *scale, uint32_t load_hz);
+
+/**
+ * Get the DSP clock chosen by the policy
+ *
+ * @param [in] scale            Pointer to policy state
+ *
+ * @return DSP clock in Hz
+ *
+ */
+uint32_t dsp_clk_scale_get_hz(const dsp_clk_scale_t *scale);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSP_CLK_SCALE_H
@@ -0,0 +1,237 @@
+/**
+ * @file halo_mbox.c
+ *
+ * @brief The HALO Core mailbox module
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "halo_mbox.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Finish the pending command and update statistics
+ *
+ */
+static void halo_mbox_finish(halo_mbox_t *mbox, bool is_acked)
+{
+    uint32_t latency_ms = mbox->pending_delay_ms;
+
+    mbox->is_pending = false;
+
+    if (!is_acked)
+    {
+        mbox->stats.fail_count++;
+        return;
+    }
+
+    // Timer delays can overrun, and the ack read itself takes time, so use the BSP clock where there is one
+    if (bsp_driver_if_g->get_time_ms != NULL)
+    {
+        latency_ms = bsp_driver_if_g->get_time_ms() - mbox->pending_start_ms;
+    }
+
+    mbox->stats.last_latency_ms = latency_ms;
+    mbox->stats.total_latency_ms += latency_ms;
+    if (latency_ms > mbox->stats.max_latency_ms)
+    {
+        mbox->stats.max_latency_ms = latency_ms;
+    }
+
+    return;
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Initialize mailbox state
+ *
+ */
+uint32_t halo_mbox_initialize(halo_mbox_t *mbox, regmap_cp_config_t *cp, const halo_mbox_config_t *config)
+{
+    if ((mbox == NULL) || (cp == NULL) || (config == NULL))
+    {
+        return HALO_MBOX_STATUS_FAIL;
+    }
+
+    memset(mbox, 0, sizeof(halo_mbox_t));
+    mbox->cp = cp;
+    mbox->config = *config;
+
+    return HALO_MBOX_STATUS_OK;
+}
+
+/**
+ * Send a mailbox command without waiting for the ack
+ *
+ */
+uint32_t halo_mbox_send(halo_mbox_t *mbox, uint32_t addr, uint32_t cmd)
+{
+    uint32_t ret;
+
+    if (mbox->is_pending)
+    {
+        return HALO_MBOX_STATUS_FAIL;
+    }
+
+    ret = regmap_write(mbox->cp, addr, cmd);
+    if (ret)
+    {
+        return HALO_MBOX_STATUS_FAIL;
+    }
+
+    mbox->is_pending = true;
+    mbox->pending_addr = addr;
+    mbox->pending_cmd = cmd;
+    mbox->pending_delay_ms = 0;
+    mbox->stats.cmd_count++;
+
+    if (bsp_driver_if_g->get_time_ms != NULL)
+    {
+        mbox->pending_start_ms = bsp_driver_if_g->get_time_ms();
+    }
+
+    return HALO_MBOX_STATUS_OK;
+}
+
+/**
+ * Check for the ack of the pending command
+ *
+ */
+uint32_t halo_mbox_complete(halo_mbox_t *mbox)
+{
+    uint32_t ret, ack_reg, val;
+
+    if (!mbox->is_pending)
+    {
+        return HALO_MBOX_STATUS_FAIL;
+    }
+
+    if (mbox->config.ack_type == HALO_MBOX_ACK_TYPE_IRQ)
+    {
+        ack_reg = mbox->config.ack_reg;
+    }
+    else
+    {
+        ack_reg = mbox->pending_addr;
+    }
+
+    mbox->stats.poll_count++;
+    ret = regmap_read(mbox->cp, ack_reg, &val);
+    if (ret)
+    {
+        halo_mbox_finish(mbox, false);
+        return HALO_MBOX_STATUS_FAIL;
+    }
+
+    if ((val & mbox->config.ack_mask) != mbox->config.ack_val)
+    {
+        return HALO_MBOX_STATUS_AGAIN;
+    }
+
+    // Ack IRQ flags are W1C
+    if (mbox->config.ack_type == HALO_MBOX_ACK_TYPE_IRQ)
+    {
+        ret = regmap_write(mbox->cp, ack_reg, mbox->config.ack_mask);
+        if (ret)
+        {
+            halo_mbox_finish(mbox, false);
+            return HALO_MBOX_STATUS_FAIL;
+        }
+    }
+
+    halo_mbox_finish(mbox, true);
+
+    return HALO_MBOX_STATUS_OK;
+}
+
+/**
+ * Wait for the ack of the pending command
+ *
+ */
+uint32_t halo_mbox_wait(halo_mbox_t *mbox)
+{
+    uint32_t ret;
+    uint32_t delay_ms = 1;
+
+    if (!mbox->is_pending)
+    {
+        return HALO_MBOX_STATUS_FAIL;
+    }
+
+    while (1)
+    {
+        ret = halo_mbox_complete(mbox);
+        if (ret != HALO_MBOX_STATUS_AGAIN)
+        {
+            return ret;
+        }
+
+        if (mbox->pending_delay_ms >= mbox->config.timeout_ms)
+        {
+            break;
+        }
+
+        bsp_driver_if_g->set_timer(delay_ms, NULL, NULL);
+        mbox->pending_delay_ms += delay_ms;
+
+        delay_ms <<= 1;
+        if ((mbox->config.poll_delay_max_ms > 0) && (delay_ms > mbox->config.poll_delay_max_ms))
+        {
+            delay_ms = mbox->config.poll_delay_max_ms;
+        }
+    }
+
+    halo_mbox_finish(mbox, false);
+
+    return HALO_MBOX_STATUS_FAIL;
+}
+
+/**
+ * Send a mailbox command and wait for the ack
+ *
+ */
+uint32_t halo_mbox_send_acked(halo_mbox_t *mbox, uint32_t addr, uint32_t cmd)
+{
+    uint32_t ret;
+
+    ret = halo_mbox_send(mbox, addr, cmd);
+    if (ret)
+    {
+        return ret;
+    }
+
+    return halo_mbox_wait(mbox);
+}
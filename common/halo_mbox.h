@@ -0,0 +1,206 @@
+/**
+ * @file halo_mbox.h
+ *
+ * @brief Functions and prototypes exported by the HALO Core mailbox module
+ *
+ * Acks are only detected by polling, with halo_mbox_complete() or halo_mbox_wait().  For HALO_MBOX_ACK_TYPE_IRQ the
+ * IRQ flag register is polled - no driver completes a command from its IRQ handler.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef HALO_MBOX_H
+#define HALO_MBOX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmap.h"
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup HALO_MBOX_STATUS_
+ * @brief Return values for all public API calls
+ *
+ * @{
+ */
+#define HALO_MBOX_STATUS_OK                 (0)
+#define HALO_MBOX_STATUS_FAIL               (1)
+#define HALO_MBOX_STATUS_AGAIN              (2)
+/** @} */
+
+/**
+ * @defgroup HALO_MBOX_ACK_TYPE_
+ * @brief How the HALO FW acknowledges a mailbox command
+ *
+ * @{
+ */
+#define HALO_MBOX_ACK_TYPE_CLEAR            (0)     ///< Command register reads back 'ack_val' once processed
+#define HALO_MBOX_ACK_TYPE_IRQ              (1)     ///< 'ack_mask' is set in 'ack_reg' (W1C) once processed
+/** @} */
+
+/***********************************************************************************************************************
+ * MACROS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Mailbox configuration
+ */
+typedef struct
+{
+    uint8_t ack_type;               ///< @see HALO_MBOX_ACK_TYPE_
+    uint32_t ack_reg;               ///< Register polled for ack - only used for HALO_MBOX_ACK_TYPE_IRQ
+    uint32_t ack_mask;              ///< Bits in 'ack_reg' compared against 'ack_val'
+    uint32_t ack_val;               ///< Value of masked ack register once the command is processed
+    uint32_t poll_delay_max_ms;     ///< Maximum delay between polls of the ack register
+    uint32_t timeout_ms;            ///< Total delay before a pending command is considered failed
+} halo_mbox_config_t;
+
+/**
+ * Mailbox command latency statistics
+ *
+ * Latencies are measured with the BSP get_time_ms() clock, from the command write until the ack is read.  If the BSP
+ * has no clock, they are the sum of polling delays spent waiting for the ack, so a command acked on the first read
+ * after sending has a latency of 0ms.
+ */
+typedef struct
+{
+    uint32_t cmd_count;             ///< Total commands sent
+    uint32_t fail_count;            ///< Total commands that were not acked before timeout
+    uint32_t poll_count;            ///< Total reads of the ack register
+    uint32_t last_latency_ms;       ///< Latency of most recent acked command
+    uint32_t max_latency_ms;        ///< Maximum latency of any acked command
+    uint32_t total_latency_ms;      ///< Sum of latencies of all acked commands
+} halo_mbox_stats_t;
+
+/**
+ * Mailbox state
+ */
+typedef struct
+{
+    regmap_cp_config_t *cp;         ///< Control Port configuration for regmap calls
+    halo_mbox_config_t config;      ///< Mailbox configuration
+    bool is_pending;                ///< (True) a command has been sent and is waiting for its ack
+    uint32_t pending_addr;          ///< Address the pending command was written to
+    uint32_t pending_cmd;           ///< Pending command
+    uint32_t pending_delay_ms;      ///< Delay spent so far waiting for the pending command
+    uint32_t pending_start_ms;      ///< BSP time the pending command was sent
+    halo_mbox_stats_t stats;        ///< Command latency statistics
+} halo_mbox_t;
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Initialize mailbox state
+ *
+ * @param [in] mbox             Pointer to mailbox state
+ * @param [in] cp               Pointer to the BSP control port configuration
+ * @param [in] config           Pointer to mailbox configuration
+ *
+ * @return
+ * - HALO_MBOX_STATUS_FAIL      if any pointers are NULL
+ * - HALO_MBOX_STATUS_OK        otherwise
+ *
+ */
+uint32_t halo_mbox_initialize(halo_mbox_t *mbox, regmap_cp_config_t *cp, const halo_mbox_config_t *config);
+
+/**
+ * Send a mailbox command without waiting for the ack
+ *
+ * The command is complete once halo_mbox_complete() or halo_mbox_wait() sees the ack.
+ *
+ * @param [in] mbox             Pointer to mailbox state
+ * @param [in] addr             Address of mailbox register or firmware control to write
+ * @param [in] cmd              Command to write
+ *
+ * @return
+ * - HALO_MBOX_STATUS_FAIL      if a command is already pending, or if control port write fails
+ * - HALO_MBOX_STATUS_OK        otherwise
+ *
+ */
+uint32_t halo_mbox_send(halo_mbox_t *mbox, uint32_t addr, uint32_t cmd);
+
+/**
+ * Check for the ack of the pending command
+ *
+ * Performs a single read of the ack register, so a caller can do other work between checks.  This is also used by
+ * halo_mbox_wait() for each poll.
+ *
+ * @param [in] mbox             Pointer to mailbox state
+ *
+ * @return
+ * - HALO_MBOX_STATUS_FAIL      if no command is pending, or if control port activity fails
+ * - HALO_MBOX_STATUS_AGAIN     if the command has not been acked yet
+ * - HALO_MBOX_STATUS_OK        otherwise
+ *
+ */
+uint32_t halo_mbox_complete(halo_mbox_t *mbox);
+
+/**
+ * Wait for the ack of the pending command
+ *
+ * Polls immediately, then backs off exponentially from 1ms up to 'poll_delay_max_ms' between polls until either the
+ * ack is seen or 'timeout_ms' has elapsed.
+ *
+ * @param [in] mbox             Pointer to mailbox state
+ *
+ * @return
+ * - HALO_MBOX_STATUS_FAIL      if no command is pending, if control port activity fails, or if timed out
+ * - HALO_MBOX_STATUS_OK        otherwise
+ *
+ */
+uint32_t halo_mbox_wait(halo_mbox_t *mbox);
+
+/**
+ * Send a mailbox command and wait for the ack
+ *
+ * @param [in] mbox             Pointer to mailbox state
+ * @param [in] addr             Address of mailbox register or firmware control to write
+ * @param [in] cmd              Command to write
+ *
+ * @return
+ * - HALO_MBOX_STATUS_FAIL      if control port activity fails, or if command is not acked before timeout
+ * - HALO_MBOX_STATUS_OK        otherwise
+ *
+ */
+uint32_t halo_mbox_send_acked(halo_mbox_t *mbox, uint32_t addr, uint32_t cmd);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HALO_MBOX_H
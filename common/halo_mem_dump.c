@@ -0,0 +1,241 @@
+/**
+ * @file halo_mem_dump.c
+ *
+ * @brief The HALO Core memory dump module
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "halo_mem_dump.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Context passed through halo_mem_dump_range() when diffing
+ */
+typedef struct
+{
+    halo_mem_dump_t *dump;
+    const uint8_t *expected;
+    halo_mem_diff_callback_t cb;
+    void *arg;
+} halo_mem_diff_context_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Convert a word in control port byte order (big-endian) to a uint32_t
+ *
+ */
+static uint32_t halo_mem_dump_get_word(const uint8_t *bytes)
+{
+    return ((uint32_t) bytes[0] << 24) | ((uint32_t) bytes[1] << 16) | ((uint32_t) bytes[2] << 8) | bytes[3];
+}
+
+/**
+ * Put a block read in control port byte order
+ *
+ * regmap_read_block() returns the bytes of an I2C/SPI read as clocked on the bus, but stores each word of a virtual
+ * regmap read as a host-endian uint32_t.
+ *
+ */
+static void halo_mem_dump_to_cp_order(regmap_cp_config_t *cp, uint8_t *bytes, uint32_t length)
+{
+    if (cp->bus_type != REGMAP_BUS_TYPE_VIRTUAL)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < length; i += HALO_MEM_DUMP_WORD_BYTES)
+    {
+        uint32_t word;
+
+        memcpy(&word, &(bytes[i]), HALO_MEM_DUMP_WORD_BYTES);
+        bytes[i] = GET_BYTE_FROM_WORD(word, 3);
+        bytes[i + 1] = GET_BYTE_FROM_WORD(word, 2);
+        bytes[i + 2] = GET_BYTE_FROM_WORD(word, 1);
+        bytes[i + 3] = GET_BYTE_FROM_WORD(word, 0);
+    }
+
+    return;
+}
+
+/**
+ * Compare a chunk read from the device against the expected image
+ *
+ */
+static uint32_t halo_mem_dump_diff_chunk(uint32_t addr, uint8_t *bytes, uint32_t length, void *arg)
+{
+    halo_mem_diff_context_t *ctx = (halo_mem_diff_context_t *) arg;
+    halo_mem_dump_stats_t *stats = &(ctx->dump->stats);
+
+    stats->words_compared += length / HALO_MEM_DUMP_WORD_BYTES;
+
+    // Only fall back to word-by-word comparison if something in the chunk differs
+    if (memcmp(bytes, ctx->expected, length) != 0)
+    {
+        for (uint32_t i = 0; i < length; i += HALO_MEM_DUMP_WORD_BYTES)
+        {
+            uint32_t expected = halo_mem_dump_get_word(&(ctx->expected[i]));
+            uint32_t actual = halo_mem_dump_get_word(&(bytes[i]));
+
+            if (expected != actual)
+            {
+                if (stats->mismatch_count == 0)
+                {
+                    stats->first_mismatch_addr = addr + i;
+                }
+                stats->mismatch_count++;
+
+                if (ctx->cb != NULL)
+                {
+                    ctx->cb(addr + i, expected, actual, ctx->arg);
+                }
+            }
+        }
+    }
+
+    ctx->expected += length;
+
+    return HALO_MEM_DUMP_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Initialize memory dump state
+ *
+ */
+uint32_t halo_mem_dump_initialize(halo_mem_dump_t *dump,
+                                  regmap_cp_config_t *cp,
+                                  uint8_t *buffer,
+                                  uint32_t buffer_size)
+{
+    uint32_t block_size = buffer_size;
+
+    if ((dump == NULL) || (cp == NULL) || (buffer == NULL))
+    {
+        return HALO_MEM_DUMP_STATUS_FAIL;
+    }
+
+    // For virtual control ports 'receive_max' is the register file length, not a transfer limit
+    if ((cp->bus_type != REGMAP_BUS_TYPE_VIRTUAL) && (cp->receive_max > 0) && (cp->receive_max < block_size))
+    {
+        block_size = cp->receive_max;
+    }
+
+    block_size -= block_size % HALO_MEM_DUMP_WORD_BYTES;
+    if (block_size == 0)
+    {
+        return HALO_MEM_DUMP_STATUS_FAIL;
+    }
+
+    memset(dump, 0, sizeof(halo_mem_dump_t));
+    dump->cp = cp;
+    dump->buffer = buffer;
+    dump->block_size = block_size;
+
+    return HALO_MEM_DUMP_STATUS_OK;
+}
+
+/**
+ * Read a range of DSP memory
+ *
+ */
+uint32_t halo_mem_dump_range(halo_mem_dump_t *dump,
+                             uint32_t addr,
+                             uint32_t length,
+                             halo_mem_dump_callback_t cb,
+                             void *arg)
+{
+    uint32_t ret;
+
+    if ((cb == NULL) || (length % HALO_MEM_DUMP_WORD_BYTES))
+    {
+        return HALO_MEM_DUMP_STATUS_FAIL;
+    }
+
+    while (length > 0)
+    {
+        uint32_t chunk = (length < dump->block_size) ? length : dump->block_size;
+
+        ret = regmap_read_block(dump->cp, addr, dump->buffer, chunk);
+        if (ret)
+        {
+            return HALO_MEM_DUMP_STATUS_FAIL;
+        }
+        halo_mem_dump_to_cp_order(dump->cp, dump->buffer, chunk);
+
+        dump->stats.read_count++;
+        dump->stats.bytes_read += chunk;
+
+        ret = cb(addr, dump->buffer, chunk, arg);
+        if (ret)
+        {
+            return HALO_MEM_DUMP_STATUS_FAIL;
+        }
+
+        addr += chunk;
+        length -= chunk;
+    }
+
+    return HALO_MEM_DUMP_STATUS_OK;
+}
+
+/**
+ * Compare a range of DSP memory against an expected image
+ *
+ */
+uint32_t halo_mem_dump_diff(halo_mem_dump_t *dump,
+                            uint32_t addr,
+                            const uint8_t *expected,
+                            uint32_t length,
+                            halo_mem_diff_callback_t cb,
+                            void *arg)
+{
+    halo_mem_diff_context_t ctx;
+
+    if (expected == NULL)
+    {
+        return HALO_MEM_DUMP_STATUS_FAIL;
+    }
+
+    ctx.dump = dump;
+    ctx.expected = expected;
+    ctx.cb = cb;
+    ctx.arg = arg;
+
+    return halo_mem_dump_range(dump, addr, length, halo_mem_dump_diff_chunk, &ctx);
+}
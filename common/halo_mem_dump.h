@@ -0,0 +1,200 @@
+/**
+ * @file halo_mem_dump.h
+ *
+ * @brief Functions and prototypes exported by the HALO Core memory dump module
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef HALO_MEM_DUMP_H
+#define HALO_MEM_DUMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmap.h"
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup HALO_MEM_DUMP_STATUS_
+ * @brief Return values for all public API calls
+ *
+ * @{
+ */
+#define HALO_MEM_DUMP_STATUS_OK             (0)
+#define HALO_MEM_DUMP_STATUS_FAIL           (1)
+/** @} */
+
+#define HALO_MEM_DUMP_WORD_BYTES            (4)     ///< Bytes per HALO memory word on the control port
+
+/***********************************************************************************************************************
+ * MACROS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Callback for each chunk of memory read by halo_mem_dump_range()
+ *
+ * @param [in] addr             Control port address of first word in chunk
+ * @param [in] bytes            Chunk contents, in control port byte order
+ * @param [in] length           Length of chunk in bytes
+ * @param [in] arg              User argument passed to halo_mem_dump_range()
+ *
+ * @return
+ * - HALO_MEM_DUMP_STATUS_FAIL  to abort the dump
+ * - HALO_MEM_DUMP_STATUS_OK    otherwise
+ *
+ */
+typedef uint32_t (*halo_mem_dump_callback_t)(uint32_t addr, uint8_t *bytes, uint32_t length, void *arg);
+
+/**
+ * Callback for each mismatched word found by halo_mem_dump_diff()
+ *
+ * @param [in] addr             Control port address of mismatched word
+ * @param [in] expected         Expected word value
+ * @param [in] actual           Word value read from device
+ * @param [in] arg              User argument passed to halo_mem_dump_diff()
+ *
+ */
+typedef void (*halo_mem_diff_callback_t)(uint32_t addr, uint32_t expected, uint32_t actual, void *arg);
+
+/**
+ * Memory dump statistics
+ */
+typedef struct
+{
+    uint32_t read_count;            ///< Total block reads issued
+    uint32_t bytes_read;            ///< Total bytes read from device
+    uint32_t words_compared;        ///< Total words compared by halo_mem_dump_diff()
+    uint32_t mismatch_count;        ///< Total words that did not match the expected image
+    uint32_t first_mismatch_addr;   ///< Address of first mismatched word - only valid if 'mismatch_count' > 0
+} halo_mem_dump_stats_t;
+
+/**
+ * Memory dump state
+ */
+typedef struct
+{
+    regmap_cp_config_t *cp;         ///< Control Port configuration for regmap calls
+    uint8_t *buffer;                ///< Scratch buffer for block reads
+    uint32_t block_size;            ///< Maximum bytes per block read
+    halo_mem_dump_stats_t stats;    ///< Dump statistics
+} halo_mem_dump_t;
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Initialize memory dump state
+ *
+ * The block read size is the largest whole number of words that fits in both 'buffer' and, for I2C/SPI control ports,
+ * the control port 'receive_max'.
+ *
+ * @param [in] dump             Pointer to memory dump state
+ * @param [in] cp               Pointer to the BSP control port configuration
+ * @param [in] buffer           Scratch buffer for block reads
+ * @param [in] buffer_size      Size of 'buffer' in bytes
+ *
+ * @return
+ * - HALO_MEM_DUMP_STATUS_FAIL  if any pointers are NULL, or if block read size is less than one word
+ * - HALO_MEM_DUMP_STATUS_OK    otherwise
+ *
+ */
+uint32_t halo_mem_dump_initialize(halo_mem_dump_t *dump,
+                                  regmap_cp_config_t *cp,
+                                  uint8_t *buffer,
+                                  uint32_t buffer_size);
+
+/**
+ * Read a range of DSP memory
+ *
+ * Reads the range with the fewest block reads possible, passing each chunk to 'cb' as it is read so that the range
+ * may be larger than the scratch buffer.  Chunks are in control port byte order for every bus type, including virtual
+ * control ports.
+ *
+ * @param [in] dump             Pointer to memory dump state
+ * @param [in] addr             Control port address of start of range
+ * @param [in] length           Length of range in bytes - must be a multiple of HALO_MEM_DUMP_WORD_BYTES
+ * @param [in] cb               Callback for each chunk read
+ * @param [in] arg              User argument passed to 'cb'
+ *
+ * @return
+ * - HALO_MEM_DUMP_STATUS_FAIL if:
+ *      - 'cb' is NULL
+ *      - 'length' is not a whole number of words
+ *      - Control port activity fails
+ *      - 'cb' aborts the dump
+ * - HALO_MEM_DUMP_STATUS_OK    otherwise
+ *
+ */
+uint32_t halo_mem_dump_range(halo_mem_dump_t *dump,
+                             uint32_t addr,
+                             uint32_t length,
+                             halo_mem_dump_callback_t cb,
+                             void *arg);
+
+/**
+ * Compare a range of DSP memory against an expected image
+ *
+ * 'expected' is in control port byte order, i.e. the same format as the data blocks output by fw_img_process(), so
+ * each FW_IMG_STATUS_DATA_READY block can be passed in directly to verify a firmware download.
+ *
+ * @param [in] dump             Pointer to memory dump state
+ * @param [in] addr             Control port address of start of range
+ * @param [in] expected         Expected contents of range
+ * @param [in] length           Length of range in bytes - must be a multiple of HALO_MEM_DUMP_WORD_BYTES
+ * @param [in] cb               Callback for each mismatched word - may be NULL
+ * @param [in] arg              User argument passed to 'cb'
+ *
+ * @return
+ * - HALO_MEM_DUMP_STATUS_FAIL if:
+ *      - 'expected' is NULL
+ *      - 'length' is not a whole number of words
+ *      - Control port activity fails
+ * - HALO_MEM_DUMP_STATUS_OK    otherwise - check 'stats.mismatch_count' for the result of the comparison
+ *
+ */
+uint32_t halo_mem_dump_diff(halo_mem_dump_t *dump,
+                            uint32_t addr,
+                            const uint8_t *expected,
+                            uint32_t length,
+                            halo_mem_diff_callback_t cb,
+                            void *arg);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HALO_MEM_DUMP_H
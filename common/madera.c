@@ -0,0 +1,730 @@
+/**
+ * @file madera.c
+ *
+ * @brief The Madera codec core module
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "madera.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+
+/**
+ * @defgroup MADERA_DSP_OFF_
+ * @brief ADSP2 core control register offsets from the DSP base address
+ *
+ * @{
+ */
+#define MADERA_DSP_OFF_CONFIG_1             (0x00)
+#define MADERA_DSP_OFF_STATUS_1             (0x04)
+#define MADERA_DSP_OFF_DMA_CONFIG_1         (0x30)
+#define MADERA_DSP_OFF_DMA_CONFIG_2         (0x32)
+#define MADERA_DSP_OFF_DMA_CONFIG_3         (0x34)
+/** @} */
+
+#define MADERA_DSP_CORE_ENA                 (0x00000002)
+#define MADERA_DSP_START                    (0x00000001)
+#define MADERA_DSP_RAM_RDY                  (0x00000001)
+
+#define MADERA_POLL_MEM_ENA_MS              (250)   ///< Delay in ms between polling RAM_RDY
+#define MADERA_POLL_MEM_ENA_MAX             (10)    ///< Maximum number of times to poll RAM_RDY
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+struct madera_fll_sync_fratio {
+    uint32_t  min;
+    uint32_t  max;
+    uint16_t  fratio;
+    int32_t  ratio;
+};
+
+struct madera_fll_gains {
+    uint32_t  min;
+    uint32_t  max;
+    int32_t   gain;            /* main gain */
+    int32_t   alt_gain;        /* alternate integer gain */
+};
+
+/**
+ * Precomputed FLL configuration for a reference/output frequency pair
+ */
+typedef struct
+{
+    uint32_t fref;
+    uint32_t fout;
+    bool sync;
+    madera_fll_cfg_t cfg;
+} madera_fll_table_entry_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static const struct madera_fll_sync_fratio madera_fll_sync_fratios[] = {
+    {       0,    64000, 4, 16 },
+    {   64000,   128000, 3,  8 },
+    {  128000,   256000, 2,  4 },
+    {  256000,  1000000, 1,  2 },
+    { 1000000, 13500000, 0,  1 },
+};
+
+static const struct madera_fll_gains madera_fll_sync_gains[] = {
+    {       0,   256000, 0, -1 },
+    {  256000,  1000000, 2, -1 },
+    { 1000000, 13500000, 4, -1 },
+};
+
+static const struct madera_fll_gains madera_fll_main_gains[] = {
+    {       0,   100000, 0, 2 },
+    {  100000,   375000, 2, 2 },
+    {  375000,   768000, 3, 2 },
+    {  768001,  1500000, 3, 3 },
+    { 1500000,  6000000, 4, 3 },
+    { 6000000, 13500000, 5, 3 },
+};
+
+/*
+ * Precomputed FLL configurations for common clock plans, checked by madera_calc_fll() before
+ * falling back to calculation.  Generated by tools/fll_table_generator/fll_table_generator.py - regenerate
+ * rather than editing by hand.  tools/fll_table_check checks every entry bit for bit against madera_calc_fll_cfg().
+ */
+static const madera_fll_table_entry_t madera_fll_table[] = {
+    /*    fref,      fout,  sync, {    n, theta, lambda, refdiv, fratio, gain, alt_gain } */
+    {    32768,  98304000, false, { 1000,     0,      0,      0,      2,    0,        2 } },
+    {    32768,  98304000,  true, {  187,     1,      2,      0,      4,    0,       -1 } },
+    {  1536000,  98304000, false, {   64,     0,      0,      0,      0,    4,        3 } },
+    {  1536000,  98304000,  true, {   64,     0,      0,      0,      0,    4,       -1 } },
+    {  3072000,  98304000, false, {   32,     0,      0,      0,      0,    4,        3 } },
+    {  3072000,  98304000,  true, {   32,     0,      0,      0,      0,    4,       -1 } },
+    { 11289600,  98304000, false, {    8,   104,    147,      0,      0,    5,        3 } },
+    { 11289600,  98304000,  true, {    8,   104,    147,      0,      0,    4,       -1 } },
+    { 12288000,  98304000, false, {    8,     0,      0,      0,      0,    5,        3 } },
+    { 12288000,  98304000,  true, {    8,     0,      0,      0,      0,    4,       -1 } },
+    { 24576000,  98304000, false, {    8,     0,      0,      1,      0,    5,        3 } },
+    { 24576000,  98304000,  true, {    8,     0,      0,      1,      0,    4,       -1 } },
+    { 49152000,  98304000, false, {    8,     0,      0,      2,      0,    5,        3 } },
+    { 49152000,  98304000,  true, {    8,     0,      0,      2,      0,    4,       -1 } },
+    {    32768,  90316800, false, {  918,     3,      4,      0,      2,    0,        2 } },
+    {    32768,  90316800,  true, {  172,    17,     64,      0,      4,    0,       -1 } },
+    {  1536000,  90316800, false, {   58,     4,      5,      0,      0,    4,        3 } },
+    {  1536000,  90316800,  true, {   58,     4,      5,      0,      0,    4,       -1 } },
+    {  3072000,  90316800, false, {   29,     2,      5,      0,      0,    4,        3 } },
+    {  3072000,  90316800,  true, {   29,     2,      5,      0,      0,    4,       -1 } },
+    { 11289600,  90316800, false, {    8,     0,      0,      0,      0,    5,        3 } },
+    { 11289600,  90316800,  true, {    8,     0,      0,      0,      0,    4,       -1 } },
+    { 12288000,  90316800, false, {    7,     7,     20,      0,      0,    5,        3 } },
+    { 12288000,  90316800,  true, {    7,     7,     20,      0,      0,    4,       -1 } },
+    { 24576000,  90316800, false, {    7,     7,     20,      1,      0,    5,        3 } },
+    { 24576000,  90316800,  true, {    7,     7,     20,      1,      0,    4,       -1 } },
+    { 49152000,  90316800, false, {    7,     7,     20,      2,      0,    5,        3 } },
+    { 49152000,  90316800,  true, {    7,     7,     20,      2,      0,    4,       -1 } },
+};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+static int32_t madera_find_sync_fratio(uint32_t fref, int32_t *fratio)
+{
+    uint32_t i;
+
+    for (i = 0; i < ARRAY_SIZE(madera_fll_sync_fratios); i++)
+    {
+        if (madera_fll_sync_fratios[i].min <= fref &&
+            fref <= madera_fll_sync_fratios[i].max)
+        {
+            if (fratio)
+            {
+                *fratio = madera_fll_sync_fratios[i].fratio;
+            }
+            return madera_fll_sync_fratios[i].ratio;
+        }
+    }
+
+    return -1;
+}
+
+static int32_t madera_find_main_fratio(const madera_fll_limits_t *limits,
+                                       uint32_t fref,
+                                       uint32_t fout,
+                                       int32_t *fratio)
+{
+    int32_t ratio = 1;
+
+    while ((fout / (ratio * fref)) > limits->max_n)
+    {
+        ratio++;
+    }
+    if (fratio)
+    {
+        *fratio = ratio - 1;
+    }
+    return ratio;
+}
+
+static int32_t madera_calc_fratio(const madera_fll_limits_t *limits,
+                                  madera_fll_cfg_t *cfg,
+                                  uint32_t fref,
+                                  uint32_t fout,
+                                  bool sync)
+{
+    int32_t init_ratio, div;
+
+    /* fref must be <= max_fref, find initial refdiv */
+    div = 1;
+    cfg->refdiv = 0;
+    while (fref > limits->max_fref)
+    {
+        div *= 2;
+        fref /= 2;
+        cfg->refdiv++;
+
+        if (div > (int32_t) limits->max_refdiv)
+        {
+            return -1;  // return a neg value to signal an error
+        }
+    }
+
+    /* Find an appropriate FLL_FRATIO */
+    if (sync)
+    {
+        init_ratio = madera_find_sync_fratio(fref, &cfg->fratio);
+    }
+    else
+    {
+        init_ratio = madera_find_main_fratio(limits, fref, fout, &cfg->fratio);
+    }
+
+    return init_ratio;
+}
+
+static uint32_t madera_find_fll_gain(madera_fll_cfg_t *cfg,
+                                     uint32_t fref,
+                                     const struct madera_fll_gains *gains,
+                                     int32_t n_gains)
+{
+    int32_t i;
+
+    for (i = 0; i < n_gains; i++)
+    {
+        if (gains[i].min <= fref && fref <= gains[i].max)
+        {
+            cfg->gain = gains[i].gain;
+            cfg->alt_gain = gains[i].alt_gain;
+            return MADERA_STATUS_OK;
+        }
+    }
+    return MADERA_STATUS_FAIL;
+}
+
+static uint32_t gcd(uint32_t n1, uint32_t n2)
+{
+    while (n1 != n2)
+    {
+        if (n1 > n2)
+        {
+            n1 -= n2;
+        }
+        else
+        {
+            n2 -= n1;
+        }
+    }
+    return n1;
+}
+
+/*
+ * The same limits madera_calc_fratio() applies, as the table is shared by devices with different FLL limits
+ */
+static bool madera_fll_cfg_in_limits(const madera_fll_limits_t *limits,
+                                     uint32_t fref,
+                                     bool sync,
+                                     const madera_fll_cfg_t *cfg)
+{
+    if ((1U << cfg->refdiv) > limits->max_refdiv)
+    {
+        return false;
+    }
+
+    if ((fref >> cfg->refdiv) > limits->max_fref)
+    {
+        return false;
+    }
+
+    if (!sync && ((uint32_t) cfg->n > limits->max_n))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+static bool madera_find_fll_table_cfg(const madera_fll_limits_t *limits,
+                                      uint32_t fref,
+                                      uint32_t fout,
+                                      bool sync,
+                                      madera_fll_cfg_t *cfg)
+{
+    uint32_t i;
+
+    for (i = 0; i < ARRAY_SIZE(madera_fll_table); i++)
+    {
+        if (madera_fll_table[i].fref == fref &&
+            madera_fll_table[i].fout == fout &&
+            madera_fll_table[i].sync == sync &&
+            madera_fll_cfg_in_limits(limits, fref, sync, &(madera_fll_table[i].cfg)))
+        {
+            *cfg = madera_fll_table[i].cfg;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Calculate the FLL configuration without the precomputed table - the table must match this bit for bit
+ */
+static uint32_t madera_calc_fll_cfg(const madera_fll_limits_t *limits,
+                                    uint32_t fref,
+                                    uint32_t fout,
+                                    bool sync,
+                                    madera_fll_cfg_t *cfg)
+{
+    uint32_t gcd_fll;
+    const struct madera_fll_gains *gains;
+    int32_t n_gains;
+    int32_t ratio;
+
+    /* Find an appropriate FLL_FRATIO and refdiv */
+    ratio = madera_calc_fratio(limits, cfg, fref, fout, sync);
+    if (ratio < 0)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    /* Apply the division for our remaining calculations */
+    fref = fref / (1 << cfg->refdiv);
+
+    cfg->n = fout / (ratio * fref);
+
+    if (fout % (ratio * fref))
+    {
+        gcd_fll = gcd(fout, ratio * fref);
+
+        cfg->theta = (fout - (cfg->n * ratio * fref))/gcd_fll;
+        cfg->lambda = (ratio * fref) / gcd_fll;
+    }
+    else
+    {
+        cfg->theta = 0;
+        cfg->lambda = 0;
+    }
+
+    /*
+     * Round down to 16bit range with cost of accuracy lost.
+     * Denominator must be bigger than numerator so we only
+     * take care of it.
+     */
+    while (cfg->lambda >= (1 << 16)) {
+        cfg->theta >>= 1;
+        cfg->lambda >>= 1;
+    }
+
+    if (sync)
+    {
+        gains = madera_fll_sync_gains;
+        n_gains = ARRAY_SIZE(madera_fll_sync_gains);
+    }
+    else
+    {
+        gains = madera_fll_main_gains;
+        n_gains = ARRAY_SIZE(madera_fll_main_gains);
+    }
+
+    return madera_find_fll_gain(cfg, fref, gains, n_gains);
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Calculate the FLL configuration for a reference and output frequency
+ *
+ */
+uint32_t madera_calc_fll(const madera_fll_limits_t *limits,
+                         uint32_t fref,
+                         uint32_t fout,
+                         bool sync,
+                         madera_fll_cfg_t *cfg)
+{
+    /* Common clock plans are precomputed, so no FLL math is needed unless the entry is outside this device's limits */
+    if (madera_find_fll_table_cfg(limits, fref, fout, sync, cfg))
+    {
+        return MADERA_STATUS_OK;
+    }
+
+    return madera_calc_fll_cfg(limits, fref, fout, sync, cfg);
+}
+
+/**
+ * Find if an algorithm is in the algorithm list of a firmware image
+ *
+ */
+bool madera_find_algid(fw_img_info_t *fw_info, uint32_t algid_id)
+{
+    if (fw_info)
+    {
+        for (uint32_t i = 0; i < fw_info->header.alg_id_list_size; i++)
+        {
+            if (fw_info->alg_id_list[i] == algid_id)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Start an ADSP2 core
+ *
+ */
+uint32_t madera_dsp_core_start(regmap_cp_config_t *cp, uint32_t dsp_base)
+{
+    uint32_t ret;
+
+    ret = regmap_update_reg(cp,
+                            dsp_base + MADERA_DSP_OFF_CONFIG_1,
+                            MADERA_DSP_CORE_ENA | MADERA_DSP_START,
+                            MADERA_DSP_CORE_ENA | MADERA_DSP_START);
+    if (ret)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    return MADERA_STATUS_OK;
+}
+
+/**
+ * Stop an ADSP2 core and disable its DMA channels
+ *
+ */
+uint32_t madera_dsp_core_stop(regmap_cp_config_t *cp, uint32_t dsp_base)
+{
+    uint32_t ret;
+
+    ret = regmap_update_reg(cp, dsp_base + MADERA_DSP_OFF_CONFIG_1, MADERA_DSP_CORE_ENA | MADERA_DSP_START, 0);
+    if (ret)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    ret = regmap_write(cp, dsp_base + MADERA_DSP_OFF_DMA_CONFIG_3, 0);
+    if (ret)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    ret = regmap_write(cp, dsp_base + MADERA_DSP_OFF_DMA_CONFIG_1, 0);
+    if (ret)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    ret = regmap_write(cp, dsp_base + MADERA_DSP_OFF_DMA_CONFIG_2, 0);
+    if (ret)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    return MADERA_STATUS_OK;
+}
+
+/**
+ * Wait for ADSP2 memory to be ready after setting MEM_ENA
+ *
+ */
+uint32_t madera_dsp_wait_ram_ready(regmap_cp_config_t *cp, uint32_t dsp_base)
+{
+    uint32_t ret, val;
+
+    for (uint32_t i = 0; i < MADERA_POLL_MEM_ENA_MAX; i++)
+    {
+        ret = regmap_read(cp, dsp_base + MADERA_DSP_OFF_STATUS_1, &val);
+        if (ret)
+        {
+            return MADERA_STATUS_FAIL;
+        }
+
+        if (val & MADERA_DSP_RAM_RDY)
+        {
+            return MADERA_STATUS_OK;
+        }
+
+        bsp_driver_if_g->set_timer(MADERA_POLL_MEM_ENA_MS, NULL, NULL);
+    }
+
+    return MADERA_STATUS_FAIL;
+}
+
+/**
+ * Pack bytes into padded 24-bit ADSP2 words
+ *
+ */
+void madera_dsp_pack_words(const uint8_t *array, uint8_t *target, uint32_t *length)
+{
+    uint32_t words = *length / MADERA_DSP_BYTES_PER_WORD;
+    uint32_t rem = *length % MADERA_DSP_BYTES_PER_WORD;
+
+    // Each 3 input bytes become one 4 byte DSP word, so no per-byte index arithmetic is needed
+    for (uint32_t i = 0; i < words; i++)
+    {
+        target[0] = 0x00;
+        target[1] = array[0];
+        target[2] = array[1];
+        target[3] = array[2];
+        target += 4;
+        array += 3;
+    }
+
+    // Pad a trailing partial word with 0s
+    if (rem > 0)
+    {
+        target[0] = 0x00;
+        target[1] = array[0];
+        target[2] = (rem > 1) ? array[1] : 0x00;
+        target[3] = 0x00;
+        words++;
+    }
+
+    *length = words * 4;
+
+    return;
+}
+
+/**
+ * Unpack padded 24-bit ADSP2 words into bytes
+ *
+ */
+void madera_dsp_unpack_words(const uint8_t *array, uint8_t *target, uint32_t *length)
+{
+    uint32_t words = *length / 4;
+    uint32_t rem = *length % 4;
+
+    // Each 4 byte DSP word becomes 3 output bytes, skipping the padding MSByte
+    for (uint32_t i = 0; i < words; i++)
+    {
+        target[0] = array[1];
+        target[1] = array[2];
+        target[2] = array[3];
+        target += 3;
+        array += 4;
+    }
+
+    // A trailing partial word still starts with the padding MSByte, so keep the data bytes after it
+    for (uint32_t i = 1; i < rem; i++)
+    {
+        target[i - 1] = array[i];
+    }
+
+    *length = (words * MADERA_DSP_BYTES_PER_WORD) + ((rem > 0) ? (rem - 1) : 0);
+
+    return;
+}
+
+/**
+ * Read consecutive elements of a DSP ring buffer struct in one transaction
+ *
+ */
+uint32_t madera_dsp_get_elements(regmap_cp_config_t *cp,
+                                 uint32_t rb_struct_base_addr,
+                                 uint32_t offset,
+                                 uint32_t *values,
+                                 uint32_t count)
+{
+    uint32_t addr = (rb_struct_base_addr + offset * MADERA_DSP_OFFSET_MUL_VALUE);
+    uint8_t bytes[MADERA_DSP_MAX_ELEMENTS * 4];
+    uint32_t ret;
+
+    if (count > MADERA_DSP_MAX_ELEMENTS)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    ret = regmap_read_block(cp, addr, bytes, (count * 4));
+    if (ret)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // 24bit values on ADSP2, so ignore the MSByte
+        values[i] = ((uint32_t) bytes[(i * 4) + 1] << 16) |
+                    ((uint32_t) bytes[(i * 4) + 2] << 8) |
+                    bytes[(i * 4) + 3];
+    }
+
+    return MADERA_STATUS_OK;
+}
+
+/**
+ * Write consecutive elements of a DSP ring buffer struct in one transaction
+ *
+ */
+uint32_t madera_dsp_set_elements(regmap_cp_config_t *cp,
+                                 uint32_t rb_struct_base_addr,
+                                 uint32_t offset,
+                                 uint32_t *values,
+                                 uint32_t count)
+{
+    uint32_t addr = (rb_struct_base_addr + offset * MADERA_DSP_OFFSET_MUL_VALUE);
+    uint8_t bytes[MADERA_DSP_MAX_ELEMENTS * 4];
+    uint32_t ret;
+
+    if (count > MADERA_DSP_MAX_ELEMENTS)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // 24bit values on ADSP2
+        bytes[(i * 4)] = 0;
+        bytes[(i * 4) + 1] = GET_BYTE_FROM_WORD(values[i], 2);
+        bytes[(i * 4) + 2] = GET_BYTE_FROM_WORD(values[i], 1);
+        bytes[(i * 4) + 3] = GET_BYTE_FROM_WORD(values[i], 0);
+    }
+
+    ret = regmap_write_block(cp, addr, bytes, (count * 4));
+    if (ret)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    return MADERA_STATUS_OK;
+}
+
+/**
+ * Clear DSP ring buffer telemetry
+ *
+ */
+void madera_dsp_telemetry_reset(madera_dsp_telemetry_t *telemetry)
+{
+    memset(telemetry, 0, sizeof(madera_dsp_telemetry_t));
+
+    return;
+}
+
+/**
+ * Sample DSP ring buffer telemetry
+ *
+ */
+uint32_t madera_dsp_telemetry_sample(regmap_cp_config_t *cp,
+                                     uint32_t rb_struct_base_addr,
+                                     uint32_t buffer_size,
+                                     madera_dsp_telemetry_t *telemetry)
+{
+    uint32_t size_words = buffer_size / MADERA_DSP_BYTES_PER_WORD;
+    uint32_t values[4];
+    uint32_t fill;
+    uint32_t error;
+    bool is_empty;
+    bool is_full;
+    uint32_t ret;
+
+    if (size_words == 0)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    ret = madera_dsp_get_elements(cp, rb_struct_base_addr, MADERA_DSP_RB_NEXT_WRITE_INDEX, values, 4);
+    if (ret)
+    {
+        return MADERA_STATUS_FAIL;
+    }
+
+    fill = (values[MADERA_DSP_RB_NEXT_WRITE_INDEX - MADERA_DSP_RB_NEXT_WRITE_INDEX] + size_words -
+            values[MADERA_DSP_RB_NEXT_READ_INDEX - MADERA_DSP_RB_NEXT_WRITE_INDEX]) % size_words;
+    fill *= MADERA_DSP_BYTES_PER_WORD;
+
+    telemetry->is_eof = (values[MADERA_DSP_RB_END_OF_STREAM - MADERA_DSP_RB_NEXT_WRITE_INDEX] != 0);
+
+    if ((telemetry->sample_count == 0) || (fill < telemetry->fill_min))
+    {
+        telemetry->fill_min = fill;
+    }
+    if (fill > telemetry->fill_max)
+    {
+        telemetry->fill_max = fill;
+    }
+    telemetry->fill_last = fill;
+    telemetry->fill_sum += fill;
+    telemetry->sample_count++;
+
+    // Count each underrun or overrun once, however many samples it lasts for
+    is_empty = ((fill == 0) && !telemetry->is_eof);
+    if (is_empty && !telemetry->is_empty)
+    {
+        telemetry->empty_count++;
+    }
+    telemetry->is_empty = is_empty;
+
+    // One word is always left between the write and read indexes
+    is_full = (fill >= ((size_words - 1) * MADERA_DSP_BYTES_PER_WORD));
+    if (is_full && !telemetry->is_full)
+    {
+        telemetry->full_count++;
+    }
+    telemetry->is_full = is_full;
+
+    // The DSP holds the error flag until it is cleared, so count each new value rather than every sample that sees it
+    error = values[MADERA_DSP_RB_ERROR - MADERA_DSP_RB_NEXT_WRITE_INDEX];
+    if ((error != 0) && (error != telemetry->error_sampled))
+    {
+        telemetry->error_count++;
+        telemetry->last_error = error;
+    }
+    telemetry->error_sampled = error;
+
+    return MADERA_STATUS_OK;
+}
+
+/**
+ * Get the average sampled fill level of a DSP ring buffer
+ *
+ */
+uint32_t madera_dsp_telemetry_get_fill_avg(const madera_dsp_telemetry_t *telemetry)
+{
+    if (telemetry->sample_count == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t) (telemetry->fill_sum / telemetry->sample_count);
+}
@@ -0,0 +1,330 @@
+/**
+ * @file madera.h
+ *
+ * @brief Functions and prototypes exported by the Madera codec core module
+ *
+ * The Madera codec core holds the FLL, ADSP2 DSP core and ring buffer support common to the Madera-class codecs
+ * (CS47L15, CS47L35).  Each device driver passes in its own control port and per-device descriptors.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef MADERA_H
+#define MADERA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmap.h"
+#include "fw_img.h"
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup MADERA_STATUS_
+ * @brief Return values for all public API calls
+ *
+ * @{
+ */
+#define MADERA_STATUS_OK                    (0)
+#define MADERA_STATUS_FAIL                  (1)
+/** @} */
+
+/**
+ * @defgroup MADERA_DSP_
+ * @brief ADSP2 memory layout
+ *
+ * @{
+ */
+#define MADERA_DSP_BYTES_PER_WORD           (3)     ///< Bytes of data in each 24-bit ADSP2 word
+#define MADERA_DSP_OFFSET_MUL_VALUE         (2)     ///< Register address increment per ADSP2 word
+#define MADERA_DSP_MAX_ELEMENTS             (4)     ///< Maximum ring buffer struct elements per block transfer
+/** @} */
+
+#define MADERA_FLL_LOCK_TIMEOUT_MS          (300)   ///< Maximum time in ms to wait for FLL lock
+#define MADERA_FLL_LOCK_POLL_MS             (2)     ///< Lock status polling period in ms if no IRQ is seen
+
+/**
+ * @defgroup MADERA_DSP_RB_
+ * @brief Word offsets of the ring buffer struct elements sampled by madera_dsp_telemetry_sample
+ *
+ * @{
+ */
+#define MADERA_DSP_RB_NEXT_WRITE_INDEX      (3)
+#define MADERA_DSP_RB_NEXT_READ_INDEX       (4)
+#define MADERA_DSP_RB_ERROR                 (5)
+#define MADERA_DSP_RB_END_OF_STREAM         (6)
+/** @} */
+
+/***********************************************************************************************************************
+ * MACROS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Per-device FLL limits
+ */
+typedef struct
+{
+    uint32_t max_fref;              ///< Maximum FLL reference frequency after REFCLK_DIV
+    uint32_t max_refdiv;            ///< Maximum REFCLK_DIV divisor
+    uint32_t max_n;                 ///< Maximum integer part of the FLL ratio
+} madera_fll_limits_t;
+
+/**
+ * FLL configuration, as written to the FLL or FLL synchroniser CONTROL registers
+ */
+typedef struct
+{
+    int32_t n;                      ///< Integer part of the FLL ratio
+    uint32_t theta;                 ///< Numerator of the fractional part of the FLL ratio
+    uint32_t lambda;                ///< Denominator of the fractional part of the FLL ratio
+    int32_t refdiv;                 ///< REFCLK_DIV, as a power of 2
+    int32_t fratio;                 ///< FRATIO register value
+    int32_t gain;                   ///< Main loop gain
+    int32_t alt_gain;               ///< Alternate integer mode gain - -1 if not applicable
+} madera_fll_cfg_t;
+
+/**
+ * DSP ring buffer telemetry
+ *
+ * Fill levels are the bytes queued in the ring buffer at each sample.  For a ring buffer the MCU fills (a decoder
+ * input), empty samples before end of stream are underruns.  For one the MCU drains (an encoder output), full samples
+ * are overruns.  Empty, full and error samples are counted once per transition, so a ring buffer that stays empty
+ * or full across several samples counts as one underrun or overrun.
+ *
+ * @see madera_dsp_telemetry_sample
+ */
+typedef struct
+{
+    uint32_t sample_count;          ///< Samples taken since madera_dsp_telemetry_reset
+    uint32_t fill_last;             ///< Fill level at the most recent sample, in bytes
+    uint32_t fill_min;              ///< Lowest fill level sampled, in bytes
+    uint32_t fill_max;              ///< Highest fill level sampled, in bytes
+    uint64_t fill_sum;              ///< Sum of sampled fill levels, for the average
+    uint32_t empty_count;           ///< Times the ring buffer was sampled newly empty before end of stream
+    uint32_t full_count;            ///< Times the ring buffer was sampled newly out of free space
+    uint32_t error_count;           ///< Times the DSP error flag was sampled set to a new non-zero value
+    uint32_t error_sampled;         ///< DSP error flag at the most recent sample
+    uint32_t last_error;            ///< Most recent non-zero DSP error flag
+    bool is_empty;                  ///< (True) the most recent sample found the ring buffer empty before end of stream
+    bool is_full;                   ///< (True) the most recent sample found no free space in the ring buffer
+    bool is_eof;                    ///< (True) end_of_stream was set at the most recent sample
+} madera_dsp_telemetry_t;
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Calculate the FLL configuration for a reference and output frequency
+ *
+ * Common clock plans are looked up in a precomputed table, so no calculation is needed for them.  A table entry that
+ * is outside 'limits' is not used, and the configuration is calculated instead.
+ *
+ * @param [in] limits           Pointer to the device FLL limits
+ * @param [in] fref             Reference (or sync) clock frequency in Hz
+ * @param [in] fout             FLL output frequency in Hz
+ * @param [in] sync             (True) configure the FLL synchroniser, (False) configure the main FLL loop
+ * @param [out] cfg             Pointer to FLL configuration
+ *
+ * @return
+ * - MADERA_STATUS_FAIL         if 'fref' cannot be divided into range, or no gain covers 'fref'
+ * - MADERA_STATUS_OK           otherwise
+ *
+ */
+uint32_t madera_calc_fll(const madera_fll_limits_t *limits,
+                         uint32_t fref,
+                         uint32_t fout,
+                         bool sync,
+                         madera_fll_cfg_t *cfg);
+
+/**
+ * Find if an algorithm is in the algorithm list of a firmware image
+ *
+ * @param [in] fw_info          Pointer to firmware image info - may be NULL
+ * @param [in] algid_id         Algorithm ID to find
+ *
+ * @return true if 'algid_id' is in the list, false otherwise
+ *
+ */
+bool madera_find_algid(fw_img_info_t *fw_info, uint32_t algid_id);
+
+/**
+ * Start an ADSP2 core
+ *
+ * @param [in] cp               Pointer to the control port configuration
+ * @param [in] dsp_base         Base address of the DSP core control registers
+ *
+ * @return
+ * - MADERA_STATUS_FAIL         if control port activity fails
+ * - MADERA_STATUS_OK           otherwise
+ *
+ */
+uint32_t madera_dsp_core_start(regmap_cp_config_t *cp, uint32_t dsp_base);
+
+/**
+ * Stop an ADSP2 core and disable its DMA channels
+ *
+ * @param [in] cp               Pointer to the control port configuration
+ * @param [in] dsp_base         Base address of the DSP core control registers
+ *
+ * @return
+ * - MADERA_STATUS_FAIL         if control port activity fails
+ * - MADERA_STATUS_OK           otherwise
+ *
+ */
+uint32_t madera_dsp_core_stop(regmap_cp_config_t *cp, uint32_t dsp_base);
+
+/**
+ * Wait for ADSP2 memory to be ready after setting MEM_ENA
+ *
+ * @param [in] cp               Pointer to the control port configuration
+ * @param [in] dsp_base         Base address of the DSP core control registers
+ *
+ * @return
+ * - MADERA_STATUS_FAIL         if control port activity fails, or RAM_RDY is not set before timeout
+ * - MADERA_STATUS_OK           otherwise
+ *
+ */
+uint32_t madera_dsp_wait_ram_ready(regmap_cp_config_t *cp, uint32_t dsp_base);
+
+/**
+ * Pack bytes into padded 24-bit ADSP2 words
+ *
+ * Every 3 bytes of 'array' become one 4 byte word in 'target', MSByte 0.  A trailing partial word is padded with 0s.
+ *
+ * @param [in] array            Bytes to pack
+ * @param [out] target          Packed words, in control port byte order
+ * @param [in,out] length       Length of 'array' in bytes on entry, length of 'target' in bytes on exit
+ *
+ */
+void madera_dsp_pack_words(const uint8_t *array, uint8_t *target, uint32_t *length);
+
+/**
+ * Unpack padded 24-bit ADSP2 words into bytes
+ *
+ * Every 4 byte word of 'array' becomes 3 bytes in 'target'.  For a trailing partial word, the bytes after its padding
+ * MSByte are kept, so 'length' need not be a multiple of 4.
+ *
+ * @param [in] array            Words to unpack, in control port byte order
+ * @param [out] target          Unpacked bytes
+ * @param [in,out] length       Length of 'array' in bytes on entry, length of 'target' in bytes on exit
+ *
+ */
+void madera_dsp_unpack_words(const uint8_t *array, uint8_t *target, uint32_t *length);
+
+/**
+ * Read consecutive elements of a DSP ring buffer struct in one transaction
+ *
+ * @param [in] cp               Pointer to the control port configuration
+ * @param [in] rb_struct_base_addr  Address of the ring buffer struct
+ * @param [in] offset           Word offset of the first element
+ * @param [out] values          24-bit element values
+ * @param [in] count            Number of elements - must not exceed MADERA_DSP_MAX_ELEMENTS
+ *
+ * @return
+ * - MADERA_STATUS_FAIL         if 'count' is too large, or if control port activity fails
+ * - MADERA_STATUS_OK           otherwise
+ *
+ */
+uint32_t madera_dsp_get_elements(regmap_cp_config_t *cp,
+                                 uint32_t rb_struct_base_addr,
+                                 uint32_t offset,
+                                 uint32_t *values,
+                                 uint32_t count);
+
+/**
+ * Write consecutive elements of a DSP ring buffer struct in one transaction
+ *
+ * @param [in] cp               Pointer to the control port configuration
+ * @param [in] rb_struct_base_addr  Address of the ring buffer struct
+ * @param [in] offset           Word offset of the first element
+ * @param [in] values           Element values - only the lower 24 bits are written
+ * @param [in] count            Number of elements - must not exceed MADERA_DSP_MAX_ELEMENTS
+ *
+ * @return
+ * - MADERA_STATUS_FAIL         if 'count' is too large, or if control port activity fails
+ * - MADERA_STATUS_OK           otherwise
+ *
+ */
+uint32_t madera_dsp_set_elements(regmap_cp_config_t *cp,
+                                 uint32_t rb_struct_base_addr,
+                                 uint32_t offset,
+                                 uint32_t *values,
+                                 uint32_t count);
+
+/**
+ * Clear DSP ring buffer telemetry
+ *
+ * @param [in] telemetry        Pointer to telemetry
+ *
+ */
+void madera_dsp_telemetry_reset(madera_dsp_telemetry_t *telemetry);
+
+/**
+ * Sample DSP ring buffer telemetry
+ *
+ * The write and read indexes, error flag and end_of_stream flag are read in one transaction, so call once per
+ * telemetry period.
+ *
+ * @param [in] cp               Pointer to the control port configuration
+ * @param [in] rb_struct_base_addr  Address of the ring buffer struct
+ * @param [in] buffer_size      Size of the ring buffer in bytes
+ * @param [in] telemetry        Pointer to telemetry to update
+ *
+ * @return
+ * - MADERA_STATUS_FAIL         if 'buffer_size' is less than one DSP word, or if control port activity fails
+ * - MADERA_STATUS_OK           otherwise
+ *
+ */
+uint32_t madera_dsp_telemetry_sample(regmap_cp_config_t *cp,
+                                     uint32_t rb_struct_base_addr,
+                                     uint32_t buffer_size,
+                                     madera_dsp_telemetry_t *telemetry);
+
+/**
+ * Get the average sampled fill level of a DSP ring buffer
+ *
+ * @param [in] telemetry        Pointer to telemetry
+ *
+ * @return Average fill level in bytes, or 0 if no samples have been taken
+ *
+ */
+uint32_t madera_dsp_telemetry_get_fill_avg(const madera_dsp_telemetry_t *telemetry);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MADERA_H
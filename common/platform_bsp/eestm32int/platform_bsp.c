@@ -29,6 +29,7 @@
 #ifdef USE_CMSIS_OS
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "task.h"
 #endif
 #include <stdio.h>
 #include <errno.h>
@@ -2291,6 +2292,11 @@ uint32_t bsp_initialize(bsp_app_callback_t cb, void *cb_arg)
     /* Configure the system clock */
     SystemClock_Config();
 
+    // Start the cycle counter behind bsp_get_time_us and bsp_delay_us
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     // Configure LD2 LED
     bsp_set_gpio(BSP_GPIO_ID_LD2, GPIO_PIN_SET);
     bsp_ld2_led.is_on = true;
@@ -2599,6 +2605,60 @@ uint32_t bsp_set_timer(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg)
     return BSP_STATUS_OK;
 }
 
+uint32_t bsp_get_time_ms(void)
+{
+#ifdef USE_CMSIS_OS
+    // SysTick drives the RTOS tick instead of the HAL tick
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+#else
+    return HAL_GetTick();
+#endif
+}
+
+uint32_t bsp_get_time_us(void)
+{
+    static uint32_t last_cycles = 0;
+    static uint32_t extra_cycles = 0;
+    static uint32_t time_us = 0;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000;
+    uint32_t primask = __get_PRIMASK();
+    uint32_t cycles;
+    uint32_t ret;
+
+    // The cycle counter wraps every few tens of seconds, so carry the time forward from the last call
+    __disable_irq();
+    cycles = DWT->CYCCNT;
+    extra_cycles += cycles - last_cycles;
+    last_cycles = cycles;
+    time_us += extra_cycles / cycles_per_us;
+    extra_cycles %= cycles_per_us;
+    ret = time_us;
+    if (!primask)
+    {
+        __enable_irq();
+    }
+
+    return ret;
+}
+
+uint32_t bsp_delay_us(uint32_t duration_us)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000;
+
+    // The wait must end before the cycle counter wraps
+    if (duration_us > (UINT32_MAX / cycles_per_us))
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    while ((DWT->CYCCNT - start) < (duration_us * cycles_per_us))
+    {
+    }
+
+    return BSP_STATUS_OK;
+}
+
 uint32_t bsp_set_gpio(uint32_t gpio_id, uint8_t gpio_state)
 {
     uint8_t buffer[2] = {0, 0};
@@ -3574,6 +3634,9 @@ static bsp_driver_if_t bsp_driver_if_s =
     .set_supply = &bsp_set_supply,
     .register_gpio_cb = &bsp_register_gpio_cb,
     .set_timer = &bsp_set_timer,
+    .get_time_ms = &bsp_get_time_ms,
+    .get_time_us = &bsp_get_time_us,
+    .delay_us = &bsp_delay_us,
     .i2c_read_repeated_start = &bsp_i2c_read_repeated_start,
     .i2c_write = &bsp_i2c_write,
     .i2c_db_write = &bsp_i2c_db_write,
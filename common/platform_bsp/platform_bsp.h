@@ -146,6 +146,9 @@ uint32_t bsp_audio_pause(void);
 uint32_t bsp_audio_resume(void);
 uint32_t bsp_audio_stop(void);
 uint32_t bsp_set_timer(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg);
+uint32_t bsp_get_time_ms(void);
+uint32_t bsp_get_time_us(void);
+uint32_t bsp_delay_us(uint32_t duration_us);
 bool     bsp_was_pb_pressed(uint8_t pb_id);
 void     bsp_sleep(void);
 uint32_t bsp_register_pb_cb(uint32_t pb_id, bsp_app_callback_t cb, void *cb_arg);
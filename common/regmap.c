@@ -407,6 +407,64 @@ uint32_t regmap_write_acked_reg(regmap_cp_config_t *cp,
     return REGMAP_STATUS_FAIL;
 }
 
+/**
+ * Wait for bits in a status register to set, checking as soon as a matching event is handled
+ *
+ */
+uint32_t regmap_poll_reg_on_event(regmap_cp_config_t *cp,
+                                  uint32_t addr,
+                                  uint32_t mask,
+                                  uint32_t event_flag,
+                                  regmap_event_handler_t handle_events,
+                                  void *driver,
+                                  uint32_t poll_ms,
+                                  uint32_t timeout_ms,
+                                  uint32_t *time_ms)
+{
+    uint32_t ret, val, event_flags;
+    bool check_sts;
+
+    for (uint32_t ms = 0; ; ms++)
+    {
+        // Check on entry and periodically in case the IRQ is not wired up
+        check_sts = ((poll_ms == 0) || ((ms % poll_ms) == 0));
+
+        ret = handle_events(driver, &event_flags);
+        if (ret)
+        {
+            return REGMAP_STATUS_FAIL;
+        }
+
+        // Only the awaited event brings the check forward
+        if (event_flags & event_flag)
+        {
+            check_sts = true;
+        }
+
+        if (check_sts)
+        {
+            ret = regmap_read(cp, addr, &val);
+            if (ret)
+            {
+                return REGMAP_STATUS_FAIL;
+            }
+
+            if ((val & mask) == mask)
+            {
+                *time_ms = ms;
+                return REGMAP_STATUS_OK;
+            }
+        }
+
+        if (ms >= timeout_ms)
+        {
+            return REGMAP_STATUS_FAIL;
+        }
+
+        bsp_driver_if_g->set_timer(1, NULL, NULL);
+    }
+}
+
 /**
  * Reads contents from a consecutive number of memory addresses
  *
@@ -108,6 +108,14 @@ typedef struct
 typedef uint32_t (*regmap_vread_t)(void *self, uint32_t *val);
 typedef uint32_t (*regmap_vwrite_t)(void *self, uint32_t val);
 
+/**
+ * Driver callback that handles any IRQ pending while regmap_poll_reg_on_event() waits
+ *
+ * Returns the event flags raised by the IRQ it handled in 'event_flags', or 0 if no IRQ was pending.  The driver keeps
+ * all raised flags to notify as usual.
+ */
+typedef uint32_t (*regmap_event_handler_t)(void *driver, uint32_t *event_flags);
+
 typedef struct
 {
     const uint32_t address;
@@ -212,6 +220,38 @@ uint32_t regmap_write_acked_reg(regmap_cp_config_t *cp,
                                 uint8_t tries,
                                 uint32_t delay);
 
+/**
+ * Wait for bits in a status register to set, checking as soon as a matching event is handled
+ *
+ * Every 1ms 'handle_events' is called, so an IRQ that fires while waiting is handled straight away.  The status is
+ * read as soon as it reports 'event_flag' - the event may have latched before the wait began, so the status decides.
+ * Other events do not bring the read forward, and their flags stay with the driver for it to notify.  The status is
+ * also read every 'poll_ms' in case the IRQ is not wired up.
+ *
+ * @param [in] cp               Pointer to the BSP control port configuration
+ * @param [in] addr             Address of the status register
+ * @param [in] mask             Status bits to wait for - all must be set
+ * @param [in] event_flag       Driver event flag raised when the status bits set
+ * @param [in] handle_events    Driver callback to handle a pending IRQ
+ * @param [in] driver           Driver state passed to 'handle_events'
+ * @param [in] poll_ms          Period to read the status at if no matching event is seen, in ms
+ * @param [in] timeout_ms       Maximum time to wait, in ms
+ * @param [out] time_ms         Time taken for the bits to set, in ms - only valid if REGMAP_STATUS_OK is returned
+ *
+ * @return
+ * - REGMAP_STATUS_FAIL         if the call to BSP or 'handle_events' failed, or the bits did not set before timeout
+ * - REGMAP_STATUS_OK           otherwise
+ */
+uint32_t regmap_poll_reg_on_event(regmap_cp_config_t *cp,
+                                  uint32_t addr,
+                                  uint32_t mask,
+                                  uint32_t event_flag,
+                                  regmap_event_handler_t handle_events,
+                                  void *driver,
+                                  uint32_t poll_ms,
+                                  uint32_t timeout_ms,
+                                  uint32_t *time_ms);
+
 /**
  * Reads contents from a consecutive number of memory addresses
  *
@@ -166,6 +166,21 @@ typedef struct
  * LOCAL VARIABLES
  **********************************************************************************************************************/
 
+/**
+ * HALO mailbox configuration
+ *
+ * Mailbox commands are ACKed by the HALO FW writing to Virtual MBOX 2, which sets the IRQ1 MBOX flag.
+ */
+static const halo_mbox_config_t cs35l41_mbox_config =
+{
+    .ack_type = HALO_MBOX_ACK_TYPE_IRQ,
+    .ack_reg = IRQ1_IRQ1_EINT_2_REG,
+    .ack_mask = IRQ1_IRQ1_EINT_2_DSP_VIRTUAL2_MBOX_WR_EINT1_BITMASK,
+    .ack_val = IRQ1_IRQ1_EINT_2_DSP_VIRTUAL2_MBOX_WR_EINT1_BITMASK,
+    .poll_delay_max_ms = BSP_TIMER_DURATION_2MS,
+    .timeout_ms = (CS35L41_POLL_ACKED_MBOX_CMD_MAX * BSP_TIMER_DURATION_2MS)
+};
+
 /**
  * CS35L41 RevB2 Register Patch Errata
  *
@@ -713,7 +728,6 @@ static bool cs35l41_is_mbox_status_correct(uint32_t cmd, uint32_t status)
 static uint32_t cs35l41_send_acked_mbox_cmd(cs35l41_t *driver, uint32_t cmd)
 {
     uint32_t ret = CS35L41_STATUS_OK;
-    uint32_t i;
     uint32_t temp_reg_val;
     regmap_cp_config_t *cp = REGMAP_GET_CP(driver);
 
@@ -746,38 +760,13 @@ static uint32_t cs35l41_send_acked_mbox_cmd(cs35l41_t *driver, uint32_t cmd)
         return ret;
     }
 
-    // Send HALO DSP MBOX Command
-    ret = regmap_write(cp, DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_1_REG, cmd);
+    // Send HALO DSP MBOX Command, poll for and clear MBOX IRQ flag
+    ret = halo_mbox_send_acked(&(driver->mbox), DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_1_REG, cmd);
     if (ret)
-    {
-        return ret;
-    }
-
-    for (i = 0; i < CS35L41_POLL_ACKED_MBOX_CMD_MAX; i++)
-    {
-        // Read IRQ1 flag register to poll for MBOX IRQ
-        regmap_read(cp, IRQ1_IRQ1_EINT_2_REG, &temp_reg_val);
-
-        if (temp_reg_val & IRQ1_IRQ1_EINT_2_DSP_VIRTUAL2_MBOX_WR_EINT1_BITMASK)
-        {
-            break;
-        }
-
-        bsp_driver_if_g->set_timer(BSP_TIMER_DURATION_2MS, NULL, NULL);
-    }
-
-    if (i >= CS35L41_POLL_ACKED_MBOX_CMD_MAX)
     {
         return CS35L41_STATUS_FAIL;
     }
 
-    // Clear MBOX IRQ flag
-    ret = regmap_write(cp, IRQ1_IRQ1_EINT_2_REG, IRQ1_IRQ1_EINT_2_DSP_VIRTUAL2_MBOX_WR_EINT1_BITMASK);
-    if (ret)
-    {
-        return ret;
-    }
-
     // Read IRQ2 Mask register to re-mask HALO DSP Virtual MBOX 1 IRQ
     ret = regmap_read(cp, IRQ2_IRQ2_MASK_2_REG, &temp_reg_val);
     if (ret)
@@ -1790,6 +1779,12 @@ uint32_t cs35l41_configure(cs35l41_t *driver, cs35l41_config_t *config)
     {
         driver->config = *config;
 
+        ret = halo_mbox_initialize(&(driver->mbox), REGMAP_GET_CP(driver), &cs35l41_mbox_config);
+        if (ret)
+        {
+            return CS35L41_STATUS_FAIL;
+        }
+
         // Advance driver to CONFIGURED state
         driver->state = CS35L41_STATE_CONFIGURED;
 
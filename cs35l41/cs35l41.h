@@ -37,6 +37,7 @@ extern "C" {
 #include "cs35l41_spec.h"
 #include "cs35l41_syscfg_regs.h"
 #include "regmap.h"
+#include "halo_mbox.h"
 
 #include "sdk_version.h"
 
@@ -240,6 +241,7 @@ typedef struct
 
     uint32_t event_flags;               ///< Flags set by Event Handler that are passed to noticiation callback
     uint8_t otp_contents[CS35L41_OTP_SIZE_BYTES];   ///< Cache storage for OTP contents
+    halo_mbox_t mbox;                   ///< HALO mailbox state for ACKed mailbox commands
 } cs35l41_t;
 
 /***********************************************************************************************************************
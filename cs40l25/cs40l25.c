@@ -207,6 +207,20 @@
  * LOCAL VARIABLES
  **********************************************************************************************************************/
 
+/**
+ * HALO mailbox configuration for ACKed firmware controls
+ *
+ * Controls are ACKed by the HALO FW clearing them once processed.
+ */
+static const halo_mbox_config_t cs40l25_mbox_config =
+{
+    .ack_type = HALO_MBOX_ACK_TYPE_CLEAR,
+    .ack_mask = 0xFFFFFFFF,
+    .ack_val = 0,
+    .poll_delay_max_ms = CS40L25_POLL_ACK_CTRL_MS,
+    .timeout_ms = (CS40L25_POLL_ACK_CTRL_MAX * CS40L25_POLL_ACK_CTRL_MS)
+};
+
 /**
  * CS40L25 RevB0 Register Patch Errata
  *
@@ -687,16 +701,15 @@ static uint32_t cs40l25_wseq_add_block(cs40l25_t *driver, uint32_t *entries, uin
  */
 static uint32_t cs40l25_write_acked_fw_control(cs40l25_t *driver, uint32_t id, uint32_t val)
 {
-    uint32_t ret;
-    regmap_cp_config_t *cp = REGMAP_GET_CP(driver);
+    uint32_t ret, addr;
 
-    ret = regmap_write_acked_fw_control(cp,
-                                        driver->fw_info,
-                                        id,
-                                        val,
-                                        0,
-                                        CS40L25_POLL_ACK_CTRL_MAX,
-                                        CS40L25_POLL_ACK_CTRL_MS);
+    addr = fw_img_find_symbol(driver->fw_info, id);
+    if (addr == 0)
+    {
+        return CS40L25_STATUS_FAIL;
+    }
+
+    ret = halo_mbox_send_acked(&(driver->mbox), addr, val);
     if (ret)
     {
         ret = CS40L25_STATUS_FAIL;
@@ -816,12 +829,9 @@ static uint32_t cs40l25_power_down(cs40l25_t *driver)
     }
     else
     {
-        ret = regmap_write_acked_reg(cp,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
-                                     CS40L25_POWERCONTROL_FRC_STDBY,
-                                     CS40L25_POWERCONTROL_NONE,
-                                     CS40L25_POLL_ACK_CTRL_MAX,
-                                     CS40L25_POLL_ACK_CTRL_MS);
+        ret = halo_mbox_send_acked(&(driver->mbox),
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
+                                   CS40L25_POWERCONTROL_FRC_STDBY);
     }
 
     if (ret)
@@ -1226,6 +1236,12 @@ uint32_t cs40l25_configure(cs40l25_t *driver, cs40l25_config_t *config)
     {
         driver->config = *config;
 
+        ret = halo_mbox_initialize(&(driver->mbox), REGMAP_GET_CP(driver), &cs40l25_mbox_config);
+        if (ret)
+        {
+            return CS40L25_STATUS_FAIL;
+        }
+
         ret = bsp_driver_if_g->register_gpio_cb(driver->config.bsp_config.bsp_int_gpio_id,
                                                 &cs40l25_irq_callback,
                                                 driver);
@@ -1703,14 +1719,11 @@ uint32_t cs40l25_start_i2s(cs40l25_t *driver)
     cs40l25_write_wseq_reg(driver, DATAIF_ASP_ENABLES1_REG, asp_reg_val.word);
 
     // Force DSP into standby
-    ret = regmap_write_acked_reg(cp,
-                                 DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
-                                 DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_FORCE_STANDBY,
-                                 DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_NONE,
-                                 CS40L25_POLL_ACK_CTRL_MAX,
-                                 CS40L25_POLL_ACK_CTRL_MS);
-
-    if (ret != REGMAP_STATUS_OK)
+    ret = halo_mbox_send_acked(&(driver->mbox),
+                               DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
+                               DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_FORCE_STANDBY);
+
+    if (ret != HALO_MBOX_STATUS_OK)
     {
         return CS40L25_STATUS_FAIL;
     }
@@ -1739,25 +1752,19 @@ uint32_t cs40l25_start_i2s(cs40l25_t *driver)
     if (i2s_passthrough)
     {
         //Wake the firmware
-        ret = regmap_write_acked_reg(cp,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_WAKEUP,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_NONE,
-                                     CS40L25_POLL_ACK_CTRL_MAX,
-                                     CS40L25_POLL_ACK_CTRL_MS);
-
-        if (ret != REGMAP_STATUS_OK)
+        ret = halo_mbox_send_acked(&(driver->mbox),
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_WAKEUP);
+
+        if (ret != HALO_MBOX_STATUS_OK)
         {
             return CS40L25_STATUS_FAIL;
         }
 
         //Enable I2S
-        ret = regmap_write_acked_reg(cp,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_REG,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_START_I2S,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_NONE,
-                                     CS40L25_POLL_ACK_CTRL_MAX,
-                                     CS40L25_POLL_ACK_CTRL_MS);
+        ret = halo_mbox_send_acked(&(driver->mbox),
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_REG,
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_START_I2S);
     }
     else
     {
@@ -1796,14 +1803,11 @@ uint32_t cs40l25_stop_i2s(cs40l25_t *driver)
 
     if (i2s_passthrough)
     {
-        ret = regmap_write_acked_reg(cp,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_FORCE_STANDBY,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_NONE,
-                                     CS40L25_POLL_ACK_CTRL_MAX,
-                                     CS40L25_POLL_ACK_CTRL_MS);
-
-        if (ret != REGMAP_STATUS_OK)
+        ret = halo_mbox_send_acked(&(driver->mbox),
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_FORCE_STANDBY);
+
+        if (ret != HALO_MBOX_STATUS_OK)
         {
             return CS40L25_STATUS_FAIL;
         }
@@ -1838,27 +1842,21 @@ uint32_t cs40l25_stop_i2s(cs40l25_t *driver)
 
     //Wake the firmware
 
-    ret = regmap_write_acked_reg(cp,
-                                 DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
-                                 DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_WAKEUP,
-                                 DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_NONE,
-                                 CS40L25_POLL_ACK_CTRL_MAX,
-                                 CS40L25_POLL_ACK_CTRL_MS);
+    ret = halo_mbox_send_acked(&(driver->mbox),
+                               DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
+                               DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_WAKEUP);
 
-    if (ret != REGMAP_STATUS_OK)
+    if (ret != HALO_MBOX_STATUS_OK)
     {
         return CS40L25_STATUS_FAIL;
     }
 
     if (i2s_passthrough)
     {
-        ret = regmap_write_acked_reg(cp,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_REG,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_STOP_I2S,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_NONE,
-                                     CS40L25_POLL_ACK_CTRL_MAX,
-                                     CS40L25_POLL_ACK_CTRL_MS);
-        if (ret != REGMAP_STATUS_OK)
+        ret = halo_mbox_send_acked(&(driver->mbox),
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_REG,
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_STOP_I2S);
+        if (ret != HALO_MBOX_STATUS_OK)
         {
             return CS40L25_STATUS_FAIL;
         }
@@ -1905,12 +1903,9 @@ uint32_t cs40l25_enable_vamp_discharge(cs40l25_t *driver, bool is_enable)
             return CS40L25_STATUS_FAIL;
         }
 
-        ret = regmap_write_acked_reg(cp,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_REG,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_DISCHARGE_VAMP,
-                                     DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_NONE,
-                                     CS40L25_POLL_ACK_CTRL_MAX,
-                                     CS40L25_POLL_ACK_CTRL_MS);
+        ret = halo_mbox_send_acked(&(driver->mbox),
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_REG,
+                                   DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_5_DISCHARGE_VAMP);
     }
     else
     {
@@ -38,6 +38,7 @@ extern "C" {
 #include "cs40l25_spec.h"
 #include "cs40l25_syscfg_regs.h"
 #include "regmap.h"
+#include "halo_mbox.h"
 
 #include "sdk_version.h"
 
@@ -365,6 +366,7 @@ typedef struct
     cs40l25_config_t config;                    ///< Driver configuration fields - see cs40l25_config_t
     fw_img_info_t *fw_info;                     ///< Current HALO FW/Coefficient boot configuration
     uint32_t event_flags;                       ///< Most recent event_flags reported to BSP Notification callback
+    halo_mbox_t mbox;                           ///< HALO mailbox state for ACKed firmware controls
 } cs40l25_t;
 
 /***********************************************************************************************************************
@@ -132,14 +132,8 @@ uint32_t cs40l25_update_haptic_config(cs40l25_t *driver, cs40l25_haptic_config_t
 uint32_t cs40l25_trigger_bhm(cs40l25_t *driver)
 {
     uint32_t ret;
-    regmap_cp_config_t *cp = REGMAP_GET_CP(driver);
 
-    ret = regmap_write_acked_reg(cp,
-                                 DSP_BHM_BUZZ_TRIGGER_REG,
-                                 1,
-                                 0,
-                                 CS40L25_POLL_ACK_CTRL_MAX,
-                                 CS40L25_POLL_ACK_CTRL_MS);
+    ret = halo_mbox_send_acked(&(driver->mbox), DSP_BHM_BUZZ_TRIGGER_REG, 1);
 
     return ret;
 }
@@ -306,12 +300,7 @@ uint32_t cs40l25_get_dynamic_redc(cs40l25_t *driver, uint32_t *redc)
     }
 
     // The PowerControl (MBOX_4) register must be set to WAKEUP (2)
-    ret = regmap_write_acked_reg(cp,
-                                 DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG,
-                                 CS40L25_POWERCONTROL_WAKEUP,
-                                 CS40L25_POWERCONTROL_NONE,
-                                 CS40L25_POLL_ACK_CTRL_MAX,
-                                 CS40L25_POLL_ACK_CTRL_MS);
+    ret = halo_mbox_send_acked(&(driver->mbox), DSP_VIRTUAL1_MBOX_DSP_VIRTUAL1_MBOX_4_REG, CS40L25_POWERCONTROL_WAKEUP);
     if (ret)
     {
         return ret;
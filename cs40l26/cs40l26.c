@@ -86,6 +86,20 @@ static const uint32_t cs40l26_irq_eint_1_to_event_flag_map[] =
     IRQ1_IRQ1_EINT_1_WKSRC_STATUS6_EINT1_BITMASK, CS40L26_EVENT_FLAG_WKSRC_CP
 };
 
+/**
+ * HALO mailbox configuration
+ *
+ * Mailbox commands are ACKed by the HALO FW resetting the mailbox once processed.
+ */
+static const halo_mbox_config_t cs40l26_mbox_config =
+{
+    .ack_type = HALO_MBOX_ACK_TYPE_CLEAR,
+    .ack_mask = 0xFFFFFFFF,
+    .ack_val = CS40L26_DSP_MBOX_RESET,
+    .poll_delay_max_ms = CS40L26_POLL_ACK_CTRL_MS,
+    .timeout_ms = (CS40L26_POLL_ACK_CTRL_MAX * CS40L26_POLL_ACK_CTRL_MS)
+};
+
 static const uint32_t cs40l26_a1_errata[] =
 {
     CS40L26_PLL_REFCLK_DETECT_0, 0x00000000,
@@ -186,6 +200,10 @@ static uint32_t cs40l26_dsp_state_get(cs40l26_t *driver, uint8_t *state)
 /**
  * Request change of state for Power Management
  *
+ * The expected DSP state in 'dsp_state' is updated for each transition sent.  WAKEUP and PREVENT_HIBERNATE are acked,
+ * so a hibernating DSP is known to be at least in STANDBY.  Once hibernation is allowed the DSP may enter it at any
+ * time, so it is expected to be in HIBERNATE.
+ *
  * @param [in] driver           Pointer to the driver state
  * @param [in] state            New state for Power Management
  *
@@ -206,12 +224,7 @@ static uint32_t cs40l26_pm_state_transition(cs40l26_t *driver, uint8_t state)
         case CS40L26_PM_STATE_WAKEUP:
             /* intentionally fall through */
         case CS40L26_PM_STATE_PREVENT_HIBERNATE:
-            ret = regmap_write_acked_reg(cp,
-                                         CS40L26_DSP_VIRTUAL1_MBOX_1,
-                                         cmd,
-                                         CS40L26_DSP_MBOX_RESET,
-                                         CS40L26_POLL_ACK_CTRL_MAX,
-                                         CS40L26_POLL_ACK_CTRL_MS);
+            ret = halo_mbox_send_acked(&(driver->mbox), CS40L26_DSP_VIRTUAL1_MBOX_1, cmd);
             break;
 
         case CS40L26_PM_STATE_ALLOW_HIBERNATE:
@@ -229,6 +242,27 @@ static uint32_t cs40l26_pm_state_transition(cs40l26_t *driver, uint8_t state)
         return ret;
     }
 
+    switch (state)
+    {
+        case CS40L26_PM_STATE_WAKEUP:
+            /* intentionally fall through */
+        case CS40L26_PM_STATE_PREVENT_HIBERNATE:
+            // Playback may have already taken the DSP to ACTIVE
+            if ((driver->dsp_state != CS40L26_DSP_STATE_STANDBY) && (driver->dsp_state != CS40L26_DSP_STATE_ACTIVE))
+            {
+                driver->dsp_state = CS40L26_DSP_STATE_STANDBY;
+            }
+            break;
+
+        case CS40L26_PM_STATE_ALLOW_HIBERNATE:
+            driver->dsp_state = CS40L26_DSP_STATE_HIBERNATE;
+            break;
+
+        case CS40L26_PM_STATE_SHUTDOWN:
+            driver->dsp_state = CS40L26_DSP_STATE_SHUTDOWN;
+            break;
+    }
+
     return CS40L26_STATUS_OK;
 }
 
@@ -289,6 +323,9 @@ static uint32_t cs40l26_event_handler(cs40l26_t *driver)
     uint32_t ret = CS40L26_STATUS_OK;
     uint32_t irq_statuses[CS40L26_IRQ1_REG_TOTAL];
     uint32_t irq_masks[CS40L26_IRQ1_REG_TOTAL];
+    uint8_t eint_buffer[CS40L26_IRQ1_REG_TOTAL * 4];
+    uint8_t mask_buffer[CS40L26_IRQ1_REG_TOTAL * 4];
+    bool has_irq = false;
     regmap_cp_config_t *cp = REGMAP_GET_CP(driver);
 
     // Read IRQ1_STATUS
@@ -303,20 +340,27 @@ static uint32_t cs40l26_event_handler(cs40l26_t *driver)
         return CS40L26_STATUS_FAIL;
     }
 
-    for (uint8_t i = 0; i < CS40L26_IRQ1_REG_TOTAL; i++)
+    // Read all IRQ1_EINT_1_* and all IRQ1_MASK_1_* in one block each
+    ret = regmap_read_block(cp, IRQ1_IRQ1_EINT_1_REG, eint_buffer, sizeof(eint_buffer));
+    if (ret)
     {
-        // Read IRQ1_EINT_1_*
-        ret = regmap_read(cp, (IRQ1_IRQ1_EINT_1_REG + (i * 4)), &(irq_statuses[i]));
-        if (ret)
-        {
-            return ret;
-        }
+        return ret;
+    }
 
-        // Read IRQ1_MASK_1_*
-        ret = regmap_read(cp, (IRQ1_IRQ1_MASK_1_REG + (i * 4)), &(irq_masks[i]));
-        if (ret)
+    ret = regmap_read_block(cp, IRQ1_IRQ1_MASK_1_REG, mask_buffer, sizeof(mask_buffer));
+    if (ret)
+    {
+        return ret;
+    }
+
+    for (uint8_t i = 0; i < CS40L26_IRQ1_REG_TOTAL; i++)
+    {
+        irq_statuses[i] = 0;
+        irq_masks[i] = 0;
+        for (uint8_t j = 0; j < 4; j++)
         {
-            return ret;
+            ADD_BYTE_TO_WORD(irq_statuses[i], eint_buffer[(i * 4) + j], (3 - j));
+            ADD_BYTE_TO_WORD(irq_masks[i], mask_buffer[(i * 4) + j], (3 - j));
         }
 
         irq_statuses[i] &= ~(irq_masks[i]);
@@ -324,17 +368,28 @@ static uint32_t cs40l26_event_handler(cs40l26_t *driver)
         // If there are unmasked IRQs, then process
         if (irq_statuses[i])
         {
-            // Clear any IRQ1 flags from first register
-            ret = regmap_write(cp, (IRQ1_IRQ1_EINT_1_REG + (i * 4)), irq_statuses[i]);
-            if (ret)
-            {
-                return ret;
-            }
+            has_irq = true;
 
             // Handle each unmasked flag - currently nothing to do here
 
             // Set event flags
-            driver->event_flags = cs40l26_irq_to_event_id(i, irq_statuses[i]);
+            driver->event_flags |= cs40l26_irq_to_event_id(i, irq_statuses[i]);
+        }
+
+        // Build clear words for all EINT registers - writing 0 to a flag leaves it unchanged
+        eint_buffer[(i * 4)] = GET_BYTE_FROM_WORD(irq_statuses[i], 3);
+        eint_buffer[(i * 4) + 1] = GET_BYTE_FROM_WORD(irq_statuses[i], 2);
+        eint_buffer[(i * 4) + 2] = GET_BYTE_FROM_WORD(irq_statuses[i], 1);
+        eint_buffer[(i * 4) + 3] = GET_BYTE_FROM_WORD(irq_statuses[i], 0);
+    }
+
+    // Clear all unmasked IRQ1 flags in one block
+    if (has_irq)
+    {
+        ret = regmap_write_block(cp, IRQ1_IRQ1_EINT_1_REG, eint_buffer, sizeof(eint_buffer));
+        if (ret)
+        {
+            return ret;
         }
     }
 
@@ -344,10 +399,15 @@ static uint32_t cs40l26_event_handler(cs40l26_t *driver)
 /**
  * Wakes device from hibernate
  *
+ * The acked PREVENT_HIBERNATE sets the expected state in 'dsp_state', so the DSP state is only read back on every Nth
+ * wake as configured by dsp_state_sample_period.  A sampled state that does not match the expected state is reported
+ * with CS40L26_EVENT_FLAG_DSP_STATE_MISMATCH.  ACTIVE matches an expected STANDBY, as playback may already have
+ * started.
+ *
  * @param [in] driver           Pointer to the driver state
  *
  * @return
- * - CS40L26_STATUS_FAI         Control port activity fails
+ * - CS40L26_STATUS_FAIL        Control port activity fails, or sampled DSP state does not match the expected state
  * - CS40L26_STATUS_OK          otherwise
  *
  */
@@ -377,15 +437,32 @@ static uint32_t cs40l26_wake(cs40l26_t *driver)
         return ret;
     }
 
+    // Otherwise trust the state tracked from the acked transition
+    driver->dsp_state_sample_count++;
+    if (driver->dsp_state_sample_count < driver->config.dsp_state_sample_period)
+    {
+        return CS40L26_STATUS_OK;
+    }
+
+    driver->dsp_state_sample_count = 0;
+
     ret = cs40l26_dsp_state_get(driver, &dsp_state);
+    if (ret)
+    {
+        return ret;
+    }
 
-    if (dsp_state != CS40L26_STATE_STANDBY &&
-        dsp_state != CS40L26_STATE_ACTIVE)
+    if ((dsp_state != driver->dsp_state) &&
+        !((driver->dsp_state == CS40L26_DSP_STATE_STANDBY) && (dsp_state == CS40L26_DSP_STATE_ACTIVE)))
     {
+        driver->dsp_state = dsp_state;
+        driver->event_flags |= CS40L26_EVENT_FLAG_DSP_STATE_MISMATCH;
         return CS40L26_STATUS_FAIL;
     }
 
-    return ret;
+    driver->dsp_state = dsp_state;
+
+    return CS40L26_STATUS_OK;
 }
 
 /**
@@ -410,10 +487,6 @@ static uint32_t cs40l26_hibernate(cs40l26_t *driver)
     }
 
     ret = regmap_write(cp, CS40L26_DSP_VIRTUAL1_MBOX_1, CS40L26_DSP_MBOX_CMD_HIBER);
-    if (ret)
-    {
-        return ret;
-    }
 
     return ret;
 }
@@ -433,6 +506,7 @@ uint32_t cs40l26_initialize(cs40l26_t *driver)
     if (NULL != driver)
     {
         memset(driver, 0, sizeof(cs40l26_t));
+        driver->dsp_state = CS40L26_DSP_STATE_UNKNOWN;
 
         ret = CS40L26_STATUS_OK;
     }
@@ -451,6 +525,16 @@ uint32_t cs40l26_configure(cs40l26_t *driver, cs40l26_config_t *config)
         (NULL != config))
     {
         driver->config = *config;
+        if (driver->config.dsp_state_sample_period == 0)
+        {
+            driver->config.dsp_state_sample_period = CS40L26_DSP_STATE_SAMPLE_PERIOD_DEFAULT;
+        }
+
+        ret = halo_mbox_initialize(&(driver->mbox), REGMAP_GET_CP(driver), &cs40l26_mbox_config);
+        if (ret)
+        {
+            return CS40L26_STATUS_FAIL;
+        }
 
         ret = bsp_driver_if_g->register_gpio_cb(driver->config.bsp_config.int_gpio_id,
                                               &cs40l26_irq_callback,
@@ -504,7 +588,6 @@ uint32_t cs40l26_process(cs40l26_t *driver)
 uint32_t cs40l26_reset(cs40l26_t *driver)
 {
     uint8_t dsp_state;
-    uint32_t halo_state;
     int ret, i;
     regmap_cp_config_t *cp = REGMAP_GET_CP(driver);
 
@@ -529,13 +612,13 @@ uint32_t cs40l26_reset(cs40l26_t *driver)
     }
     for (i = 0; i < 10; i++)
     {
-        ret = regmap_read(cp, CS40L26_A1_DSP_HALO_STATE_REG, &halo_state);
+        ret = regmap_read(cp, CS40L26_A1_DSP_HALO_STATE_REG, &(driver->halo_state));
         if (ret)
         {
             return ret;
         }
 
-        if (halo_state == CS40L26_DSP_HALO_STATE_RUN)
+        if (driver->halo_state == CS40L26_DSP_HALO_STATE_RUN)
         {
             break;
         }
@@ -563,6 +646,7 @@ uint32_t cs40l26_reset(cs40l26_t *driver)
     {
         return CS40L26_STATUS_FAIL;
     }
+    driver->dsp_state = dsp_state;
 
     ret = regmap_update_reg(cp, CS40L26_PLL_REFCLK_DETECT_0, CS40L26_PLL_REFCLK_DET_EN_MASK, 0);
     if (ret)
@@ -635,15 +719,25 @@ uint32_t cs40l26_boot(cs40l26_t *driver, fw_img_info_t *fw_info)
     {
         return ret;
     }
+    ret = regmap_read_fw_control(cp, driver->fw_info, CS40L26_SYM_FIRMWARE_CS40L26_HALO_STATE, &(driver->halo_state));
+    if (ret)
+    {
+        return ret;
+    }
+    if (driver->halo_state != CS40L26_DSP_HALO_STATE_RUN)
+    {
+        return CS40L26_STATUS_FAIL;
+    }
     ret = cs40l26_dsp_state_get(driver, &dsp_state);
     if (ret)
     {
         return ret;
     }
-    if (dsp_state != CS40L26_DSP_HALO_STATE_RUN)
+    if (dsp_state != CS40L26_DSP_STATE_STANDBY)
     {
         return CS40L26_STATUS_FAIL;
     }
+    driver->dsp_state = dsp_state;
     return CS40L26_STATUS_OK;
 }
 
@@ -37,6 +37,7 @@ extern "C" {
 #include "cs40l26_spec.h"
 #include "cs40l26_syscfg_regs.h"
 #include "regmap.h"
+#include "halo_mbox.h"
 
 #include "sdk_version.h"
 
@@ -116,10 +117,16 @@ extern "C" {
  */
 #define CS40L26_EVENT_FLAG_DSP_ERROR                    (1 << 31)
 #define CS40L26_EVENT_FLAG_STATE_ERROR                  (1 << 30)
+#define CS40L26_EVENT_FLAG_DSP_STATE_MISMATCH           (1 << 29)
 #define CS40L26_EVENT_FLAG_WKSRC_CP                     (1 << 1)
 #define CS40L26_EVENT_FLAG_WKSRC_GPIO                   (1 << 0)
 /** @} */
 
+/**
+ * Default wakes between DSP state read-backs in cs40l26_power(), if the dsp_state_sample_period config is 0
+ */
+#define CS40L26_DSP_STATE_SAMPLE_PERIOD_DEFAULT         (16)
+
 /**
  *  Minimum firmware version that will be accepted by the boot function
  */
@@ -192,6 +199,7 @@ typedef struct
     uint32_t *syscfg_regs;              ///< Pointer to system configuration table
     uint32_t syscfg_regs_total;         ///< Total entries in system configuration table
     cs40l26_calibration_t cal_data;     ///< Calibration data from previous calibration sequence
+    uint32_t dsp_state_sample_period;   ///< Verify DSP state on every Nth wake, 0 for CS40L26_DSP_STATE_SAMPLE_PERIOD_DEFAULT
 } cs40l26_config_t;
 
 /**
@@ -210,6 +218,10 @@ typedef struct
     cs40l26_config_t config;    ///< Driver configuration fields - see cs40l26_config_t
     fw_img_info_t *fw_info;     ///< Current HALO FW/Coefficient boot configuration
     uint32_t event_flags;       ///< Most recent event_flags reported to BSP Notification callback
+    uint8_t dsp_state;          ///< Expected DSP Power Management state, tracked from PM transitions - @see CS40L26_DSP_STATE_
+    uint32_t halo_state;        ///< HALO core state at the last reset or boot - CS40L26_DSP_HALO_STATE_RUN once running
+    uint32_t dsp_state_sample_count;    ///< Wakes since DSP state was last verified
+    halo_mbox_t mbox;           ///< HALO mailbox state for ACKed mailbox commands
 } cs40l26_t;
 
 /***********************************************************************************************************************
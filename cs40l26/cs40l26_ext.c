@@ -155,6 +155,79 @@ uint32_t cs40l26_get_dynamic_f0(cs40l26_t *driver, cs40l26_dynamic_f0_table_entr
     return ret;
 }
 
+/**
+ * Map GPI edges to haptic effects
+ *
+ */
+uint32_t cs40l26_set_gpio_event_map(cs40l26_t *driver, cs40l26_gpio_event_map_t *map)
+{
+    uint8_t buffer[CS40L26_EVENT_MAP_NUM_REGS * 4];
+    uint32_t words[CS40L26_EVENT_MAP_NUM_REGS];
+    regmap_cp_config_t *cp = REGMAP_GET_CP(driver);
+
+    if (map == NULL)
+    {
+        return CS40L26_STATUS_FAIL;
+    }
+
+    // Registers are laid out GPI1 rise, GPI1 fall, GPI2 rise, ...
+    for (uint8_t i = 0; i < CS40L26_EVENT_MAP_NUM_GPI; i++)
+    {
+        words[(i * 2)] = map->gpi[i].rise.word;
+        words[(i * 2) + 1] = map->gpi[i].fall.word;
+    }
+
+    for (uint8_t i = 0; i < CS40L26_EVENT_MAP_NUM_REGS; i++)
+    {
+        buffer[(i * 4)] = GET_BYTE_FROM_WORD(words[i], 3);
+        buffer[(i * 4) + 1] = GET_BYTE_FROM_WORD(words[i], 2);
+        buffer[(i * 4) + 2] = GET_BYTE_FROM_WORD(words[i], 1);
+        buffer[(i * 4) + 3] = GET_BYTE_FROM_WORD(words[i], 0);
+    }
+
+    return regmap_write_block(cp, CS40L26_A1_EVENT_MAP_1, buffer, sizeof(buffer));
+}
+
+/**
+ * Get the current GPI to haptic effect mapping
+ *
+ */
+uint32_t cs40l26_get_gpio_event_map(cs40l26_t *driver, cs40l26_gpio_event_map_t *map)
+{
+    uint32_t ret;
+    uint8_t buffer[CS40L26_EVENT_MAP_NUM_REGS * 4];
+    uint32_t words[CS40L26_EVENT_MAP_NUM_REGS];
+    regmap_cp_config_t *cp = REGMAP_GET_CP(driver);
+
+    if (map == NULL)
+    {
+        return CS40L26_STATUS_FAIL;
+    }
+
+    ret = regmap_read_block(cp, CS40L26_A1_EVENT_MAP_1, buffer, sizeof(buffer));
+    if (ret)
+    {
+        return ret;
+    }
+
+    for (uint8_t i = 0; i < CS40L26_EVENT_MAP_NUM_REGS; i++)
+    {
+        words[i] = 0;
+        ADD_BYTE_TO_WORD(words[i], buffer[(i * 4)], 3);
+        ADD_BYTE_TO_WORD(words[i], buffer[(i * 4) + 1], 2);
+        ADD_BYTE_TO_WORD(words[i], buffer[(i * 4) + 2], 1);
+        ADD_BYTE_TO_WORD(words[i], buffer[(i * 4) + 3], 0);
+    }
+
+    for (uint8_t i = 0; i < CS40L26_EVENT_MAP_NUM_GPI; i++)
+    {
+        map->gpi[i].rise.word = words[(i * 2)];
+        map->gpi[i].fall.word = words[(i * 2) + 1];
+    }
+
+    return CS40L26_STATUS_OK;
+}
+
 #ifdef PWLE_API_ENABLE
 uint32_t cs40l26_trigger_pwle(cs40l26_t *driver, rth_pwle_section_t **s)
 {
@@ -97,6 +97,46 @@ typedef struct
     };
 } cs40l26_dynamic_f0_table_entry_t;
 
+/**
+ * GPI Event Map entry type
+ *
+ * Selects the effect played by the HALO FW when the corresponding GPI edge is detected.  The bitfield matches the
+ * register encoding given by CS40L26_EVENT_MAP_INDEX_MASK and CS40L26_EVENT_MAP_BANK_MASK.
+ *
+ * @see CS40L26_EVENT_MAP_BANK_
+ */
+typedef struct
+{
+    union
+    {
+        uint32_t word;
+        struct
+        {
+            uint32_t index                      : 8;  ///< Index into the bank selected by 'bank'
+            uint32_t bank                       : 3;  ///< Wavetable bank - RAM, ROM or OWT
+            uint32_t reserved                   : 21;
+        };
+    };
+} cs40l26_gpio_event_map_entry_t;
+
+/**
+ * GPI Event Map configuration
+ *
+ * Entries are in the order of the contiguous GPI Event Map registers, so that the whole map can be written in a single
+ * block.  Set an entry's 'word' to CS40L26_EVENT_MAP_GPI_DISABLE, or its 'bank' to CS40L26_EVENT_MAP_BANK_ROM and
+ * 'index' to CS40L26_EVENT_MAP_INDEX_DISABLE, for any edge that should not trigger an effect.
+ *
+ * @see cs40l26_set_gpio_event_map
+ */
+typedef struct
+{
+    struct
+    {
+        cs40l26_gpio_event_map_entry_t rise;    ///< Effect to play on rising edge of GPI
+        cs40l26_gpio_event_map_entry_t fall;    ///< Effect to play on falling edge of GPI
+    } gpi[CS40L26_EVENT_MAP_NUM_GPI];
+} cs40l26_gpio_event_map_t;
+
 #ifdef PWLE_API_ENABLE
 typedef struct
 {
@@ -287,6 +327,39 @@ uint32_t cs40l26_set_dynamic_f0_enable(cs40l26_t *driver, bool enable);
  */
 uint32_t cs40l26_get_dynamic_f0(cs40l26_t *driver, cs40l26_dynamic_f0_table_entry_t *f0_entry);
 
+/**
+ * Map GPI edges to haptic effects
+ *
+ * Writes the complete GPI Event Map in one block write.  Once mapped, effects are triggered directly by the GPI edges
+ * without any control port activity.
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] map              Pointer to GPI Event Map configuration
+ *
+ * @return
+ * - CS40L26_STATUS_FAIL
+ *      - if map is NULL
+ *      - if control port write fails
+ * - CS40L26_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs40l26_set_gpio_event_map(cs40l26_t *driver, cs40l26_gpio_event_map_t *map);
+
+/**
+ * Get the current GPI to haptic effect mapping
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [out] map             Pointer to GPI Event Map configuration
+ *
+ * @return
+ * - CS40L26_STATUS_FAIL
+ *      - if map is NULL
+ *      - if control port read fails
+ * - CS40L26_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs40l26_get_gpio_event_map(cs40l26_t *driver, cs40l26_gpio_event_map_t *map);
+
 #ifdef PWLE_API_ENABLE
 uint32_t cs40l26_trigger_pwle(cs40l26_t *driver, rth_pwle_section_t **s);
 uint32_t cs40l26_trigger_pwle_advanced(cs40l26_t *driver, rth_pwle_section_t **s, uint8_t repeat, uint8_t num_sections);
@@ -140,6 +140,25 @@ extern "C" {
 #define CS40L26_SLOT0_MAX_PWLE_SECTIONS  (61)
 #define CS40l26_SLOT1_MAX_PWLE_SECTIONS  (65)
 
+/* GPI Event Mapping */
+#define CS40L26_A1_EVENT_MAP_1             (0x02806FC4)     ///< GPI1 rise, followed by GPI1 fall, GPI2 rise, ...
+#define CS40L26_EVENT_MAP_NUM_GPI          (4)
+#define CS40L26_EVENT_MAP_NUM_REGS         (CS40L26_EVENT_MAP_NUM_GPI * 2)
+#define CS40L26_EVENT_MAP_INDEX_SHIFT      (0)
+#define CS40L26_EVENT_MAP_INDEX_MASK       (0xFF)           ///< Bits 7:0 - effect index within the bank
+#define CS40L26_EVENT_MAP_BANK_SHIFT       (8)
+#define CS40L26_EVENT_MAP_BANK_MASK        (0x700)          ///< Bits 10:8 - effect bank
+#define CS40L26_EVENT_MAP_BANK_RAM         (0)
+#define CS40L26_EVENT_MAP_BANK_ROM         (1)
+#define CS40L26_EVENT_MAP_BANK_OWT         (2)
+#define CS40L26_EVENT_MAP_INDEX_DISABLE    (0xFF)
+/*
+ * The HALO FW treats ROM effect 0xFF as "no effect", so this 0x1FF encoding fits the 'index'/'bank' bitfield of
+ * cs40l26_gpio_event_map_entry_t and reads back as index 0xFF in bank CS40L26_EVENT_MAP_BANK_ROM
+ */
+#define CS40L26_EVENT_MAP_GPI_DISABLE      ((CS40L26_EVENT_MAP_BANK_ROM << CS40L26_EVENT_MAP_BANK_SHIFT) | \
+                                            (CS40L26_EVENT_MAP_INDEX_DISABLE << CS40L26_EVENT_MAP_INDEX_SHIFT))
+
 
 /* Dynamic F0 */
 
@@ -24,6 +24,7 @@
  **********************************************************************************************************************/
 #include <stddef.h>
 #include "cs47l15.h"
+#include "madera.h"
 #include "bsp_driver_if.h"
 #include "string.h"
 
@@ -39,8 +40,6 @@
  */
 #define CS47L15_POLL_ACK_CTRL_MS                (10)    ///< Delay in ms between polling ACK controls
 #define CS47L15_POLL_ACK_CTRL_MAX               (10)    ///< Maximum number of times to poll ACK controls
-#define CS47L15_POLL_MEM_ENA_MS                 (250)   ///< Delay in ms between polling ACK controls
-#define CS47L15_POLL_MEM_ENA_MAX                (10)    ///< Maximum number of times to poll ACK controls
 /** @} */
 
 /**
@@ -61,7 +60,6 @@
 #define CS47L15_FLL_MAX_FREF            (13500000)
 #define CS47L15_FLL_MIN_FOUT            (90000000)
 #define CS47L15_FLL_MAX_FOUT            (100000000)
-#define CS47L15_FLL_MAX_FRATIO          (16)
 #define CS47L15_FLL_MAX_REFDIV          (8)
 #define CS47L15_FLL_MAX_N               (1023)
 
@@ -122,46 +120,13 @@ const irq_reg_t cs47l15_event_data[] =
 {
     {0x00, CS47L15_BOOT_DONE_STS1_MASK         , CS47L15_EVENT_FLAG_BOOT_DONE},        //< CS47L15_IRQ1_STATUS_1
     {0x20, CS47L15_IRQ_DSP1_BUS_ERR_EINT1_MASK , CS47L15_EVENT_FLAG_DSP_BUS_ERROR},    //< CS47L15_IRQ1_STATUS_33
+    {0x01, CS47L15_FLL1_LOCK_EINT1_MASK        , CS47L15_EVENT_FLAG_FLL1_LOCK},        //< CS47L15_IRQ1_STATUS_2
+    {0x01, CS47L15_FLL_AO_LOCK_EINT1_MASK      , CS47L15_EVENT_FLAG_FLLAO_LOCK},       //< CS47L15_IRQ1_STATUS_2
     {0x0A, CS47L15_DSP_IRQ1_EINT1_MASK         , CS47L15_EVENT_FLAG_DSP_IRQ1},         //< CS47L15_IRQ1_STATUS_11
     {0x0E, CS47L15_SPK_OVERHEAT_WARN_EINT1_MASK, CS47L15_EVENT_FLAG_OVERTEMP_WARNING}, //< CS47L15_IRQ1_STATUS_15
     {0x0E, CS47L15_SPK_OVERHEAT_EINT1_MASK     , CS47L15_EVENT_FLAG_OVERTEMP_ERROR},   //< CS47L15_IRQ1_STATUS_15
 };
 
-static const struct {
-    uint32_t min;
-    uint32_t max;
-    uint16_t  fratio;
-    int32_t  ratio;
-} fll_sync_fratios[] = {
-    {       0,    64000, 4, 16 },
-    {   64000,   128000, 3,  8 },
-    {  128000,   256000, 2,  4 },
-    {  256000,  1000000, 1,  2 },
-    { 1000000, 13500000, 0,  1 },
-};
-
-struct cs47l15_fll_gains {
-    uint32_t  min;
-    uint32_t  max;
-    int32_t   gain;            /* main gain */
-    int32_t   alt_gain;        /* alternate integer gain */
-};
-
-static const struct cs47l15_fll_gains cs47l15_fll_sync_gains[] = {
-    {       0,   256000, 0, -1 },
-    {  256000,  1000000, 2, -1 },
-    { 1000000, 13500000, 4, -1 },
-};
-
-static const struct cs47l15_fll_gains cs47l15_fll_main_gains[] = {
-    {       0,   100000, 0, 2 },
-    {  100000,   375000, 2, 2 },
-    {  375000,   768000, 3, 2 },
-    {  768001,  1500000, 3, 3 },
-    { 1500000,  6000000, 4, 3 },
-    { 6000000, 13500000, 5, 3 },
-};
-
 struct reg_sequence {
     uint32_t reg;
     uint32_t def;
@@ -216,38 +181,16 @@ static const struct cs47l15_fllao_patch cs47l15_fllao_settings[] = {
     },
 };
 
-struct cs47l15_fll_cfg {
-    int32_t n;
-    uint32_t theta;
-    uint32_t lambda;
-    int32_t refdiv;
-    int32_t fratio;
-    int32_t gain;
-    int32_t alt_gain;
+static const madera_fll_limits_t cs47l15_fll_limits = {
+    .max_fref = CS47L15_FLL_MAX_FREF,
+    .max_refdiv = CS47L15_FLL_MAX_REFDIV,
+    .max_n = CS47L15_FLL_MAX_N,
 };
 
 /***********************************************************************************************************************
  * LOCAL FUNCTIONS
  **********************************************************************************************************************/
 #ifdef CS47L15_USEFUL_UNUSED
-/**
- * Find if an algorithm is in the algorithm list and return true if it is.
- * Returns false if not.
- */
-static bool find_algid(fw_img_info_t *fw_info, uint32_t algid_id)
-{
-    if (fw_info)
-    {
-        for (uint32_t i = 0; i < fw_info->header.alg_id_list_size; i++)
-        {
-            if (fw_info->alg_id_list[i] == algid_id)
-                return true;
-        }
-    }
-
-    return false;
-}
-
 bool cs47l15_find_algid(cs47l15_t *driver, uint32_t dsp_core, uint32_t algid_id)
 {
     bool ret;
@@ -257,14 +200,14 @@ bool cs47l15_find_algid(cs47l15_t *driver, uint32_t dsp_core, uint32_t algid_id)
 
     if (dsp_core != 0)
     {
-        return find_algid(driver->dsp_info[dsp_core - 1].fw_info, algid_id);
+        return madera_find_algid(driver->dsp_info[dsp_core - 1].fw_info, algid_id);
     }
     else
     {
         // search all DSPs if dsp_core is 0
         for (uint32_t i = 0; i < CS47L15_NUM_DSP; i++)
         {
-            ret = find_algid(driver->dsp_info[i].fw_info, algid_id);
+            ret = madera_find_algid(driver->dsp_info[i].fw_info, algid_id);
 
             if (ret)
                 return true;
@@ -493,13 +436,10 @@ static uint32_t cs47l15_power_up(cs47l15_t *driver, cs47l15_dsp_t *dsp_info)
         return ret;
     }
 
-    ret = cs47l15_update_reg(driver,
-                             dsp_info->base_addr + CS47L15_DSP_OFF_CONFIG_1,
-                             CS47L15_DSP1_CORE_ENA_MASK | CS47L15_DSP1_START_MASK,
-                             CS47L15_DSP1_CORE_ENA | CS47L15_DSP1_START);
-    if (ret == CS47L15_STATUS_FAIL)
+    ret = madera_dsp_core_start(REGMAP_GET_CP(driver), dsp_info->base_addr);
+    if (ret)
     {
-        return ret;
+        return CS47L15_STATUS_FAIL;
     }
 
     return CS47L15_STATUS_OK;
@@ -531,31 +471,10 @@ static uint32_t cs47l15_power_down(cs47l15_t *driver, cs47l15_dsp_t *dsp_info)
     }
 
     // Disable DSP
-    ret = cs47l15_update_reg(driver,
-                             dsp_info->base_addr + CS47L15_DSP_OFF_CONFIG_1,
-                             CS47L15_DSP1_CORE_ENA_MASK | CS47L15_DSP1_START_MASK,
-                             0);
-    if (ret == CS47L15_STATUS_FAIL)
-    {
-        return ret;
-    }
-
-    ret = cs47l15_write_reg(driver, dsp_info->base_addr + CS47L15_DSP_OFF_DMA_CONFIG_3, 0);
-    if (ret == CS47L15_STATUS_FAIL)
-    {
-        return ret;
-    }
-
-    ret = cs47l15_write_reg(driver, dsp_info->base_addr + CS47L15_DSP_OFF_DMA_CONFIG_1, 0);
-    if (ret == CS47L15_STATUS_FAIL)
-    {
-        return ret;
-    }
-
-    ret = cs47l15_write_reg(driver, dsp_info->base_addr + CS47L15_DSP_OFF_DMA_CONFIG_2, 0);
-    if (ret == CS47L15_STATUS_FAIL)
+    ret = madera_dsp_core_stop(REGMAP_GET_CP(driver), dsp_info->base_addr);
+    if (ret)
     {
-        return ret;
+        return CS47L15_STATUS_FAIL;
     }
 
     return CS47L15_STATUS_OK;
@@ -576,7 +495,7 @@ static uint32_t cs47l15_power_down(cs47l15_t *driver, cs47l15_dsp_t *dsp_info)
  */
 static uint32_t cs47l15_power_mem_ena(cs47l15_t *driver, cs47l15_dsp_t *dsp_info)
 {
-    uint32_t val, i, ret;
+    uint32_t val, ret;
 
     ret = cs47l15_update_reg(driver, CS47L15_DSP_CLOCK_1, CS47L15_DSP_CLK_ENA_MASK, CS47L15_DSP_CLK_ENA);
     if (ret == CS47L15_STATUS_FAIL)
@@ -602,21 +521,8 @@ static uint32_t cs47l15_power_mem_ena(cs47l15_t *driver, cs47l15_dsp_t *dsp_info
         return ret;
     }
 
-    for (i = 0; i < CS47L15_POLL_MEM_ENA_MAX; i++)
-    {
-        ret = cs47l15_read_reg(driver, dsp_info->base_addr + CS47L15_DSP_OFF_STATUS_1, &val);
-        if (ret == CS47L15_STATUS_FAIL)
-        {
-            return ret;
-        }
-
-        if (val & CS47L15_DSP1_RAM_RDY)
-            break;
-
-        bsp_driver_if_g->set_timer(CS47L15_POLL_MEM_ENA_MS, NULL, NULL);
-    }
-
-    if (i == CS47L15_POLL_MEM_ENA_MAX)
+    ret = madera_dsp_wait_ram_ready(REGMAP_GET_CP(driver), dsp_info->base_addr);
+    if (ret)
     {
         return CS47L15_STATUS_FAIL;
     }
@@ -693,7 +599,7 @@ static uint32_t cs47l15_event_handler(cs47l15_t *driver)
 }
 
 static uint32_t cs47l15_write_fll(cs47l15_t *driver, uint32_t base,
-                                  struct cs47l15_fll_cfg *cfg, int32_t source,
+                                  madera_fll_cfg_t *cfg, int32_t source,
                                   bool sync, int32_t gain)
 {
     uint32_t ret = CS47L15_STATUS_OK;
@@ -752,194 +658,6 @@ static uint32_t cs47l15_write_fll(cs47l15_t *driver, uint32_t base,
     return ret;
 }
 
-static int32_t cs47l15_find_sync_fratio(uint32_t fref, int32_t  *fratio)
-{
-    uint32_t i;
-
-    for (i = 0; i < ARRAY_SIZE(fll_sync_fratios); i++)
-    {
-        if (fll_sync_fratios[i].min <= fref &&
-            fref <= fll_sync_fratios[i].max)
-            {
-            if (fratio)
-            {
-                *fratio = fll_sync_fratios[i].fratio;
-            }
-            return fll_sync_fratios[i].ratio;
-        }
-    }
-
-    return -1;
-}
-
-static int32_t cs47l15_find_main_fratio(uint32_t fref, uint32_t fout,
-                                        int32_t *fratio)
-{
-    int32_t ratio = 1;
-
-    while ((fout / (ratio * fref)) > CS47L15_FLL_MAX_N)
-    {
-        ratio++;
-    }
-    if (fratio)
-    {
-        *fratio = ratio - 1;
-    }
-    return ratio;
-}
-
-static int32_t cs47l15_find_fratio(cs47l15_fll_t *fll,
-                                   uint32_t fref,
-                                   bool sync, int32_t *fratio)
-{
-    if (sync)
-    {
-        return cs47l15_find_sync_fratio(fref, fratio);
-    }
-    else
-    {
-        return cs47l15_find_main_fratio(fref, fll->fout, fratio);
-    }
-}
-
-static int32_t cs47l15_calc_fratio(cs47l15_fll_t *fll,
-                                   struct cs47l15_fll_cfg *cfg,
-                                   uint32_t fref,
-                                   bool sync)
-{
-    int32_t init_ratio, div;
-
-    /* fref must be <=13.5MHz, find initial refdiv */
-    div = 1;
-    cfg->refdiv = 0;
-    while (fref > CS47L15_FLL_MAX_FREF)
-    {
-        div *= 2;
-        fref /= 2;
-        cfg->refdiv++;
-
-        if (div > CS47L15_FLL_MAX_REFDIV)
-        {
-            return -1;  // return a neg value to signal an error
-        }
-    }
-
-    /* Find an appropriate FLL_FRATIO */
-    init_ratio = cs47l15_find_fratio(fll, fref, sync, &cfg->fratio);
-    if (init_ratio < 0)
-    {
-        return init_ratio;
-    }
-
-    if (!sync)
-    {
-        cfg->fratio = init_ratio - 1;
-    }
-
-    return init_ratio;
-}
-
-static uint32_t cs47l15_find_fll_gain(struct cs47l15_fll_cfg *cfg,
-                                      uint32_t fref,
-                                      const struct cs47l15_fll_gains *gains,
-                                      int32_t n_gains)
-{
-    int32_t i;
-
-    for (i = 0; i < n_gains; i++)
-    {
-        if (gains[i].min <= fref && fref <= gains[i].max)
-        {
-            cfg->gain = gains[i].gain;
-            cfg->alt_gain = gains[i].alt_gain;
-            return CS47L15_STATUS_OK;
-        }
-    }
-    return CS47L15_STATUS_FAIL;
-}
-
-static uint32_t gcd(uint32_t n1, uint32_t n2)
-{
-    while (n1 != n2)
-    {
-        if (n1 > n2)
-        {
-            n1 -= n2;
-        }
-        else
-        {
-            n2 -= n1;
-        }
-    }
-    return n1;
-}
-
-static uint32_t cs47l15_calc_fll(cs47l15_fll_t *fll,
-                                 struct cs47l15_fll_cfg *cfg,
-                                 uint32_t fref,
-                                 bool sync)
-{
-    uint32_t gcd_fll;
-    const struct cs47l15_fll_gains *gains;
-    int32_t n_gains;
-    int32_t ratio;
-    uint32_t ret;
-
-    /* Find an appropriate FLL_FRATIO and refdiv */
-    ratio = cs47l15_calc_fratio(fll, cfg, fref, sync);
-    if (ratio < 0)
-    {
-        return CS47L15_STATUS_FAIL;
-    }
-
-    /* Apply the division for our remaining calculations */
-    fref = fref / (1 << cfg->refdiv);
-
-    cfg->n = fll->fout / (ratio * fref);
-
-    if (fll->fout % (ratio * fref))
-    {
-        gcd_fll = gcd(fll->fout, ratio * fref);
-
-        cfg->theta = (fll->fout - (cfg->n * ratio * fref))/gcd_fll;
-        cfg->lambda = (ratio * fref) / gcd_fll;
-    }
-    else
-    {
-        cfg->theta = 0;
-        cfg->lambda = 0;
-    }
-
-    /*
-     * Round down to 16bit range with cost of accuracy lost.
-     * Denominator must be bigger than numerator so we only
-     * take care of it.
-     */
-    while (cfg->lambda >= (1 << 16)) {
-        cfg->theta >>= 1;
-        cfg->lambda >>= 1;
-    }
-
-    if (sync)
-    {
-        gains = cs47l15_fll_sync_gains;
-        n_gains = ARRAY_SIZE(cs47l15_fll_sync_gains);
-    }
-    else
-    {
-        gains = cs47l15_fll_main_gains;
-        n_gains = ARRAY_SIZE(cs47l15_fll_main_gains);
-    }
-
-    ret = cs47l15_find_fll_gain(cfg, fref, gains, n_gains);
-    if (ret == CS47L15_STATUS_FAIL)
-    {
-        return ret;
-    }
-
-    return CS47L15_STATUS_OK;
-}
-
 static uint32_t cs47l15_is_enabled_fll(cs47l15_t *driver, uint32_t base, bool *enabled)
 {
     uint32_t reg;
@@ -961,7 +679,7 @@ static uint32_t cs47l15_is_enabled_fll(cs47l15_t *driver, uint32_t base, bool *e
 
 static uint32_t cs47l15_set_fll_phase_integrator(cs47l15_t* driver,
                                                  cs47l15_fll_t *fll,
-                                                 struct cs47l15_fll_cfg *ref_cfg,
+                                                 madera_fll_cfg_t *ref_cfg,
                                                  bool sync)
 {
     uint32_t val, ret;
@@ -1012,7 +730,7 @@ static int32_t cs47l15_apply_config_fll(cs47l15_t* driver, cs47l15_fll_t *fll)
     int32_t gain;
     uint32_t ret;
     bool already_enabled = false, sync_enabled = false;
-    struct cs47l15_fll_cfg ref_cfg;
+    madera_fll_cfg_t ref_cfg;
 
     ret = cs47l15_is_enabled_fll(driver, fll->base, &already_enabled);
     if (ret != CS47L15_STATUS_OK)
@@ -1064,7 +782,7 @@ static int32_t cs47l15_apply_config_fll(cs47l15_t* driver, cs47l15_fll_t *fll)
     /* Apply SYNCCLK setting */
     if (fll->sync_src >= 0)
     {
-        ret = cs47l15_calc_fll(fll, &ref_cfg, fll->sync_freq, true);
+        ret = madera_calc_fll(&cs47l15_fll_limits, fll->sync_freq, fll->fout, true, &ref_cfg);
         if (ret == CS47L15_STATUS_FAIL)
         {
             cs47l15_disable_fll(driver, fll);
@@ -1085,7 +803,7 @@ static int32_t cs47l15_apply_config_fll(cs47l15_t* driver, cs47l15_fll_t *fll)
     }
 
     /* Apply REFCLK setting */
-    ret = cs47l15_calc_fll(fll, &ref_cfg, fll->ref_freq, false);
+    ret = madera_calc_fll(&cs47l15_fll_limits, fll->ref_freq, fll->fout, false, &ref_cfg);
     if (ret == CS47L15_STATUS_FAIL)
     {
         cs47l15_disable_fll(driver, fll);
@@ -1572,6 +1290,29 @@ uint32_t cs47l15_write_block(cs47l15_t *driver, uint32_t addr, uint8_t *data, ui
     return CS47L15_STATUS_OK;
 }
 
+/**
+ * Read block of data from the CS47L15 register file
+ *
+ */
+uint32_t cs47l15_read_block(cs47l15_t *driver, uint32_t addr, uint8_t *data, uint32_t size)
+{
+    uint32_t ret;
+    regmap_cp_config_t *cp = REGMAP_GET_CP(driver);
+
+    if (data == NULL || size == 0 || size % 4 != 0)
+    {
+        return CS47L15_STATUS_FAIL;
+    }
+
+    ret = regmap_read_block(cp, addr, data, size);
+    if (ret)
+    {
+        return CS47L15_STATUS_FAIL;
+    }
+
+    return CS47L15_STATUS_OK;
+}
+
 /**
  * Finish booting the CS47L15
  *
@@ -1809,41 +1550,78 @@ uint32_t cs47l15_fll_disable(cs47l15_t *driver, uint32_t fll_id)
     return ret;
 }
 
+/**
+ * Handle an IRQ pending during an FLL lock wait, as cs47l15_process() would
+ *
+ * Returns the event flags raised by this IRQ, and leaves all raised flags for cs47l15_process() to notify.
+ *
+ */
+static uint32_t cs47l15_fll_handle_events(void *arg, uint32_t *event_flags)
+{
+    cs47l15_t *driver = arg;
+    uint32_t flags = driver->event_flags;
+    uint32_t ret;
+
+    *event_flags = 0;
+
+    if (driver->mode != CS47L15_MODE_HANDLING_EVENTS)
+    {
+        return CS47L15_STATUS_OK;
+    }
+
+    driver->mode = CS47L15_MODE_HANDLING_CONTROLS;
+
+    // Events are only handled in STANDBY, otherwise the lock status is left to polling
+    if (driver->state != CS47L15_STATE_STANDBY)
+    {
+        return CS47L15_STATUS_OK;
+    }
+
+    ret = cs47l15_event_handler(driver);
+    *event_flags = driver->event_flags;
+    driver->event_flags |= flags;
+
+    return ret;
+}
+
 /**
  * Wait for short time for an FLL to achieve lock
  *
  */
 uint32_t cs47l15_fll_wait_for_lock(cs47l15_t *driver, uint32_t fll_id)
 {
-    uint32_t i, mask, temp_reg_val, ret=CS47L15_STATUS_OK;
+    uint32_t mask, lock_flag, ret;
 
     switch(fll_id)
     {
         case CS47L15_FLL1:
             mask = CS47L15_FLL1_LOCK_STS1_MASK;
+            lock_flag = CS47L15_EVENT_FLAG_FLL1_LOCK;
             break;
         case CS47L15_FLLAO:
             mask = CS47L15_FLL_AO_LOCK_STS1_MASK;
+            lock_flag = CS47L15_EVENT_FLAG_FLLAO_LOCK;
             break;
         default:
             return CS47L15_STATUS_FAIL;
             break;
     }
 
-    for (i = 0; i < 30; i++)
+    ret = regmap_poll_reg_on_event(REGMAP_GET_CP(driver),
+                                   CS47L15_IRQ1_RAW_STATUS_2,
+                                   mask,
+                                   lock_flag,
+                                   &cs47l15_fll_handle_events,
+                                   driver,
+                                   MADERA_FLL_LOCK_POLL_MS,
+                                   MADERA_FLL_LOCK_TIMEOUT_MS,
+                                   &driver->fll[fll_id].lock_time_ms);
+    if (ret)
     {
-        ret = cs47l15_read_reg(driver, CS47L15_IRQ1_RAW_STATUS_2, &temp_reg_val);
-        if (ret == CS47L15_STATUS_FAIL)
-        {
-            return ret;
-        }
-        if (temp_reg_val & mask)
-        {
-            return CS47L15_STATUS_OK;
-        }
-        bsp_driver_if_g->set_timer(10, NULL, NULL);
+        return CS47L15_STATUS_FAIL;
     }
-    return CS47L15_STATUS_FAIL;
+
+    return CS47L15_STATUS_OK;
 }
 
 /*!
@@ -120,6 +120,8 @@ extern "C" {
  *
  * @{
  */
+#define CS47L15_EVENT_FLAG_FLLAO_LOCK                   (1 << 6)
+#define CS47L15_EVENT_FLAG_FLL1_LOCK                    (1 << 5)
 #define CS47L15_EVENT_FLAG_BOOT_DONE                    (1 << 4)
 #define CS47L15_EVENT_FLAG_DSP_IRQ1                     (1 << 3)
 #define CS47L15_EVENT_FLAG_DSP_BUS_ERROR                (1 << 2)
@@ -279,6 +281,8 @@ typedef struct
 
     int32_t ref_src;
     uint32_t ref_freq;
+
+    uint32_t lock_time_ms;          ///< Time taken to lock by the last successful cs47l15_fll_wait_for_lock(), in ms
 } cs47l15_fll_t;
 
 /**
@@ -494,6 +498,24 @@ uint32_t cs47l15_write_acked_reg(cs47l15_t *driver, uint32_t addr, uint32_t val)
  */
 uint32_t cs47l15_write_block(cs47l15_t *driver, uint32_t addr, uint8_t *data, uint32_t size);
 
+/*
+ * Read block of data from the CS47L15 register file
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] addr             Starting address of read source
+ * @param [in] data             Pointer to array of bytes to be read into
+ * @param [in] size             Size of array of bytes to be read
+ *
+ * @return
+ * - CS47L15_STATUS_FAIL if:
+ *      - Any pointers are NULL
+ *      - size is not multiple of 4
+ *      - Control port activity fails
+ * - otherwise, returns CS47L15_STATUS_OK
+ *
+ */
+uint32_t cs47l15_read_block(cs47l15_t *driver, uint32_t addr, uint8_t *data, uint32_t size);
+
 /**
  * Finish booting the CS47L15
  *
@@ -590,6 +612,11 @@ uint32_t cs47l15_fll_disable(cs47l15_t *driver, uint32_t fll_id);
 /**
  * Wait a short time for the FLL to reach a locked state
  *
+ * In STANDBY, any IRQ that fires while waiting is handled straight away, and the lock status is checked as soon as the
+ * handler reports this FLL's lock event.  Other IRQs do not bring the check forward, and their event flags are still
+ * notified by the next cs47l15_process().  The lock status is also polled every few ms in case the IRQ is not wired
+ * up.  The time taken is stored in the FLL 'lock_time_ms'.
+ *
  * @param [in] driver           Pointer to the driver state
  * @param [in] fll_id           FLL Id to achieve lock
  *
@@ -24,6 +24,7 @@
  **********************************************************************************************************************/
 #include <stddef.h>
 #include "cs47l15_ext.h"
+#include "madera.h"
 #include "bsp_driver_if.h"
 
 /***********************************************************************************************************************
@@ -43,7 +44,6 @@
  **********************************************************************************************************************/
 static uint32_t cs47l15_get_dsp_element_value(cs47l15_t *driver, uint32_t rb_struct_base_addr, dsp_struct_offsets_t offset, uint32_t *value);
 static uint32_t cs47l15_set_dsp_element_value(cs47l15_t *driver, uint32_t rb_struct_base_addr, dsp_struct_offsets_t offset, uint32_t value);
-static void     cs47l15_read_array(const uint8_t *array, uint8_t *target, uint32_t *length);
 static uint32_t cs47l15_init_dsp_ringbuf_structure(cs47l15_t *driver, uint32_t rb_struct_base_addr, ring_buffer_struct_t *dsp_buffer);
 
 /***********************************************************************************************************************
@@ -86,7 +86,7 @@ uint32_t cs47l15_dsp_buf_write(cs47l15_t *driver,
     }
 
     // read a portion of data with padding
-    cs47l15_read_array(data, buffer->linear_buf, &data_len);
+    madera_dsp_pack_words(data, buffer->linear_buf, &data_len);
 
     // determine remaining space in buffer
     dsp_avail_wrap = ((buffer->dsp_buf.buffer_size + buffer->dsp_buf.buffer_size / 3) - (buffer->dsp_buf.next_write_index * 4));
@@ -108,6 +108,10 @@ uint32_t cs47l15_dsp_buf_write(cs47l15_t *driver,
         buffer->dsp_buf.next_write_index += (data_len / 4);
     }
 
+    /*
+     * Publish next_write_index before acking - irq_ack sits before it in the ring buffer struct, so a block write would
+     * let the DSP see the ack with a stale write index and raise the watermark IRQ again
+     */
     ret = cs47l15_set_dsp_element_value(driver, buffer->rb_struct_base_addr, next_write_index, buffer->dsp_buf.next_write_index);
     if (ret)
     {
@@ -123,6 +127,104 @@ uint32_t cs47l15_dsp_buf_write(cs47l15_t *driver,
     return CS47L15_STATUS_OK;
 }
 
+/**
+ * Read data from dsp ring buffer
+ *
+ * If data has already started streaming, it should only be called after determining that there is data available in
+ * buffer
+ *
+ * @param [in]
+ * - driver              Pointer to the driver state
+ * - buffer              Pointer to dsp ringbuff structure
+ * - data                Pointer to array of data bytes to store incoming data
+ * - data_len            Number of bytes to read into data array. Must be a whole number of 3-byte DSP words, and
+ *                       should not be longer than avail data in dsp buffer or longer than the allocated buffer.
+ *
+ * @return
+ * - CS47L15_STATUS_FAIL         Control port activity fails, or data_len is invalid
+ * - CS47L15_STATUS_OK           otherwise
+ *
+ * @see cs47l15_dsp_buf_init
+ * @see cs47l15_dsp_buf_data_avail
+ *
+ */
+uint32_t cs47l15_dsp_buf_read(cs47l15_t *driver,
+                               dsp_buffer_t *buffer,
+                               uint8_t * data,
+                               uint32_t data_len)
+{
+    uint32_t buffer_words = buffer->dsp_buf.buffer_size / CS47L15_DSP_BYTES_PER_WORD;
+    uint32_t words = data_len / CS47L15_DSP_BYTES_PER_WORD;
+    uint32_t segment_words;
+    uint32_t dsp_buff_add;
+    uint32_t padded_len;
+    uint32_t ret;
+
+    if ((data_len > buffer->dsp_buf.avail) ||
+        (data_len > buffer->buf_size) ||
+        (data_len % CS47L15_DSP_BYTES_PER_WORD))
+    {
+        return CS47L15_STATUS_FAIL;
+    }
+
+    if (words == 0)
+    {
+        return CS47L15_STATUS_OK;
+    }
+
+    // first segment runs from the read index up to the end of the dsp buffer
+    segment_words = buffer_words - buffer->dsp_buf.next_read_index;
+    if (segment_words > words)
+    {
+        segment_words = words;
+    }
+
+    dsp_buff_add = (buffer->dsp_buf.buffer_base + (buffer->dsp_buf.next_read_index * CS47L15_DSP_OFFSET_MUL_VALUE));
+    ret = cs47l15_read_block(driver, dsp_buff_add, buffer->linear_buf, (segment_words * 4));
+    if (ret)
+    {
+        return ret;
+    }
+
+    // if the data wraps, the second segment starts at the beginning of the dsp buffer
+    if (segment_words < words)
+    {
+        ret = cs47l15_read_block(driver,
+                                 buffer->dsp_buf.buffer_base,
+                                 (buffer->linear_buf + (segment_words * 4)),
+                                 ((words - segment_words) * 4));
+        if (ret)
+        {
+            return ret;
+        }
+    }
+
+    padded_len = words * 4;
+    madera_dsp_unpack_words(buffer->linear_buf, data, &padded_len);
+
+    buffer->dsp_buf.next_read_index = (buffer->dsp_buf.next_read_index + words) % buffer_words;
+    buffer->dsp_buf.avail -= data_len;
+
+    /*
+     * next_write_index is owned by the DSP and sits between irq_ack and next_read_index, so these can't be combined
+     * into one block write without racing the DSP.  Update the read index before acking, so the DSP sees the freed
+     * space when it re-arms the IRQ.
+     */
+    ret = cs47l15_set_dsp_element_value(driver, buffer->rb_struct_base_addr, next_read_index, buffer->dsp_buf.next_read_index);
+    if (ret)
+    {
+        return ret;
+    }
+
+    ret = cs47l15_set_dsp_element_value(driver, buffer->rb_struct_base_addr, irq_ack, CS47L15_DSP_IRQ_ACK_VAL);
+    if (ret)
+    {
+        return ret;
+    }
+
+    return CS47L15_STATUS_OK;
+}
+
 /**
  * Initialize struct with buffer needed to send data to dsp
  *
@@ -258,6 +360,54 @@ uint32_t cs47l15_dsp_buf_avail(cs47l15_t *driver,
     return CS47L15_STATUS_OK;
 }
 
+/**
+ * Check available data on DSP encoder
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - buffer           Pointer to dsp ringbuff structure
+ * - data_avail       Pointer to how much data is available in DSP buffer
+ *
+ * @return
+ * - CS47L15_STATUS_FAIL         Control port activity fails, or the DSP reports a ring buffer error
+ * - CS47L15_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l15_dsp_buf_data_avail(cs47l15_t *driver,
+                                    dsp_buffer_t *buffer,
+                                    uint32_t * data_avail)
+{
+    uint32_t element_values[4];
+    int32_t data;
+    uint32_t ret;
+
+    // Get irq_ack, next_write_index, next_read_index and dsp_error in one transaction
+    ret = madera_dsp_get_elements(REGMAP_GET_CP(driver), buffer->rb_struct_base_addr, irq_ack, element_values, 4);
+    if (ret)
+    {
+        return ret;
+    }
+
+    if (element_values[dsp_error - irq_ack])
+    {
+        buffer->dsp_buf.error = element_values[dsp_error - irq_ack];
+        return CS47L15_STATUS_FAIL;
+    }
+
+    buffer->dsp_buf.next_write_index = element_values[next_write_index - irq_ack];
+
+    data = (buffer->dsp_buf.next_write_index - buffer->dsp_buf.next_read_index);
+    data *= 3;
+    if (data < 0)
+    {
+        data = data + buffer->dsp_buf.buffer_size;
+    }
+
+    buffer->dsp_buf.avail = data;
+    *data_avail = buffer->dsp_buf.avail;
+    return CS47L15_STATUS_OK;
+}
+
 /**
  * Send EOF signal to dsp
  *
@@ -278,6 +428,35 @@ uint32_t cs47l15_dsp_buf_eof(cs47l15_t *driver,
     return ret;
 }
 
+/**
+ * Sample DSP ring buffer telemetry
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - buffer           Pointer to dsp ringbuff structure
+ * - telemetry        Pointer to telemetry to update
+ *
+ * @return
+ * - CS47L15_STATUS_FAIL         Control port activity fails
+ * - CS47L15_STATUS_OK           otherwise
+ *
+ */
+uint32_t cs47l15_dsp_buf_telemetry_sample(cs47l15_t *driver, dsp_buffer_t *buffer, madera_dsp_telemetry_t *telemetry)
+{
+    uint32_t ret;
+
+    ret = madera_dsp_telemetry_sample(REGMAP_GET_CP(driver),
+                                      buffer->rb_struct_base_addr,
+                                      buffer->dsp_buf.buffer_size,
+                                      telemetry);
+    if (ret)
+    {
+        return CS47L15_STATUS_FAIL;
+    }
+
+    return CS47L15_STATUS_OK;
+}
+
 /***********************************************************************************************************************
  * LOCAL FUNCTIONS
  **********************************************************************************************************************/
@@ -314,43 +493,6 @@ static uint32_t cs47l15_init_dsp_ringbuf_structure(cs47l15_t *driver,
     return CS47L15_STATUS_OK;
 }
 
-/**
- * Read array into target buffer, and add padding for 24bit data on DSP (1 byte of 0s for every 3 bytes of data)
- *
- */
-
-static void cs47l15_read_array(const uint8_t *array, uint8_t *target, uint32_t *length)
-{
-    uint32_t rem;
-    uint32_t end_padding_len;
-    uint32_t j = 0; // keep track of where to put data in target
-    for (uint32_t i = 0; i < *length; i++)
-    {
-        if (i % 3 == 0) // count each 3 bytes to pad with 0s
-        {
-            target[j] = 0x00;
-            j++;
-        }
-        target[j] = array[i];
-        j++;
-    }
-
-    rem = j % 4;
-    if (rem > 0)
-    {
-        end_padding_len = 4 - rem;
-        for (uint32_t i = 0; i < end_padding_len; i++)
-        {
-            target[j] = 0x00;
-            j++;
-        }
-    }
-
-    *length = j;
-
-    return;
-}
-
 /**
  * Read a value of an element of buffer struct from DSP
  *
@@ -398,4 +540,3 @@ static uint32_t cs47l15_set_dsp_element_value(cs47l15_t *driver,
         return CS47L15_STATUS_OK;
     }
 }
-
@@ -31,6 +31,7 @@ extern "C" {
  * INCLUDES
  **********************************************************************************************************************/
 #include "cs47l15.h"
+#include "madera.h"
 
 /***********************************************************************************************************************
  * LITERALS & CONSTANTS
@@ -46,6 +47,7 @@ extern "C" {
 #define CS47L15_DSP_EOF_VAL                       0x1
 #define CS47L15_DSP_DEC_ALGORITHM_STOPPED         0x10000
 #define CS47L15_DSP_SCRATCH_1_MASK                0xFFFF0000
+#define CS47L15_DSP_BYTES_PER_WORD                3
 
 /***********************************************************************************************************************
  * MACROS
@@ -134,6 +136,30 @@ typedef enum
  *
  */
 uint32_t cs47l15_dsp_buf_write(cs47l15_t *driver, dsp_buffer_t *buffer, uint8_t * data, uint32_t data_len);
+
+/**
+ * Read data from dsp ring buffer
+ *
+ * If data has already started streaming, it should only be called after IRQ signal from DSP, and after determining
+ * that there is data available in buffer
+ *
+ * @param [in]
+ * - driver              Pointer to the driver state
+ * - buffer              Pointer to dsp ringbuff structure
+ * - data                Pointer to array of data bytes to store incoming data
+ * - data_len            Number of bytes to read into data array. Must be a whole number of 3-byte DSP words, and
+ *                       should not be longer than avail data in dsp buffer or longer than the allocated buffer.
+ *
+ * @return
+ * - CS47L15_STATUS_FAIL         Control port activity fails, or data_len is invalid
+ * - CS47L15_STATUS_OK           otherwise
+ *
+ * @see cs47l15_dsp_buf_init
+ * @see cs47l15_dsp_buf_data_avail
+ *
+ */
+uint32_t cs47l15_dsp_buf_read(cs47l15_t *driver, dsp_buffer_t *buffer, uint8_t * data, uint32_t data_len);
+
 /**
  * Initialize struct with buffers needed to send data to dsp
  *
@@ -170,6 +196,21 @@ uint32_t cs47l15_dsp_buf_init(cs47l15_t *driver, dsp_buffer_t *buffer, uint8_t *
  */
 uint32_t cs47l15_dsp_buf_avail(cs47l15_t *driver, dsp_buffer_t *buffer, uint32_t * space_avail);
 
+/**
+ * Check available data on DSP encoder
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - buffer           Pointer to dsp ringbuff structure
+ * - data_avail       Pointer to how much data is available in DSP buffer
+ *
+ * @return
+ * - CS47L15_STATUS_FAIL         Control port activity fails, or the DSP reports a ring buffer error
+ * - CS47L15_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l15_dsp_buf_data_avail(cs47l15_t *driver, dsp_buffer_t *buffer, uint32_t * data_avail);
+
 /**
  * Send EOF signal to dsp
  *
@@ -183,6 +224,24 @@ uint32_t cs47l15_dsp_buf_avail(cs47l15_t *driver, dsp_buffer_t *buffer, uint32_t
  *
  */
 uint32_t cs47l15_dsp_buf_eof(cs47l15_t *driver, dsp_buffer_t *buffer);
+
+/**
+ * Sample DSP ring buffer telemetry
+ *
+ * Updates the fill level statistics and error counters with one read of the ring buffer state.  Call once per
+ * telemetry period, after clearing 'telemetry' with madera_dsp_telemetry_reset().
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - buffer           Pointer to dsp ringbuff structure, already initialized with cs47l15_dsp_buf_init()
+ * - telemetry        Pointer to telemetry to update
+ *
+ * @return
+ * - CS47L15_STATUS_FAIL         Control port activity fails
+ * - CS47L15_STATUS_OK           otherwise
+ *
+ */
+uint32_t cs47l15_dsp_buf_telemetry_sample(cs47l15_t *driver, dsp_buffer_t *buffer, madera_dsp_telemetry_t *telemetry);
 /***********************************************************************************************************************
  * LOCAL FUNCTIONS
  **********************************************************************************************************************/
@@ -82,6 +82,7 @@ static bridge_device_t device_list[] =
         .bus_i2c_cs_address = 0,
         .device_id_str = "6360",
         .dev_name_str = "CS47L35-1",
+        .bytes_per_addr = 2,
         .b.dev_id = BSP_DUT_DEV_ID,
         .b.bus_type = REGMAP_BUS_TYPE_SPI,
         .b.receive_max = BRIDGE_BLOCK_BUFFER_LENGTH_BYTES,
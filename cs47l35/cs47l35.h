@@ -121,6 +121,7 @@ extern "C" {
  *
  * @{
  */
+#define CS47L35_EVENT_FLAG_FLL1_LOCK                    (1 << 5)
 #define CS47L35_EVENT_FLAG_BOOT_DONE                    (1 << 4)
 #define CS47L35_EVENT_FLAG_DSP_ENCODER                  (1 << 3)
 #define CS47L35_EVENT_FLAG_DSP_DECODER                  (1 << 2)
@@ -287,6 +288,8 @@ typedef struct
 
     int32_t ref_src;
     uint32_t ref_freq;
+
+    uint32_t lock_time_ms;          ///< Time taken to lock by the last successful cs47l35_fll_wait_for_lock(), in ms
 } cs47l35_fll_t;
 
 /**
@@ -616,6 +619,11 @@ uint32_t cs47l35_fll_disable(cs47l35_t *driver, uint32_t fll_id);
 /**
  * Wait a short time for the FLL to reach a locked state
  *
+ * In STANDBY, any IRQ that fires while waiting is handled straight away, and the lock status is checked as soon as the
+ * handler reports this FLL's lock event.  Other IRQs do not bring the check forward, and their event flags are still
+ * notified by the next cs47l35_process().  The lock status is also polled every few ms in case the IRQ is not wired
+ * up.  The time taken is stored in the FLL 'lock_time_ms'.
+ *
  * @param [in] driver           Pointer to the driver state
  * @param [in] fll_id           FLL Id to achieve lock
  *
@@ -23,7 +23,9 @@
  * INCLUDES
  **********************************************************************************************************************/
 #include <stddef.h>
+#include <string.h>
 #include "cs47l35_ext.h"
+#include "madera.h"
 #include "bsp_driver_if.h"
 
 /***********************************************************************************************************************
@@ -43,7 +45,8 @@
  **********************************************************************************************************************/
 static uint32_t cs47l35_get_dsp_element_value(cs47l35_t *driver, uint32_t rb_struct_base_addr, dsp_struct_offsets_t offset, uint32_t *value);
 static uint32_t cs47l35_set_dsp_element_value(cs47l35_t *driver, uint32_t rb_struct_base_addr, dsp_struct_offsets_t offset, uint32_t value);
-static void     cs47l35_read_array(const uint8_t *array, uint8_t *target, uint32_t *length);
+static uint32_t cs47l35_dsp_buf_update_space(dsp_buffer_t *buffer);
+static uint32_t cs47l35_dsp_stream_refill(cs47l35_t *driver, dsp_stream_t *stream);
 static void     cs47l35_write_array(cs47l35_t *driver, dsp_buffer_t *buffer, uint32_t addr, uint8_t *data, uint32_t length);
 static uint32_t cs47l35_init_dsp_ringbuf_structure(cs47l35_t *driver, uint32_t rb_struct_base_addr, ring_buffer_struct_t *dsp_buffer, uint32_t xmem_addr);
 
@@ -86,7 +89,7 @@ uint32_t cs47l35_dsp_buf_write(cs47l35_t *driver,
         return CS47L35_STATUS_FAIL;
     }
     // read a portion of data with padding
-    cs47l35_read_array(data, buffer->linear_buf, &data_len);
+    madera_dsp_pack_words(data, buffer->linear_buf, &data_len);
 
     // determine remaining space in buffer
     dsp_avail_wrap = ((buffer->dsp_buf.buffer_size + buffer->dsp_buf.buffer_size / 3) - (buffer->dsp_buf.next_write_index * 4));
@@ -108,6 +111,10 @@ uint32_t cs47l35_dsp_buf_write(cs47l35_t *driver,
         buffer->dsp_buf.next_write_index += (data_len / 4);
     }
 
+    /*
+     * Publish next_write_index before acking - irq_ack sits before it in the ring buffer struct, so a block write would
+     * let the DSP see the ack with a stale write index and raise the watermark IRQ again
+     */
     ret = cs47l35_set_dsp_element_value(driver, buffer->rb_struct_base_addr, next_write_index, buffer->dsp_buf.next_write_index);
     if (ret)
     {
@@ -132,11 +139,11 @@ uint32_t cs47l35_dsp_buf_write(cs47l35_t *driver,
  * - driver              Pointer to the driver state
  * - buffer              Pointer to dsp ringbuff structure
  * - data                Pointer to array of data bytes to store incoming data
- * - data_len            Number of bytes to read from data array. Should not be longer to avail data in dsp buffer
- *                       or longer than the allocated buffer.
+ * - data_len            Number of bytes to read into data array. Must be a whole number of 3-byte DSP words, and
+ *                       should not be longer than avail data in dsp buffer or longer than the allocated buffer.
  *
  * @return
- * - CS47L35_STATUS_FAIL         Control port activity fails
+ * - CS47L35_STATUS_FAIL         Control port activity fails, or data_len is invalid
  * - CS47L35_STATUS_OK           otherwise
  *
  * @see cs47l35_init_dsp_buffer
@@ -152,7 +159,9 @@ uint32_t cs47l35_dsp_buf_read(cs47l35_t *driver,
     uint32_t dsp_buff_add;
     uint32_t ret;
 
-    if (data_len > buffer->dsp_buf.avail)
+    // Only whole DSP words can be read, as the read index moves a word at a time
+    if ((data_len > buffer->dsp_buf.avail) ||
+        (data_len % CS47L35_DSP_BYTES_PER_WORD))
     {
         return CS47L35_STATUS_FAIL;
     }
@@ -308,7 +317,6 @@ uint32_t cs47l35_dsp_buf_space_avail(cs47l35_t *driver,
                                 dsp_buffer_t *buffer,
                                 uint32_t * space_avail)
 {
-    int32_t size;
     uint32_t ret;
 
     ret = cs47l35_get_dsp_element_value(driver, buffer->rb_struct_base_addr, next_read_index, &buffer->dsp_buf.next_read_index);
@@ -317,21 +325,7 @@ uint32_t cs47l35_dsp_buf_space_avail(cs47l35_t *driver,
         return ret;
     }
 
-    size = (buffer->dsp_buf.next_read_index - buffer->dsp_buf.next_write_index);
-    size *= 3;
-    if (size <= 0)
-    {
-        size = size + (buffer->dsp_buf.buffer_size);
-    }
-    if (size <= 3)
-    {
-        buffer->dsp_buf.avail =  0;
-        *space_avail = buffer->dsp_buf.avail;
-        return CS47L35_STATUS_OK;
-    }
-
-    // maintain minimum 1 3-byte word gap between writeindex and readindex while filling the buffer */
-    buffer->dsp_buf.avail = (size - 3);
+    cs47l35_dsp_buf_update_space(buffer);
     *space_avail = buffer->dsp_buf.avail;
     return CS47L35_STATUS_OK;
 }
@@ -400,10 +394,234 @@ uint32_t cs47l35_dsp_buf_eof(cs47l35_t *driver,
     return ret;
 }
 
+/**
+ * Sample DSP ring buffer telemetry
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - buffer           Pointer to dsp ringbuff structure
+ * - telemetry        Pointer to telemetry to update
+ *
+ * @return
+ * - CS47L35_STATUS_FAIL         Control port activity fails
+ * - CS47L35_STATUS_OK           otherwise
+ *
+ */
+uint32_t cs47l35_dsp_buf_telemetry_sample(cs47l35_t *driver, dsp_buffer_t *buffer, madera_dsp_telemetry_t *telemetry)
+{
+    uint32_t ret;
+
+    ret = madera_dsp_telemetry_sample(REGMAP_GET_CP(driver),
+                                      buffer->rb_struct_base_addr,
+                                      buffer->dsp_buf.buffer_size,
+                                      telemetry);
+    if (ret)
+    {
+        return CS47L35_STATUS_FAIL;
+    }
+
+    return CS47L35_STATUS_OK;
+}
+
+/**
+ * Start feeding a stream to a DSP ring buffer
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - stream           Pointer to stream state
+ * - buffer           Pointer to dsp ringbuff structure, already initialized with cs47l35_dsp_buf_init()
+ * - data             Pointer to stream data, which must remain valid until the stream is done
+ * - data_len         Length of stream data in bytes
+ *
+ * @return
+ * - CS47L35_STATUS_FAIL         Control port activity fails
+ * - CS47L35_STATUS_OK           otherwise
+ *
+ */
+uint32_t cs47l35_dsp_stream_start(cs47l35_t *driver,
+                                  dsp_stream_t *stream,
+                                  dsp_buffer_t *buffer,
+                                  uint8_t *data,
+                                  uint32_t data_len)
+{
+    if ((stream == NULL) || (buffer == NULL) || (data == NULL))
+    {
+        return CS47L35_STATUS_FAIL;
+    }
+
+    memset(stream, 0, sizeof(dsp_stream_t));
+    stream->buffer = buffer;
+    stream->data = data;
+    stream->data_len = data_len;
+
+    return cs47l35_dsp_stream_refill(driver, stream);
+}
+
+/**
+ * Report a high watermark IRQ for a stream
+ *
+ * @param [in]
+ * - stream           Pointer to stream state
+ *
+ */
+void cs47l35_dsp_stream_irq(dsp_stream_t *stream)
+{
+    stream->is_irq_pending = true;
+    stream->stats.irq_count++;
+
+    return;
+}
+
+/**
+ * Refill a stream's DSP ring buffer if a watermark IRQ is pending
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - stream           Pointer to stream state
+ *
+ * @return
+ * - CS47L35_STATUS_FAIL         Control port activity fails, or the DSP reports a ring buffer error
+ * - CS47L35_STATUS_OK           otherwise
+ *
+ */
+uint32_t cs47l35_dsp_stream_process(cs47l35_t *driver, dsp_stream_t *stream)
+{
+    if (!stream->is_irq_pending || stream->is_eof_sent)
+    {
+        return CS47L35_STATUS_OK;
+    }
+
+    stream->is_irq_pending = false;
+
+    return cs47l35_dsp_stream_refill(driver, stream);
+}
+
 /***********************************************************************************************************************
  * LOCAL FUNCTIONS
  **********************************************************************************************************************/
 
+/**
+ * Update available space in dsp ringbuff struct from the cached read and write indexes
+ *
+ * Returns the free space in bytes, including the gap kept between write index and read index.
+ *
+ */
+static uint32_t cs47l35_dsp_buf_update_space(dsp_buffer_t *buffer)
+{
+    int32_t size;
+
+    size = (buffer->dsp_buf.next_read_index - buffer->dsp_buf.next_write_index);
+    size *= 3;
+    if (size <= 0)
+    {
+        size = size + (buffer->dsp_buf.buffer_size);
+    }
+
+    // maintain minimum 1 3-byte word gap between writeindex and readindex while filling the buffer
+    if (size <= 3)
+    {
+        buffer->dsp_buf.avail = 0;
+    }
+    else
+    {
+        buffer->dsp_buf.avail = (size - 3);
+    }
+
+    return (uint32_t) size;
+}
+
+/**
+ * Write as much of the remaining stream as fits in the DSP ring buffer
+ *
+ */
+static uint32_t cs47l35_dsp_stream_refill(cs47l35_t *driver, dsp_stream_t *stream)
+{
+    dsp_buffer_t *buffer = stream->buffer;
+    uint32_t element_values[4];
+    uint32_t fill, remaining, len;
+    uint32_t ret;
+
+    // Get irq_ack, next_write_index, next_read_index and dsp_error in one transaction
+    ret = madera_dsp_get_elements(REGMAP_GET_CP(driver), buffer->rb_struct_base_addr, irq_ack, element_values, 4);
+    if (ret)
+    {
+        return ret;
+    }
+
+    if (element_values[dsp_error - irq_ack])
+    {
+        buffer->dsp_buf.error = element_values[dsp_error - irq_ack];
+        return CS47L35_STATUS_FAIL;
+    }
+
+    buffer->dsp_buf.next_read_index = element_values[next_read_index - irq_ack];
+    fill = buffer->dsp_buf.buffer_size - cs47l35_dsp_buf_update_space(buffer);
+
+    // The priming write from cs47l35_dsp_stream_start() always finds the DSP ring buffer empty
+    if (stream->stats.refill_count > 0)
+    {
+        if (fill == 0)
+        {
+            stream->stats.underrun_count++;
+        }
+        if ((stream->stats.refill_count == 1) || (fill < stream->stats.min_refill_fill))
+        {
+            stream->stats.min_refill_fill = fill;
+        }
+    }
+    stream->stats.last_refill_fill = fill;
+
+    remaining = stream->data_len - stream->data_offset;
+    len = remaining;
+    if (len > buffer->dsp_buf.avail)
+    {
+        len = buffer->dsp_buf.avail;
+    }
+    if (len > buffer->buf_size)
+    {
+        len = buffer->buf_size;
+    }
+    // Only the final write may end part way through a DSP word, otherwise padding would be inserted in the stream
+    if (len < remaining)
+    {
+        len -= len % CS47L35_DSP_BYTES_PER_WORD;
+    }
+
+    if (len > 0)
+    {
+        ret = cs47l35_dsp_buf_write(driver, buffer, (stream->data + stream->data_offset), len);
+        if (ret)
+        {
+            return ret;
+        }
+
+        stream->data_offset += len;
+        stream->stats.bytes_written += len;
+        stream->stats.refill_count++;
+    }
+    else
+    {
+        ret = cs47l35_set_dsp_element_value(driver, buffer->rb_struct_base_addr, irq_ack, CS47L35_DSP_IRQ_ACK_VAL);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+
+    if (stream->data_offset == stream->data_len)
+    {
+        ret = cs47l35_dsp_buf_eof(driver, buffer);
+        if (ret)
+        {
+            return ret;
+        }
+
+        stream->is_eof_sent = true;
+    }
+
+    return CS47L35_STATUS_OK;
+}
+
 /**
  * Initialize each element of dsp ringbuff struct, and communicate values with DSP when needed
  *
@@ -434,42 +652,6 @@ static uint32_t cs47l35_init_dsp_ringbuf_structure(cs47l35_t *driver,
     return CS47L35_STATUS_OK;
 }
 
-/**
- * Read array into target buffer, and add padding for 24bit data on DSP (1 byte of 0s for every 3 bytes of data)
- *
- */
-
-static void cs47l35_read_array(const uint8_t *array, uint8_t *target, uint32_t *length)
-{
-    uint32_t rem;
-    uint32_t j = 0; // keep track of where to put data in target
-    for (uint32_t i = 0; i < *length; i++)
-    {
-        if (i % 3 == 0) // count each 3 bytes to pad with 0s
-        {
-            target[j] = 0x00;
-            j++;
-        }
-        target[j] = array[i];
-        j++;
-    }
-
-    rem = j % 4;
-    if (rem > 0)
-    {
-        uint32_t end_padding_len = 4 - rem;
-        for (uint32_t i = 0; i < end_padding_len; i++)
-        {
-            target[j] = 0x00;
-            j++;
-        }
-    }
-
-    *length = j;
-
-    return;
-}
-
 /**
  * Write array into target buffer, and remove padding
  *
@@ -477,17 +659,10 @@ static void cs47l35_read_array(const uint8_t *array, uint8_t *target, uint32_t *
 
 static void cs47l35_write_array(cs47l35_t *driver, dsp_buffer_t *buffer, uint32_t addr, uint8_t * data, uint32_t length)
 {
-    uint32_t j = 0; // keep track of where to put data in target
     cs47l35_read_block(driver, addr, buffer->linear_buf, length);
-    for (uint32_t i = 0; i < length; i++)
-    {
-        if ((i) % 4 == 0)
-        {
-            continue; // skip padding
-        }
-        data[j] = buffer->linear_buf[i];
-        j++;
-    }
+
+    madera_dsp_unpack_words(buffer->linear_buf, data, &length);
+
     return;
 }
 
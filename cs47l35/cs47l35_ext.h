@@ -31,6 +31,7 @@ extern "C" {
  * INCLUDES
  **********************************************************************************************************************/
 #include "cs47l35.h"
+#include "madera.h"
 
 /***********************************************************************************************************************
  * LITERALS & CONSTANTS
@@ -46,6 +47,7 @@ extern "C" {
 #define CS47L35_DSP_EOF_VAL                       0x1
 #define CS47L35_DSP_ENC_ALGORITHM_STOPPED         0xFF000000
 #define CS47L35_DSP_DEC_ALGORITHM_STOPPED         0x00FF0000
+#define CS47L35_DSP_BYTES_PER_WORD                3
 
 /***********************************************************************************************************************
  * MACROS
@@ -107,6 +109,40 @@ typedef enum
     lower_water_mark,
 }dsp_struct_offsets_t;
 
+/**
+ * Statistics for a stream fed to a DSP ring buffer
+ *
+ * Fill levels are the bytes still queued in the DSP ring buffer when a refill starts, i.e. how much audio was left
+ * when the MCU got around to servicing the watermark IRQ.
+ *
+ * @see cs47l35_dsp_stream_process
+ */
+typedef struct
+{
+    uint32_t irq_count;                 ///< Watermark IRQs reported by cs47l35_dsp_stream_irq()
+    uint32_t refill_count;              ///< Refills written to the DSP ring buffer
+    uint32_t bytes_written;             ///< Total stream bytes written to the DSP ring buffer
+    uint32_t underrun_count;            ///< Refills that found the DSP ring buffer already drained
+    uint32_t last_refill_fill;          ///< Fill level when the most recent refill started
+    uint32_t min_refill_fill;           ///< Lowest fill level seen when a refill started
+} dsp_stream_stats_t;
+
+/**
+ * Data structure for feeding a stream to a DSP ring buffer
+ *
+ * @see cs47l35_dsp_stream_start
+ */
+typedef struct
+{
+    dsp_buffer_t *buffer;               ///< DSP ring buffer being fed
+    uint8_t *data;                      ///< Stream data
+    uint32_t data_len;                  ///< Total length of stream data in bytes
+    uint32_t data_offset;               ///< Offset of next stream byte to write
+    bool is_irq_pending;                ///< (True) a watermark IRQ has not been serviced yet
+    bool is_eof_sent;                   ///< (True) all data written and EOF signalled to the DSP
+    dsp_stream_stats_t stats;           ///< Stream statistics
+} dsp_stream_t;
+
 /***********************************************************************************************************************
  * GLOBAL VARIABLES
  **********************************************************************************************************************/
@@ -145,11 +181,11 @@ uint32_t cs47l35_dsp_buf_write(cs47l35_t *driver, dsp_buffer_t *buffer, uint8_t
  * - driver              Pointer to the driver state
  * - buffer              Pointer to dsp ringbuff structure
  * - data                Pointer to array of data bytes to store incoming data
- * - data_len            Number of bytes to read from data array. Should not be longer to avail data in dsp buffer
- *                       or longer than the allocated buffer.
+ * - data_len            Number of bytes to read into data array. Must be a whole number of 3-byte DSP words, and
+ *                       should not be longer than avail data in dsp buffer or longer than the allocated buffer.
  *
  * @return
- * - CS47L35_STATUS_FAIL         Control port activity fails
+ * - CS47L35_STATUS_FAIL         Control port activity fails, or data_len is invalid
  * - CS47L35_STATUS_OK           otherwise
  *
  * @see cs47l35_init_dsp_buffer
@@ -223,6 +259,79 @@ uint32_t cs47l35_dsp_buf_data_avail(cs47l35_t *driver, dsp_buffer_t *buffer, uin
  */
 uint32_t cs47l35_dsp_buf_eof(cs47l35_t *driver, dsp_buffer_t *buffer);
 
+/**
+ * Sample DSP ring buffer telemetry
+ *
+ * Updates the fill level statistics and error counters with one read of the ring buffer state.  Call once per
+ * telemetry period, after clearing 'telemetry' with madera_dsp_telemetry_reset().
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - buffer           Pointer to dsp ringbuff structure, already initialized with cs47l35_dsp_buf_init()
+ * - telemetry        Pointer to telemetry to update
+ *
+ * @return
+ * - CS47L35_STATUS_FAIL         Control port activity fails
+ * - CS47L35_STATUS_OK           otherwise
+ *
+ */
+uint32_t cs47l35_dsp_buf_telemetry_sample(cs47l35_t *driver, dsp_buffer_t *buffer, madera_dsp_telemetry_t *telemetry);
+
+/**
+ * Start feeding a stream to a DSP ring buffer
+ *
+ * Primes the DSP ring buffer with as much of the stream as fits.  After this, the stream is refilled from
+ * cs47l35_dsp_stream_process() each time the firmware's high watermark IRQ is reported with cs47l35_dsp_stream_irq().
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - stream           Pointer to stream state
+ * - buffer           Pointer to dsp ringbuff structure, already initialized with cs47l35_dsp_buf_init()
+ * - data             Pointer to stream data, which must remain valid until the stream is done
+ * - data_len         Length of stream data in bytes
+ *
+ * @return
+ * - CS47L35_STATUS_FAIL         Control port activity fails
+ * - CS47L35_STATUS_OK           otherwise
+ *
+ * @see cs47l35_dsp_stream_irq
+ * @see cs47l35_dsp_stream_process
+ *
+ */
+uint32_t cs47l35_dsp_stream_start(cs47l35_t *driver,
+                                  dsp_stream_t *stream,
+                                  dsp_buffer_t *buffer,
+                                  uint8_t *data,
+                                  uint32_t data_len);
+
+/**
+ * Report a high watermark IRQ for a stream
+ *
+ * Only marks the stream as needing a refill, so it is safe to call from the driver notification callback.
+ *
+ * @param [in]
+ * - stream           Pointer to stream state
+ *
+ */
+void cs47l35_dsp_stream_irq(dsp_stream_t *stream);
+
+/**
+ * Refill a stream's DSP ring buffer if a watermark IRQ is pending
+ *
+ * Each refill is one block read of the ring buffer state, then the largest write that fits in the free space, then
+ * one block write to update the write index and ack the IRQ.  Once all data is written, EOF is signalled to the DSP.
+ *
+ * @param [in]
+ * - driver           Pointer to the driver state
+ * - stream           Pointer to stream state
+ *
+ * @return
+ * - CS47L35_STATUS_FAIL         Control port activity fails, or the DSP reports a ring buffer error
+ * - CS47L35_STATUS_OK           otherwise
+ *
+ */
+uint32_t cs47l35_dsp_stream_process(cs47l35_t *driver, dsp_stream_t *stream);
+
 /***********************************************************************************************************************
  * LOCAL FUNCTIONS
  **********************************************************************************************************************/
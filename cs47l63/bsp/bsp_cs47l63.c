@@ -39,11 +39,147 @@
 #define CS47L63_DSP1_CHANNEL1 (0x100)
 #define CS47L63_DSP1_CHANNEL2 (0x101)
 
+#define BSP_FW_IMG_CHUNK_BYTES (1024)   ///< Emulate a system where only 1k fw_img blocks can be processed at a time
+
+/**
+ * @defgroup BSP_USE_CASE_STAGE_
+ * @brief Dependency stages of use case register fields, in power up order
+ *
+ * @{
+ */
+#define BSP_USE_CASE_STAGE_ROUTING              (0)
+#define BSP_USE_CASE_STAGE_SOURCES              (1)
+#define BSP_USE_CASE_STAGE_OUTPUTS              (2)
+#define BSP_USE_CASE_STAGE_UNMUTE               (3)
+/** @} */
+
+#define BSP_DSP_CLK_HZ                          (147456000)
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Use case register fields - index of each field in bsp_use_case_fields and in bsp_use_case_regs_t 'regs'
+ */
+typedef enum
+{
+    BSP_USE_CASE_FIELD_DSP1RX1_SRC = 0,
+    BSP_USE_CASE_FIELD_DSP1RX2_SRC,
+    BSP_USE_CASE_FIELD_OUT1L_SRC1,
+    BSP_USE_CASE_FIELD_OUT1L_SRC2,
+    BSP_USE_CASE_FIELD_TONE1_EN,
+    BSP_USE_CASE_FIELD_OUTPUT_ENABLE,
+    BSP_USE_CASE_FIELD_OUT1L_VOLUME,
+    BSP_USE_CASE_N_FIELDS
+} bsp_use_case_field_id_t;
+
+/**
+ * Codec clocking and register state of a use case
+ */
+typedef struct
+{
+    cs47l63_clock_target_t clocks;              ///< Clocking - FLL1 reference CS47L63_FLL_SRC_NO_INPUT if clocks are off
+    uint32_t regs[BSP_USE_CASE_N_FIELDS];       ///< Target value of each of bsp_use_case_fields
+} bsp_use_case_regs_t;
+
+/**
+ * Firmware download state for one DSP core
+ */
+typedef struct
+{
+    uint32_t dsp_core;                          ///< DSP core number - 1-based
+    const uint8_t *fw_img;                      ///< Start of the fw_img for this core
+    fw_img_boot_state_t boot_state;             ///< fw_img processing state - 'fw_info' is handed to the driver
+    bsp_dsp_boot_stats_t stats;                 ///< Statistics for the last boot
+} bsp_dsp_boot_t;
+
 /***********************************************************************************************************************
  * LOCAL VARIABLES
  **********************************************************************************************************************/
 static cs47l63_t cs47l63_driver;
-static fw_img_boot_state_t boot_state;
+static cs47l63_use_case_t use_case_state;
+
+static bsp_dsp_boot_t dsp_boot[CS47L63_NUM_DSP] =
+{
+    { .dsp_core = 1, .fw_img = cs47l63_fw_img },
+};
+static bsp_dsp_boot_stats_t dsp_boot_total;
+
+static const cs47l63_use_case_field_t bsp_use_case_fields[BSP_USE_CASE_N_FIELDS] =
+{
+    [BSP_USE_CASE_FIELD_DSP1RX1_SRC] =
+        { CS47L63_DSP1RX1_INPUT1,   CS47L63_DSP1RX1_SRC1_MASK,  0,  BSP_USE_CASE_STAGE_ROUTING },
+    [BSP_USE_CASE_FIELD_DSP1RX2_SRC] =
+        { CS47L63_DSP1RX2_INPUT1,   CS47L63_DSP1RX2_SRC1_MASK,  0,  BSP_USE_CASE_STAGE_ROUTING },
+    [BSP_USE_CASE_FIELD_OUT1L_SRC1] =
+        { CS47L63_OUT1L_INPUT1,     CS47L63_OUT1L_SRC1_MASK,    0,  BSP_USE_CASE_STAGE_ROUTING },
+    [BSP_USE_CASE_FIELD_OUT1L_SRC2] =
+        { CS47L63_OUT1L_INPUT2,     CS47L63_OUT1L_SRC1_MASK,    0,  BSP_USE_CASE_STAGE_ROUTING },
+    [BSP_USE_CASE_FIELD_TONE1_EN] =
+        { CS47L63_TONE_GENERATOR1,  CS47L63_TONE1_EN_MASK,      0,  BSP_USE_CASE_STAGE_SOURCES },
+    [BSP_USE_CASE_FIELD_OUTPUT_ENABLE] =
+        { CS47L63_OUTPUT_ENABLE_1,  0xFFFFFFFF,                 0,  BSP_USE_CASE_STAGE_OUTPUTS },
+    [BSP_USE_CASE_FIELD_OUT1L_VOLUME] =
+        { CS47L63_OUT1L_VOLUME_1,   0xFFFFFFFF,                 (CS47L63_OUT_VU | CS47L63_OUT1L_MUTE | 0x60),
+                                                                    BSP_USE_CASE_STAGE_UNMUTE },
+};
+
+static const bsp_use_case_regs_t bsp_use_case_off =
+{
+    .clocks = { .fll_src = CS47L63_FLL_SRC_NO_INPUT },
+    .regs =
+    {
+        [BSP_USE_CASE_FIELD_DSP1RX1_SRC] = 0,
+        [BSP_USE_CASE_FIELD_DSP1RX2_SRC] = 0,
+        [BSP_USE_CASE_FIELD_OUT1L_SRC1] = 0,
+        [BSP_USE_CASE_FIELD_OUT1L_SRC2] = 0,
+        [BSP_USE_CASE_FIELD_TONE1_EN] = 0,
+        [BSP_USE_CASE_FIELD_OUTPUT_ENABLE] = 0,
+        [BSP_USE_CASE_FIELD_OUT1L_VOLUME] = (CS47L63_OUT_VU | CS47L63_OUT1L_MUTE | 0x60),
+    },
+};
+
+static const bsp_use_case_regs_t bsp_use_case_tg_hp =
+{
+    .clocks =
+    {
+        .fll_src = CS47L63_FLL_SRC_MCLK2,
+        .fll_ref_freq = 32768,
+        .sample_rate = 48000,
+    },
+    .regs =
+    {
+        [BSP_USE_CASE_FIELD_DSP1RX1_SRC] = 0,
+        [BSP_USE_CASE_FIELD_DSP1RX2_SRC] = 0,
+        [BSP_USE_CASE_FIELD_OUT1L_SRC1] = CS47L63_SRC_TONE_GENERATOR1,
+        [BSP_USE_CASE_FIELD_OUT1L_SRC2] = 0,
+        [BSP_USE_CASE_FIELD_TONE1_EN] = CS47L63_TONE1_EN,
+        [BSP_USE_CASE_FIELD_OUTPUT_ENABLE] = CS47L63_OUT1L_EN_MASK,
+        [BSP_USE_CASE_FIELD_OUT1L_VOLUME] = (CS47L63_OUT_VU | 0x60),
+    },
+};
+
+static const bsp_use_case_regs_t bsp_use_case_tg_dsp_hp =
+{
+    .clocks =
+    {
+        .fll_src = CS47L63_FLL_SRC_INT_OSC,
+        .fll_ref_freq = 12288000,
+        .sample_rate = 48000,
+        .dsp_clk_hz = BSP_DSP_CLK_HZ,
+    },
+    .regs =
+    {
+        [BSP_USE_CASE_FIELD_DSP1RX1_SRC] = CS47L63_SRC_TONE_GENERATOR1,
+        [BSP_USE_CASE_FIELD_DSP1RX2_SRC] = CS47L63_SRC_TONE_GENERATOR1,
+        [BSP_USE_CASE_FIELD_OUT1L_SRC1] = CS47L63_DSP1_CHANNEL1,
+        [BSP_USE_CASE_FIELD_OUT1L_SRC2] = CS47L63_DSP1_CHANNEL2,
+        [BSP_USE_CASE_FIELD_TONE1_EN] = CS47L63_TONE1_EN,
+        [BSP_USE_CASE_FIELD_OUTPUT_ENABLE] = CS47L63_OUT1L_EN_MASK,
+        [BSP_USE_CASE_FIELD_OUT1L_VOLUME] = (CS47L63_OUT_VU | 0x60),
+    },
+};
 
 static cs47l63_bsp_config_t bsp_config =
 {
@@ -94,6 +230,183 @@ static bridge_device_t device_list[] =
  * LOCAL FUNCTIONS
  **********************************************************************************************************************/
 
+/**
+ * Release a DSP core's firmware, enable its memory and read in the header of its fw_img
+ *
+ */
+static uint32_t bsp_dut_boot_prepare(bsp_dsp_boot_t *boot)
+{
+    fw_img_boot_state_t *boot_state = &boot->boot_state;
+    uint32_t ret;
+
+    // Inform the driver that any current firmware is no longer available by passing a NULL
+    // fw_info pointer to cs47l63_boot
+    ret = cs47l63_boot(&cs47l63_driver, boot->dsp_core, NULL);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    // Free anything malloc'ed in previous boots
+    if (boot_state->fw_info.sym_table)
+        bsp_free(boot_state->fw_info.sym_table);
+    if (boot_state->fw_info.alg_id_list)
+        bsp_free(boot_state->fw_info.alg_id_list);
+    if (boot_state->block_data)
+        bsp_free(boot_state->block_data);
+
+    // Ensure your fw_img_boot_state_t struct is initialised to zero.
+    memset(boot_state, 0, sizeof(fw_img_boot_state_t));
+    memset(&boot->stats, 0, sizeof(bsp_dsp_boot_stats_t));
+
+    ret = cs47l63_power(&cs47l63_driver, boot->dsp_core, CS47L63_POWER_MEM_ENA);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    // Initialise pointer to the currently available fw_img data
+    boot_state->fw_img_blocks = (uint8_t *) boot->fw_img;
+    boot_state->fw_img_blocks_size = BSP_FW_IMG_CHUNK_BYTES;
+
+    // Read in the fw_img header
+    ret = fw_img_read_header(boot_state);
+    if (ret)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    // malloc enough memory to hold the symbol table, using sym_table_size in the previously
+    // read in fw_img header
+    boot_state->fw_info.sym_table = (fw_img_v1_sym_table_t *)bsp_malloc(boot_state->fw_info.header.sym_table_size *
+                                                                    sizeof(fw_img_v1_sym_table_t));
+    if (boot_state->fw_info.sym_table == NULL)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    // malloc enough memory to hold the alg_id list, using the alg_id_list_size in the fw_img header
+    boot_state->fw_info.alg_id_list = (uint32_t *) bsp_malloc(boot_state->fw_info.header.alg_id_list_size *
+                                                              sizeof(uint32_t));
+    if (boot_state->fw_info.alg_id_list == NULL)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    // Finally malloc enough memory to hold the largest data block in the fw_img being processed.
+    // This may have been configured during fw_img creation.
+    // If your control interface has specific memory requirements (dma-able, etc), then this memory
+    // should adhere to them.
+    // From fw_img_v2 forward, the max_block_size is stored in the fw_img header itself
+    boot_state->block_data_size = boot_state->fw_info.header.max_block_size;
+    boot_state->block_data = (uint8_t *) bsp_malloc(boot_state->block_data_size);
+    if (boot_state->block_data == NULL)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    return BSP_STATUS_OK;
+}
+
+/**
+ * Process the rest of a DSP core's fw_img, writing each data block as it becomes ready
+ *
+ */
+static uint32_t bsp_dut_boot_download(bsp_dsp_boot_t *boot)
+{
+    fw_img_boot_state_t *boot_state = &boot->boot_state;
+    const uint8_t *fw_img = boot->fw_img;
+    const uint8_t *fw_img_end = boot->fw_img + FW_IMG_SIZE(boot->fw_img);
+    uint32_t write_size = BSP_FW_IMG_CHUNK_BYTES;
+    uint32_t ret;
+
+    while (fw_img < fw_img_end)
+    {
+        // Start processing the rest of the fw_img
+        ret = fw_img_process(boot_state);
+        if (ret == FW_IMG_STATUS_DATA_READY)
+        {
+            // Data is ready to be sent to the device, so pass it to the driver
+            ret = cs47l63_write_block(&cs47l63_driver, boot_state->block.block_addr,
+                                      boot_state->block_data, boot_state->block.block_size);
+            if (ret == CS47L63_STATUS_FAIL)
+            {
+                return BSP_STATUS_FAIL;
+            }
+
+            boot->stats.block_count++;
+            boot->stats.bytes_written += boot_state->block.block_size;
+
+            // There is still more data in this fw_img block, so don't provide new data
+            continue;
+        }
+        if (ret == FW_IMG_STATUS_FAIL)
+        {
+            return BSP_STATUS_FAIL;
+        }
+
+        // This fw_img block has been processed, so fetch the next block.
+        // In this example, we just increment the pointer.
+        fw_img += write_size;
+
+        if (ret == FW_IMG_STATUS_NODATA)
+        {
+            if (fw_img_end - fw_img < write_size)
+            {
+                write_size = fw_img_end - fw_img;
+            }
+
+            boot_state->fw_img_blocks = (uint8_t *) fw_img;
+            boot_state->fw_img_blocks_size = write_size;
+        }
+    }
+
+    return BSP_STATUS_OK;
+}
+
+/**
+ * Switch the codec to a use case, writing only the registers that differ from the current use case
+ *
+ * Paths are muted and torn down before any clock change that interrupts audio, and built back up once the clock plan
+ * has been applied.  FLL1 is only relocked if the new use case needs a different reference or rate family.
+ *
+ */
+static uint32_t bsp_dut_use_case_switch(const bsp_use_case_regs_t *target)
+{
+    cs47l63_clock_plan_t plan;
+    bool clock_change;
+    uint32_t ret;
+
+    ret = cs47l63_clock_plan(&cs47l63_driver, &target->clocks, &plan);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return BSP_STATUS_FAIL;
+    }
+    clock_change = ((plan.steps & CS47L63_CLOCK_STEPS_STOP_AUDIO) != 0);
+
+    ret = cs47l63_use_case_power_down(&cs47l63_driver,
+                                      &use_case_state,
+                                      clock_change ? bsp_use_case_off.regs : target->regs);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    ret = cs47l63_clock_apply(&cs47l63_driver, &plan);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    ret = cs47l63_use_case_power_up(&cs47l63_driver, &use_case_state, target->regs);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    return BSP_STATUS_OK;
+}
+
 /***********************************************************************************************************************
  * API FUNCTIONS
  **********************************************************************************************************************/
@@ -159,124 +472,94 @@ uint32_t bsp_dut_reset(void)
         return BSP_STATUS_FAIL;
     }
 
+    // Reset returns the use case registers to their defaults, so take a fresh copy for the delta engine
+    ret = cs47l63_use_case_init(&cs47l63_driver, &use_case_state, bsp_use_case_fields, BSP_USE_CASE_N_FIELDS);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return BSP_STATUS_FAIL;
+    }
+
     return BSP_STATUS_OK;
 }
 
 uint32_t bsp_dut_boot(void)
 {
     uint32_t ret;
-    const uint8_t *fw_img;
-    const uint8_t *fw_img_end;
-    uint32_t write_size;
+    uint32_t boot_start_ms = bsp_get_time_ms();
+    uint32_t start_ms;
 
-    fw_img = cs47l63_fw_img;
-    fw_img_end = cs47l63_fw_img + FW_IMG_SIZE(cs47l63_fw_img);
+    memset(&dsp_boot_total, 0, sizeof(bsp_dsp_boot_stats_t));
 
-    // Inform the driver that any current firmware is no longer available by passing a NULL
-    // fw_info pointer to cs47l63_boot
-    ret = cs47l63_boot(&cs47l63_driver, 1, NULL);
-    if (ret != CS47L63_STATUS_OK)
+    // Get every core ready to take its firmware before any download starts
+    for (uint32_t i = 0; i < CS47L63_NUM_DSP; i++)
     {
-        return ret;
-    }
+        start_ms = bsp_get_time_ms();
 
-    // Free anything malloc'ed in previous boots
-    if (boot_state.fw_info.sym_table)
-        bsp_free(boot_state.fw_info.sym_table);
-    if (boot_state.fw_info.alg_id_list)
-        bsp_free(boot_state.fw_info.alg_id_list);
-    if (boot_state.block_data)
-        bsp_free(boot_state.block_data);
+        ret = bsp_dut_boot_prepare(&dsp_boot[i]);
+        if (ret != BSP_STATUS_OK)
+        {
+            return BSP_STATUS_FAIL;
+        }
 
-    // Ensure your fw_img_boot_state_t struct is initialised to zero.
-    memset(&boot_state, 0, sizeof(fw_img_boot_state_t));
+        dsp_boot[i].stats.boot_ms = bsp_get_time_ms() - start_ms;
+    }
 
-    // Emulate a system where only 1k fw_img blocks can be processed at a time
-    write_size = 1024;
+    // Stream every core's fw_img back to back in one pass
+    for (uint32_t i = 0; i < CS47L63_NUM_DSP; i++)
+    {
+        start_ms = bsp_get_time_ms();
 
-    // Initialise pointer to the currently available fw_img data
-    boot_state.fw_img_blocks = (uint8_t *) fw_img;
-    boot_state.fw_img_blocks_size = write_size;
+        ret = bsp_dut_boot_download(&dsp_boot[i]);
+        if (ret != BSP_STATUS_OK)
+        {
+            return BSP_STATUS_FAIL;
+        }
 
-    // Read in the fw_img header
-    ret = fw_img_read_header(&boot_state);
-    if (ret)
-    {
-        return BSP_STATUS_FAIL;
+        dsp_boot[i].stats.boot_ms += bsp_get_time_ms() - start_ms;
+        dsp_boot_total.block_count += dsp_boot[i].stats.block_count;
+        dsp_boot_total.bytes_written += dsp_boot[i].stats.bytes_written;
     }
 
-    // malloc enough memory to hold the symbol table, using sym_table_size in the previously
-    // read in fw_img header
-    boot_state.fw_info.sym_table = (fw_img_v1_sym_table_t *)bsp_malloc(boot_state.fw_info.header.sym_table_size *
-                                                                   sizeof(fw_img_v1_sym_table_t));
-    if (boot_state.fw_info.sym_table == NULL)
+    // fw_img processing is complete, so inform the driver and pass it the fw_info block
+    for (uint32_t i = 0; i < CS47L63_NUM_DSP; i++)
     {
-        return BSP_STATUS_FAIL;
-    }
+        start_ms = bsp_get_time_ms();
 
-    // malloc enough memory to hold the alg_id list, using the alg_id_list_size in the fw_img header
-    boot_state.fw_info.alg_id_list = (uint32_t *) bsp_malloc(boot_state.fw_info.header.alg_id_list_size * sizeof(uint32_t));
-    if (boot_state.fw_info.alg_id_list == NULL)
-    {
-        return BSP_STATUS_FAIL;
-    }
+        ret = cs47l63_boot(&cs47l63_driver, dsp_boot[i].dsp_core, &dsp_boot[i].boot_state.fw_info);
 
-    // Finally malloc enough memory to hold the largest data block in the fw_img being processed.
-    // This may have been configured during fw_img creation.
-    // If your control interface has specific memory requirements (dma-able, etc), then this memory
-    // should adhere to them.
-    // From fw_img_v2 forward, the max_block_size is stored in the fw_img header itself
-    boot_state.block_data_size = boot_state.fw_info.header.max_block_size;
-    boot_state.block_data = (uint8_t *) bsp_malloc(boot_state.block_data_size);
-    if (boot_state.block_data == NULL)
-    {
-        return BSP_STATUS_FAIL;
-    }
+        bsp_free(dsp_boot[i].boot_state.block_data);
+        dsp_boot[i].boot_state.block_data = NULL;
 
-    while (fw_img < fw_img_end)
-    {
-        // Start processing the rest of the fw_img
-        ret = fw_img_process(&boot_state);
-        if (ret == FW_IMG_STATUS_DATA_READY)
-        {
-            // Data is ready to be sent to the device, so pass it to the driver
-            ret = cs47l63_write_block(&cs47l63_driver, boot_state.block.block_addr,
-                                      boot_state.block_data, boot_state.block.block_size);
-            if (ret == CS47L63_STATUS_FAIL)
-            {
-                return BSP_STATUS_FAIL;
-            }
-            // There is still more data in this fw_img block, so don't provide new data
-            continue;
-        }
-        if (ret == FW_IMG_STATUS_FAIL)
+        if (ret != CS47L63_STATUS_OK)
         {
             return BSP_STATUS_FAIL;
         }
 
-        // This fw_img block has been processed, so fetch the next block.
-        // In this example, we just increment the pointer.
-        fw_img += write_size;
-
-        if (ret == FW_IMG_STATUS_NODATA)
-        {
-            if (fw_img_end - fw_img < write_size)
-            {
-                write_size = fw_img_end - fw_img;
-            }
-
-            boot_state.fw_img_blocks = (uint8_t *) fw_img;
-            boot_state.fw_img_blocks_size = write_size;
-        }
+        dsp_boot[i].stats.boot_ms += bsp_get_time_ms() - start_ms;
     }
 
-    // fw_img processing is complete, so inform the driver and pass it the fw_info block
-    ret = cs47l63_boot(&cs47l63_driver, 1, &boot_state.fw_info);
+    dsp_boot_total.boot_ms = bsp_get_time_ms() - boot_start_ms;
 
-    bsp_free(boot_state.block_data);
-    boot_state.block_data = NULL;
+    return BSP_STATUS_OK;
+}
 
-    return ret;
+uint32_t bsp_dut_get_boot_stats(uint32_t dsp_core, bsp_dsp_boot_stats_t *stats)
+{
+    // DSP core 0 gives the totals for the last bsp_dut_boot()
+    if (dsp_core == 0)
+    {
+        *stats = dsp_boot_total;
+    }
+    else if (dsp_core <= CS47L63_NUM_DSP)
+    {
+        *stats = dsp_boot[dsp_core - 1].stats;
+    }
+    else
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    return BSP_STATUS_OK;
 }
 
 uint32_t bsp_dut_use_case(uint32_t use_case)
@@ -285,99 +568,28 @@ uint32_t bsp_dut_use_case(uint32_t use_case)
 
     switch (use_case) {
         case BSP_USE_CASE_TG_HP_EN:
-            cs47l63_update_reg(&cs47l63_driver,
-                               CS47L63_DSP_CLOCK1,
-                               CS47L63_DSP_CLK_FREQ_MASK,
-                               (0x24DD << CS47L63_DSP_CLK_FREQ_SHIFT));
-            ret = cs47l63_fll_config(&cs47l63_driver,
-                                     CS47L63_FLL1,
-                                     CS47L63_FLL_SRC_MCLK2,
-                                     32768,
-                                     49152000);
-            if (ret != CS47L63_STATUS_OK)
-            {
-                return BSP_STATUS_FAIL;
-            }
-            ret = cs47l63_fll_enable(&cs47l63_driver, CS47L63_FLL1);
-            if (ret != CS47L63_STATUS_OK)
-            {
-                return BSP_STATUS_FAIL;
-            }
-            ret = cs47l63_fll_wait_for_lock(&cs47l63_driver, CS47L63_FLL1);
-            if (ret != CS47L63_STATUS_OK)
-            {
-                return BSP_STATUS_FAIL;
-            }
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_SYSTEM_CLOCK1, CS47L63_SYSCLK_EN_MASK, CS47L63_SYSCLK_EN);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_OUT1L_INPUT1, CS47L63_OUT1L_SRC1_MASK, CS47L63_SRC_TONE_GENERATOR1);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_TONE_GENERATOR1, CS47L63_TONE1_EN_MASK, CS47L63_TONE1_EN);
-            cs47l63_write_reg(&cs47l63_driver, CS47L63_OUTPUT_ENABLE_1, CS47L63_OUT1L_EN_MASK);
-            cs47l63_write_reg(&cs47l63_driver, CS47L63_OUT1L_VOLUME_1, CS47L63_OUT_VU | 0x60);
+            ret = bsp_dut_use_case_switch(&bsp_use_case_tg_hp);
             break;
         case BSP_USE_CASE_TG_HP_DIS:
-            cs47l63_write_reg(&cs47l63_driver, CS47L63_OUT1L_VOLUME_1, CS47L63_OUT_VU | CS47L63_OUT1L_MUTE | 0x60);
-            cs47l63_write_reg(&cs47l63_driver, CS47L63_OUTPUT_ENABLE_1, 0);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_TONE_GENERATOR1, CS47L63_TONE1_EN_MASK, 0);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_OUT1L_INPUT1, CS47L63_OUT1L_SRC1_MASK, 0);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_SYSTEM_CLOCK1, CS47L63_SYSCLK_EN_MASK, 0);
-            ret = cs47l63_fll_disable(&cs47l63_driver, CS47L63_FLL1);
-            if (ret != CS47L63_STATUS_OK)
-            {
-                return BSP_STATUS_FAIL;
-            }
+            ret = bsp_dut_use_case_switch(&bsp_use_case_off);
             break;
         case BSP_USE_CASE_DSP_PRELOAD_PT_EN:
-            ret = cs47l63_power(&cs47l63_driver, 1 , CS47L63_POWER_MEM_ENA);
-            bsp_dut_boot();
+            ret = bsp_dut_boot();
             break;
         case BSP_USE_CASE_DSP_PRELOAD_PT_DIS:
             ret = cs47l63_power(&cs47l63_driver, 1 , CS47L63_POWER_MEM_DIS);
             break;
         case BSP_USE_CASE_TG_DSP_HP_EN:
-            cs47l63_update_reg(&cs47l63_driver,
-                               CS47L63_DSP_CLOCK1,
-                               CS47L63_DSP_CLK_FREQ_MASK,
-                               (0x24DD << CS47L63_DSP_CLK_FREQ_SHIFT));
-            ret = cs47l63_fll_config(&cs47l63_driver,
-                                     CS47L63_FLL1,
-                                     CS47L63_FLL_SRC_INT_OSC,
-                                     12288000,
-                                     49152000);
-            if (ret != CS47L63_STATUS_OK)
-            {
-                return BSP_STATUS_FAIL;
-            }
-            ret = cs47l63_fll_enable(&cs47l63_driver, CS47L63_FLL1);
-            if (ret != CS47L63_STATUS_OK)
-            {
-                return BSP_STATUS_FAIL;
-            }
-            ret = cs47l63_fll_wait_for_lock(&cs47l63_driver, CS47L63_FLL1);
-            if (ret != CS47L63_STATUS_OK)
+            ret = bsp_dut_use_case_switch(&bsp_use_case_tg_dsp_hp);
+            if (ret != BSP_STATUS_OK)
             {
                 return BSP_STATUS_FAIL;
             }
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_SYSTEM_CLOCK1, CS47L63_SYSCLK_EN_MASK, CS47L63_SYSCLK_EN);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_DSP1RX1_INPUT1, CS47L63_DSP1RX1_SRC1_MASK, CS47L63_SRC_TONE_GENERATOR1);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_DSP1RX2_INPUT1, CS47L63_DSP1RX2_SRC1_MASK, CS47L63_SRC_TONE_GENERATOR1);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_OUT1L_INPUT1, CS47L63_OUT1L_SRC1_MASK, CS47L63_DSP1_CHANNEL1);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_OUT1L_INPUT2, CS47L63_OUT1L_SRC1_MASK, CS47L63_DSP1_CHANNEL2);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_TONE_GENERATOR1, CS47L63_TONE1_EN_MASK, CS47L63_TONE1_EN);
-            cs47l63_write_reg(&cs47l63_driver, CS47L63_OUTPUT_ENABLE_1, CS47L63_OUT1L_EN_MASK);
-            cs47l63_write_reg(&cs47l63_driver, CS47L63_OUT1L_VOLUME_1, CS47L63_OUT_VU | 0x60);
             ret = cs47l63_power(&cs47l63_driver, 1, CS47L63_POWER_UP);
             break;
         case BSP_USE_CASE_TG_DSP_HP_DIS:
-            cs47l63_write_reg(&cs47l63_driver, CS47L63_OUT1L_VOLUME_1, CS47L63_OUT_VU | CS47L63_OUT1L_MUTE | 0x60);
-            cs47l63_write_reg(&cs47l63_driver, CS47L63_OUTPUT_ENABLE_1, 0);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_TONE_GENERATOR1, CS47L63_TONE1_EN_MASK, 0);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_OUT1L_INPUT1, CS47L63_OUT1L_SRC1_MASK, 0);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_OUT1L_INPUT2, CS47L63_OUT1L_SRC1_MASK, 0);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_DSP1RX1_INPUT1, CS47L63_DSP1RX1_SRC1_MASK, 0);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_DSP1RX2_INPUT1, CS47L63_DSP1RX2_SRC1_MASK, 0);
-            cs47l63_update_reg(&cs47l63_driver, CS47L63_SYSTEM_CLOCK1, CS47L63_SYSCLK_EN_MASK, 0);
-            ret = cs47l63_fll_disable(&cs47l63_driver, CS47L63_FLL1);
-            if (ret != CS47L63_STATUS_OK)
+            ret = bsp_dut_use_case_switch(&bsp_use_case_off);
+            if (ret != BSP_STATUS_OK)
             {
                 return BSP_STATUS_FAIL;
             }
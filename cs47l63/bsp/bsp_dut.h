@@ -30,6 +30,7 @@ extern "C" {
 /***********************************************************************************************************************
  * INCLUDES
  **********************************************************************************************************************/
+#include <stdint.h>
 #include <stdbool.h>
 
 /***********************************************************************************************************************
@@ -53,6 +54,16 @@ extern "C" {
  * ENUMS, STRUCTS, UNIONS, TYPEDEFS
  **********************************************************************************************************************/
 
+/**
+ * Firmware boot statistics, for one DSP core or for all of them
+ */
+typedef struct
+{
+    uint32_t block_count;                       ///< fw_img data blocks written
+    uint32_t bytes_written;                     ///< fw_img data bytes written
+    uint32_t boot_ms;                           ///< Time spent enabling memory, downloading and starting the firmware
+} bsp_dsp_boot_stats_t;
+
 /***********************************************************************************************************************
  * GLOBAL VARIABLES
  **********************************************************************************************************************/
@@ -63,6 +74,7 @@ extern "C" {
 uint32_t bsp_dut_initialize(void);
 uint32_t bsp_dut_reset(void);
 uint32_t bsp_dut_boot(void);
+uint32_t bsp_dut_get_boot_stats(uint32_t dsp_core, bsp_dsp_boot_stats_t *stats);
 uint32_t bsp_dut_use_case(uint32_t use_case);
 uint32_t bsp_dut_process(void);
 
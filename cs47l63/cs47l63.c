@@ -39,6 +39,8 @@
  */
 #define CS47L63_POLL_ACK_CTRL_MS                (10)    ///< Delay in ms between polling ACK controls
 #define CS47L63_POLL_ACK_CTRL_MAX               (10)    ///< Maximum number of times to poll ACK controls
+#define CS47L63_POLL_FLL_LOCK_MS                (2)     ///< Lock status polling period in ms if no IRQ is seen
+#define CS47L63_POLL_FLL_LOCK_TIMEOUT_MS        (300)   ///< Maximum time in ms to wait for FLL lock
 /** @} */
 
 /**
@@ -52,6 +54,15 @@
 #define CS47L63_REGION_LOCK_CODE                (0x0)          ///< A code that will lock a region
 /** @} */
 
+/**
+ * @defgroup CS47L63_REG_SEQUENCE_
+ * @brief Register sequence block write limits
+ *
+ * @{
+ */
+#define CS47L63_REG_SEQUENCE_BLOCK_MAX          (16)    ///< Maximum contiguous registers coalesced into one block write
+/** @} */
+
 /***********************************************************************************************************************
  * ENUMS, STRUCTS, UNIONS, TYPEDEFS
  **********************************************************************************************************************/
@@ -94,6 +105,47 @@ typedef struct
 #define CS47L63_FLL_CONTROL5_OFFS           (0x10)
 #define CS47L63_FLL_CONTROL6_OFFS           (0x14)
 
+/**
+ * FLL configuration, as written to FLL CONTROL2 - CONTROL4
+ */
+typedef struct
+{
+    uint32_t refdiv;
+    uint32_t lockdet_thr;
+    uint32_t n;
+    uint32_t theta;
+    uint32_t lambda;
+    uint32_t gains;
+    uint32_t hp;
+    uint32_t fbdiv;
+} cs47l63_fll_cfg_t;
+
+/**
+ * Precomputed FLL configuration for a reference/output frequency pair
+ */
+typedef struct
+{
+    uint32_t fin;
+    uint32_t fout;
+    cs47l63_fll_cfg_t cfg;
+} cs47l63_fll_table_entry_t;
+
+/**
+ * Clock planner defines
+ */
+#define CS47L63_SYSCLK_SRC_FLL1             (0x4)
+#define CS47L63_SYSCLK_FREQ_98M304          (0x4)   ///< 98.304MHz, or 90.3168MHz with SYSCLK_FRAC set
+#define CS47L63_DSP_CLK_FREQ_UNITS_PER_MHZ  (64)
+
+/**
+ * SAMPLE_RATE_n code for a sample rate
+ */
+typedef struct
+{
+    uint32_t rate;
+    uint32_t code;
+} cs47l63_sample_rate_t;
+
 /***********************************************************************************************************************
  * LOCAL VARIABLES
  **********************************************************************************************************************/
@@ -146,7 +198,9 @@ const irq_reg_t cs47l63_event_data[] =
     { 0x20, CS47L63_DSP1_IRQ0_MASK1_MASK,         CS47L63_EVENT_FLAG_DSP1_IRQ0},    //< CS47L63_IRQ1_EINT_9
     { 0x18, CS47L63_DSP1_WDT_EXPIRE_STS1_MASK,    CS47L63_EVENT_FLAG_WDT_EXPIRE},   //< CS47L63_IRQ1_EINT_7
     { 0x18, CS47L63_DSP1_AHB_SYS_ERR_MASK1_MASK,  CS47L63_EVENT_FLAG_AHB_SYS_ERR},  //< CS47L63_IRQ1_EINT_7
-    { 0x18, CS47L63_DSP1_AHB_PACK_ERR_MASK1_MASK, CS47L63_EVENT_FLAG_AHB_PACK_ERR}  //< CS47L63_IRQ1_EINT_7
+    { 0x18, CS47L63_DSP1_AHB_PACK_ERR_MASK1_MASK, CS47L63_EVENT_FLAG_AHB_PACK_ERR}, //< CS47L63_IRQ1_EINT_7
+    { 0x14, CS47L63_FLL1_LOCK_RISE_MASK1_MASK,    CS47L63_EVENT_FLAG_FLL1_LOCK},    //< CS47L63_IRQ1_EINT_6
+    { 0x14, CS47L63_FLL2_LOCK_RISE_MASK1_MASK,    CS47L63_EVENT_FLAG_FLL2_LOCK}     //< CS47L63_IRQ1_EINT_6
 };
 
 /**
@@ -156,6 +210,70 @@ const irq_reg_t cs47l63_event_data[] =
  */
 #define N_IRQ_REGS  ((sizeof(cs47l63_event_data)) / (sizeof(irq_reg_t)))
 
+/**
+ * Number of EINT registers from CS47L63_IRQ1_EINT_1 to the last register in cs47l63_event_data
+ *
+ * cs47l63_event_handler() fails rather than index past this for an entry beyond CS47L63_IRQ1_EINT_9, so extend the
+ * last register here along with the table.
+ *
+ * @see cs47l63_event_handler
+ */
+#define CS47L63_IRQ_EINT_REGS   (((CS47L63_IRQ1_EINT_9 - CS47L63_IRQ1_EINT_1) / 4) + 1)
+
+/*
+ * Precomputed FLL configurations for common clock plans, checked by cs47l63_fll_do_config() before
+ * falling back to calculation.  Generated by tools/fll_table_generator/fll_table_generator.py - regenerate
+ * rather than editing by hand.  tools/fll_table_check checks every entry bit for bit against cs47l63_fll_calc_cfg().
+ */
+static const cs47l63_fll_table_entry_t cs47l63_fll_table[] = {
+    /*     fin,     fout, { refdiv, lockdet_thr,   n, theta, lambda,  gains, hp, fbdiv } */
+    {    32768, 49152000, {      0,           2, 375,     0,      1, 0x23f0,  0,     4 } },
+    {  1536000, 49152000, {      0,           8,  32,     0,      1, 0x21f0,  1,     1 } },
+    {  3072000, 49152000, {      0,           8,  16,     0,      1, 0x21f0,  1,     1 } },
+    { 11289600, 49152000, {      0,           8,   4,    52,    147, 0x21f0,  3,     1 } },
+    { 12288000, 49152000, {      0,           8,   4,     0,      1, 0x21f0,  1,     1 } },
+    { 24576000, 49152000, {      1,           8,   4,     0,      1, 0x21f0,  1,     1 } },
+    { 49152000, 49152000, {      2,           8,   4,     0,      1, 0x21f0,  1,     1 } },
+    {    32768, 45158400, {      0,           2,   5,   785,   2048, 0x23f0,  3,   256 } },
+    {  1536000, 45158400, {      0,           8,  29,     2,      5, 0x21f0,  3,     1 } },
+    {  3072000, 45158400, {      0,           8,  14,     7,     10, 0x21f0,  3,     1 } },
+    { 11289600, 45158400, {      0,           8,   4,     0,      1, 0x21f0,  1,     1 } },
+    { 12288000, 45158400, {      0,           8,   3,    27,     40, 0x21f0,  3,     1 } },
+    { 24576000, 45158400, {      1,           8,   3,    27,     40, 0x21f0,  3,     1 } },
+    { 49152000, 45158400, {      2,           8,   3,    27,     40, 0x21f0,  3,     1 } },
+};
+
+/**
+ * Number of entries in the precomputed FLL configuration table
+ *
+ * @see cs47l63_fll_do_config
+ */
+#define N_FLL_TABLE_ENTRIES ((sizeof(cs47l63_fll_table)) / (sizeof(cs47l63_fll_table_entry_t)))
+
+/**
+ * Supported sample rates - rates that are multiples of 11.025kHz are in the 44.1kHz family
+ *
+ * @see cs47l63_clock_plan
+ */
+static const cs47l63_sample_rate_t cs47l63_sample_rates[] =
+{
+    {   8000, 0x11 },
+    {  11025, 0x09 },
+    {  12000, 0x01 },
+    {  16000, 0x12 },
+    {  22050, 0x0A },
+    {  24000, 0x02 },
+    {  32000, 0x13 },
+    {  44100, 0x0B },
+    {  48000, 0x03 },
+    {  88200, 0x0C },
+    {  96000, 0x04 },
+    { 176400, 0x0D },
+    { 192000, 0x05 },
+};
+
+#define N_SAMPLE_RATES ((sizeof(cs47l63_sample_rates)) / (sizeof(cs47l63_sample_rate_t)))
+
 /***********************************************************************************************************************
  * LOCAL FUNCTIONS
  **********************************************************************************************************************/
@@ -375,6 +493,9 @@ uint32_t cs47l63_update_reg(cs47l63_t *driver, uint32_t addr, uint32_t mask, uin
 /**
  * Writes the contents of multiple register/memory addresses
  *
+ * Runs of entries at consecutive addresses with no delay between them are written in one block write.  Transaction,
+ * byte, bus time and delay totals are accumulated in the driver 'reg_sequence_stats'.
+ *
  * @param [in] driver           Pointer to the driver state
  * @param [in] reg_sequence     An array of register/address write entries
  * @param [in] length           The length of the array
@@ -384,26 +505,87 @@ uint32_t cs47l63_update_reg(cs47l63_t *driver, uint32_t addr, uint32_t mask, uin
  * - CS47L63_STATUS_OK          otherwise
  *
  */
-uint32_t cs47l63_write_reg_sequence(cs47l63_t *driver, cs47l63_reg_sequence_t *reg_sequence, uint32_t length)
+uint32_t cs47l63_write_reg_sequence(cs47l63_t *driver, const cs47l63_reg_sequence_t *reg_sequence, uint32_t length)
 {
     uint32_t ret = CS47L63_STATUS_FAIL;
-    cs47l63_reg_sequence_t *sequence_entry = reg_sequence;
+    cs47l63_reg_sequence_stats_t *stats = &driver->reg_sequence_stats;
+    uint8_t block[CS47L63_REG_SEQUENCE_BLOCK_MAX * 4];
+    uint32_t index = 0;
+
+    while (index < length)
+    {
+        const cs47l63_reg_sequence_t *sequence_entry = &reg_sequence[index];
+        uint32_t count = 1;
+        uint32_t start_us = 0;
+        uint32_t delay_us;
+        uint32_t delay_ms;
+
+        // Extend the run while the next entry is at the next address and nothing needs a delay in between
+        while ((index + count < length) &&
+               (count < CS47L63_REG_SEQUENCE_BLOCK_MAX) &&
+               (reg_sequence[index + count - 1].delay_us == 0) &&
+               (reg_sequence[index + count].reg_addr == (sequence_entry->reg_addr + (count * 4))))
+        {
+            count++;
+        }
 
-    for (uint32_t index = 0; index < length; ++index)
-    {
-        // Write the next register/address in the sequence
-        ret = cs47l63_write_reg(driver, sequence_entry->reg_addr, sequence_entry->reg_val);
+        if (bsp_driver_if_g->get_time_us != NULL)
+        {
+            start_us = bsp_driver_if_g->get_time_us();
+        }
+
+        if (count == 1)
+        {
+            ret = cs47l63_write_reg(driver, sequence_entry->reg_addr, sequence_entry->reg_val);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                block[(i * 4)] = GET_BYTE_FROM_WORD(sequence_entry[i].reg_val, 3);
+                block[(i * 4) + 1] = GET_BYTE_FROM_WORD(sequence_entry[i].reg_val, 2);
+                block[(i * 4) + 2] = GET_BYTE_FROM_WORD(sequence_entry[i].reg_val, 1);
+                block[(i * 4) + 3] = GET_BYTE_FROM_WORD(sequence_entry[i].reg_val, 0);
+            }
+            ret = cs47l63_write_block(driver, sequence_entry->reg_addr, block, (count * 4));
+        }
         if (ret != CS47L63_STATUS_OK)
         {
             return CS47L63_STATUS_FAIL;
         }
 
-        // Delay if required
-        if (sequence_entry->delay_us > 0)
+        if (bsp_driver_if_g->get_time_us != NULL)
+        {
+            stats->bus_us += bsp_driver_if_g->get_time_us() - start_us;
+        }
+        stats->write_count++;
+        stats->bytes_written += count * 4;
+        index += count;
+
+        /*
+         * Delay if required.  Whole ms go on the BSP timer and the rest on the BSP us delay.  Without a us delay the
+         * rest is rounded up to another ms, rather than treating 'delay_us' as ms.
+         */
+        delay_us = sequence_entry[count - 1].delay_us;
+        delay_ms = delay_us / 1000;
+        if ((delay_us % 1000) != 0)
+        {
+            if ((bsp_driver_if_g->delay_us == NULL) ||
+                (bsp_driver_if_g->delay_us(delay_us % 1000) != BSP_STATUS_OK))
+            {
+                delay_ms++;
+            }
+            else
+            {
+                stats->delay_wait_us += delay_us % 1000;
+            }
+        }
+        if (delay_ms > 0)
         {
-            bsp_driver_if_g->set_timer(sequence_entry->delay_us, NULL, NULL);
+            bsp_driver_if_g->set_timer(delay_ms, NULL, NULL);
+            stats->delay_wait_us += delay_ms * 1000;
         }
-        ++sequence_entry;
+        stats->delay_us += delay_us;
     }
 
     return ret;
@@ -645,31 +827,92 @@ static uint32_t cs47l63_power_mem_dis(cs47l63_t *driver, cs47l63_dsp_t *dsp_info
  */
 static uint32_t cs47l63_event_handler(cs47l63_t *driver)
 {
+    uint32_t eint[CS47L63_IRQ_EINT_REGS] = {0};
+    uint32_t clear[CS47L63_IRQ_EINT_REGS] = {0};
+    bool is_used[CS47L63_IRQ_EINT_REGS] = {false};
+    uint8_t data[CS47L63_IRQ_EINT_REGS * 4];
+    uint32_t start, end, n;
     uint32_t ret;
-    uint32_t temp_reg_val;
-    uint32_t old_reg = 0;
-    uint32_t new_reg;
 
-    driver->event_flags = 0;
     for (uint32_t i = 0; i < N_IRQ_REGS; i++)
     {
-        new_reg = CS47L63_IRQ1_EINT_1 + cs47l63_event_data[i].irq_reg_offset;
-        if (old_reg != new_reg)
+        if ((cs47l63_event_data[i].irq_reg_offset / 4) >= CS47L63_IRQ_EINT_REGS)
         {
-            ret = cs47l63_read_reg(driver, new_reg, &temp_reg_val);
-            if (ret != CS47L63_STATUS_OK)
+            return CS47L63_STATUS_FAIL;
+        }
+
+        is_used[cs47l63_event_data[i].irq_reg_offset / 4] = true;
+    }
+
+    // Read each run of EINT registers that has events in one transaction, skipping the gaps in the register map
+    for (start = 0; start < CS47L63_IRQ_EINT_REGS; start = end)
+    {
+        if (!is_used[start])
+        {
+            end = start + 1;
+            continue;
+        }
+
+        for (end = start + 1; (end < CS47L63_IRQ_EINT_REGS) && is_used[end]; end++)
+        {
+        }
+
+        n = end - start;
+        ret = cs47l63_read_block(driver, CS47L63_IRQ1_EINT_1 + (start * 4), data, n * 4);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
+        }
+
+        for (uint32_t k = 0; k < n; k++)
+        {
+            eint[start + k] = ((uint32_t) data[(k * 4)] << 24) | ((uint32_t) data[(k * 4) + 1] << 16) |
+                              ((uint32_t) data[(k * 4) + 2] << 8) | data[(k * 4) + 3];
+        }
+    }
+
+    // Add to any flags not yet notified, as cs47l63_fll_wait_for_lock() may handle events before cs47l63_process()
+    for (uint32_t i = 0; i < N_IRQ_REGS; i++)
+    {
+        uint32_t reg = cs47l63_event_data[i].irq_reg_offset / 4;
+
+        if (eint[reg] & cs47l63_event_data[i].mask)
+        {
+            driver->event_flags |= cs47l63_event_data[i].event_flag;
+            clear[reg] |= cs47l63_event_data[i].mask;
+        }
+    }
+
+    // Clear every event in a run of registers with one write - writing 0 to the other EINT bits leaves them as they are
+    for (start = 0; start < CS47L63_IRQ_EINT_REGS; start = end)
+    {
+        if (clear[start] == 0)
+        {
+            end = start + 1;
+            continue;
+        }
+
+        n = 0;
+        for (end = start; (end < CS47L63_IRQ_EINT_REGS) && is_used[end]; end++)
+        {
+            if (clear[end] != 0)
             {
-                return CS47L63_STATUS_FAIL;
+                n = end - start + 1;
             }
         }
-        old_reg = new_reg;
 
-        if (temp_reg_val & cs47l63_event_data[i].mask)
+        for (uint32_t k = 0; k < n; k++)
         {
-            driver->event_flags |= cs47l63_event_data[i].event_flag;
-            ret = cs47l63_write_reg(driver,
-                                    CS47L63_IRQ1_EINT_1 + cs47l63_event_data[i].irq_reg_offset,
-                                    cs47l63_event_data[i].mask);
+            data[(k * 4)] = GET_BYTE_FROM_WORD(clear[start + k], 3);
+            data[(k * 4) + 1] = GET_BYTE_FROM_WORD(clear[start + k], 2);
+            data[(k * 4) + 2] = GET_BYTE_FROM_WORD(clear[start + k], 1);
+            data[(k * 4) + 3] = GET_BYTE_FROM_WORD(clear[start + k], 0);
+        }
+
+        ret = cs47l63_write_block(driver, CS47L63_IRQ1_EINT_1 + (start * 4), data, n * 4);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
         }
     }
 
@@ -736,13 +979,26 @@ static uint32_t gcd(uint32_t n1, uint32_t n2)
     return n1;
 }
 
-static uint32_t cs47l63_fll_do_config(cs47l63_t *driver, cs47l63_fll_t *fll)
+static bool cs47l63_fll_find_table_cfg(uint32_t fin, uint32_t fout, cs47l63_fll_cfg_t *cfg)
+{
+    for (uint32_t i = 0; i < N_FLL_TABLE_ENTRIES; i++)
+    {
+        if ((cs47l63_fll_table[i].fin == fin) && (cs47l63_fll_table[i].fout == fout))
+        {
+            *cfg = cs47l63_fll_table[i].cfg;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint32_t cs47l63_fll_calc_cfg(cs47l63_fll_t *fll, cs47l63_fll_cfg_t *cfg)
 {
     int32_t refdiv, fref, fout, lockdet_thr, fllgcd;
     bool frac = false;
     uint32_t fll_n, min_n, max_n, ratio, theta, lambda, hp, fbdiv;
     uint32_t gains, num;
-    uint32_t ret;
     uint32_t fin=fll->ref_freq;
 
     for (refdiv = 0; refdiv < 4; refdiv++)
@@ -834,6 +1090,33 @@ static uint32_t cs47l63_fll_do_config(cs47l63_t *driver, cs47l63_fll_t *fll)
         return CS47L63_STATUS_FAIL;
     }
 
+    cfg->refdiv = refdiv;
+    cfg->lockdet_thr = lockdet_thr;
+    cfg->n = fll_n;
+    cfg->theta = theta;
+    cfg->lambda = lambda;
+    cfg->gains = gains;
+    cfg->hp = hp;
+    cfg->fbdiv = fbdiv;
+
+    return CS47L63_STATUS_OK;
+}
+
+static uint32_t cs47l63_fll_do_config(cs47l63_t *driver, cs47l63_fll_t *fll)
+{
+    cs47l63_fll_cfg_t cfg;
+    uint32_t ret;
+
+    // Common clock plans are precomputed, so no FLL math is needed
+    if (!cs47l63_fll_find_table_cfg(fll->ref_freq, fll->fout, &cfg))
+    {
+        ret = cs47l63_fll_calc_cfg(fll, &cfg);
+        if (ret == CS47L63_STATUS_FAIL)
+        {
+            return ret;
+        }
+    }
+
     // Write lockdet_thr, phasedet, refclk_div, N to CTRL2
     ret = cs47l63_update_reg(driver,
                              fll->base + CS47L63_FLL_CONTROL2_OFFS,
@@ -841,10 +1124,10 @@ static uint32_t cs47l63_fll_do_config(cs47l63_t *driver, cs47l63_fll_t *fll)
                              CS47L63_FLL1_PHASEDET_MASK |
                              CS47L63_FLL1_REFCLK_DIV_MASK |
                              CS47L63_FLL1_N_MASK,
-                             (lockdet_thr << CS47L63_FLL1_LOCKDET_THR_SHIFT) |
+                             (cfg.lockdet_thr << CS47L63_FLL1_LOCKDET_THR_SHIFT) |
                              (1 << CS47L63_FLL1_PHASEDET_SHIFT) |
-                             (refdiv << CS47L63_FLL1_REFCLK_DIV_SHIFT) |
-                             (fll_n << CS47L63_FLL1_N_SHIFT));
+                             (cfg.refdiv << CS47L63_FLL1_REFCLK_DIV_SHIFT) |
+                             (cfg.n << CS47L63_FLL1_N_SHIFT));
     if (ret == CS47L63_STATUS_FAIL)
     {
         return ret;
@@ -853,8 +1136,8 @@ static uint32_t cs47l63_fll_do_config(cs47l63_t *driver, cs47l63_fll_t *fll)
     // Write lambda, theta to CTRL3
     ret = cs47l63_write_reg(driver,
                             fll->base + CS47L63_FLL_CONTROL3_OFFS,
-                            (lambda << CS47L63_FLL1_LAMBDA_SHIFT) |
-                            (theta << CS47L63_FLL1_THETA_SHIFT));
+                            (cfg.lambda << CS47L63_FLL1_LAMBDA_SHIFT) |
+                            (cfg.theta << CS47L63_FLL1_THETA_SHIFT));
     if (ret == CS47L63_STATUS_FAIL)
     {
         return ret;
@@ -866,9 +1149,9 @@ static uint32_t cs47l63_fll_do_config(cs47l63_t *driver, cs47l63_fll_t *fll)
                              (0xffff << CS47L63_FLL1_FD_GAIN_COARSE_SHIFT) |
                              CS47L63_FLL1_HP_MASK |
                              CS47L63_FLL1_FB_DIV_MASK,
-                             (gains << CS47L63_FLL1_FD_GAIN_COARSE_SHIFT) |
-                             (hp << CS47L63_FLL1_HP_SHIFT) |
-                             (fbdiv << CS47L63_FLL1_FB_DIV_SHIFT));
+                             (cfg.gains << CS47L63_FLL1_FD_GAIN_COARSE_SHIFT) |
+                             (cfg.hp << CS47L63_FLL1_HP_SHIFT) |
+                             (cfg.fbdiv << CS47L63_FLL1_FB_DIV_SHIFT));
     if (ret == CS47L63_STATUS_FAIL)
     {
         return ret;
@@ -1024,22 +1307,24 @@ static uint32_t cs47l63_common_patch(cs47l63_t *driver)
 
 static uint32_t cs47l63_otpid_8_patch(cs47l63_t *driver)
 {
-    cs47l63_write_reg(driver, 0x0030, 0x0055);
-    cs47l63_write_reg(driver, 0x0030, 0x00aa);
-    cs47l63_write_reg(driver, 0x0034, 0x0055);
-    cs47l63_write_reg(driver, 0x0034, 0x00aa);
-    cs47l63_write_reg(driver, 0x4d68, 0x1db10000);
-    cs47l63_write_reg(driver, 0x4d70, 0x700249b8);
-    cs47l63_write_reg(driver, 0x24ac, 0x10000);
-    cs47l63_write_reg(driver, 0x24b4, 0x05ff);
-    cs47l63_write_reg(driver, 0x2420, 0x4150415);
-    cs47l63_write_reg(driver, 0x2424, 0x0415);
-    cs47l63_write_reg(driver, 0x0030, 0x00cc);
-    cs47l63_write_reg(driver, 0x0030, 0x0033);
-    cs47l63_write_reg(driver, 0x0034, 0x00cc);
-    cs47l63_write_reg(driver, 0x0034, 0x0033);
+    static const cs47l63_reg_sequence_t patch[] = {
+        { 0x0030, 0x0055,     0 },
+        { 0x0030, 0x00aa,     0 },
+        { 0x0034, 0x0055,     0 },
+        { 0x0034, 0x00aa,     0 },
+        { 0x4d68, 0x1db10000, 0 },
+        { 0x4d70, 0x700249b8, 0 },
+        { 0x24ac, 0x10000,    0 },
+        { 0x24b4, 0x05ff,     0 },
+        { 0x2420, 0x4150415,  0 },
+        { 0x2424, 0x0415,     0 },
+        { 0x0030, 0x00cc,     0 },
+        { 0x0030, 0x0033,     0 },
+        { 0x0034, 0x00cc,     0 },
+        { 0x0034, 0x0033,     0 }
+    };
 
-    return CS47L63_STATUS_OK;
+    return cs47l63_write_reg_sequence(driver, patch, sizeof(patch) / sizeof(cs47l63_reg_sequence_t));
 }
 
 #ifdef CS47L63_ADC_STANDARD_MODE
@@ -1077,6 +1362,119 @@ static uint32_t cs47l63_adc_support_patch(cs47l63_t *driver)
 }
 #endif
 
+/**
+ * Write the fields of a use case that change in one direction
+ *
+ * Stages are walked in power up or power down order.  Within a stage fields are written in table order, and fields
+ * sharing a register are folded into one write, so that cs47l63_write_reg_sequence can merge contiguous registers.
+ *
+ * The highest stage holds the mutes.  If any lower stage field changes, e.g. a mixer source is rerouted, the down pass
+ * also writes the highest stage fields to their 'off_val' so the change is made muted, and the up pass restores them.
+ *
+ */
+static uint32_t cs47l63_use_case_apply(cs47l63_t *driver,
+                                       cs47l63_use_case_t *use_case,
+                                       const uint32_t *target,
+                                       bool power_up)
+{
+    cs47l63_reg_sequence_t sequence[CS47L63_USE_CASE_FIELDS_MAX];
+    const cs47l63_use_case_field_t *fields = use_case->fields;
+    uint32_t length = 0;
+    uint32_t max_stage = 0;
+    bool mute = false;
+
+    for (uint32_t i = 0; i < use_case->n_fields; i++)
+    {
+        if (fields[i].stage > max_stage)
+        {
+            max_stage = fields[i].stage;
+        }
+    }
+
+    // Any change below the mute stage is made with the mute stage off
+    for (uint32_t i = 0; !power_up && (i < use_case->n_fields); i++)
+    {
+        if ((fields[i].stage < max_stage) &&
+            ((use_case->shadow[i] & fields[i].mask) != (target[i] & fields[i].mask)))
+        {
+            mute = true;
+        }
+    }
+
+    for (uint32_t n = 0; n <= max_stage; n++)
+    {
+        uint32_t stage = power_up ? n : (max_stage - n);
+        uint32_t stage_start = length;
+
+        for (uint32_t i = 0; i < use_case->n_fields; i++)
+        {
+            uint32_t val = target[i] & fields[i].mask;
+            uint32_t reg_val;
+            uint32_t j;
+
+            if (mute && (fields[i].stage == max_stage))
+            {
+                val = fields[i].off_val & fields[i].mask;
+            }
+
+            if ((fields[i].stage != stage) || ((use_case->shadow[i] & fields[i].mask) == val))
+            {
+                continue;
+            }
+
+            // Muting/disabling fields are written on the way down, everything else on the way up
+            if (!power_up && (val != (fields[i].off_val & fields[i].mask)))
+            {
+                continue;
+            }
+
+            reg_val = (use_case->shadow[i] & ~fields[i].mask) | val;
+            for (j = 0; j < use_case->n_fields; j++)
+            {
+                if (fields[j].reg == fields[i].reg)
+                {
+                    use_case->shadow[j] = reg_val;
+                }
+            }
+
+            for (j = stage_start; j < length; j++)
+            {
+                if (sequence[j].reg_addr == fields[i].reg)
+                {
+                    break;
+                }
+            }
+            sequence[j].reg_addr = fields[i].reg;
+            sequence[j].reg_val = reg_val;
+            sequence[j].delay_us = 0;
+            if (j == length)
+            {
+                length++;
+            }
+        }
+    }
+
+    if (length == 0)
+    {
+        return CS47L63_STATUS_OK;
+    }
+
+    return cs47l63_write_reg_sequence(driver, sequence, length);
+}
+
+/**
+ * Convert a DSP clock frequency to a DSP_CLK_FREQ value
+ *
+ * @param [in] dsp_clk_hz       DSP clock in Hz
+ *
+ * @return DSP_CLK_FREQ value, rounded to the nearest 1/64MHz
+ *
+ */
+static uint32_t cs47l63_dsp_clk_freq(uint32_t dsp_clk_hz)
+{
+    return (uint32_t) ((((uint64_t) dsp_clk_hz * CS47L63_DSP_CLK_FREQ_UNITS_PER_MHZ) + 500000) / 1000000);
+}
+
 static uint32_t cs47l63_patch(cs47l63_t *driver)
 {
     uint32_t ret;
@@ -1665,34 +2063,365 @@ uint32_t cs47l63_fll_disable(cs47l63_t *driver, uint32_t fll_id)
     return ret;
 }
 
+/**
+ * Handle an IRQ pending during an FLL lock wait, as cs47l63_process() would
+ *
+ * Returns the event flags raised by this IRQ, and leaves all raised flags for cs47l63_process() to notify.
+ *
+ */
+static uint32_t cs47l63_fll_handle_events(void *arg, uint32_t *event_flags)
+{
+    cs47l63_t *driver = arg;
+    uint32_t flags = driver->event_flags;
+    uint32_t ret;
+
+    *event_flags = 0;
+
+    if (driver->mode != CS47L63_MODE_HANDLING_EVENTS)
+    {
+        return CS47L63_STATUS_OK;
+    }
+
+    driver->mode = CS47L63_MODE_HANDLING_CONTROLS;
+
+    // Events are only handled in STANDBY, otherwise the lock status is left to polling
+    if (driver->state != CS47L63_STATE_STANDBY)
+    {
+        return CS47L63_STATUS_OK;
+    }
+
+    driver->event_flags = 0;
+    ret = cs47l63_event_handler(driver);
+    *event_flags = driver->event_flags;
+    driver->event_flags |= flags;
+
+    return ret;
+}
+
 /**
  * Wait a short period for FLL to achieve lock
  *
  */
 uint32_t cs47l63_fll_wait_for_lock(cs47l63_t *driver, uint32_t fll_id)
 {
-    uint32_t ret, i, val=0;
+    uint32_t ret;
+    uint32_t lock_flag;
 
     if (fll_id >= CS47L63_NUM_FLL)
     {
         return CS47L63_STATUS_FAIL;
     }
 
-    for (i = 0; i < 30; i++)
+    lock_flag = (fll_id == CS47L63_FLL1) ? CS47L63_EVENT_FLAG_FLL1_LOCK : CS47L63_EVENT_FLAG_FLL2_LOCK;
+
+    ret = regmap_poll_reg_on_event(REGMAP_GET_CP(driver),
+                                   driver->fll[fll_id].sts_addr,
+                                   driver->fll[fll_id].sts_mask,
+                                   lock_flag,
+                                   &cs47l63_fll_handle_events,
+                                   driver,
+                                   CS47L63_POLL_FLL_LOCK_MS,
+                                   CS47L63_POLL_FLL_LOCK_TIMEOUT_MS,
+                                   &driver->fll[fll_id].lock_time_ms);
+    if (ret)
     {
-        ret = cs47l63_read_reg(driver, driver->fll[fll_id].sts_addr, &val);
+        return CS47L63_STATUS_FAIL;
+    }
+
+    return CS47L63_STATUS_OK;
+}
+
+/**
+ * Initialize use case delta engine state
+ *
+ */
+uint32_t cs47l63_use_case_init(cs47l63_t *driver,
+                               cs47l63_use_case_t *use_case,
+                               const cs47l63_use_case_field_t *fields,
+                               uint32_t n_fields)
+{
+    uint32_t ret;
+
+    if ((fields == NULL) || (n_fields > CS47L63_USE_CASE_FIELDS_MAX))
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    use_case->fields = fields;
+    use_case->n_fields = n_fields;
+
+    for (uint32_t i = 0; i < n_fields; i++)
+    {
+        ret = cs47l63_read_reg(driver, fields[i].reg, &(use_case->shadow[i]));
         if (ret != CS47L63_STATUS_OK)
         {
-            return ret;
+            return CS47L63_STATUS_FAIL;
         }
+    }
+
+    return CS47L63_STATUS_OK;
+}
+
+/**
+ * Apply the fields of a target use case that are muting or disabling
+ *
+ */
+uint32_t cs47l63_use_case_power_down(cs47l63_t *driver, cs47l63_use_case_t *use_case, const uint32_t *target)
+{
+    return cs47l63_use_case_apply(driver, use_case, target, false);
+}
 
-        if (val & driver->fll[fll_id].sts_mask)
+/**
+ * Apply the remaining fields of a target use case
+ *
+ */
+uint32_t cs47l63_use_case_power_up(cs47l63_t *driver, cs47l63_use_case_t *use_case, const uint32_t *target)
+{
+    return cs47l63_use_case_apply(driver, use_case, target, true);
+}
+
+/**
+ * Compute the clock changes needed to reach a target clocking
+ *
+ */
+uint32_t cs47l63_clock_plan(cs47l63_t *driver, const cs47l63_clock_target_t *target, cs47l63_clock_plan_t *plan)
+{
+    cs47l63_fll_t *fll = &driver->fll[CS47L63_FLL1];
+    bool clocks_on = (target->fll_src != CS47L63_FLL_SRC_NO_INPUT);
+    uint32_t sysclk_val;
+    uint32_t ret;
+    uint32_t i;
+
+    memset(plan, 0, sizeof(cs47l63_clock_plan_t));
+    plan->fll_src = target->fll_src;
+    plan->fll_ref_freq = target->fll_ref_freq;
+
+    if (target->dsp_clk_hz > CS47L63_DSP_CLK_HZ_MAX)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    ret = cs47l63_read_reg(driver, CS47L63_SYSTEM_CLOCK1, &(plan->system_clock1));
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    ret = cs47l63_read_reg(driver, CS47L63_SAMPLE_RATE1, &(plan->sample_rate1));
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    ret = cs47l63_read_reg(driver, CS47L63_DSP_CLOCK1, &(plan->dsp_clock1));
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    // Everything stops with the FLL, and is picked up again by the next plan that restarts it
+    if (!clocks_on)
+    {
+        plan->system_clock1_target = plan->system_clock1 & ~CS47L63_SYSCLK_EN_MASK;
+        if (plan->system_clock1 & CS47L63_SYSCLK_EN_MASK)
         {
-            return CS47L63_STATUS_OK;
+            plan->steps |= CS47L63_CLOCK_STEP_SYSCLK_DIS;
         }
-        bsp_driver_if_g->set_timer(10, NULL, NULL);
+        if (fll->is_enabled)
+        {
+            plan->steps |= CS47L63_CLOCK_STEP_FLL_DIS;
+        }
+
+        return CS47L63_STATUS_OK;
     }
-    return CS47L63_STATUS_FAIL;
+
+    for (i = 0; i < N_SAMPLE_RATES; i++)
+    {
+        if (cs47l63_sample_rates[i].rate == target->sample_rate)
+        {
+            break;
+        }
+    }
+    if (i == N_SAMPLE_RATES)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    if ((target->sample_rate % 11025) == 0)
+    {
+        plan->fll_fout = CS47L63_FLL1_FOUT_44K1;
+        sysclk_val = CS47L63_SYSCLK_FRAC;
+    }
+    else
+    {
+        plan->fll_fout = CS47L63_FLL1_FOUT_48K;
+        sysclk_val = 0;
+    }
+    sysclk_val |= (CS47L63_SYSCLK_FREQ_98M304 << CS47L63_SYSCLK_FREQ_SHIFT) | CS47L63_SYSCLK_EN |
+                  (CS47L63_SYSCLK_SRC_FLL1 << CS47L63_SYSCLK_SRC_SHIFT);
+    plan->system_clock1_target = (plan->system_clock1 &
+                                  ~(CS47L63_SYSCLK_FRAC_MASK | CS47L63_SYSCLK_FREQ_MASK | CS47L63_SYSCLK_EN_MASK |
+                                    CS47L63_SYSCLK_SRC_MASK)) | sysclk_val;
+
+    // A running FLL that already gives the target family is left alone
+    if (!fll->is_enabled ||
+        (fll->ref_src != target->fll_src) ||
+        (fll->ref_freq != target->fll_ref_freq) ||
+        (fll->fout != plan->fll_fout))
+    {
+        if (fll->is_enabled)
+        {
+            plan->steps |= CS47L63_CLOCK_STEP_FLL_DIS;
+        }
+        plan->steps |= CS47L63_CLOCK_STEP_FLL_LOCK;
+    }
+
+    if (plan->system_clock1 != plan->system_clock1_target)
+    {
+        plan->steps |= CS47L63_CLOCK_STEP_SYSCLK;
+    }
+
+    // SYSCLK must be stopped while its source relocks or its family changes
+    if ((plan->system_clock1 & CS47L63_SYSCLK_EN_MASK) &&
+        ((plan->steps & CS47L63_CLOCK_STEP_FLL_LOCK) ||
+         ((plan->system_clock1 ^ plan->system_clock1_target) & ~CS47L63_SYSCLK_EN_MASK)))
+    {
+        plan->steps |= CS47L63_CLOCK_STEP_SYSCLK_DIS | CS47L63_CLOCK_STEP_SYSCLK;
+    }
+
+    if ((plan->sample_rate1 & CS47L63_SAMPLE_RATE_1_MASK) != cs47l63_sample_rates[i].code)
+    {
+        plan->sample_rate1 = (plan->sample_rate1 & ~CS47L63_SAMPLE_RATE_1_MASK) | cs47l63_sample_rates[i].code;
+        plan->steps |= CS47L63_CLOCK_STEP_SAMPLE_RATE;
+    }
+
+    if (target->dsp_clk_hz)
+    {
+        uint32_t dsp_clk_freq = cs47l63_dsp_clk_freq(target->dsp_clk_hz);
+
+        if (((plan->dsp_clock1 & CS47L63_DSP_CLK_FREQ_MASK) >> CS47L63_DSP_CLK_FREQ_SHIFT) != dsp_clk_freq)
+        {
+            plan->dsp_clock1 = (plan->dsp_clock1 & ~CS47L63_DSP_CLK_FREQ_MASK) |
+                               (dsp_clk_freq << CS47L63_DSP_CLK_FREQ_SHIFT);
+            plan->steps |= CS47L63_CLOCK_STEP_DSP_CLK;
+        }
+    }
+
+    return CS47L63_STATUS_OK;
+}
+
+/**
+ * Apply a clock plan
+ *
+ */
+uint32_t cs47l63_clock_apply(cs47l63_t *driver, const cs47l63_clock_plan_t *plan)
+{
+    uint32_t ret;
+
+    if (plan->steps & CS47L63_CLOCK_STEP_SYSCLK_DIS)
+    {
+        ret = cs47l63_write_reg(driver, CS47L63_SYSTEM_CLOCK1, plan->system_clock1 & ~CS47L63_SYSCLK_EN_MASK);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
+        }
+    }
+
+    if (plan->steps & CS47L63_CLOCK_STEP_FLL_DIS)
+    {
+        ret = cs47l63_fll_disable(driver, CS47L63_FLL1);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
+        }
+    }
+
+    if (plan->steps & CS47L63_CLOCK_STEP_FLL_LOCK)
+    {
+        ret = cs47l63_fll_config(driver, CS47L63_FLL1, plan->fll_src, plan->fll_ref_freq, plan->fll_fout);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
+        }
+
+        ret = cs47l63_fll_enable(driver, CS47L63_FLL1);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
+        }
+
+        ret = cs47l63_fll_wait_for_lock(driver, CS47L63_FLL1);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
+        }
+    }
+
+    if (plan->steps & CS47L63_CLOCK_STEP_SAMPLE_RATE)
+    {
+        ret = cs47l63_write_reg(driver, CS47L63_SAMPLE_RATE1, plan->sample_rate1);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
+        }
+    }
+
+    if (plan->steps & CS47L63_CLOCK_STEP_DSP_CLK)
+    {
+        ret = cs47l63_write_reg(driver, CS47L63_DSP_CLOCK1, plan->dsp_clock1);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
+        }
+    }
+
+    if (plan->steps & CS47L63_CLOCK_STEP_SYSCLK)
+    {
+        ret = cs47l63_write_reg(driver, CS47L63_SYSTEM_CLOCK1, plan->system_clock1_target);
+        if (ret != CS47L63_STATUS_OK)
+        {
+            return CS47L63_STATUS_FAIL;
+        }
+    }
+
+    return CS47L63_STATUS_OK;
+}
+
+/**
+ * Change the DSP clock frequency
+ *
+ */
+uint32_t cs47l63_set_dsp_clk(cs47l63_t *driver, uint32_t dsp_core, uint32_t dsp_clk_hz)
+{
+    uint32_t dsp_clk_freq = cs47l63_dsp_clk_freq(dsp_clk_hz);
+    uint32_t ret;
+
+    if ((dsp_core == 0) || (dsp_core > CS47L63_NUM_DSP) || (dsp_clk_hz == 0) ||
+        (dsp_clk_hz > CS47L63_DSP_CLK_HZ_MAX))
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    ret = cs47l63_update_reg(driver,
+                             CS47L63_DSP_CLOCK1,
+                             CS47L63_DSP_CLK_FREQ_MASK,
+                             dsp_clk_freq << CS47L63_DSP_CLK_FREQ_SHIFT);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    // Tell the firmware, as cs47l63_power_up does when the core starts
+    ret = cs47l63_update_reg(driver,
+                             driver->dsp_info[dsp_core - 1].base_addr + CS47L63_DSP_OFF_CLOCK_FREQ,
+                             CS47L63_DSP1_CLK_FREQ_SEL_MASK,
+                             dsp_clk_freq);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    return CS47L63_STATUS_OK;
 }
 
 /*!
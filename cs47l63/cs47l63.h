@@ -122,6 +122,8 @@ extern "C" {
 #define CS47L63_EVENT_FLAG_WDT_EXPIRE                   (1 << 6)
 #define CS47L63_EVENT_FLAG_AHB_SYS_ERR                  (1 << 7)
 #define CS47L63_EVENT_FLAG_AHB_PACK_ERR                 (1 << 8)
+#define CS47L63_EVENT_FLAG_FLL1_LOCK                    (1 << 9)
+#define CS47L63_EVENT_FLAG_FLL2_LOCK                    (1 << 10)
 /** @} */
 
 #define CS47L63_NUM_DSP                                 (1)
@@ -149,6 +151,40 @@ extern "C" {
 #define CS47L63_FLL_SRC_ASP2_BCLK       (0x9)
 /** @} */
 
+#define CS47L63_USE_CASE_FIELDS_MAX     (16)    ///< Maximum register fields managed by a cs47l63_use_case_t
+
+/**
+ * @brief FLL1 output frequency for each sample rate family
+ *
+ * @{
+ */
+#define CS47L63_FLL1_FOUT_48K           (49152000)
+#define CS47L63_FLL1_FOUT_44K1          (45158400)
+/** @} */
+
+#define CS47L63_DSP_CLK_HZ_MAX          (150000000) ///< Highest DSP_CLK_FREQ that can be requested
+
+/**
+ * @defgroup CS47L63_CLOCK_STEP_
+ * @brief Steps of a clock plan, in the order cs47l63_clock_apply performs them
+ *
+ * @see cs47l63_clock_plan_t member steps
+ *
+ * @{
+ */
+#define CS47L63_CLOCK_STEP_SYSCLK_DIS   (1 << 0)    ///< Stop SYSCLK before its source or family changes
+#define CS47L63_CLOCK_STEP_FLL_DIS      (1 << 1)    ///< Disable FLL1
+#define CS47L63_CLOCK_STEP_FLL_LOCK     (1 << 2)    ///< Configure and enable FLL1, and wait for lock
+#define CS47L63_CLOCK_STEP_SAMPLE_RATE  (1 << 3)    ///< Write SAMPLE_RATE_1
+#define CS47L63_CLOCK_STEP_DSP_CLK      (1 << 4)    ///< Write DSP_CLK_FREQ
+#define CS47L63_CLOCK_STEP_SYSCLK       (1 << 5)    ///< Write SYSCLK_FRAC and restart SYSCLK
+/** @} */
+
+/**
+ * Clock plan steps that interrupt audio - paths should be torn down before applying a plan that has any of these
+ */
+#define CS47L63_CLOCK_STEPS_STOP_AUDIO  (CS47L63_CLOCK_STEP_SYSCLK_DIS | CS47L63_CLOCK_STEP_SAMPLE_RATE)
+
 /***********************************************************************************************************************
  * MACROS
  **********************************************************************************************************************/
@@ -283,8 +319,77 @@ typedef struct
 
     bool is_enabled;
     bool is_hold;
+
+    uint32_t lock_time_ms;          ///< Time taken to lock by the last successful cs47l63_fll_wait_for_lock(), in ms
 } cs47l63_fll_t;
 
+/**
+ * Register field managed by the use case delta engine
+ *
+ * @see cs47l63_use_case_power_down
+ * @see cs47l63_use_case_power_up
+ */
+typedef struct
+{
+    uint32_t reg;                               ///< Register address
+    uint32_t mask;                              ///< Field mask within the register
+    uint32_t off_val;                           ///< Field value when muted or disabled
+    uint32_t stage;                             ///< Dependency stage - lower stages power up first and power down last
+} cs47l63_use_case_field_t;
+
+/**
+ * Use case delta engine state
+ */
+typedef struct
+{
+    const cs47l63_use_case_field_t *fields;     ///< Managed register fields
+    uint32_t n_fields;                          ///< Number of entries in 'fields'
+    uint32_t shadow[CS47L63_USE_CASE_FIELDS_MAX];   ///< Current value of the register containing each field
+} cs47l63_use_case_t;
+
+/**
+ * Target clocking, as passed to cs47l63_clock_plan
+ *
+ * SYSCLK is always sourced from FLL1, with FLL1 locked to CS47L63_FLL1_FOUT_48K or CS47L63_FLL1_FOUT_44K1 depending on
+ * the family of 'sample_rate'.
+ */
+typedef struct
+{
+    uint32_t fll_src;               ///< FLL1 reference source - CS47L63_FLL_SRC_NO_INPUT to stop SYSCLK and FLL1
+    uint32_t fll_ref_freq;          ///< FLL1 reference frequency in Hz
+    uint32_t sample_rate;           ///< SAMPLE_RATE_1 in Hz
+    uint32_t dsp_clk_hz;            ///< DSP clock in Hz - 0 leaves DSP_CLK_FREQ as it is
+} cs47l63_clock_target_t;
+
+/**
+ * Clock changes needed to reach a cs47l63_clock_target_t, as computed by cs47l63_clock_plan
+ */
+typedef struct
+{
+    uint32_t steps;                 ///< Steps to perform - @see CS47L63_CLOCK_STEP_
+    uint32_t fll_src;               ///< FLL1 reference source for CS47L63_CLOCK_STEP_FLL_LOCK
+    uint32_t fll_ref_freq;          ///< FLL1 reference frequency for CS47L63_CLOCK_STEP_FLL_LOCK
+    uint32_t fll_fout;              ///< FLL1 output frequency for CS47L63_CLOCK_STEP_FLL_LOCK
+    uint32_t system_clock1;         ///< Current SYSTEM_CLOCK1 value
+    uint32_t system_clock1_target;  ///< SYSTEM_CLOCK1 value once the plan is applied
+    uint32_t sample_rate1;          ///< SAMPLE_RATE1 value for CS47L63_CLOCK_STEP_SAMPLE_RATE
+    uint32_t dsp_clock1;            ///< DSP_CLOCK1 value for CS47L63_CLOCK_STEP_DSP_CLK
+} cs47l63_clock_plan_t;
+
+/**
+ * Register sequence statistics
+ *
+ * Totals accumulated over all register sequences written since cs47l63_initialize.
+ */
+typedef struct
+{
+    uint32_t write_count;                       ///< Control port write transactions issued
+    uint32_t bytes_written;                     ///< Register data bytes written
+    uint32_t bus_us;                            ///< Time spent in control port writes in us - 0 without get_time_us
+    uint32_t delay_us;                          ///< Total delay requested by sequence entries in us
+    uint32_t delay_wait_us;                     ///< Total delay waited in us, including any rounding up to whole ms
+} cs47l63_reg_sequence_stats_t;
+
 /**
  * Driver state data structure
  *
@@ -306,6 +411,8 @@ typedef struct
     cs47l63_dsp_t dsp_info[CS47L63_NUM_DSP];             ///< Current ADSP2 FW/Coefficient boot configuration
 
     cs47l63_fll_t fll[CS47L63_NUM_FLL];                  ///< FLL configurations
+
+    cs47l63_reg_sequence_stats_t reg_sequence_stats;     ///< Register sequence bus and delay totals
 } cs47l63_t;
 
 /**
@@ -620,6 +727,11 @@ uint32_t cs47l63_fll_disable(cs47l63_t *driver, uint32_t fll_id);
 /**
  * Wait a short time for the FLL to reach a locked state
  *
+ * In STANDBY, any IRQ that fires while waiting is handled straight away, and the lock status is checked as soon as the
+ * handler reports CS47L63_EVENT_FLAG_FLL1_LOCK or CS47L63_EVENT_FLAG_FLL2_LOCK for this FLL.  Other IRQs do not bring
+ * the check forward, and their event flags are still notified by the next cs47l63_process().  The lock status is also
+ * polled every few ms in case the IRQ is not wired up.  The time taken is stored in the FLL 'lock_time_ms'.
+ *
  * @param [in] driver           Pointer to the driver state
  * @param [in] fll_id           FLL Id to achieve lock
  *
@@ -630,6 +742,119 @@ uint32_t cs47l63_fll_disable(cs47l63_t *driver, uint32_t fll_id);
  */
 uint32_t cs47l63_fll_wait_for_lock(cs47l63_t *driver, uint32_t fll_id);
 
+/**
+ * Initialize use case delta engine state
+ *
+ * Reads the registers containing 'fields' once, so that use case changes can be applied without read-modify-writes.
+ * Must be called again after anything other than the engine changes these registers, e.g. after cs47l63_reset.
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] use_case         Pointer to use case delta engine state
+ * @param [in] fields           Register fields to manage
+ * @param [in] n_fields         Number of entries in 'fields' - at most CS47L63_USE_CASE_FIELDS_MAX
+ *
+ * @return
+ * - CS47L63_STATUS_FAIL        if 'n_fields' is too large, or if control port activity fails
+ * - CS47L63_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l63_use_case_init(cs47l63_t *driver,
+                               cs47l63_use_case_t *use_case,
+                               const cs47l63_use_case_field_t *fields,
+                               uint32_t n_fields);
+
+/**
+ * Apply the fields of a target use case that are muting or disabling
+ *
+ * Only fields whose target value is their 'off_val' and differs from the current value are written, highest stage
+ * first.  The highest stage is treated as the mute stage: if any field in a lower stage differs from its target value,
+ * e.g. an output mixer is rerouted, the highest stage fields are also written to their 'off_val' and are restored by
+ * cs47l63_use_case_power_up.  Contiguous register writes are merged into block writes.
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] use_case         Pointer to use case delta engine state
+ * @param [in] target           Target value of each field, in field position
+ *
+ * @return
+ * - CS47L63_STATUS_FAIL        if control port activity fails - call cs47l63_use_case_init to resynchronize
+ * - CS47L63_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l63_use_case_power_down(cs47l63_t *driver, cs47l63_use_case_t *use_case, const uint32_t *target);
+
+/**
+ * Apply the remaining fields of a target use case
+ *
+ * Writes every field that differs from its target value, lowest stage first.  Contiguous register writes are merged
+ * into block writes.  Call after cs47l63_use_case_power_down and any clock changes that the new use case needs.
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] use_case         Pointer to use case delta engine state
+ * @param [in] target           Target value of each field, in field position
+ *
+ * @return
+ * - CS47L63_STATUS_FAIL        if control port activity fails - call cs47l63_use_case_init to resynchronize
+ * - CS47L63_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l63_use_case_power_up(cs47l63_t *driver, cs47l63_use_case_t *use_case, const uint32_t *target);
+
+/**
+ * Compute the clock changes needed to reach a target clocking
+ *
+ * Reads the current SYSCLK, sample rate and DSP clock registers and compares them, and the FLL1 state, against
+ * 'target'.  FLL1 is only relocked if it is not already running from the target reference at the target family's
+ * output frequency, and SYSCLK is only stopped if FLL1 is relocked or the rate family changes.
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] target           Pointer to the target clocking
+ * @param [out] plan            Pointer to the clock plan - 'steps' is 0 if the target is already met
+ *
+ * @return
+ * - CS47L63_STATUS_FAIL if:
+ *      - 'sample_rate' is not supported, or 'dsp_clk_hz' is above CS47L63_DSP_CLK_HZ_MAX
+ *      - Control port activity fails
+ * - CS47L63_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l63_clock_plan(cs47l63_t *driver, const cs47l63_clock_target_t *target, cs47l63_clock_plan_t *plan);
+
+/**
+ * Apply a clock plan
+ *
+ * Performs the steps in 'plan' in CS47L63_CLOCK_STEP_ order.  Audio paths should be torn down first if the plan has
+ * any of CS47L63_CLOCK_STEPS_STOP_AUDIO.  CS47L63_CLOCK_STEP_DSP_CLK can be applied while the DSP is running, but only
+ * writes DSP_CLK_FREQ - use cs47l63_set_dsp_clk to also update the clock frequency the firmware reads.
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] plan             Pointer to a clock plan computed by cs47l63_clock_plan
+ *
+ * @return
+ * - CS47L63_STATUS_FAIL        if control port activity fails, or FLL1 fails to lock
+ * - CS47L63_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l63_clock_apply(cs47l63_t *driver, const cs47l63_clock_plan_t *plan);
+
+/**
+ * Change the DSP clock frequency
+ *
+ * Writes DSP_CLK_FREQ, and the DSP core clock frequency register that the firmware reads its clock from.  FLL1 and
+ * SYSCLK are left as they are.
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] dsp_core         Number of the DSP core.  1-based.
+ * @param [in] dsp_clk_hz       DSP clock in Hz
+ *
+ * @return
+ * - CS47L63_STATUS_FAIL if:
+ *      - 'dsp_core' is invalid, or 'dsp_clk_hz' is 0 or above CS47L63_DSP_CLK_HZ_MAX
+ *      - Control port activity fails
+ * - CS47L63_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l63_set_dsp_clk(cs47l63_t *driver, uint32_t dsp_core, uint32_t dsp_clk_hz);
+
 /**********************************************************************************************************************/
 #ifdef __cplusplus
 }
@@ -38,3 +38,107 @@
  * LOCAL FUNCTIONS
  **********************************************************************************************************************/
 
+/**
+ * Get the current firmware load in DSP cycles per second
+ *
+ * @return
+ * - CS47L63_STATUS_FAIL        if control port activity fails
+ * - CS47L63_STATUS_OK          otherwise
+ *
+ */
+static uint32_t cs47l63_dsp_clk_scale_get_load(cs47l63_t *driver, cs47l63_dsp_clk_scale_t *scale, uint32_t *load_hz)
+{
+    uint64_t hz;
+    uint32_t val;
+    uint32_t ret;
+
+    if (scale->get_load_hz != NULL)
+    {
+        return scale->get_load_hz(scale->get_load_arg, load_hz);
+    }
+
+    ret = cs47l63_read_reg(driver, scale->load_addr, &val);
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    if (scale->load_type == CS47L63_DSP_LOAD_PCT)
+    {
+        hz = ((uint64_t) val * dsp_clk_scale_get_hz(&(scale->policy))) / 100;
+    }
+    else
+    {
+        hz = (uint64_t) val * 1000000;
+    }
+
+    // Above 4294 MIPS the load does not fit - saturate rather than wrap to a light load
+    *load_hz = (hz > UINT32_MAX) ? UINT32_MAX : (uint32_t) hz;
+
+    return CS47L63_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Start scaling the DSP clock to the firmware load
+ *
+ */
+uint32_t cs47l63_dsp_clk_scale_init(cs47l63_t *driver,
+                                    cs47l63_dsp_clk_scale_t *scale,
+                                    uint32_t dsp_core,
+                                    uint32_t load_symbol_id,
+                                    uint32_t load_type,
+                                    const dsp_clk_scale_config_t *config)
+{
+    uint32_t ret;
+
+    if ((dsp_core == 0) || (dsp_core > CS47L63_NUM_DSP) || (config->n_levels == 0))
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    ret = dsp_clk_scale_init(&(scale->policy), config, config->n_levels - 1);
+    if (ret != DSP_CLK_SCALE_STATUS_OK)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    scale->dsp_core = dsp_core;
+    scale->load_type = load_type;
+    scale->load_addr = (load_symbol_id == 0) ? 0 : cs47l63_find_symbol(driver, dsp_core, load_symbol_id);
+    scale->get_load_hz = NULL;
+    scale->get_load_arg = NULL;
+    scale->load_hz = 0;
+
+    return cs47l63_set_dsp_clk(driver, dsp_core, dsp_clk_scale_get_hz(&(scale->policy)));
+}
+
+/**
+ * Sample the firmware load and scale the DSP clock to it
+ *
+ */
+uint32_t cs47l63_dsp_clk_scale_process(cs47l63_t *driver, cs47l63_dsp_clk_scale_t *scale)
+{
+    uint32_t ret;
+
+    if ((scale->get_load_hz == NULL) && (scale->load_addr == 0))
+    {
+        return CS47L63_STATUS_OK;
+    }
+
+    ret = cs47l63_dsp_clk_scale_get_load(driver, scale, &(scale->load_hz));
+    if (ret != CS47L63_STATUS_OK)
+    {
+        return CS47L63_STATUS_FAIL;
+    }
+
+    if (!dsp_clk_scale_update(&(scale->policy), scale->load_hz))
+    {
+        return CS47L63_STATUS_OK;
+    }
+
+    return cs47l63_set_dsp_clk(driver, scale->dsp_core, dsp_clk_scale_get_hz(&(scale->policy)));
+}
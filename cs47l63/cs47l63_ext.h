@@ -31,11 +31,24 @@ extern "C" {
  * INCLUDES
  **********************************************************************************************************************/
 #include "cs47l63.h"
+#include "dsp_clk_scale.h"
 
 /***********************************************************************************************************************
  * LITERALS & CONSTANTS
  **********************************************************************************************************************/
 
+/**
+ * @defgroup CS47L63_DSP_LOAD_
+ * @brief How the firmware reports its load
+ *
+ * @see cs47l63_dsp_clk_scale_init
+ *
+ * @{
+ */
+#define CS47L63_DSP_LOAD_MIPS                   (0)     ///< Millions of DSP cycles per second the firmware needs
+#define CS47L63_DSP_LOAD_PCT                    (1)     ///< Percentage of the current DSP clock the firmware uses
+/** @} */
+
 /***********************************************************************************************************************
  * MACROS
  **********************************************************************************************************************/
@@ -44,6 +57,28 @@ extern "C" {
  * ENUMS, STRUCTS, UNIONS, TYPEDEFS
  **********************************************************************************************************************/
 
+/**
+ * DSP clock scaling state
+ */
+typedef struct
+{
+    uint32_t dsp_core;                  ///< DSP core number - 1-based
+    uint32_t load_type;                 ///< How the firmware reports its load - @see CS47L63_DSP_LOAD_
+    uint32_t load_addr;                 ///< Control port address of the firmware load metric - 0 if there is none
+    /**
+     * Optional load source in place of the firmware load metric, e.g. a simulation - NULL to read the firmware
+     *
+     * @param [in] arg          'get_load_arg'
+     * @param [out] load_hz     Load in DSP cycles per second
+     *
+     * @return CS47L63_STATUS_OK, or CS47L63_STATUS_FAIL if there is no load sample
+     */
+    uint32_t (*get_load_hz)(void *arg, uint32_t *load_hz);
+    void *get_load_arg;                 ///< Argument passed to 'get_load_hz'
+    uint32_t load_hz;                   ///< Most recent load sample in Hz
+    dsp_clk_scale_t policy;             ///< Clock scaling policy state
+} cs47l63_dsp_clk_scale_t;
+
 /***********************************************************************************************************************
  * GLOBAL VARIABLES
  **********************************************************************************************************************/
@@ -52,6 +87,50 @@ extern "C" {
  * API FUNCTIONS
  **********************************************************************************************************************/
 
+/**
+ * Start scaling the DSP clock to the firmware load
+ *
+ * Resolves the firmware load metric and switches the DSP to the highest clock in 'config', so that the firmware has
+ * full headroom until the first load sample.  Call after the DSP has been powered up.  'get_load_hz' is cleared, so
+ * set it after this call to take the load from elsewhere.
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] scale            Pointer to DSP clock scaling state
+ * @param [in] dsp_core         Number of the DSP core.  1-based.
+ * @param [in] load_symbol_id   Firmware control holding the load metric - 0, or a symbol the firmware does not have,
+ *                              leaves the clock to 'get_load_hz'
+ * @param [in] load_type        How the firmware reports its load - @see CS47L63_DSP_LOAD_
+ * @param [in] config           Pointer to clock scaling policy configuration
+ *
+ * @return
+ * - CS47L63_STATUS_FAIL        if 'config' is invalid, or if control port activity fails
+ * - CS47L63_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l63_dsp_clk_scale_init(cs47l63_t *driver,
+                                    cs47l63_dsp_clk_scale_t *scale,
+                                    uint32_t dsp_core,
+                                    uint32_t load_symbol_id,
+                                    uint32_t load_type,
+                                    const dsp_clk_scale_config_t *config);
+
+/**
+ * Sample the firmware load and scale the DSP clock to it
+ *
+ * Call periodically while the DSP is running.  The load is taken from 'get_load_hz' if it is set, otherwise from the
+ * firmware load metric.  If there is neither, the DSP clock is left as it is.  A load metric too large to express in
+ * Hz saturates at the largest load, which steps the clock up.
+ *
+ * @param [in] driver           Pointer to the driver state
+ * @param [in] scale            Pointer to DSP clock scaling state
+ *
+ * @return
+ * - CS47L63_STATUS_FAIL        if control port activity fails
+ * - CS47L63_STATUS_OK          otherwise
+ *
+ */
+uint32_t cs47l63_dsp_clk_scale_process(cs47l63_t *driver, cs47l63_dsp_clk_scale_t *scale);
+
 /**********************************************************************************************************************/
 #ifdef __cplusplus
 }
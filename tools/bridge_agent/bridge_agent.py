@@ -26,6 +26,7 @@ import sys
 import socket
 import os
 import signal
+import select
 
 # Bridge to Alt-OS MCU internal message protocol version
 BRIDGE_MCU_MSG_FORMAT = "0.1"
@@ -87,7 +88,9 @@ cmd_mcu_opcodes = {
     "SM"                    :0xd,   # ServiceMessage
     "SA"                    :0xe,   # ServiceAvailable
     "SD"                    :0xf,   # Shutdown
-    "IntBridgeMcuMsgVersion":0x10
+    "IntBridgeMcuMsgVersion":0x10,
+    "IntBridgeBlockFormat"  :0x11,
+    "Batch"                 :0x12
 }
 
 cmds_with_numerical_args = ["R", "Read", "BlockRead", "BR", "W", "Write", "BlockWrite", "BW"]
@@ -95,6 +98,8 @@ cmds_with_numerical_args = ["R", "Read", "BlockRead", "BR", "W", "Write", "Block
 no_arg_abbrv_cmds = ["CD", "IN", "DT", "DV", "DC", "SM", "SA", "SD"]
 
 ERROR_REPLY = "ER"
+WMT_READ_FAILED = "28"
+WMT_UNSUPPORTED = "33"
 DEFAULT_NUM_CHIPS = 1
 
 BRIDGE_STATE_HANDSHAKE_GET_CD                   = 0
@@ -105,11 +110,15 @@ BRIDGE_STATE_HANDSHAKE_INFO                     = 4
 BRIDGE_STATE_HANDSHAKE_WAIT_MCU_REPLY_INFO      = 5
 BRIDGE_STATE_WAIT_CLI_CMD                       = 6
 BRIDGE_STATE_WAIT_MCU_REPLY                     = 7
+BRIDGE_STATE_BLOCK_FORMAT                       = 8
+BRIDGE_STATE_WAIT_BLOCK_FORMAT                  = 9
+BRIDGE_STATE_SEQ_PROBE                          = 10
+BRIDGE_STATE_WAIT_SEQ_PROBE                     = 11
 # States for executing a block-write operation
-BRIDGE_STATE_BW_START                           = 11
-BRIDGE_STATE_BW_CONTINUE                        = 12
-BRIDGE_STATE_BW_END                             = 13
-BRIDGE_STATE_BW_DONE                            = 14
+BRIDGE_STATE_BW_START                           = 12
+BRIDGE_STATE_BW_CONTINUE                        = 13
+BRIDGE_STATE_BW_END                             = 14
+BRIDGE_STATE_BW_DONE                            = 15
 BWs = "BWs"
 BWc = "BWc"
 BWe = "BWe"
@@ -133,6 +142,41 @@ PAYLOAD_BINARY_ENDIANNESS = 'little'
 PAYLOAD_UNPACK_SHORT = "<H"   # Little endian unsigned short
 PAYLOAD_UNPACK_INT   = "<I"   # Little endian unsigned int
 
+# Formats the MCU can send BlockRead data in. Hex is used unless the MCU accepts binary during the handshake, so
+# firmware that does not know the block format command keeps working
+BLOCK_FORMAT_HEX = 0
+BLOCK_FORMAT_BINARY = 1
+block_format_names = {"hex": BLOCK_FORMAT_HEX, "binary": BLOCK_FORMAT_BINARY}
+# A binary BlockRead reply is '$' and a 2-byte data length, or '#' and a 4-byte data length for reads of more than
+# 64kB, then the data and a trailer. The MCU streams the data as it reads it, so the trailer is '!' instead of '\n' if
+# it could not read all of it
+BLOCK_BINARY_MARKER = '$'
+BLOCK_BINARY_LONG_MARKER = '#'
+block_binary_header_lens = {BLOCK_BINARY_MARKER: 3, BLOCK_BINARY_LONG_MARKER: 5}
+BLOCK_BINARY_READ_FAILED = '!'
+BR_MAX_SHORT_READ_LEN = 0xFFFF
+block_format = BLOCK_FORMAT_HEX
+
+# Runs of single register reads and writes that a client sends without waiting for each reply are sent to the MCU
+# as one batch command, of up to BRIDGE_MAX_BATCH_OPS in bridge.h
+BATCH_MAX_OPS = 112
+BATCH_OP_READ = 0
+BATCH_OP_WRITE = 1
+batch_ops = {"RE": BATCH_OP_READ, "WR": BATCH_OP_WRITE}
+
+# Up to a window of commands are sent to the MCU without waiting for the replies to earlier ones. Each has
+# OPCODE_SEQ_FLAG set in its opcode and a sequence number after its last field, and the MCU sends SEQ_TAG and the
+# sequence number before the reply. The MCU drops a message that does not fit in its bridge receive FIFO
+# (USART2_RX_BUFFER_SIZE_BYTES in platform_bsp.c), so commands are only sent while they all fit
+OPCODE_SEQ_FLAG = 0x80
+SEQ_TAG = '@'
+SEQ_NUM_MOD = 0x100
+MCU_RX_FIFO_BYTES = 1024
+DEFAULT_WINDOW = 8
+# A BlockWrite is sent in chunks that each wait for a reply, and a Detect reply changes how later commands are sent,
+# so these are sent with nothing else in flight
+window_barrier_cmds = ["BW", "DT"]
+
 
 # Translation table to go from <name> string from Detect reply to an integer
 class Name_To_Int_Id(object):
@@ -262,7 +306,7 @@ def payload_length_bytes(payload_len):
 # Current Command object
 #=========================================================================
 class current_command(object):
-    recvd_cmd_b = b''   # ToDo could make these instance vars
+    recvd_cmd_b = b''
     seq_num = None
     device_name = ""
     action = ""
@@ -270,16 +314,16 @@ class current_command(object):
     arg2 = None
 
     def get_all_bytes(self):
-        return self.__class__.recvd_cmd_b
+        return self.recvd_cmd_b
 
     def get_all_str(self):
-        return str(self.__class__.recvd_cmd_b, 'UTF-8')
+        return str(self.recvd_cmd_b, 'UTF-8')
 
     def get_action_str(self):
-        return self.__class__.action
+        return self.action
 
     def new_cmd(self, cmd_b):
-        self.__class__.recvd_cmd_b = cmd_b
+        self.recvd_cmd_b = cmd_b
         '''Incoming cmd from client can be of the form
         1. "[<deviceName>:<SeqNum>] Read <reg>" or "[<deviceName>:<SeqNum>] BlockRead <starReg> <numBytes>"
         2. "[<deviceName>:<SeqNum>] Write <reg> <val>" or "[<deviceName>:<SeqNum>] BlockWrite <StartReg> <data>"
@@ -293,41 +337,120 @@ class current_command(object):
         10."ProtocolVersion 105"
         11. "[SeqNum] <command>"
         '''
-        self.__class__.seq_num = None
+        self.seq_num = None
         parts = str(cmd_b, 'UTF-8').split()
         if '[' in parts[0]:
             # Cmd has seq num part
             part1 = parts[0]
             if ':' in part1:
                 # Eg "[CS47L63-1:2] R c08"
-                self.__class__.device_name = part1[1: part1.find(':')]
-                self.__class__.seq_num = part1[part1.find(':') + 1: part1.find(']')]
+                self.device_name = part1[1: part1.find(':')]
+                self.seq_num = part1[part1.find(':') + 1: part1.find(']')]
             else:
                 # Eg "[4] Detect" or "[4]  Read <reg>"
-                self.__class__.device_name = None
-                self.__class__.seq_num = part1[part1.find('[') + 1: part1.find(']')]
+                self.device_name = None
+                self.seq_num = part1[part1.find('[') + 1: part1.find(']')]
             parts.pop(0)
-        self.__class__.action = parts[0]
+        self.action = parts[0]
         if len(parts) == 1:
-            self.__class__.arg1 = None
-            self.__class__.arg2 = None
+            self.arg1 = None
+            self.arg2 = None
         elif len(parts) == 2:
-            self.__class__.arg1 = parts[1]
-            self.__class__.arg2 = None
-            if self.__class__.action in cmds_with_numerical_args:
-                self.__class__.arg1 = str(int(self.__class__.arg1, 16))
+            self.arg1 = parts[1]
+            self.arg2 = None
+            if self.action in cmds_with_numerical_args:
+                self.arg1 = str(int(self.arg1, 16))
         elif len(parts) == 3:
-            self.__class__.arg1 = parts[1]
-            self.__class__.arg2 = parts[2]
-            if self.__class__.action in cmds_with_numerical_args:
-                self.__class__.arg1 = str(int(self.__class__.arg1, 16))
-                self.__class__.arg2 = str(int(self.__class__.arg2, 16))
+            self.arg1 = parts[1]
+            self.arg2 = parts[2]
+            if self.action in cmds_with_numerical_args:
+                self.arg1 = str(int(self.arg1, 16))
+                self.arg2 = str(int(self.arg2, 16))
         else:
             raise bridge_excpn("Unexpected Cmd format received: {}".format(cmd_b))
-        if self.__class__.action not in cmd_mcu_abbreviated:
+        if self.action not in cmd_mcu_abbreviated:
             raise bridge_excpn("Unexpected Cmd action received: {}".format(cmd_b))
 
 
+#==========================================================================
+# Split data from the client into commands
+#=========================================================================
+class client_cmd_splitter(object):
+    def __init__(self):
+        self.rx_b = b''
+
+    def add(self, data_b):
+        # Returns the commands completed by data_b. Data with no '\n' at all is taken as one whole command, as
+        # it was before clients could send several commands at once
+        if not self.rx_b and b'\n' not in data_b:
+            return [data_b] if data_b.strip() else []
+        self.rx_b += data_b
+        lines = self.rx_b.split(b'\n')
+        self.rx_b = lines.pop()
+        return [line + b'\n' for line in lines if line.strip()]
+
+def parse_client_cmds(cmds_b):
+    cmds = []
+    for cmd_b in cmds_b:
+        cmd = current_command()
+        cmd.new_cmd(cmd_b)
+        cmds.append(cmd)
+    return cmds
+
+#==========================================================================
+# Batch runs of single register reads and writes
+#=========================================================================
+def take_batch(pending_cmds):
+    # Returns the run of reads and writes to the same device at the front of pending_cmds, or [] if there are not at
+    # least 2 to batch
+    batch = []
+    for cmd in pending_cmds:
+        if len(batch) == BATCH_MAX_OPS or cmd_mcu_abbreviated[cmd.action] not in batch_ops or \
+                cmd.device_name not in devices or (batch and cmd.device_name != batch[0].device_name):
+            break
+        batch.append(cmd)
+    if len(batch) < 2:
+        return []
+    del pending_cmds[:len(batch)]
+    return batch
+
+def batch_to_binary(batch):
+    bin_payload = bytearray()
+    payload_len = 6 + (9 * len(batch))
+    # Add payload-length field (2 bytes)
+    bin_payload += payload_length_bytes(payload_len)
+    # Add OpCode
+    bin_payload.append(cmd_mcu_opcodes["Batch"])
+    # Batch has ChipId field
+    bin_payload.append(devices[batch[0].device_name]["chip_id"])
+    # Add number of ops (2 bytes)
+    bin_payload += len(batch).to_bytes(2, PAYLOAD_BINARY_ENDIANNESS)
+    # Add each op, its 4-byte address and 4-byte write value (0 for reads)
+    for cmd in batch:
+        bin_payload.append(batch_ops[cmd_mcu_abbreviated[cmd.action]])
+        bin_payload += int(cmd.arg1).to_bytes(4, PAYLOAD_BINARY_ENDIANNESS)
+        write_val = int(cmd.arg2) if cmd.arg2 is not None else 0
+        bin_payload += write_val.to_bytes(4, PAYLOAD_BINARY_ENDIANNESS)
+    return bin_payload
+
+def batch_reply_handler(batch, mcu_reply_str):
+    # Expect MCU reply to be the result of each op, separated by ',': the value read in hex, "Ok", or "ER<N>"
+    if ERROR_REPLY in mcu_reply_str[:len(ERROR_REPLY)] and ' ' in mcu_reply_str:
+        # The whole batch failed, so every command gets the error
+        results = [mcu_reply_str.replace(' ', '')] * len(batch)
+    else:
+        results = mcu_reply_str.split(',')
+    cli_rsp_str = ''
+    for cmd, result in zip(batch, results):
+        if ERROR_REPLY in result[:len(ERROR_REPLY)]:
+            rsp_str = "Error {}\n".format(result[len(ERROR_REPLY):])
+        elif batch_ops[cmd_mcu_abbreviated[cmd.action]] == BATCH_OP_READ:
+            rsp_str = hex(int(result, 16)) + "\n"
+        else:
+            rsp_str = "Ok\n"
+        cli_rsp_str += prepend_seq_num(cmd, rsp_str)
+    return cli_rsp_str
+
 def hexstr_to_decstr(hexstr):
     if hexstr is not None and len(hexstr):
         return str(int(hexstr, 16))
@@ -449,26 +572,30 @@ def send_bw_data_to_mcu_binary(crnt_cmd, chip_id, ser_ch, ch_num, state, verbose
 # Command Handler Function
 #=========================================================================
 
-# Creates binary fields according to cmd type and writes to serial channel
+# Writes cmd to serial channel, in chunks for a block-write
 def client_cmd_handler_binary(crnt_cmd, ser_ch, ch_num, state, verbose, user_num_reg_in_chunk):
-    # Switch on cmd type
-    abbr_action_str = cmd_mcu_abbreviated[crnt_cmd.get_action_str()]
-    if abbr_action_str == "BW":
+    if cmd_mcu_abbreviated[crnt_cmd.get_action_str()] == "BW":
         try:
             send_bw_data_to_mcu_binary(crnt_cmd, devices[crnt_cmd.device_name]["chip_id"],
                                        ser_ch, ch_num, state, verbose, user_num_reg_in_chunk)
         except (blockwrite_chunk_excpn, missing_chip_id_excpn) as bwe:
             print(bwe)
             raise
-    elif abbr_action_str in no_arg_abbrv_cmds:
+    else:
+        ser_ch.write_channel_bytes(ch_num, client_cmd_to_binary(crnt_cmd))
+
+# Creates binary fields according to cmd type, for all but block-writes
+def client_cmd_to_binary(crnt_cmd):
+    # Switch on cmd type
+    abbr_action_str = cmd_mcu_abbreviated[crnt_cmd.get_action_str()]
+    if abbr_action_str in no_arg_abbrv_cmds:
         bin_payload = bytearray()
         payload_len = 3
         # Add payload-length field (2 bytes)
         bin_payload += payload_length_bytes(payload_len)
         # Add OpCode
         bin_payload.append(cmd_mcu_opcodes[abbr_action_str])
-        # Write binary payload to serial channel
-        ser_ch.write_channel_bytes(ch_num, bin_payload)
+        return bin_payload
     elif abbr_action_str == "PV":
         bin_payload = bytearray()
         payload_len = 5
@@ -479,8 +606,7 @@ def client_cmd_handler_binary(crnt_cmd, ser_ch, ch_num, state, verbose, user_num
         # Add version from cmd's first arg. This will be eg "106"
         pv_int = int(crnt_cmd.arg1)
         bin_payload += pv_int.to_bytes(2, PAYLOAD_BINARY_ENDIANNESS)
-        # Write binary payload to serial channel
-        ser_ch.write_channel_bytes(ch_num, bin_payload)
+        return bin_payload
     elif abbr_action_str == "RE":
         bin_payload = bytearray()
         payload_len = 8
@@ -493,8 +619,7 @@ def client_cmd_handler_binary(crnt_cmd, ser_ch, ch_num, state, verbose, user_num
         # Add 4-byte address to read
         read_addr_int = int(crnt_cmd.arg1)
         bin_payload += read_addr_int.to_bytes(4, PAYLOAD_BINARY_ENDIANNESS)
-        # Write binary payload to serial channel
-        ser_ch.write_channel_bytes(ch_num, bin_payload)
+        return bin_payload
     elif abbr_action_str == "WR":
         bin_payload = bytearray()
         payload_len = 12
@@ -510,11 +635,13 @@ def client_cmd_handler_binary(crnt_cmd, ser_ch, ch_num, state, verbose, user_num
         # Add write value
         write_val = int(crnt_cmd.arg2)
         bin_payload += write_val.to_bytes(4, PAYLOAD_BINARY_ENDIANNESS)
-        # Write binary payload to serial channel
-        ser_ch.write_channel_bytes(ch_num, bin_payload)
+        return bin_payload
     elif abbr_action_str == "BR":
         bin_payload = bytearray()
-        payload_len = 10
+        read_len = int(crnt_cmd.arg2)
+        # Number of bytes to read is 2 bytes, or 4 bytes for reads the MCU can only stream
+        read_len_bytes = 2 if read_len <= BR_MAX_SHORT_READ_LEN else 4
+        payload_len = 8 + read_len_bytes
         # Add payload-length field (2 bytes)
         bin_payload += payload_length_bytes(payload_len)
         # Add OpCode
@@ -524,15 +651,59 @@ def client_cmd_handler_binary(crnt_cmd, ser_ch, ch_num, state, verbose, user_num
         # Add 4-byte address to read
         read_addr_int = int(crnt_cmd.arg1)
         bin_payload += read_addr_int.to_bytes(4, PAYLOAD_BINARY_ENDIANNESS)
-        # Add number of bytes to read (2 bytes)
-        read_len = int(crnt_cmd.arg2)
-        bin_payload += read_len.to_bytes(2, PAYLOAD_BINARY_ENDIANNESS)
-        # Write binary payload to serial channel
-        ser_ch.write_channel_bytes(ch_num, bin_payload)
+        # Add number of bytes to read
+        bin_payload += read_len.to_bytes(read_len_bytes, PAYLOAD_BINARY_ENDIANNESS)
+        return bin_payload
     else:
         raise Exception("Unknown abbr_action_str: {}".format(abbr_action_str))
 
 
+def tag_mcu_msg(bin_payload, seq):
+    # Makes bin_payload a sequence-numbered message
+    payload_len = int.from_bytes(bin_payload[:PAYLOAD_BYTE_LENGTH], PAYLOAD_BINARY_ENDIANNESS) + 1
+    bin_payload[:PAYLOAD_BYTE_LENGTH] = payload_length_bytes(payload_len)
+    bin_payload[PAYLOAD_BYTE_LENGTH] |= OPCODE_SEQ_FLAG
+    bin_payload.append(seq)
+
+#==========================================================================
+# Messages to the MCU for client commands
+#=========================================================================
+class mcu_msg(object):
+    # One message to the MCU, for a single client command or a batch of them
+    def __init__(self, cmds, is_batch, bin_payload):
+        self.cmds = cmds
+        self.is_batch = is_batch
+        # None for a block-write, which is sent in chunks
+        self.bin_payload = bin_payload
+        self.seq = None
+        abbr_action_str = cmd_mcu_abbreviated[cmds[0].action]
+        self.is_barrier = abbr_action_str in window_barrier_cmds
+        self.is_block = not is_batch and abbr_action_str == "BR"
+
+    def num_bytes(self):
+        return len(self.bin_payload) if self.bin_payload is not None else 0
+
+def take_mcu_msg(pending_cmds, is_batch_supported, seq):
+    # Takes the batch or single command at the front of pending_cmds and makes its message, sequence-numbered with
+    # seq unless seq is None
+    batch = take_batch(pending_cmds) if is_batch_supported else []
+    if batch:
+        msg = mcu_msg(batch, True, batch_to_binary(batch))
+    else:
+        crnt_cmd = pending_cmds.pop(0)
+        is_bw = cmd_mcu_abbreviated[crnt_cmd.action] == "BW"
+        msg = mcu_msg([crnt_cmd], False, None if is_bw else client_cmd_to_binary(crnt_cmd))
+    if msg.bin_payload is not None and seq is not None:
+        tag_mcu_msg(msg.bin_payload, seq)
+        msg.seq = seq
+    return msg
+
+def can_send_mcu_msg(msg, in_flight, in_flight_bytes, window):
+    if not in_flight:
+        return True
+    return len(in_flight) < window and not msg.is_barrier and not in_flight[-1].is_barrier and \
+        in_flight_bytes + msg.num_bytes() <= MCU_RX_FIFO_BYTES
+
 def new_send_internal_CD_binary(ser_ch, ch_num):
     bin_payload = bytearray()
     payload_len = 3
@@ -541,6 +712,16 @@ def new_send_internal_CD_binary(ser_ch, ch_num):
     bin_payload.append(cmd_mcu_opcodes["CD"])
     ser_ch.write_channel_bytes(ch_num, bin_payload)
 
+def send_internal_seq_probe(ser_ch, ch_num):
+    # A sequence-numbered CD, which older MCU code replies to with an untagged error
+    bin_payload = bytearray()
+    payload_len = 3
+    bin_payload += payload_len.to_bytes(PAYLOAD_BYTE_LENGTH, PAYLOAD_BINARY_ENDIANNESS)
+    # Add OpCode
+    bin_payload.append(cmd_mcu_opcodes["CD"])
+    tag_mcu_msg(bin_payload, 0)
+    ser_ch.write_channel_bytes(ch_num, bin_payload)
+
 def send_internal_bridge_mcu_protocol_version(ser_ch, ch_num):
     bin_payload = bytearray()
     payload_len = 3
@@ -549,6 +730,15 @@ def send_internal_bridge_mcu_protocol_version(ser_ch, ch_num):
     bin_payload.append(cmd_mcu_opcodes["IntBridgeMcuMsgVersion"])
     ser_ch.write_channel_bytes(ch_num, bin_payload)
 
+def send_internal_block_format(ser_ch, ch_num, fmt):
+    bin_payload = bytearray()
+    payload_len = 4
+    bin_payload += payload_len.to_bytes(PAYLOAD_BYTE_LENGTH, PAYLOAD_BINARY_ENDIANNESS)
+    # Add OpCode
+    bin_payload.append(cmd_mcu_opcodes["IntBridgeBlockFormat"])
+    bin_payload.append(fmt)
+    ser_ch.write_channel_bytes(ch_num, bin_payload)
+
 def send_internal_IN_binary(ser_ch, ch_num):
     bin_payload = bytearray()
     payload_len = 3
@@ -640,8 +830,10 @@ def do_reply_handler(current_cmd, mcu_reply_str):
         # response to client format : "[seqNum] Ok"
         cli_rsp_str = "Ok\n"
     elif current_cmd.action == "BR" or current_cmd.action == "BlockRead":
-        # Expect MCU reply to be string of multiple reg read values eg "0048ac40000000a0" No! will ne in decimal?
+        # Expect MCU reply to be string of multiple reg read values eg "0048ac40000000a0", or the same data in binary
         # response to client format : "[seqNum] <regreadvalue>"
+        if mcu_reply_str[:1] in block_binary_header_lens:
+            mcu_reply_str = block_binary_to_hexstr(mcu_reply_str)
         cli_rsp_str = mcu_reply_str + "\n"
 
     elif current_cmd.action == "Info":
@@ -691,6 +883,14 @@ def wait_for_sock_recv(sock):
         print("Socket related error: {}".format(excp))
         raise excp
 
+def is_sock_readable(sock):
+    try:
+        readable, _, _ = select.select([sock], [], [], 0)
+        return bool(readable)
+    except OSError as excp:
+        print("Socket related error: {}".format(excp))
+        raise excp
+
 def wait_for_serial_data(ser_ch, ch_num):
     # smcio read is non-blocking so loop read until we read a full string
     data_str = ""
@@ -701,9 +901,80 @@ def wait_for_serial_data(ser_ch, ch_num):
         data_str = data_str + data_tmp
     return data_str
 
+def binary_reply_len(data_str):
+    # Length of a complete binary reply including its trailer, or None if the header has not arrived yet
+    header_len = block_binary_header_lens[data_str[0]]
+    if len(data_str) < header_len:
+        return None
+    data_len = int.from_bytes(data_str[1:header_len].encode('latin-1'), PAYLOAD_BINARY_ENDIANNESS)
+    return header_len + data_len + 1
 
-def inner_loop(sock, ser_ch, ch_num, state, crnt_cmd, verbose, user_num_reg_in_chunk):
-    global wisce_device_id
+#==========================================================================
+# Split data from the MCU into replies
+#=========================================================================
+class mcu_reply_reader(object):
+    # Replies to commands in flight can arrive together, so data after a reply is kept for the next one
+    def __init__(self, ser_ch, ch_num):
+        self.ser_ch = ser_ch
+        self.ch_num = ch_num
+        self.rx_str = ''
+
+    def reply_len(self, start, is_block):
+        # Length of the reply at rx_str[start:], or None if not known yet. Binary data may contain '\n', so a
+        # binary BlockRead reply is read by its length. Error replies are still strings.
+        if is_block and self.rx_str[start:start + 1] in block_binary_header_lens:
+            return binary_reply_len(self.rx_str[start:start + block_binary_header_lens[BLOCK_BINARY_LONG_MARKER]])
+        end = self.rx_str.find('\n', start)
+        return None if end < 0 else end + 1 - start
+
+    def read(self, min_len):
+        # Reads at least once, then until there are min_len chars
+        data_parts = [self.rx_str]
+        rxed_len = len(self.rx_str)
+        while True:
+            data_tmp = self.ser_ch.read_channel(self.ch_num)
+            if data_tmp != '':
+                data_parts.append(data_tmp)
+                rxed_len += len(data_tmp)
+                if rxed_len >= min_len:
+                    break
+        self.rx_str = ''.join(data_parts)
+
+    def get_reply(self, is_block):
+        # Returns the sequence number the reply is tagged with, or None if untagged, and the reply
+        while True:
+            start = len(SEQ_TAG) + 1 if self.rx_str[:1] == SEQ_TAG else 0
+            reply_len = self.reply_len(start, is_block) if len(self.rx_str) > start else None
+            if reply_len is not None and len(self.rx_str) >= start + reply_len:
+                break
+            self.read(start + reply_len if reply_len is not None else 0)
+        seq = ord(self.rx_str[start - 1]) if start else None
+        reply = self.rx_str[start:start + reply_len]
+        self.rx_str = self.rx_str[start + reply_len:]
+        if is_block and reply[0] in block_binary_header_lens and reply[-1] == BLOCK_BINARY_READ_FAILED:
+            reply = "{} {}\n".format(ERROR_REPLY, WMT_READ_FAILED)
+        return seq, reply
+
+def block_binary_to_hexstr(mcu_reply_str):
+    # smcio hands over each received byte as a char, so latin-1 gets the bytes back
+    data_str = mcu_reply_str[block_binary_header_lens[mcu_reply_str[0]]:binary_reply_len(mcu_reply_str) - 1]
+    return data_str.encode('latin-1').hex().upper()
+
+
+def inner_loop(sock, ser_ch, ch_num, state, crnt_cmd, verbose, user_num_reg_in_chunk, block_format_req, window_req):
+    global wisce_device_id, block_format
+    cmd_splitter = client_cmd_splitter()
+    reply_reader = mcu_reply_reader(ser_ch, ch_num)
+    pending_cmds = []
+    # Messages sent to the MCU and waiting for a reply, oldest first, and the next one to send
+    in_flight = []
+    in_flight_bytes = 0
+    next_msg = None
+    next_seq = 0
+    # One command at a time until the MCU shows it supports sequence numbers
+    window = 1
+    # Until the MCU says it does not support batches
+    is_batch_supported = True
     while True:
         try:
             dbg_pr_general(verbose, "Loop state: {}".format(state))
@@ -733,6 +1004,40 @@ def inner_loop(sock, ser_ch, ch_num, state, crnt_cmd, verbose, user_num_reg_in_c
                     print("Some commands may not work as expected")
                 else:
                     print("Bridge and MCU msg format versions match: {}".format(bridge_mcu_msg_format))
+                state = BRIDGE_STATE_BLOCK_FORMAT
+            elif state == BRIDGE_STATE_BLOCK_FORMAT:
+                # The MCU reverted to hex when asked for its msg format version, so only ask if hex is not wanted
+                block_format = BLOCK_FORMAT_HEX
+                if block_format_req == BLOCK_FORMAT_HEX:
+                    state = BRIDGE_STATE_SEQ_PROBE
+                else:
+                    send_internal_block_format(ser_ch, ch_num, block_format_req)
+                    state = BRIDGE_STATE_WAIT_BLOCK_FORMAT
+            elif state == BRIDGE_STATE_WAIT_BLOCK_FORMAT:
+                dbg_pr_general(verbose, "BlockRead format: Waiting for device reply")
+                reply = wait_for_serial_data(ser_ch, ch_num)
+                dbg_pr_DeviceMsgToAgent(verbose, reply)
+                reply = reply[:-1]
+                # Older MCU code replies with an error, and keeps sending hex
+                if ERROR_REPLY not in reply[:len(ERROR_REPLY)]:
+                    block_format = int(reply)
+                print("BlockRead format: {}".format("binary" if block_format == BLOCK_FORMAT_BINARY else "hex"))
+                state = BRIDGE_STATE_SEQ_PROBE
+            elif state == BRIDGE_STATE_SEQ_PROBE:
+                window = 1
+                if window_req == 1:
+                    state = BRIDGE_STATE_HANDSHAKE_INFO
+                else:
+                    send_internal_seq_probe(ser_ch, ch_num)
+                    state = BRIDGE_STATE_WAIT_SEQ_PROBE
+            elif state == BRIDGE_STATE_WAIT_SEQ_PROBE:
+                dbg_pr_general(verbose, "Sequence numbers: Waiting for device reply")
+                reply = wait_for_serial_data(ser_ch, ch_num)
+                dbg_pr_DeviceMsgToAgent(verbose, reply)
+                # Older MCU code replies with an untagged error
+                if reply[:len(SEQ_TAG)] == SEQ_TAG:
+                    window = window_req
+                print("Commands in flight to device: {}".format(window))
                 state = BRIDGE_STATE_HANDSHAKE_INFO
             elif state == BRIDGE_STATE_HANDSHAKE_INFO:
                 # Create abbr Info cmd
@@ -752,22 +1057,54 @@ def inner_loop(sock, ser_ch, ch_num, state, crnt_cmd, verbose, user_num_reg_in_c
                 socket_send(sock, agent_resp.encode())
                 state = BRIDGE_STATE_WAIT_CLI_CMD
             elif state == BRIDGE_STATE_WAIT_CLI_CMD:
-                dbg_pr_general(verbose, "Waiting for Client Command")
-                cli_cmd_b = wait_for_sock_recv(sock)
-                if not cli_cmd_b:
-                    raise bridge_sock_excpn("No command received. Remote end may have terminated connection")
-                crnt_cmd.new_cmd(cli_cmd_b)
-                dbg_pr_ClientMsg(verbose, crnt_cmd.get_all_str())
-                client_cmd_handler_binary(crnt_cmd, ser_ch, ch_num, state, verbose, user_num_reg_in_chunk)
-                state = BRIDGE_STATE_WAIT_MCU_REPLY
+                # Commands that arrive while others are waiting for a reply can be sent to the MCU too
+                if next_msg is None and pending_cmds and not (in_flight and in_flight[-1].is_barrier):
+                    next_msg = take_mcu_msg(pending_cmds, is_batch_supported, next_seq if window > 1 else None)
+                    if next_msg.seq is not None:
+                        next_seq = (next_seq + 1) % SEQ_NUM_MOD
+                if next_msg is not None and can_send_mcu_msg(next_msg, in_flight, in_flight_bytes, window):
+                    for cmd in next_msg.cmds:
+                        dbg_pr_ClientMsg(verbose, cmd.get_all_str())
+                    if next_msg.bin_payload is None:
+                        client_cmd_handler_binary(next_msg.cmds[0], ser_ch, ch_num, state, verbose,
+                                                  user_num_reg_in_chunk)
+                    else:
+                        ser_ch.write_channel_bytes(ch_num, next_msg.bin_payload)
+                    in_flight.append(next_msg)
+                    in_flight_bytes += next_msg.num_bytes()
+                    next_msg = None
+                elif in_flight and not (window > 1 and is_sock_readable(sock)):
+                    state = BRIDGE_STATE_WAIT_MCU_REPLY
+                else:
+                    dbg_pr_general(verbose, "Waiting for Client Command")
+                    cli_cmd_b = wait_for_sock_recv(sock)
+                    if not cli_cmd_b:
+                        raise bridge_sock_excpn("No command received. Remote end may have terminated connection")
+                    pending_cmds += parse_client_cmds(cmd_splitter.add(cli_cmd_b))
             elif state == BRIDGE_STATE_WAIT_MCU_REPLY:
                 dbg_pr_general(verbose, "Waiting for reply from device")
-                mcu_reply = wait_for_serial_data(ser_ch, ch_num)
+                msg = in_flight.pop(0)
+                in_flight_bytes -= msg.num_bytes()
+                seq, mcu_reply = reply_reader.get_reply(msg.is_block and block_format == BLOCK_FORMAT_BINARY)
                 dbg_pr_DeviceMsgToAgent(verbose, mcu_reply)
+                if seq != msg.seq:
+                    raise bridge_excpn("Device reply out of sequence: expected {}, received {}".format(msg.seq, seq))
                 mcu_reply = mcu_reply[:-1]
-                client_resp_s = reply_handler(crnt_cmd, mcu_reply)
-                dbg_pr_AgentMsgToClient(verbose, client_resp_s)
-                socket_send(sock, client_resp_s.encode())
+                if not msg.is_batch:
+                    client_resp_s = reply_handler(msg.cmds[0], mcu_reply)
+                elif mcu_reply == "{} {}".format(ERROR_REPLY, WMT_UNSUPPORTED):
+                    # Older MCU code, so send these and any later commands one at a time. Such code does not support
+                    # sequence numbers either, so no later command is in flight
+                    print("Device does not support batch commands")
+                    is_batch_supported = False
+                    pending_cmds[:0] = msg.cmds + (next_msg.cmds if next_msg is not None else [])
+                    next_msg = None
+                    client_resp_s = None
+                else:
+                    client_resp_s = batch_reply_handler(msg.cmds, mcu_reply)
+                if client_resp_s is not None:
+                    dbg_pr_AgentMsgToClient(verbose, client_resp_s)
+                    socket_send(sock, client_resp_s.encode())
                 state = BRIDGE_STATE_WAIT_CLI_CMD
             else:
                 print("REACHED INCORRECT STATE. TERMINATING")
@@ -781,7 +1118,8 @@ def inner_loop(sock, ser_ch, ch_num, state, crnt_cmd, verbose, user_num_reg_in_c
         ## TODO: send_bw_data_to_mcu() can raise exception!
         ## TODO: Should catch general Exception here, send ER msg to client & continue loop
 
-def outer_loop(ser_ch, ch_num, verbose, user_num_reg_in_chunk):
+def outer_loop(ser_ch, ch_num, verbose, user_num_reg_in_chunk, block_format_req=BLOCK_FORMAT_BINARY,
+               window_req=DEFAULT_WINDOW):
     while True:
         try:
             # Create socket & wait for connection to bridge client
@@ -790,7 +1128,8 @@ def outer_loop(ser_ch, ch_num, verbose, user_num_reg_in_chunk):
             current_cmd = current_command()
 
             with bridgecli_sockcon:
-                inner_loop(bridgecli_sockcon, ser_ch, ch_num, state, current_cmd, verbose, user_num_reg_in_chunk)
+                inner_loop(bridgecli_sockcon, ser_ch, ch_num, state, current_cmd, verbose, user_num_reg_in_chunk,
+                           block_format_req, window_req)
 
         except (TypeError, UnicodeError) as err:
             # Sometimes a client will send rubbish data down the socket
@@ -142,6 +142,14 @@ def get_args(args):
     parser.add_argument('-r', '--user_num_reg_in_chunk', dest='user_num_reg_in_chunk', default=100, type=int,
                         help='The number of registers to chunk in a block-write operation. '
                         'Must be between 1 and 200. Omitting this option defaults to 100')
+    parser.add_argument('-f', '--block-format', dest='block_format', default='binary',
+                        choices=list(bridge_agent.block_format_names.keys()),
+                        help='The format to ask the MCU to send block-read data in. Falls back to hex if the MCU '
+                        'does not support binary. Omitting this option defaults to binary')
+    parser.add_argument('-w', '--window', dest='window', default=bridge_agent.DEFAULT_WINDOW, type=int,
+                        help='The number of commands to send to the MCU before waiting for their replies. '
+                        'Must be between 1 and 255. Falls back to 1 if the MCU does not support sequence-numbered '
+                        'commands. Omitting this option defaults to {}'.format(bridge_agent.DEFAULT_WINDOW))
 
     return parser.parse_args(args[1:])
 
@@ -177,6 +185,11 @@ def validate_args(args):
         print("Invalid chunk-size specified ({})".format(args.user_num_reg_in_chunk))
         return False
 
+    # Replies are matched to commands by a 1-byte sequence number
+    if not 0 < args.window < bridge_agent.SEQ_NUM_MOD:
+        print("Invalid window specified ({})".format(args.window))
+        return False
+
     return True
 
 def print_start():
@@ -193,6 +206,8 @@ def print_args(args):
     print("Timeout (s): " + str(args.timeout))
     if args.verbose:
         print("Register chunk size for block-writes: {}".format(args.user_num_reg_in_chunk))
+        print("Block-read format: {}".format(args.block_format))
+        print("Commands in flight: {}".format(args.window))
     print("")
 
 def print_results(results_string):
@@ -263,7 +278,8 @@ def main(argv):
     ''' Do Wisce Agent stuff using new module bridge_agent.py '''
     devices = dict()  # No device details discovered yet
     try:
-        bridge_agent.outer_loop(p, '3', args.verbose, args.user_num_reg_in_chunk)
+        bridge_agent.outer_loop(p, '3', args.verbose, args.user_num_reg_in_chunk,
+                                bridge_agent.block_format_names[args.block_format], args.window)
     except IOError as e:
         print("\nIOError: {}. Exiting\n".format(e))
         raise
@@ -0,0 +1,1023 @@
+/**
+ * @file bridge_bench.c
+ *
+ * @brief Host benchmark replaying a bridge command log through bridge_process()
+ *
+ * Builds a log of the binary messages bridge_agent.py sends to the MCU for a scripted register session - the agent
+ * handshake followed mostly by single register writes and reads, with some block reads and block writes - and
+ * replays it through bridge_process() against a simulated SPI device.  Reports the commands handled per second of
+ * host CPU time.
+ *
+ * Before timing, the log is replayed once and every response is checked against the one worked out from the log with
+ * a shadow of the simulated register file, including the data of each BlockRead in hex or binary.  Binary
+ * BlockReads include ones streamed in several chunks, one long enough to need a 4-byte length, and ones running into
+ * addresses the simulated device fails to read.  With --batch, runs of single register reads and writes are sent as
+ * batch commands, as the agent does.  With --seq, commands other than BlockWrite chunks carry sequence numbers, which
+ * the check expects each response to be tagged with.  With
+ * --old-firmware the commands added since MCU message format 0.1 are answered as MCU code from before them does,
+ * and the log is the one the agent sends once it has fallen back.
+ *
+ * Usage: bridge_bench [options]
+ *   -n, --commands <count>                     Commands in the log after the handshake (default 10000)
+ *   -r, --repeat <count>                       Times to replay the log (default 50)
+ *   -b, --binary                               Negotiate binary BlockRead responses in the handshake
+ *   -a, --batch                                Send runs of register reads and writes as batch commands
+ *   -s, --seq                                  Send commands with sequence numbers once the MCU accepts them
+ *   -o, --old-firmware                         Reject the block format, batch and sequence-numbered commands as older
+ *                                              MCU code does
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#define _GNU_SOURCE
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include "bridge.h"
+#include "platform_bsp.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define BENCH_DEFAULT_COMMANDS              (10000)
+#define BENCH_DEFAULT_REPEAT                (50)
+
+#define BENCH_REG_WORDS                     (0x10000)   ///< Size of the simulated register file
+#define BENCH_BLOCK_READ_MAX_BYTES          (BRIDGE_MAX_BLOCK_READ_BYTES)
+#define BENCH_STREAM_READ_MAX_BYTES         (4 * BRIDGE_MAX_BLOCK_READ_BYTES)
+#define BENCH_LONG_READ_BYTES               (0x10000 + BRIDGE_MAX_BLOCK_READ_BYTES)
+#define BENCH_FAIL_ADDR                     (0x20000)   ///< Reads from here on fail - bench_rand() picks below it
+#define BENCH_BLOCK_WRITE_REGS              (32)
+#define BENCH_MSG_MAX_BYTES                 (8 + (BENCH_BLOCK_WRITE_REGS * BRIDGE_REG_BYTES))
+#define BENCH_RESP_MAX_BYTES                (16 + BENCH_LONG_READ_BYTES)
+
+/**
+ * @defgroup BENCH_OP_
+ * @brief Coded command Ids, as in cmd_mcu_opcodes in bridge_agent.py
+ *
+ * @{
+ */
+#define BENCH_OP_CD                         (0x1)
+#define BENCH_OP_IN                         (0x3)
+#define BENCH_OP_DT                         (0x4)
+#define BENCH_OP_RE                         (0x5)
+#define BENCH_OP_WR                         (0x6)
+#define BENCH_OP_BR                         (0x7)
+#define BENCH_OP_BWS                        (0x8)
+#define BENCH_OP_BWC                        (0x9)
+#define BENCH_OP_BWE                        (0xa)
+#define BENCH_OP_IV                         (0x10)
+#define BENCH_OP_BF                         (0x11)
+#define BENCH_OP_BA                         (0x12)
+/** @} */
+
+// MCU code for message format 0.1 from before the block format command has no handler for it, or anything after it,
+// which includes any opcode with BENCH_OP_SEQ_FLAG set
+#define BENCH_OP_FIRST_NEW                  (BENCH_OP_BF)
+
+#define BENCH_OP_SEQ_FLAG                   (0x80)
+#define BENCH_SEQ_TAG                       ('@')
+
+#define BENCH_CHIP_ID                       (1)
+#define BENCH_BATCH_OP_LEN                  (9)
+#define BENCH_BATCH_OP_READ                 (0)
+#define BENCH_BATCH_OP_WRITE                (1)
+#define BENCH_BATCH_ARGS_MAX_BYTES          (3 + (BRIDGE_MAX_BATCH_OPS * BENCH_BATCH_OP_LEN))
+#define BENCH_BLOCK_FORMAT_BINARY           (1)
+#define BENCH_BLOCK_BINARY_MARKER           ('$')
+#define BENCH_BLOCK_BINARY_LONG_MARKER      ('#')
+#define BENCH_BLOCK_BINARY_OK               ('\n')
+#define BENCH_BLOCK_BINARY_READ_FAILED      ('!')
+#define BENCH_UNSUPPORTED_RESP              ("ER 33\n")
+#define BENCH_READ_FAILED_RESP              ("ER 28\n")
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Command log of agent to MCU messages
+ */
+typedef struct
+{
+    uint8_t *bytes;
+    size_t length;
+    size_t size;
+    uint32_t count;                     ///< Messages in the log
+    bool is_seq;                        ///< Whether to add sequence numbers to commands
+    uint8_t seq;                        ///< Next sequence number
+} bench_log_t;
+
+/**
+ * Scans bridge responses for errors
+ */
+typedef struct
+{
+    uint64_t bytes;
+    uint32_t error_count;
+    uint32_t match;                     ///< Chars of "ER " matched so far
+} bench_resp_t;
+
+/**
+ * Responses expected to a log, worked out from a shadow of the simulated register file
+ */
+typedef struct
+{
+    uint32_t regs[BENCH_REG_WORDS];
+    bool is_old_fw;
+    bool is_binary;                     ///< BlockRead format the MCU is using
+    uint32_t bw_addr;                   ///< BlockWrite being collected
+    uint8_t bw_data[BRIDGE_BLOCK_BUFFER_LENGTH_BYTES];
+    uint32_t bw_len;
+    uint32_t error_count;               ///< Error responses expected
+} bench_check_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static uint32_t bench_regs[BENCH_REG_WORDS];
+static uint64_t bench_txn_count;
+static uint32_t bench_rand_state = 1;
+
+static bridge_device_t bench_devices[] =
+{
+    {
+        .device_id_str = "CS47L63",
+        .dev_name_str = "CS47L63-1",
+        .bus_i2c_cs_address = 1,
+        .b =
+        {
+            .dev_id = 0,
+            .bus_type = REGMAP_BUS_TYPE_SPI,
+            .receive_max = 0,
+            .spi_pad_len = 4,
+        },
+    },
+};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+static uint32_t bench_rand(void)
+{
+    bench_rand_state = (bench_rand_state * 1103515245) + 12345;
+
+    return (bench_rand_state >> 16) & 0x7FFF;
+}
+
+static uint32_t bench_reg_index(uint32_t addr, uint32_t offset)
+{
+    return ((addr / 4) + offset) % BENCH_REG_WORDS;
+}
+
+static uint32_t bench_get_addr(const uint8_t *addr_buffer)
+{
+    // Mask off the SPI R/W bit
+    return (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+           ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+}
+
+static uint32_t *bench_get_reg(const uint8_t *addr_buffer, uint32_t offset)
+{
+    return &(bench_regs[bench_reg_index(bench_get_addr(addr_buffer), offset)]);
+}
+
+static bool bench_is_read_failed(uint32_t addr, uint32_t length)
+{
+    return (((uint64_t) addr + length) > BENCH_FAIL_ADDR);
+}
+
+static uint32_t bench_spi_read(uint32_t bsp_dev_id,
+                               uint8_t *addr_buffer,
+                               uint32_t addr_length,
+                               uint8_t *data_buffer,
+                               uint32_t data_length,
+                               uint32_t pad_len)
+{
+    bench_txn_count++;
+    if (bench_is_read_failed(bench_get_addr(addr_buffer), data_length))
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    for (uint32_t i = 0; (i + 4) <= data_length; i += 4)
+    {
+        uint32_t val = *bench_get_reg(addr_buffer, i / 4);
+
+        data_buffer[i] = GET_BYTE_FROM_WORD(val, 3);
+        data_buffer[i + 1] = GET_BYTE_FROM_WORD(val, 2);
+        data_buffer[i + 2] = GET_BYTE_FROM_WORD(val, 1);
+        data_buffer[i + 3] = GET_BYTE_FROM_WORD(val, 0);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_spi_write(uint32_t bsp_dev_id,
+                                uint8_t *addr_buffer,
+                                uint32_t addr_length,
+                                uint8_t *data_buffer,
+                                uint32_t data_length,
+                                uint32_t pad_len)
+{
+    for (uint32_t i = 0; (i + 4) <= data_length; i += 4)
+    {
+        *bench_get_reg(addr_buffer, i / 4) = ((uint32_t) data_buffer[i] << 24) |
+                                             ((uint32_t) data_buffer[i + 1] << 16) |
+                                             ((uint32_t) data_buffer[i + 2] << 8) |
+                                             data_buffer[i + 3];
+    }
+    bench_txn_count++;
+
+    return BSP_STATUS_OK;
+}
+
+/**
+ * Make the last message in the log a sequence-numbered one
+ *
+ */
+static void bench_log_tag(bench_log_t *log, size_t offset, uint8_t seq)
+{
+    uint8_t *msg = &(log->bytes[offset]);
+    uint32_t msg_len = msg[0] | ((uint32_t) msg[1] << 8);
+
+    msg[2] |= BENCH_OP_SEQ_FLAG;
+    msg[msg_len++] = seq;
+    msg[0] = GET_BYTE_FROM_WORD(msg_len, 0);
+    msg[1] = GET_BYTE_FROM_WORD(msg_len, 1);
+    log->length++;
+
+    return;
+}
+
+/**
+ * Append one message to the log - the length field counts itself, and is sent LSB first as the agent does
+ *
+ * BlockWrite chunks each wait for a reply, so the agent does not number them.
+ *
+ */
+static void bench_log_add(bench_log_t *log, uint8_t opcode, const uint8_t *args, uint32_t args_len)
+{
+    size_t offset = log->length;
+    uint8_t *msg = &(log->bytes[offset]);
+    uint32_t msg_len = 3 + args_len;
+
+    msg[0] = GET_BYTE_FROM_WORD(msg_len, 0);
+    msg[1] = GET_BYTE_FROM_WORD(msg_len, 1);
+    msg[2] = opcode;
+    memcpy(&(msg[3]), args, args_len);
+
+    log->length += msg_len;
+    log->count++;
+
+    if (log->is_seq && (opcode != BENCH_OP_BWS) && (opcode != BENCH_OP_BWC) && (opcode != BENCH_OP_BWE))
+    {
+        bench_log_tag(log, offset, log->seq++);
+    }
+
+    return;
+}
+
+static uint32_t bench_put_word(uint8_t *bytes, uint32_t val)
+{
+    bytes[0] = GET_BYTE_FROM_WORD(val, 0);
+    bytes[1] = GET_BYTE_FROM_WORD(val, 1);
+    bytes[2] = GET_BYTE_FROM_WORD(val, 2);
+    bytes[3] = GET_BYTE_FROM_WORD(val, 3);
+
+    return 4;
+}
+
+/**
+ * Append a BlockRead, with a 4-byte length field if the length does not fit 2 bytes, as the agent sends it
+ *
+ */
+static void bench_log_add_block_read(bench_log_t *log, uint32_t addr, uint32_t read_len)
+{
+    uint8_t args[9];
+    uint32_t len;
+
+    args[0] = BENCH_CHIP_ID;
+    len = 1 + bench_put_word(&(args[1]), addr);
+    if (read_len > 0xFFFF)
+    {
+        len += bench_put_word(&(args[len]), read_len);
+    }
+    else
+    {
+        args[len++] = GET_BYTE_FROM_WORD(read_len, 0);
+        args[len++] = GET_BYTE_FROM_WORD(read_len, 1);
+    }
+    bench_log_add(log, BENCH_OP_BR, args, len);
+
+    return;
+}
+
+/**
+ * Append a run of register reads and writes as one batch command if there are at least 2, as the agent sends them
+ *
+ * Older MCU code rejects the first batch, after which the agent sends it and every later run one command at a time.
+ *
+ */
+static void bench_log_add_batch(bench_log_t *log, uint8_t *batch_args, bool is_old_fw, bool *is_batch_rejected)
+{
+    uint32_t num_ops = batch_args[1] | ((uint32_t) batch_args[2] << 8);
+
+    if ((num_ops >= 2) && !(*is_batch_rejected))
+    {
+        bench_log_add(log, BENCH_OP_BA, batch_args, 3 + (num_ops * BENCH_BATCH_OP_LEN));
+        if (!is_old_fw)
+        {
+            return;
+        }
+        *is_batch_rejected = true;
+    }
+
+    for (uint32_t i = 0; i < num_ops; i++)
+    {
+        uint8_t *op = &(batch_args[3 + (i * BENCH_BATCH_OP_LEN)]);
+        uint8_t args[9];
+
+        args[0] = BENCH_CHIP_ID;
+        memcpy(&(args[1]), &(op[1]), 8);
+        if (op[0] == BENCH_BATCH_OP_WRITE)
+        {
+            bench_log_add(log, BENCH_OP_WR, args, 9);
+        }
+        else
+        {
+            bench_log_add(log, BENCH_OP_RE, args, 5);
+        }
+    }
+
+    return;
+}
+
+/**
+ * Build the log of a scripted register session
+ *
+ */
+static uint32_t bench_log_build(bench_log_t *log,
+                                uint32_t commands,
+                                bool is_binary,
+                                bool is_batch,
+                                bool is_seq,
+                                bool is_old_fw)
+{
+    uint8_t args[BENCH_MSG_MAX_BYTES];
+    uint8_t batch_args[BENCH_BATCH_ARGS_MAX_BYTES];
+    uint32_t num_ops = 0;
+    bool is_batch_rejected = false;
+    uint32_t len;
+
+    log->size = (commands + 8) * BENCH_MSG_MAX_BYTES;
+    log->bytes = malloc(log->size);
+    if (log->bytes == NULL)
+    {
+        return 1;
+    }
+    log->length = 0;
+    log->count = 0;
+    log->is_seq = false;
+    log->seq = 0;
+
+    // Agent handshake, then the client detects the devices
+    bench_log_add(log, BENCH_OP_CD, NULL, 0);
+    bench_log_add(log, BENCH_OP_IV, NULL, 0);
+    if (is_binary)
+    {
+        args[0] = BENCH_BLOCK_FORMAT_BINARY;
+        bench_log_add(log, BENCH_OP_BF, args, 1);
+    }
+    if (is_seq)
+    {
+        // A sequence-numbered CD probes for support, with sequence number 0 ahead of the first command's
+        size_t offset = log->length;
+
+        bench_log_add(log, BENCH_OP_CD, NULL, 0);
+        bench_log_tag(log, offset, 0);
+    }
+    bench_log_add(log, BENCH_OP_IN, NULL, 0);
+
+    // Older MCU code rejects the block format command and the probe, so the agent carries on in hex, unnumbered
+    is_binary = is_binary && !is_old_fw;
+    log->is_seq = is_seq && !is_old_fw;
+
+    bench_log_add(log, BENCH_OP_DT, NULL, 0);
+
+    batch_args[0] = BENCH_CHIP_ID;
+    while (commands > 0)
+    {
+        uint32_t pick = bench_rand() % 100;
+        uint32_t addr = (bench_rand() % BENCH_REG_WORDS) * 4;
+
+        args[0] = BENCH_CHIP_ID;
+        len = 1 + bench_put_word(&(args[1]), addr);
+
+        if (pick < 85)
+        {
+            uint8_t *op = &(batch_args[3 + (num_ops * BENCH_BATCH_OP_LEN)]);
+
+            // A read is a batch op with a write value of 0, so build both as batch ops
+            op[0] = (pick < 60) ? BENCH_BATCH_OP_WRITE : BENCH_BATCH_OP_READ;
+            bench_put_word(&(op[1]), addr);
+            bench_put_word(&(op[5]), (pick < 60) ? bench_rand() : 0);
+            num_ops++;
+            commands--;
+
+            if (is_batch && (num_ops < BRIDGE_MAX_BATCH_OPS) && (commands > 0))
+            {
+                continue;
+            }
+        }
+
+        // The agent sends the run of reads and writes so far before anything else
+        if (num_ops > 0)
+        {
+            batch_args[1] = GET_BYTE_FROM_WORD(num_ops, 0);
+            batch_args[2] = GET_BYTE_FROM_WORD(num_ops, 1);
+            bench_log_add_batch(log, batch_args, is_old_fw, &is_batch_rejected);
+            num_ops = 0;
+        }
+
+        if (pick < 85)
+        {
+            continue;
+        }
+        else if ((pick < 95) || (commands < 2))
+        {
+            // Binary responses are streamed, so the agent need not split long reads
+            uint32_t max_len = is_binary ? BENCH_STREAM_READ_MAX_BYTES : BENCH_BLOCK_READ_MAX_BYTES;
+
+            bench_log_add_block_read(log, addr, ((bench_rand() % (max_len / 4)) + 1) * 4);
+            commands--;
+        }
+        else
+        {
+            for (uint32_t i = 0; i < BENCH_BLOCK_WRITE_REGS; i++, len += 4)
+            {
+                uint32_t val = bench_rand();
+
+                // Register values are sent in control port byte order
+                args[len] = GET_BYTE_FROM_WORD(val, 3);
+                args[len + 1] = GET_BYTE_FROM_WORD(val, 2);
+                args[len + 2] = GET_BYTE_FROM_WORD(val, 1);
+                args[len + 3] = GET_BYTE_FROM_WORD(val, 0);
+            }
+            bench_log_add(log, BENCH_OP_BWS, args, len);
+            bench_log_add(log, BENCH_OP_BWE, NULL, 0);
+            commands -= 2;
+        }
+    }
+
+    if (is_binary)
+    {
+        /*
+         * Once the session has filled the register file: streamed in chunks, long enough for a 4-byte length, failing
+         * part way through, and failing from the start
+         */
+        bench_log_add_block_read(log, 0x1000, 3 * BRIDGE_MAX_BLOCK_READ_BYTES + 4);
+        bench_log_add_block_read(log, 0x2000, BENCH_LONG_READ_BYTES);
+        bench_log_add_block_read(log, BENCH_FAIL_ADDR - BRIDGE_MAX_BLOCK_READ_BYTES, 2 * BRIDGE_MAX_BLOCK_READ_BYTES);
+        bench_log_add_block_read(log, BENCH_FAIL_ADDR, 8);
+    }
+
+    return 0;
+}
+
+/**
+ * Response stream writer, counting error responses
+ *
+ */
+static ssize_t bench_resp_write(void *cookie, const char *buf, size_t size)
+{
+    static const char error_str[] = "ER ";
+    bench_resp_t *resp = cookie;
+    size_t i = 0;
+
+    // Skip to each 'E' rather than stepping a byte at a time, so the scan does not swamp the bridge in the timing
+    while (i < size)
+    {
+        if (resp->match == 0)
+        {
+            const char *next = memchr(&(buf[i]), error_str[0], size - i);
+
+            if (next == NULL)
+            {
+                break;
+            }
+            i = (next - buf) + 1;
+            resp->match = 1;
+            continue;
+        }
+
+        resp->match = (buf[i] == error_str[resp->match]) ? (resp->match + 1) : (buf[i] == error_str[0]);
+        if (resp->match == (sizeof(error_str) - 1))
+        {
+            resp->error_count++;
+            resp->match = 0;
+        }
+        i++;
+    }
+    resp->bytes += size;
+
+    return size;
+}
+
+static bool bench_is_new_opcode(uint8_t opcode)
+{
+    return ((opcode & BENCH_OP_SEQ_FLAG) || (opcode >= BENCH_OP_FIRST_NEW));
+}
+
+/**
+ * Process the next command in the log, answering it as older MCU code does if that code has no handler for it
+ *
+ */
+static void bench_process(bool is_old_fw)
+{
+    if (is_old_fw)
+    {
+        long pos = ftell(bridge_read_file);
+        uint32_t msg_len = (uint32_t) fgetc(bridge_read_file);
+
+        msg_len |= (uint32_t) fgetc(bridge_read_file) << 8;
+        if (bench_is_new_opcode((uint8_t) fgetc(bridge_read_file)))
+        {
+            fseek(bridge_read_file, pos + msg_len, SEEK_SET);
+            fputs(BENCH_UNSUPPORTED_RESP, bridge_write_file);
+            return;
+        }
+        fseek(bridge_read_file, pos, SEEK_SET);
+    }
+
+    bridge_process();
+
+    return;
+}
+
+/**
+ * Work out the response to one message of the log, updating the shadow register file
+ *
+ * @return Length of the response in 'resp', or of its start if 'is_any_line' is set, in which case the rest is a
+ *         line of any text but an error
+ *
+ */
+static uint32_t bench_expect(bench_check_t *check, const uint8_t *msg, char *resp, bool *is_any_line)
+{
+    uint32_t msg_len = msg[0] | ((uint32_t) msg[1] << 8);
+    uint8_t opcode = msg[2];
+    const uint8_t *args = &(msg[3]);
+    uint32_t args_len = msg_len - 3;
+    uint32_t len = 0;
+    uint32_t addr = 0;
+
+    *is_any_line = false;
+
+    if (check->is_old_fw && bench_is_new_opcode(opcode))
+    {
+        check->error_count++;
+        return sprintf(resp, "%s", BENCH_UNSUPPORTED_RESP);
+    }
+
+    // The response to a sequence-numbered command is tagged with the number, errors included
+    if (opcode & BENCH_OP_SEQ_FLAG)
+    {
+        opcode &= ~BENCH_OP_SEQ_FLAG;
+        args_len--;
+        resp[len++] = BENCH_SEQ_TAG;
+        resp[len++] = msg[msg_len - 1];
+    }
+
+    if (args_len >= 5)
+    {
+        addr = args[1] | ((uint32_t) args[2] << 8) | ((uint32_t) args[3] << 16) | ((uint32_t) args[4] << 24);
+    }
+
+    switch (opcode)
+    {
+        case BENCH_OP_CD:
+            len += sprintf(&(resp[len]), "%s\n", bench_devices[0].dev_name_str);
+            break;
+
+        case BENCH_OP_IN:
+        case BENCH_OP_DT:
+            *is_any_line = true;
+            break;
+
+        case BENCH_OP_IV:
+            // Every agent asks for this when it connects, so the MCU goes back to hex
+            check->is_binary = false;
+            len += sprintf(&(resp[len]), "0.1\n");
+            break;
+
+        case BENCH_OP_BF:
+            check->is_binary = (args[0] == BENCH_BLOCK_FORMAT_BINARY);
+            len += sprintf(&(resp[len]), "%u\n", args[0]);
+            break;
+
+        case BENCH_OP_RE:
+            len += sprintf(&(resp[len]), "%u\n", check->regs[bench_reg_index(addr, 0)]);
+            break;
+
+        case BENCH_OP_WR:
+            check->regs[bench_reg_index(addr, 0)] = args[5] | ((uint32_t) args[6] << 8) |
+                                                    ((uint32_t) args[7] << 16) | ((uint32_t) args[8] << 24);
+            len += sprintf(&(resp[len]), "Ok\n");
+            break;
+
+        case BENCH_OP_BR:
+        {
+            bool is_long_len = (args_len >= 9);
+            uint32_t read_len = args[5] | ((uint32_t) args[6] << 8);
+            uint32_t chunk_len = (read_len < BRIDGE_MAX_BLOCK_READ_BYTES) ? read_len : BRIDGE_MAX_BLOCK_READ_BYTES;
+            bool is_failed;
+
+            if (is_long_len)
+            {
+                read_len |= ((uint32_t) args[7] << 16) | ((uint32_t) args[8] << 24);
+            }
+
+            if (!check->is_binary && (read_len > BRIDGE_MAX_BLOCK_READ_BYTES))
+            {
+                check->error_count++;
+                len += sprintf(&(resp[len]), "%s", BENCH_UNSUPPORTED_RESP);
+                break;
+            }
+
+            // The MCU reads the first chunk before committing to a response
+            if (bench_is_read_failed(addr, check->is_binary ? chunk_len : read_len))
+            {
+                check->error_count++;
+                len += sprintf(&(resp[len]), "%s", BENCH_READ_FAILED_RESP);
+                break;
+            }
+
+            if (check->is_binary)
+            {
+                resp[len++] = is_long_len ? BENCH_BLOCK_BINARY_LONG_MARKER : BENCH_BLOCK_BINARY_MARKER;
+                resp[len++] = GET_BYTE_FROM_WORD(read_len, 0);
+                resp[len++] = GET_BYTE_FROM_WORD(read_len, 1);
+                if (is_long_len)
+                {
+                    resp[len++] = GET_BYTE_FROM_WORD(read_len, 2);
+                    resp[len++] = GET_BYTE_FROM_WORD(read_len, 3);
+                }
+            }
+
+            // Each later chunk that cannot be read, and every one after it, is sent as 0s
+            is_failed = false;
+            for (uint32_t i = 0; i < (read_len / 4); i++)
+            {
+                uint32_t val = check->regs[bench_reg_index(addr, i)];
+
+                if ((((i * 4) % BRIDGE_MAX_BLOCK_READ_BYTES) == 0) && !is_failed)
+                {
+                    uint32_t left = read_len - (i * 4);
+
+                    is_failed = bench_is_read_failed(addr + (i * 4),
+                                                     (left < BRIDGE_MAX_BLOCK_READ_BYTES) ?
+                                                     left : BRIDGE_MAX_BLOCK_READ_BYTES);
+                }
+                if (is_failed)
+                {
+                    val = 0;
+                }
+
+                if (check->is_binary)
+                {
+                    resp[len++] = GET_BYTE_FROM_WORD(val, 3);
+                    resp[len++] = GET_BYTE_FROM_WORD(val, 2);
+                    resp[len++] = GET_BYTE_FROM_WORD(val, 1);
+                    resp[len++] = GET_BYTE_FROM_WORD(val, 0);
+                }
+                else
+                {
+                    len += sprintf(&(resp[len]), "%08X", val);
+                }
+            }
+            if (check->is_binary)
+            {
+                resp[len++] = is_failed ? BENCH_BLOCK_BINARY_READ_FAILED : BENCH_BLOCK_BINARY_OK;
+            }
+            else
+            {
+                resp[len++] = '\n';
+            }
+            break;
+        }
+
+        case BENCH_OP_BWS:
+            check->bw_addr = addr;
+            check->bw_len = 0;
+            args += 5;
+            args_len -= 5;
+            // Fall through, as the start carries register values too
+
+        case BENCH_OP_BWC:
+            memcpy(&(check->bw_data[check->bw_len]), args, args_len);
+            check->bw_len += args_len;
+            len += sprintf(&(resp[len]), "BWc\n");
+            break;
+
+        case BENCH_OP_BA:
+        {
+            uint32_t num_ops = args[1] | ((uint32_t) args[2] << 8);
+
+            for (uint32_t i = 0; i < num_ops; i++)
+            {
+                const uint8_t *op = &(args[3 + (i * BENCH_BATCH_OP_LEN)]);
+                uint32_t op_addr = op[1] | ((uint32_t) op[2] << 8) | ((uint32_t) op[3] << 16) |
+                                   ((uint32_t) op[4] << 24);
+                uint32_t *reg = &(check->regs[bench_reg_index(op_addr, 0)]);
+
+                if (i > 0)
+                {
+                    resp[len++] = ',';
+                }
+
+                if (op[0] == BENCH_BATCH_OP_WRITE)
+                {
+                    *reg = op[5] | ((uint32_t) op[6] << 8) | ((uint32_t) op[7] << 16) | ((uint32_t) op[8] << 24);
+                    len += sprintf(&(resp[len]), "Ok");
+                }
+                else
+                {
+                    len += sprintf(&(resp[len]), "%08X", *reg);
+                }
+            }
+            resp[len++] = '\n';
+            break;
+        }
+
+        case BENCH_OP_BWE:
+            for (uint32_t i = 0; i < (check->bw_len / 4); i++)
+            {
+                const uint8_t *val = &(check->bw_data[i * 4]);
+
+                check->regs[bench_reg_index(check->bw_addr, i)] = ((uint32_t) val[0] << 24) |
+                                                                  ((uint32_t) val[1] << 16) |
+                                                                  ((uint32_t) val[2] << 8) |
+                                                                  val[3];
+            }
+            len += sprintf(&(resp[len]), "Ok\n");
+            break;
+
+        default:
+            check->error_count++;
+            len += sprintf(&(resp[len]), "%s", BENCH_UNSUPPORTED_RESP);
+            break;
+    }
+
+    return len;
+}
+
+/**
+ * Replay the log once and check every response against the one expected
+ *
+ * @return Number of responses that did not match
+ *
+ */
+static uint32_t bench_check(const bench_log_t *log, bench_check_t *check)
+{
+    static char expected[BENCH_RESP_MAX_BYTES];
+    char *resp;
+    size_t resp_len;
+    size_t pos = 0;
+    uint32_t mismatch_count = 0;
+
+    memset(bench_regs, 0, sizeof(bench_regs));
+    memset(check->regs, 0, sizeof(check->regs));
+    check->is_binary = false;
+    check->error_count = 0;
+
+    bridge_write_file = open_memstream(&resp, &resp_len);
+    if (bridge_write_file == NULL)
+    {
+        return 1;
+    }
+    rewind(bridge_read_file);
+    while (ftell(bridge_read_file) < (long) log->length)
+    {
+        bench_process(check->is_old_fw);
+    }
+    fclose(bridge_write_file);
+
+    for (size_t offset = 0; offset < log->length; offset += log->bytes[offset] | (log->bytes[offset + 1] << 8))
+    {
+        const uint8_t *msg = &(log->bytes[offset]);
+        bool is_any_line;
+        uint32_t len = bench_expect(check, msg, expected, &is_any_line);
+
+        if (((pos + len) > resp_len) || (memcmp(&(resp[pos]), expected, len) != 0))
+        {
+            printf("Unexpected response to opcode 0x%x at log offset %zu, response offset %zu\n", msg[2], offset, pos);
+            mismatch_count++;
+            break;
+        }
+
+        if (is_any_line)
+        {
+            const char *end = memchr(&(resp[pos + len]), '\n', resp_len - pos - len);
+
+            if ((end == NULL) || (strncmp(&(resp[pos + len]), "ER ", 3) == 0))
+            {
+                printf("Unexpected response to opcode 0x%x at log offset %zu, response offset %zu\n",
+                       msg[2], offset, pos);
+                mismatch_count++;
+                break;
+            }
+            len = (end - &(resp[pos])) + 1;
+        }
+        pos += len;
+    }
+
+    if ((mismatch_count == 0) && (pos != resp_len))
+    {
+        printf("%zu bytes of response left over\n", resp_len - pos);
+        mismatch_count++;
+    }
+    free(resp);
+
+    return mismatch_count;
+}
+
+static void print_usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  -n, --commands <count>    Commands in the log after the handshake (default %d)\n",
+           BENCH_DEFAULT_COMMANDS);
+    printf("  -r, --repeat <count>      Times to replay the log (default %d)\n", BENCH_DEFAULT_REPEAT);
+    printf("  -b, --binary              Negotiate binary BlockRead responses in the handshake\n");
+    printf("  -a, --batch               Send runs of register reads and writes as batch commands\n");
+    printf("  -s, --seq                 Send commands with sequence numbers once the MCU accepts them\n");
+    printf("  -o, --old-firmware        Reject the block format, batch and sequence-numbered commands as older MCU\n");
+    printf("                            code does\n");
+
+    return;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+static bsp_driver_if_t bench_driver_if_s =
+{
+    .spi_read = &bench_spi_read,
+    .spi_write = &bench_spi_write,
+};
+
+bsp_driver_if_t *bsp_driver_if_g = &bench_driver_if_s;
+
+FILE* bridge_write_file;
+FILE* bridge_read_file;
+
+/***********************************************************************************************************************
+ * MAIN
+ **********************************************************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const struct option long_options[] =
+    {
+        {"commands",    required_argument,  NULL,   'n'},
+        {"repeat",      required_argument,  NULL,   'r'},
+        {"binary",      no_argument,        NULL,   'b'},
+        {"batch",       no_argument,        NULL,   'a'},
+        {"seq",         no_argument,        NULL,   's'},
+        {"old-firmware", no_argument,       NULL,   'o'},
+        {"help",        no_argument,        NULL,   'h'},
+        {NULL,          0,                  NULL,   0},
+    };
+    cookie_io_functions_t resp_funcs = {.write = &bench_resp_write};
+    uint32_t commands = BENCH_DEFAULT_COMMANDS;
+    uint32_t repeat = BENCH_DEFAULT_REPEAT;
+    bool is_binary = false;
+    bool is_batch = false;
+    bool is_seq = false;
+    bench_resp_t resp = {0};
+    static bench_check_t check;
+    bench_log_t log;
+    struct timespec start, stop;
+    uint64_t handled = 0;
+    double cpu_s;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "n:r:basoh", long_options, NULL)) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                commands = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'r':
+                repeat = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'b':
+                is_binary = true;
+                break;
+
+            case 'a':
+                is_batch = true;
+                break;
+
+            case 's':
+                is_seq = true;
+                break;
+
+            case 'o':
+                check.is_old_fw = true;
+                break;
+
+            default:
+                print_usage(argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if ((commands == 0) ||
+        (repeat == 0) ||
+        bench_log_build(&log, commands, is_binary, is_batch, is_seq, check.is_old_fw))
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    bridge_read_file = fmemopen(log.bytes, log.length, "r");
+    if ((bridge_read_file == NULL) || bridge_initialize(bench_devices, 1))
+    {
+        printf("Failed to set up the bridge\n");
+        return 1;
+    }
+
+    if (bench_check(&log, &check) != 0)
+    {
+        printf("FAIL: responses do not match the log\n");
+        return 1;
+    }
+
+    bench_txn_count = 0;
+    bridge_write_file = fopencookie(&resp, "w", resp_funcs);
+    if (bridge_write_file == NULL)
+    {
+        printf("Failed to set up the bridge\n");
+        return 1;
+    }
+    setvbuf(bridge_write_file, NULL, _IOFBF, BUFSIZ);
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &start);
+    for (uint32_t i = 0; i < repeat; i++)
+    {
+        rewind(bridge_read_file);
+        while (ftell(bridge_read_file) < (long) log.length)
+        {
+            bench_process(check.is_old_fw);
+            handled++;
+        }
+    }
+    fflush(bridge_write_file);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &stop);
+
+    cpu_s = (stop.tv_sec - start.tv_sec) + ((stop.tv_nsec - start.tv_nsec) / 1e9);
+
+    printf("Log:             %u commands, %zu bytes, %s block reads%s%s%s\n",
+           log.count,
+           log.length,
+           (is_binary && !check.is_old_fw) ? "binary" : "hex",
+           is_batch ? ", batches" : "",
+           log.is_seq ? ", sequence numbers" : "",
+           check.is_old_fw ? ", older MCU code" : "");
+    printf("Checked:         %u responses, %u errors expected\n", log.count, check.error_count);
+    printf("Replayed:        %llu commands, %llu bus transactions\n",
+           (unsigned long long) handled,
+           (unsigned long long) bench_txn_count);
+    printf("Responses:       %llu bytes, %u errors\n", (unsigned long long) resp.bytes, resp.error_count);
+    printf("CPU time:        %.3f s\n", cpu_s);
+    printf("Commands/s:      %.0f\n", handled / cpu_s);
+
+    fclose(bridge_read_file);
+    fclose(bridge_write_file);
+    free(log.bytes);
+
+    return (resp.error_count == (check.error_count * repeat)) ? 0 : 1;
+}
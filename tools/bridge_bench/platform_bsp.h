@@ -0,0 +1,50 @@
+/**
+ * @file platform_bsp.h
+ *
+ * @brief Host stand-in for the platform BSP, providing only what the bridge uses
+ *
+ * The bridge bench is built with this directory ahead of common/platform_bsp, so that bridge.c sees the bridge
+ * transport files without the MCU BSP.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef PLATFORM_BSP_H
+#define PLATFORM_BSP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdio.h>
+#include <stdbool.h>
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+extern FILE* bridge_write_file;
+extern FILE* bridge_read_file;
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PLATFORM_BSP_H
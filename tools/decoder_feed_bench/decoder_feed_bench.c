@@ -0,0 +1,377 @@
+/**
+ * @file decoder_feed_bench.c
+ *
+ * @brief Host benchmark of feeding the CS47L15/CS47L35 compressed decoders over the control port
+ *
+ * Runs the real driver ring buffer write path against a simulated decoder draining the DSP ring buffer at the stream
+ * rate.  Every control port transfer costs simulated time according to the bus clock, so the bench finds the minimum
+ * bus clock that keeps the decoder fed without underrun, and reports the buffer occupancy, refill count and MCU time
+ * needed per second of audio.
+ *
+ * Usage: decoder_feed_bench [options]
+ *   -p, --part <cs47l15|cs47l35>   Part and test stream (default cs47l15, mp3_test_01_mp3_48)
+ *   -b, --bus <spi|i2c>            Control port (default spi)
+ *   -c, --clock <Hz>               Bus clock to report at (default 8000000 for SPI, 400000 for I2C)
+ *   -r, --bitrate <bps>            Override the stream bitrate parsed from the test stream
+ *   -w, --dsp-buf-words <words>    DSP ring buffer size (default 6144)
+ *   -m, --watermark <percent>      Free space that raises the DSP IRQ (default 50)
+ *   -l, --irq-latency-us <us>      DSP IRQ to MCU refill latency (default 1000)
+ *   -o, --txn-overhead-us <us>     MCU set up time per control port transfer (default 5)
+ *   -n, --repeat <count>           Runs averaged for host CPU time (default 10)
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include "decoder_feed_bench.h"
+#include "sdk_version.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define BENCH_DEFAULT_SPI_CLOCK_HZ          (8000000)
+#define BENCH_DEFAULT_I2C_CLOCK_HZ          (400000)
+#define BENCH_DEFAULT_SPI_PAD_LEN           (2)         ///< As configured in bsp_cs47l15.c and bsp_cs47l35.c
+#define BENCH_DEFAULT_BUFFER_WORDS          (6144)
+#define BENCH_DEFAULT_WATERMARK_PERCENT     (50)
+#define BENCH_DEFAULT_IRQ_LATENCY_US        (1000)
+#define BENCH_DEFAULT_TXN_OVERHEAD_US       (5)
+#define BENCH_DEFAULT_REPEAT                (10)
+
+#define BENCH_MIN_CLOCK_HZ                  (1000)
+#define BENCH_MAX_CLOCK_HZ                  (100000000)
+#define BENCH_CLOCK_SEARCH_RESOLUTION       (100)       ///< Search stops within 1/100 of the minimum clock
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static const bench_part_t *bench_parts[] =
+{
+    &bench_part_cs47l15,
+    &bench_part_cs47l35,
+};
+
+static const struct option bench_options[] =
+{
+    {"part",            required_argument, NULL, 'p'},
+    {"bus",             required_argument, NULL, 'b'},
+    {"clock",           required_argument, NULL, 'c'},
+    {"bitrate",         required_argument, NULL, 'r'},
+    {"dsp-buf-words",   required_argument, NULL, 'w'},
+    {"watermark",       required_argument, NULL, 'm'},
+    {"irq-latency-us",  required_argument, NULL, 'l'},
+    {"txn-overhead-us", required_argument, NULL, 'o'},
+    {"repeat",          required_argument, NULL, 'n'},
+    {NULL,              0,                 NULL, 0},
+};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Feed the whole stream to the decoder at the configured bus clock
+ *
+ */
+static uint32_t bench_run(const bench_part_t *part, const bench_sim_cfg_t *cfg, const bench_sim_result_t **result)
+{
+    uint32_t lin_buf_size = (cfg->buffer_words * 4) + 4;
+    uint8_t *lin_buf;
+    uint32_t ret;
+
+    if (bench_sim_reset(cfg))
+    {
+        return BENCH_STATUS_FAIL;
+    }
+    *result = bench_sim_get_result();
+
+    // Large enough for the driver to write the whole DSP ring buffer at once
+    lin_buf = malloc(lin_buf_size);
+    if (lin_buf == NULL)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    ret = part->start(cfg, lin_buf, lin_buf_size);
+
+    while ((ret == BENCH_STATUS_OK) && !(*result)->is_eof)
+    {
+        uint64_t irq_ns = bench_sim_next_irq_ns();
+
+        // A refill that did not ack the IRQ leaves the stream stalled
+        if ((irq_ns == BENCH_TIME_NEVER) || ((*result)->irq_count > cfg->stream_len))
+        {
+            ret = BENCH_STATUS_FAIL;
+            break;
+        }
+
+        bench_sim_take_irq(irq_ns);
+        ret = part->service();
+    }
+
+    free(lin_buf);
+
+    return ret;
+}
+
+/**
+ * Check if a run kept the decoder fed with the right data
+ *
+ */
+static bool bench_is_fed(uint32_t ret, const bench_sim_result_t *result)
+{
+    return ((ret == BENCH_STATUS_OK) && result->is_eof && (result->underrun_count == 0) &&
+            (result->mismatch_count == 0));
+}
+
+/**
+ * Binary search for the lowest bus clock that keeps the decoder fed, or 0 if even the fastest clock does not
+ *
+ */
+static uint32_t bench_find_min_clock(const bench_part_t *part, bench_sim_cfg_t cfg)
+{
+    const bench_sim_result_t *result;
+    uint32_t lo = BENCH_MIN_CLOCK_HZ;
+    uint32_t hi = BENCH_MAX_CLOCK_HZ;
+    uint32_t ret;
+
+    cfg.bus_clock_hz = hi;
+    ret = bench_run(part, &cfg, &result);
+    if (!bench_is_fed(ret, result))
+    {
+        return 0;
+    }
+
+    while ((hi - lo) > ((lo / BENCH_CLOCK_SEARCH_RESOLUTION) + 1))
+    {
+        cfg.bus_clock_hz = lo + ((hi - lo) / 2);
+        ret = bench_run(part, &cfg, &result);
+        if (bench_is_fed(ret, result))
+        {
+            hi = cfg.bus_clock_hz;
+        }
+        else
+        {
+            lo = cfg.bus_clock_hz;
+        }
+    }
+
+    return hi;
+}
+
+static void bench_print_usage(void)
+{
+    printf("Usage: decoder_feed_bench [-p cs47l15|cs47l35] [-b spi|i2c] [-c Hz] [-r bps] [-w words] [-m percent]\n");
+    printf("                          [-l us] [-o us] [-n count]\n");
+
+    return;
+}
+
+/***********************************************************************************************************************
+ * MAIN PROGRAM
+ **********************************************************************************************************************/
+int main(int argc, char *argv[])
+{
+    const bench_part_t *part = bench_parts[0];
+    const bench_sim_result_t *result;
+    bench_sim_result_t report;
+    bench_sim_cfg_t cfg;
+    uint32_t bitrate = 0;
+    uint32_t watermark_percent = BENCH_DEFAULT_WATERMARK_PERCENT;
+    uint32_t irq_latency_us = BENCH_DEFAULT_IRQ_LATENCY_US;
+    uint32_t txn_overhead_us = BENCH_DEFAULT_TXN_OVERHEAD_US;
+    uint32_t repeat = BENCH_DEFAULT_REPEAT;
+    uint64_t duration_us;
+    double audio_s;
+    double cpu_s;
+    clock_t cpu_start;
+    uint32_t min_clock_hz;
+    uint32_t ret = BENCH_STATUS_OK;
+    int opt;
+
+    memset(&cfg, 0, sizeof(bench_sim_cfg_t));
+    cfg.bus_type = REGMAP_BUS_TYPE_SPI_3000;
+    cfg.buffer_words = BENCH_DEFAULT_BUFFER_WORDS;
+
+    while ((opt = getopt_long(argc, argv, "p:b:c:r:w:m:l:o:n:", bench_options, NULL)) != -1)
+    {
+        switch (opt)
+        {
+            case 'p':
+                part = NULL;
+                for (uint32_t i = 0; i < (sizeof(bench_parts) / sizeof(bench_parts[0])); i++)
+                {
+                    if (strcmp(optarg, bench_parts[i]->name) == 0)
+                    {
+                        part = bench_parts[i];
+                    }
+                }
+                if (part == NULL)
+                {
+                    printf("ERROR: Unsupported part %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'b':
+                if (strcmp(optarg, "spi") == 0)
+                {
+                    cfg.bus_type = REGMAP_BUS_TYPE_SPI_3000;
+                }
+                else if (strcmp(optarg, "i2c") == 0)
+                {
+                    cfg.bus_type = REGMAP_BUS_TYPE_I2C;
+                }
+                else
+                {
+                    printf("ERROR: Unsupported bus %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'c':
+                cfg.bus_clock_hz = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'r':
+                bitrate = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'w':
+                cfg.buffer_words = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'm':
+                watermark_percent = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'l':
+                irq_latency_us = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'o':
+                txn_overhead_us = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'n':
+                repeat = strtoul(optarg, NULL, 0);
+                break;
+
+            default:
+                bench_print_usage();
+                return 1;
+        }
+    }
+
+    if ((cfg.buffer_words < 2) || (watermark_percent == 0) || (watermark_percent > 100) || (repeat == 0))
+    {
+        bench_print_usage();
+        return 1;
+    }
+
+    if (cfg.bus_clock_hz == 0)
+    {
+        cfg.bus_clock_hz = (cfg.bus_type == REGMAP_BUS_TYPE_I2C) ? BENCH_DEFAULT_I2C_CLOCK_HZ : BENCH_DEFAULT_SPI_CLOCK_HZ;
+    }
+    cfg.spi_pad_len = (cfg.bus_type == REGMAP_BUS_TYPE_I2C) ? 0 : BENCH_DEFAULT_SPI_PAD_LEN;
+    cfg.txn_overhead_ns = txn_overhead_us * 1000;
+    cfg.irq_latency_ns = irq_latency_us * 1000;
+    cfg.xmem_base = part->xmem_base;
+    cfg.watermark_bytes = ((cfg.buffer_words * watermark_percent) / 100) * 3;
+    cfg.stream = part->stream;
+    cfg.stream_len = *(part->stream_len);
+
+    duration_us = part->get_duration_us(cfg.stream, cfg.stream_len);
+    if (bitrate == 0)
+    {
+        if (duration_us == 0)
+        {
+            printf("ERROR: Cannot parse %s, specify --bitrate\n", part->stream_name);
+            return 1;
+        }
+        cfg.byte_rate = (cfg.stream_len * 1000000.0) / duration_us;
+    }
+    else
+    {
+        cfg.byte_rate = bitrate / 8.0;
+    }
+    audio_s = cfg.stream_len / cfg.byte_rate;
+
+    printf("\n");
+    printf("decoder_feed_bench\n");
+    printf("SDK version %d.%d.%d\n", SDK_VERSION_MAJOR, SDK_VERSION_MINOR, SDK_VERSION_UPDATE);
+    printf("\n");
+    printf("Part: %s\n", part->name);
+    printf("Stream: %s, %lu bytes, %.3f s at %.1f kbps\n",
+           part->stream_name, (unsigned long) cfg.stream_len, audio_s, (cfg.byte_rate * 8) / 1000);
+    printf("Bus: %s, %lu us per transfer set up\n",
+           (cfg.bus_type == REGMAP_BUS_TYPE_I2C) ? "I2C" : "SPI", (unsigned long) txn_overhead_us);
+    printf("DSP ring buffer: %lu words, IRQ at %lu%% free, serviced after %lu us\n",
+           (unsigned long) cfg.buffer_words, (unsigned long) watermark_percent, (unsigned long) irq_latency_us);
+
+    cpu_start = clock();
+    for (uint32_t i = 0; i < repeat; i++)
+    {
+        ret = bench_run(part, &cfg, &result);
+    }
+    cpu_s = ((double) (clock() - cpu_start)) / (CLOCKS_PER_SEC * (double) repeat);
+    // The minimum clock search below reuses the simulation
+    report = *result;
+
+    printf("\n");
+    printf("At %lu Hz:\n", (unsigned long) cfg.bus_clock_hz);
+    if (ret)
+    {
+        printf("  Stream stalled after %lu of %lu bytes\n",
+               (unsigned long) report.committed_bytes, (unsigned long) cfg.stream_len);
+    }
+    printf("  Underruns: %lu, decoder starved for %.3f ms\n",
+           (unsigned long) report.underrun_count, report.starved_ns / 1000000.0);
+    printf("  Peak buffer occupancy: %lu of %lu bytes (%.1f%%)\n",
+           (unsigned long) report.peak_occupancy, (unsigned long) (cfg.buffer_words * 3),
+           (100.0 * report.peak_occupancy) / (cfg.buffer_words * 3));
+    printf("  Refills: %lu, DSP IRQs: %lu\n", (unsigned long) report.refill_count, (unsigned long) report.irq_count);
+    printf("  Control port: %lu transfers, %llu bytes\n",
+           (unsigned long) report.txn_count, (unsigned long long) report.bus_bytes);
+    printf("  MCU time in control port transfers: %.3f ms per s of audio\n",
+           (report.bus_busy_ns / 1000000.0) / audio_s);
+    printf("  Host CPU time: %.3f us per s of audio\n", (cpu_s * 1000000.0) / audio_s);
+    printf("  Stream check: %lu mismatched words\n", (unsigned long) report.mismatch_count);
+
+    min_clock_hz = bench_find_min_clock(part, cfg);
+    printf("\n");
+    if (min_clock_hz)
+    {
+        printf("Minimum bus clock: %lu Hz\n", (unsigned long) min_clock_hz);
+    }
+    else
+    {
+        printf("Minimum bus clock: none up to %lu Hz - IRQ latency or watermark too large for the buffer\n",
+               (unsigned long) BENCH_MAX_CLOCK_HZ);
+    }
+
+    printf("Exit.\n");
+
+    return bench_is_fed(ret, &report) ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file decoder_feed_bench.h
+ *
+ * @brief Functions and prototypes shared by the compressed decoder feed benchmark
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef DECODER_FEED_BENCH_H
+#define DECODER_FEED_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmap.h"
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup BENCH_STATUS_
+ * @brief Return values for all bench calls
+ *
+ * @{
+ */
+#define BENCH_STATUS_OK                     (0)
+#define BENCH_STATUS_FAIL                   (1)
+/** @} */
+
+/**
+ * @defgroup BENCH_DSP_
+ * @brief Layout of the simulated DSP XM, in 24-bit DSP words from XMEM_0
+ *
+ * @{
+ */
+#define BENCH_DSP_PTR_WORD                  (0x0)       ///< Word holding the ring buffer struct pointer symbol
+#define BENCH_DSP_STRUCT_WORD               (0x10)      ///< Ring buffer struct
+#define BENCH_DSP_BUFFER_WORD               (0x40)      ///< Ring buffer data
+/** @} */
+
+#define BENCH_TIME_NEVER                    (UINT64_MAX)
+
+/***********************************************************************************************************************
+ * MACROS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Simulation configuration
+ */
+typedef struct
+{
+    uint8_t bus_type;                   ///< REGMAP_BUS_TYPE_I2C or REGMAP_BUS_TYPE_SPI_3000
+    uint32_t bus_clock_hz;              ///< Control port clock
+    uint32_t spi_pad_len;               ///< SPI padding bytes between address and data phases
+    uint32_t txn_overhead_ns;           ///< MCU time to set up each control port transfer
+    uint32_t irq_latency_ns;            ///< Time from the DSP IRQ to the MCU servicing it
+    uint32_t xmem_base;                 ///< Control port address of the DSP core XMEM_0
+    uint32_t buffer_words;              ///< DSP ring buffer size in 24-bit words
+    uint32_t watermark_bytes;           ///< Free space in the DSP ring buffer that raises the DSP IRQ
+    double byte_rate;                   ///< Rate the decoder consumes the stream at, in bytes per second
+    const uint8_t *stream;              ///< Stream data, to check what the decoder consumes
+    uint32_t stream_len;                ///< Length of stream data in bytes
+} bench_sim_cfg_t;
+
+/**
+ * Simulation results
+ */
+typedef struct
+{
+    uint64_t now_ns;                    ///< Simulated time
+    uint64_t bus_busy_ns;               ///< Time spent in control port transfers, including set up overhead
+    uint32_t txn_count;                 ///< Control port transfers
+    uint64_t bus_bytes;                 ///< Bytes clocked on the control port, including address and padding
+    uint32_t irq_count;                 ///< DSP IRQs serviced
+    uint32_t refill_count;              ///< Write index updates that added data to the DSP ring buffer
+    uint64_t committed_bytes;           ///< Stream bytes made visible to the decoder
+    uint32_t peak_occupancy;            ///< Highest DSP ring buffer fill level, in bytes
+    uint32_t underrun_count;            ///< Refills that found the decoder already starved
+    uint64_t starved_ns;                ///< Total time the decoder was starved before EOF
+    uint32_t mismatch_count;            ///< DSP words that did not match the stream
+    bool is_eof;                        ///< (True) end_of_stream was written
+} bench_sim_result_t;
+
+/**
+ * Part under test - each part feeds its decoder the way its BSP does
+ */
+typedef struct
+{
+    const char *name;                   ///< Part name
+    const char *stream_name;            ///< Name of the test stream
+    const uint8_t *stream;              ///< Test stream
+    const uint32_t *stream_len;         ///< Length of test stream in bytes
+    uint32_t xmem_base;                 ///< Control port address of the decoder DSP core XMEM_0
+    /**
+     * Audio duration of the stream in us, or 0 if it cannot be parsed
+     */
+    uint64_t (*get_duration_us)(const uint8_t *stream, uint32_t stream_len);
+    /**
+     * Initialize the driver and the ring buffer, and start the stream
+     */
+    uint32_t (*start)(const bench_sim_cfg_t *cfg, uint8_t *lin_buf, uint32_t lin_buf_size);
+    /**
+     * Service a DSP IRQ - the stream is done once end_of_stream is written
+     */
+    uint32_t (*service)(void);
+} bench_part_t;
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+extern const bench_part_t bench_part_cs47l15;
+extern const bench_part_t bench_part_cs47l35;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Reset the simulated control port and DSP
+ *
+ * @param [in] cfg              Pointer to simulation configuration - must remain valid for the simulation
+ *
+ * @return
+ * - BENCH_STATUS_FAIL          if the DSP memory cannot be allocated
+ * - BENCH_STATUS_OK            otherwise
+ *
+ */
+uint32_t bench_sim_reset(const bench_sim_cfg_t *cfg);
+
+/**
+ * Get the time the DSP next raises its IRQ
+ *
+ * @return Simulated time in ns, or BENCH_TIME_NEVER if the IRQ is not armed
+ *
+ */
+uint64_t bench_sim_next_irq_ns(void);
+
+/**
+ * Advance simulated time to the DSP IRQ being serviced, and disarm the IRQ until the next irq_ack
+ *
+ * @param [in] irq_ns           Time the DSP raised the IRQ
+ *
+ */
+void bench_sim_take_irq(uint64_t irq_ns);
+
+/**
+ * Get the simulation results so far
+ *
+ * @return Pointer to simulation results
+ *
+ */
+const bench_sim_result_t *bench_sim_get_result(void);
+
+/**
+ * Fill in control port configuration for the simulated bus
+ *
+ * @param [in] cfg              Pointer to simulation configuration
+ * @param [out] cp              Pointer to control port configuration
+ *
+ */
+void bench_sim_get_cp_config(const bench_sim_cfg_t *cfg, regmap_cp_config_t *cp);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DECODER_FEED_BENCH_H
@@ -0,0 +1,510 @@
+/**
+ * @file decoder_feed_bench_bsp.c
+ *
+ * @brief Simulated control port and DSP decoder for the compressed decoder feed benchmark
+ *
+ * Implements the BSP-Driver Interface control port calls used by regmap, charging each transfer to a simulated clock
+ * according to the bus timing model.  Writes and reads land in a model of the decoder DSP XM, where a consumer drains
+ * the ring buffer at the stream rate and raises the watermark IRQ.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "decoder_feed_bench.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup BENCH_RB_
+ * @brief Word offsets of the ring buffer struct elements
+ *
+ * @{
+ */
+#define BENCH_RB_BUFFER_BASE                (0)
+#define BENCH_RB_BUFFER_SIZE                (1)
+#define BENCH_RB_IRQ_ACK                    (2)
+#define BENCH_RB_NEXT_WRITE_INDEX           (3)
+#define BENCH_RB_NEXT_READ_INDEX            (4)
+#define BENCH_RB_END_OF_STREAM              (6)
+#define BENCH_RB_HIGHER_WATER_MARK          (9)
+/** @} */
+
+#define BENCH_DSP_BYTES_PER_WORD            (3)
+#define BENCH_I2C_BITS_PER_BYTE             (9)     ///< 8 data bits and ACK
+#define BENCH_NS_PER_S                      (1000000000.0)
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Simulated control port and DSP state
+ */
+typedef struct
+{
+    const bench_sim_cfg_t *cfg;
+    uint32_t *xm;                       ///< DSP XM words
+    uint32_t xm_words;
+    uint32_t write_index;               ///< Last next_write_index written by the driver
+    uint64_t start_ns;                  ///< Time the decoder would have started to consume the stream at byte 0
+    bool is_playing;                    ///< (True) the decoder has received data
+    bool is_irq_armed;                  ///< (True) the DSP raises the IRQ once free space reaches the watermark
+    bench_sim_result_t result;
+} bench_sim_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static bench_sim_t sim;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Charge a control port transfer to the simulated clock
+ *
+ */
+static void bench_sim_transfer(uint64_t bits, uint32_t bytes)
+{
+    uint64_t ns = sim.cfg->txn_overhead_ns;
+
+    ns += (uint64_t) (((bits * BENCH_NS_PER_S) / sim.cfg->bus_clock_hz) + 0.5);
+
+    sim.result.now_ns += ns;
+    sim.result.bus_busy_ns += ns;
+    sim.result.bus_bytes += bytes;
+    sim.result.txn_count++;
+
+    return;
+}
+
+/**
+ * Stream bytes consumed by the decoder at the current time
+ *
+ */
+static uint64_t bench_sim_consumed(void)
+{
+    double demand;
+
+    if (!sim.is_playing)
+    {
+        return 0;
+    }
+
+    demand = ((sim.result.now_ns - sim.start_ns) * sim.cfg->byte_rate) / BENCH_NS_PER_S;
+    if (demand > sim.result.committed_bytes)
+    {
+        return sim.result.committed_bytes;
+    }
+
+    return (uint64_t) demand;
+}
+
+/**
+ * Get the XM word at a control port address, or NULL if outside the simulated XM
+ *
+ */
+static uint32_t *bench_sim_get_word(uint32_t addr)
+{
+    uint32_t word;
+
+    if ((addr < sim.cfg->xmem_base) || ((addr - sim.cfg->xmem_base) & 1))
+    {
+        return NULL;
+    }
+
+    word = (addr - sim.cfg->xmem_base) / 2;
+    if (word >= sim.xm_words)
+    {
+        return NULL;
+    }
+
+    return &(sim.xm[word]);
+}
+
+/**
+ * The driver has moved next_write_index, handing the words behind it to the decoder
+ *
+ */
+static void bench_sim_commit(uint32_t write_index)
+{
+    uint32_t words = sim.cfg->buffer_words;
+    uint32_t delta = ((write_index + words) - sim.write_index) % words;
+    double demand;
+    uint64_t occupancy;
+
+    if (delta == 0)
+    {
+        return;
+    }
+
+    if (sim.is_playing)
+    {
+        demand = ((sim.result.now_ns - sim.start_ns) * sim.cfg->byte_rate) / BENCH_NS_PER_S;
+        if (demand > sim.result.committed_bytes)
+        {
+            // The decoder stalled when it ran out of data, so it resumes from where it stopped
+            uint64_t starved_at_ns = sim.start_ns +
+                                     (uint64_t) ((sim.result.committed_bytes * BENCH_NS_PER_S) / sim.cfg->byte_rate);
+
+            sim.result.underrun_count++;
+            sim.result.starved_ns += sim.result.now_ns - starved_at_ns;
+            sim.start_ns += sim.result.now_ns - starved_at_ns;
+        }
+    }
+    else
+    {
+        sim.is_playing = true;
+        sim.start_ns = sim.result.now_ns;
+    }
+
+    // Check the decoder sees the stream, including across the ring buffer wrap
+    for (uint32_t i = 0; i < delta; i++)
+    {
+        uint32_t val = sim.xm[BENCH_DSP_BUFFER_WORD + ((sim.write_index + i) % words)];
+        uint64_t offset = sim.result.committed_bytes + (i * BENCH_DSP_BYTES_PER_WORD);
+
+        for (uint32_t j = 0; j < BENCH_DSP_BYTES_PER_WORD; j++)
+        {
+            uint8_t expected = ((offset + j) < sim.cfg->stream_len) ? sim.cfg->stream[offset + j] : 0;
+
+            if (((val >> (8 * (2 - j))) & 0xFF) != expected)
+            {
+                sim.result.mismatch_count++;
+                break;
+            }
+        }
+    }
+
+    sim.result.committed_bytes += delta * BENCH_DSP_BYTES_PER_WORD;
+    sim.result.refill_count++;
+    sim.write_index = write_index;
+
+    occupancy = sim.result.committed_bytes - bench_sim_consumed();
+    if (occupancy > sim.result.peak_occupancy)
+    {
+        sim.result.peak_occupancy = (uint32_t) occupancy;
+    }
+
+    return;
+}
+
+/**
+ * Write words in control port byte order to the simulated DSP
+ *
+ */
+static void bench_sim_write_words(uint32_t addr, const uint8_t *bytes, uint32_t length)
+{
+    uint32_t struct_addr = sim.cfg->xmem_base + (BENCH_DSP_STRUCT_WORD * 2);
+
+    for (uint32_t i = 0; (i + 4) <= length; i += 4, addr += 2)
+    {
+        uint32_t *word = bench_sim_get_word(addr);
+        uint32_t val = ((uint32_t) bytes[i] << 24) | ((uint32_t) bytes[i + 1] << 16) |
+                       ((uint32_t) bytes[i + 2] << 8) | bytes[i + 3];
+
+        if (word == NULL)
+        {
+            continue;
+        }
+
+        // DSP words are 24 bits wide
+        *word = val & 0xFFFFFF;
+
+        if (addr == (struct_addr + (BENCH_RB_IRQ_ACK * 2)))
+        {
+            sim.is_irq_armed = true;
+        }
+        else if (addr == (struct_addr + (BENCH_RB_NEXT_WRITE_INDEX * 2)))
+        {
+            bench_sim_commit(*word % sim.cfg->buffer_words);
+        }
+        else if (addr == (struct_addr + (BENCH_RB_END_OF_STREAM * 2)))
+        {
+            sim.result.is_eof = (*word != 0);
+        }
+    }
+
+    return;
+}
+
+/**
+ * Read words in control port byte order from the simulated DSP
+ *
+ */
+static void bench_sim_read_words(uint32_t addr, uint8_t *bytes, uint32_t length)
+{
+    uint32_t struct_addr = sim.cfg->xmem_base + (BENCH_DSP_STRUCT_WORD * 2);
+
+    for (uint32_t i = 0; (i + 4) <= length; i += 4, addr += 2)
+    {
+        uint32_t *word = bench_sim_get_word(addr);
+        uint32_t val = 0;
+
+        if (word != NULL)
+        {
+            // next_read_index is owned by the decoder, so reflects what it has consumed by now
+            if (addr == (struct_addr + (BENCH_RB_NEXT_READ_INDEX * 2)))
+            {
+                *word = (bench_sim_consumed() / BENCH_DSP_BYTES_PER_WORD) % sim.cfg->buffer_words;
+            }
+            val = *word;
+        }
+
+        bytes[i] = GET_BYTE_FROM_WORD(val, 3);
+        bytes[i + 1] = GET_BYTE_FROM_WORD(val, 2);
+        bytes[i + 2] = GET_BYTE_FROM_WORD(val, 1);
+        bytes[i + 3] = GET_BYTE_FROM_WORD(val, 0);
+    }
+
+    return;
+}
+
+/**
+ * Get the control port address from a transfer's address phase
+ *
+ */
+static uint32_t bench_sim_get_addr(const uint8_t *addr_buffer)
+{
+    // Mask off the SPI R/W bit
+    return (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+           ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+}
+
+static uint32_t bench_set_timer(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg)
+{
+    sim.result.now_ns += (uint64_t) duration_ms * 1000000;
+
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_i2c_read_repeated_start(uint32_t bsp_dev_id,
+                                              uint8_t *write_buffer,
+                                              uint32_t write_length,
+                                              uint8_t *read_buffer,
+                                              uint32_t read_length,
+                                              bsp_callback_t cb,
+                                              void *cb_arg)
+{
+    // START, device address, register address, repeated START, device address, data, STOP
+    bench_sim_transfer((BENCH_I2C_BITS_PER_BYTE * (2 + write_length + read_length)) + 3,
+                       2 + write_length + read_length);
+    bench_sim_read_words(bench_sim_get_addr(write_buffer), read_buffer, read_length);
+
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_i2c_write(uint32_t bsp_dev_id,
+                                uint8_t *write_buffer,
+                                uint32_t write_length,
+                                bsp_callback_t cb,
+                                void *cb_arg)
+{
+    // START, device address, register address, data, STOP
+    bench_sim_transfer((BENCH_I2C_BITS_PER_BYTE * (1 + write_length)) + 2, 1 + write_length);
+    bench_sim_write_words(bench_sim_get_addr(write_buffer), &(write_buffer[4]), write_length - 4);
+
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_i2c_db_write(uint32_t bsp_dev_id,
+                                   uint8_t *write_buffer_0,
+                                   uint32_t write_length_0,
+                                   uint8_t *write_buffer_1,
+                                   uint32_t write_length_1,
+                                   bsp_callback_t cb,
+                                   void *cb_arg)
+{
+    bench_sim_transfer((BENCH_I2C_BITS_PER_BYTE * (1 + write_length_0 + write_length_1)) + 2,
+                       1 + write_length_0 + write_length_1);
+    bench_sim_write_words(bench_sim_get_addr(write_buffer_0), write_buffer_1, write_length_1);
+
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_spi_read(uint32_t bsp_dev_id,
+                               uint8_t *addr_buffer,
+                               uint32_t addr_length,
+                               uint8_t *data_buffer,
+                               uint32_t data_length,
+                               uint32_t pad_len)
+{
+    uint32_t bytes = addr_length + pad_len + data_length;
+
+    bench_sim_transfer(8 * bytes, bytes);
+    bench_sim_read_words(bench_sim_get_addr(addr_buffer), data_buffer, data_length);
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_spi_write(uint32_t bsp_dev_id,
+                                uint8_t *addr_buffer,
+                                uint32_t addr_length,
+                                uint8_t *data_buffer,
+                                uint32_t data_length,
+                                uint32_t pad_len)
+{
+    uint32_t bytes = addr_length + pad_len + data_length;
+
+    bench_sim_transfer(8 * bytes, bytes);
+    bench_sim_write_words(bench_sim_get_addr(addr_buffer), data_buffer, data_length);
+
+    return BSP_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+static bsp_driver_if_t bench_driver_if_s =
+{
+    .set_timer = &bench_set_timer,
+    .i2c_read_repeated_start = &bench_i2c_read_repeated_start,
+    .i2c_write = &bench_i2c_write,
+    .i2c_db_write = &bench_i2c_db_write,
+    .spi_read = &bench_spi_read,
+    .spi_write = &bench_spi_write,
+};
+
+bsp_driver_if_t *bsp_driver_if_g = &bench_driver_if_s;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Reset the simulated control port and DSP
+ *
+ */
+uint32_t bench_sim_reset(const bench_sim_cfg_t *cfg)
+{
+    uint32_t *rb;
+
+    free(sim.xm);
+    memset(&sim, 0, sizeof(bench_sim_t));
+
+    sim.cfg = cfg;
+    sim.xm_words = BENCH_DSP_BUFFER_WORD + cfg->buffer_words;
+    sim.xm = calloc(sim.xm_words, sizeof(uint32_t));
+    if (sim.xm == NULL)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    // Firmware has booted and published its ring buffer, which is empty so the IRQ is due straight away
+    sim.xm[BENCH_DSP_PTR_WORD] = BENCH_DSP_STRUCT_WORD;
+    rb = &(sim.xm[BENCH_DSP_STRUCT_WORD]);
+    rb[BENCH_RB_BUFFER_BASE] = BENCH_DSP_BUFFER_WORD;
+    rb[BENCH_RB_BUFFER_SIZE] = cfg->buffer_words;
+    rb[BENCH_RB_HIGHER_WATER_MARK] = cfg->watermark_bytes / BENCH_DSP_BYTES_PER_WORD;
+    sim.is_irq_armed = true;
+
+    return BENCH_STATUS_OK;
+}
+
+/**
+ * Get the time the DSP next raises its IRQ
+ *
+ */
+uint64_t bench_sim_next_irq_ns(void)
+{
+    uint64_t threshold = ((uint64_t) sim.cfg->buffer_words * BENCH_DSP_BYTES_PER_WORD) - sim.cfg->watermark_bytes;
+    uint64_t irq_ns;
+
+    if (!sim.is_irq_armed)
+    {
+        return BENCH_TIME_NEVER;
+    }
+
+    if (!sim.is_playing || (sim.result.committed_bytes <= threshold))
+    {
+        return sim.result.now_ns;
+    }
+
+    // Fill level drops to the watermark once everything above it has been consumed
+    irq_ns = sim.start_ns +
+             (uint64_t) (((sim.result.committed_bytes - threshold) * BENCH_NS_PER_S) / sim.cfg->byte_rate);
+
+    return (irq_ns > sim.result.now_ns) ? irq_ns : sim.result.now_ns;
+}
+
+/**
+ * Advance simulated time to the DSP IRQ being serviced
+ *
+ */
+void bench_sim_take_irq(uint64_t irq_ns)
+{
+    if (irq_ns > sim.result.now_ns)
+    {
+        sim.result.now_ns = irq_ns;
+    }
+    sim.result.now_ns += sim.cfg->irq_latency_ns;
+    sim.result.irq_count++;
+    sim.is_irq_armed = false;
+
+    return;
+}
+
+/**
+ * Get the simulation results so far
+ *
+ */
+const bench_sim_result_t *bench_sim_get_result(void)
+{
+    return &(sim.result);
+}
+
+/**
+ * Fill in control port configuration for the simulated bus
+ *
+ */
+void bench_sim_get_cp_config(const bench_sim_cfg_t *cfg, regmap_cp_config_t *cp)
+{
+    memset(cp, 0, sizeof(regmap_cp_config_t));
+    cp->bus_type = cfg->bus_type;
+    cp->spi_pad_len = cfg->spi_pad_len;
+
+    return;
+}
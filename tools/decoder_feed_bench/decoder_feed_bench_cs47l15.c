@@ -0,0 +1,164 @@
+/**
+ * @file decoder_feed_bench_cs47l15.c
+ *
+ * @brief CS47L15 MP3 decoder feed for the compressed decoder feed benchmark
+ *
+ * Feeds the decoder the same way as the BSP_USE_CASE_MP3_PROCESS use case in bsp_cs47l15.c.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "decoder_feed_bench.h"
+#include "cs47l15.h"
+#include "cs47l15_ext.h"
+#include "mp3_test_01_48.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define BENCH_MP3_HEADER_BYTES              (4)
+#define BENCH_MP3_SAMPLES_PER_FRAME         (1152)      ///< MPEG-1 Layer III
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static cs47l15_t cs47l15_driver;
+static dsp_buffer_t buffer;
+static uint8_t *mp3_data;
+static uint32_t mp3_data_len;
+static uint32_t bytes_written_total;
+
+/**
+ * MPEG-1 Layer III bitrates in kbps and sample rates in Hz, indexed by header fields
+ */
+static const uint16_t bench_mp3_bitrates_kbps[] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320};
+static const uint32_t bench_mp3_sample_rates[] = {44100, 48000, 32000};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Audio duration of an MPEG-1 Layer III stream, summed frame by frame
+ *
+ */
+static uint64_t bench_cs47l15_get_duration_us(const uint8_t *stream, uint32_t stream_len)
+{
+    uint64_t duration_us = 0;
+    uint32_t offset = 0;
+
+    while ((offset + BENCH_MP3_HEADER_BYTES) <= stream_len)
+    {
+        const uint8_t *h = &(stream[offset]);
+        uint32_t bitrate_index = h[2] >> 4;
+        uint32_t sample_rate_index = (h[2] >> 2) & 0x3;
+        uint32_t padding = (h[2] >> 1) & 0x1;
+        uint32_t frame_len;
+
+        // Frame sync, MPEG-1, Layer III
+        if ((h[0] != 0xFF) || ((h[1] & 0xFE) != 0xFA) ||
+            (bitrate_index == 0) || (bitrate_index >= (sizeof(bench_mp3_bitrates_kbps) / sizeof(uint16_t))) ||
+            (sample_rate_index >= (sizeof(bench_mp3_sample_rates) / sizeof(uint32_t))))
+        {
+            break;
+        }
+
+        frame_len = ((144000 * bench_mp3_bitrates_kbps[bitrate_index]) / bench_mp3_sample_rates[sample_rate_index]) +
+                    padding;
+        duration_us += (BENCH_MP3_SAMPLES_PER_FRAME * 1000000ULL) / bench_mp3_sample_rates[sample_rate_index];
+        offset += frame_len;
+    }
+
+    return duration_us;
+}
+
+static uint32_t bench_cs47l15_start(const bench_sim_cfg_t *cfg, uint8_t *lin_buf, uint32_t lin_buf_size)
+{
+    uint32_t ret;
+
+    memset(&cs47l15_driver, 0, sizeof(cs47l15_t));
+    bench_sim_get_cp_config(cfg, REGMAP_GET_CP(&cs47l15_driver));
+
+    ret = cs47l15_dsp_buf_init(&cs47l15_driver,
+                               &buffer,
+                               lin_buf,
+                               lin_buf_size,
+                               cfg->xmem_base + (BENCH_DSP_PTR_WORD * 2),
+                               1);
+    if (ret)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    mp3_data = (uint8_t *) cfg->stream;
+    mp3_data_len = cfg->stream_len;
+    bytes_written_total = 0;
+
+    // Nothing is written until the first DSP IRQ
+    return BENCH_STATUS_OK;
+}
+
+static uint32_t bench_cs47l15_service(void)
+{
+    uint32_t space_avail;
+    uint32_t ret;
+
+    ret = cs47l15_dsp_buf_avail(&cs47l15_driver, &buffer, &space_avail);
+    if (ret)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+    if (space_avail)
+    {
+        if (bytes_written_total + space_avail > mp3_data_len)
+        {
+            space_avail = mp3_data_len - bytes_written_total;
+        }
+        ret = cs47l15_dsp_buf_write(&cs47l15_driver, &buffer, mp3_data, space_avail);
+        if (ret)
+        {
+            return BENCH_STATUS_FAIL;
+        }
+        mp3_data += space_avail;
+        bytes_written_total += space_avail;
+    }
+    if (bytes_written_total >= mp3_data_len)
+    {
+        cs47l15_dsp_buf_eof(&cs47l15_driver, &buffer);
+    }
+
+    return BENCH_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+const bench_part_t bench_part_cs47l15 =
+{
+    .name = "cs47l15",
+    .stream_name = "mp3_test_01_mp3_48",
+    .stream = mp3_test_01_mp3_48,
+    .stream_len = &mp3_test_01_mp3_48_len,
+    .xmem_base = CS47L15_DSP1_XMEM_0,
+    .get_duration_us = &bench_cs47l15_get_duration_us,
+    .start = &bench_cs47l15_start,
+    .service = &bench_cs47l15_service,
+};
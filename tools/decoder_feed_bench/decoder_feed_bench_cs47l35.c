@@ -0,0 +1,174 @@
+/**
+ * @file decoder_feed_bench_cs47l35.c
+ *
+ * @brief CS47L35 Opus decoder feed for the compressed decoder feed benchmark
+ *
+ * Feeds the DSP2 SILK decoder with the watermark IRQ driven stream feeder in cs47l35_ext.c.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "decoder_feed_bench.h"
+#include "cs47l35.h"
+#include "cs47l35_ext.h"
+#include "opus_test_01_16.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define BENCH_OPUS_PACKET_HEADER_BYTES      (8)     ///< Big-endian packet length, then encoder final range
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static cs47l35_t cs47l35_driver;
+static dsp_buffer_t buffer_dec;
+static dsp_stream_t stream_dec;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Frame duration in us for an Opus TOC byte configuration (RFC 6716 section 3.1)
+ *
+ */
+static uint32_t bench_opus_frame_us(uint8_t toc)
+{
+    static const uint32_t silk_us[] = {10000, 20000, 40000, 60000};
+    static const uint32_t hybrid_us[] = {10000, 20000};
+    static const uint32_t celt_us[] = {2500, 5000, 10000, 20000};
+    uint32_t config = toc >> 3;
+
+    if (config < 12)
+    {
+        return silk_us[config & 0x3];
+    }
+    else if (config < 16)
+    {
+        return hybrid_us[config & 0x1];
+    }
+
+    return celt_us[config & 0x3];
+}
+
+/**
+ * Audio duration of an Opus stream of length-prefixed packets, summed packet by packet
+ *
+ */
+static uint64_t bench_cs47l35_get_duration_us(const uint8_t *stream, uint32_t stream_len)
+{
+    uint64_t duration_us = 0;
+    uint32_t offset = 0;
+
+    while ((offset + BENCH_OPUS_PACKET_HEADER_BYTES) < stream_len)
+    {
+        const uint8_t *p = &(stream[offset]);
+        uint32_t packet_len = ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+        uint8_t toc = p[BENCH_OPUS_PACKET_HEADER_BYTES];
+        uint32_t frames;
+
+        // A truncated final packet is not played
+        if ((packet_len == 0) || ((offset + BENCH_OPUS_PACKET_HEADER_BYTES + packet_len) > stream_len))
+        {
+            break;
+        }
+
+        switch (toc & 0x3)
+        {
+            case 0:
+                frames = 1;
+                break;
+
+            case 1:
+            case 2:
+                frames = 2;
+                break;
+
+            default:
+                frames = (packet_len > 1) ? (p[BENCH_OPUS_PACKET_HEADER_BYTES + 1] & 0x3F) : 0;
+                break;
+        }
+
+        duration_us += frames * bench_opus_frame_us(toc);
+        offset += BENCH_OPUS_PACKET_HEADER_BYTES + packet_len;
+    }
+
+    return duration_us;
+}
+
+static uint32_t bench_cs47l35_start(const bench_sim_cfg_t *cfg, uint8_t *lin_buf, uint32_t lin_buf_size)
+{
+    uint32_t ret;
+
+    memset(&cs47l35_driver, 0, sizeof(cs47l35_t));
+    bench_sim_get_cp_config(cfg, REGMAP_GET_CP(&cs47l35_driver));
+
+    ret = cs47l35_dsp_buf_init(&cs47l35_driver,
+                               &buffer_dec,
+                               lin_buf,
+                               lin_buf_size,
+                               cfg->xmem_base + (BENCH_DSP_PTR_WORD * 2),
+                               2);
+    if (ret)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    // Primes the ring buffer
+    ret = cs47l35_dsp_stream_start(&cs47l35_driver, &stream_dec, &buffer_dec, (uint8_t *) cfg->stream, cfg->stream_len);
+    if (ret)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    return BENCH_STATUS_OK;
+}
+
+static uint32_t bench_cs47l35_service(void)
+{
+    uint32_t ret;
+
+    cs47l35_dsp_stream_irq(&stream_dec);
+
+    ret = cs47l35_dsp_stream_process(&cs47l35_driver, &stream_dec);
+    if (ret)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    return BENCH_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+const bench_part_t bench_part_cs47l35 =
+{
+    .name = "cs47l35",
+    .stream_name = "opus_test_01_16",
+    .stream = opus_test_01_16,
+    .stream_len = &opus_test_01_16_len,
+    .xmem_base = CS47L35_DSP2_XMEM_0,
+    .get_duration_us = &bench_cs47l35_get_duration_us,
+    .start = &bench_cs47l35_start,
+    .service = &bench_cs47l35_service,
+};
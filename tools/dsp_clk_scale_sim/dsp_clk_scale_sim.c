@@ -0,0 +1,458 @@
+/**
+ * @file dsp_clk_scale_sim.c
+ *
+ * @brief Host simulation of the DSP clock scaling policy against simulated firmware load
+ *
+ * Feeds a load profile to cs47l63_dsp_clk_scale_process() one sample at a time through its 'get_load_hz' callback,
+ * in place of the firmware load metric, against a simulated control port.  Reports how often the clock changed, how
+ * often the load overran the clock that was running, and the average clock compared to running at the highest level.
+ *
+ * Usage: dsp_clk_scale_sim [options]
+ *   -p, --profile <step|ramp|noisy|bursts>     Simulated load (default noisy)
+ *   -u, --up-pct <percent>                     Load that steps the clock up (default 90)
+ *   -d, --down-pct <percent>                   Load that steps the clock down (default 70)
+ *   -n, --down-samples <count>                 Samples before stepping down (default 8)
+ *   -s, --samples <count>                      Samples to simulate (default 1000)
+ *   -v, --verbose                              Print every sample
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "cs47l63_ext.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define SIM_DEFAULT_UP_PCT                  (90)
+#define SIM_DEFAULT_DOWN_PCT                (70)
+#define SIM_DEFAULT_DOWN_SAMPLES            (8)
+#define SIM_DEFAULT_SAMPLES                 (1000)
+
+#define SIM_MIPS                            (1000000)
+
+#define SIM_MAX_REGS                        (8)
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Simulated firmware load profile
+ */
+typedef struct
+{
+    const char *name;
+    /**
+     * Load in Hz for sample 'n' of 'samples'
+     */
+    uint32_t (*get_load_hz)(uint32_t n, uint32_t samples);
+} sim_profile_t;
+
+/**
+ * Position in the load profile, passed to sim_get_load_hz
+ */
+typedef struct
+{
+    const sim_profile_t *profile;
+    uint32_t n;
+    uint32_t samples;
+} sim_load_t;
+
+/**
+ * Simulated control port register
+ */
+typedef struct
+{
+    uint32_t addr;
+    uint32_t val;
+} sim_reg_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+
+/**
+ * DSP clocks to choose from - multiples of 24.576MHz up to the BSP_DSP_CLK_HZ used by bsp_cs47l63.c
+ */
+static const uint32_t sim_levels_hz[] =
+{
+    24576000,
+    49152000,
+    73728000,
+    98304000,
+    122880000,
+    147456000,
+};
+
+static uint32_t sim_noise_state = 1;
+
+static sim_reg_t sim_regs[SIM_MAX_REGS];
+static uint32_t sim_n_regs = 0;
+static uint32_t sim_dsp_clock1_writes = 0;
+
+static cs47l63_t cs47l63_driver;
+
+static const struct option sim_options[] =
+{
+    {"profile",         required_argument, NULL, 'p'},
+    {"up-pct",          required_argument, NULL, 'u'},
+    {"down-pct",        required_argument, NULL, 'd'},
+    {"down-samples",    required_argument, NULL, 'n'},
+    {"samples",         required_argument, NULL, 's'},
+    {"verbose",         no_argument,       NULL, 'v'},
+    {NULL,              0,                 NULL, 0},
+};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Repeatable pseudo-random noise in the range +/- 'amplitude'
+ *
+ */
+static int32_t sim_noise(int32_t amplitude)
+{
+    sim_noise_state = (sim_noise_state * 1103515245) + 12345;
+
+    return (int32_t) ((sim_noise_state >> 16) % ((2 * amplitude) + 1)) - amplitude;
+}
+
+/**
+ * Light load, a heavy middle third, then light again
+ *
+ */
+static uint32_t sim_load_step(uint32_t n, uint32_t samples)
+{
+    return (((n * 3) / samples) == 1) ? (110 * SIM_MIPS) : (30 * SIM_MIPS);
+}
+
+/**
+ * Load ramping from idle to above the highest clock and back
+ *
+ */
+static uint32_t sim_load_ramp(uint32_t n, uint32_t samples)
+{
+    uint32_t half = samples / 2;
+    uint32_t pos = (n < half) ? n : (samples - n);
+
+    return (uint32_t) (((uint64_t) 150 * SIM_MIPS * pos) / (half ? half : 1));
+}
+
+/**
+ * Load jittering around the threshold for stepping up from the second clock
+ *
+ */
+static uint32_t sim_load_noisy(uint32_t n, uint32_t samples)
+{
+    return (uint32_t) ((44 * SIM_MIPS) + (sim_noise(4) * SIM_MIPS));
+}
+
+/**
+ * Voice processing switching between a light and a heavy algorithm
+ *
+ */
+static uint32_t sim_load_bursts(uint32_t n, uint32_t samples)
+{
+    uint32_t base = ((n / 50) % 2) ? (90 * SIM_MIPS) : (20 * SIM_MIPS);
+
+    return (uint32_t) (base + (sim_noise(2) * SIM_MIPS));
+}
+
+static const sim_profile_t sim_profiles[] =
+{
+    { "step",   &sim_load_step },
+    { "ramp",   &sim_load_ramp },
+    { "noisy",  &sim_load_noisy },
+    { "bursts", &sim_load_bursts },
+};
+
+/**
+ * Load source for cs47l63_dsp_clk_scale_process in place of the firmware load metric
+ *
+ */
+static uint32_t sim_get_load_hz(void *arg, uint32_t *load_hz)
+{
+    sim_load_t *load = (sim_load_t *) arg;
+
+    *load_hz = load->profile->get_load_hz(load->n, load->samples);
+
+    return CS47L63_STATUS_OK;
+}
+
+/**
+ * Get a simulated register, adding it if it has not been accessed before
+ *
+ */
+static sim_reg_t *sim_find_reg(uint32_t addr)
+{
+    for (uint32_t i = 0; i < sim_n_regs; i++)
+    {
+        if (sim_regs[i].addr == addr)
+        {
+            return &(sim_regs[i]);
+        }
+    }
+
+    if (sim_n_regs >= SIM_MAX_REGS)
+    {
+        return NULL;
+    }
+    sim_regs[sim_n_regs].addr = addr;
+    sim_regs[sim_n_regs].val = 0;
+
+    return &(sim_regs[sim_n_regs++]);
+}
+
+static uint32_t sim_set_timer(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg)
+{
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t sim_spi_read(uint32_t bsp_dev_id,
+                             uint8_t *addr_buffer,
+                             uint32_t addr_length,
+                             uint8_t *data_buffer,
+                             uint32_t data_length,
+                             uint32_t pad_len)
+{
+    // Mask off the SPI R/W bit
+    uint32_t addr = (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+                    ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+    sim_reg_t *reg = sim_find_reg(addr);
+
+    if ((reg == NULL) || (data_length != 4))
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    data_buffer[0] = GET_BYTE_FROM_WORD(reg->val, 3);
+    data_buffer[1] = GET_BYTE_FROM_WORD(reg->val, 2);
+    data_buffer[2] = GET_BYTE_FROM_WORD(reg->val, 1);
+    data_buffer[3] = GET_BYTE_FROM_WORD(reg->val, 0);
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t sim_spi_write(uint32_t bsp_dev_id,
+                              uint8_t *addr_buffer,
+                              uint32_t addr_length,
+                              uint8_t *data_buffer,
+                              uint32_t data_length,
+                              uint32_t pad_len)
+{
+    uint32_t addr = (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+                    ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+    sim_reg_t *reg = sim_find_reg(addr);
+
+    if ((reg == NULL) || (data_length != 4))
+    {
+        return BSP_STATUS_FAIL;
+    }
+
+    reg->val = ((uint32_t) data_buffer[0] << 24) | ((uint32_t) data_buffer[1] << 16) |
+               ((uint32_t) data_buffer[2] << 8) | data_buffer[3];
+    if (addr == CS47L63_DSP_CLOCK1)
+    {
+        sim_dsp_clock1_writes++;
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static void sim_print_usage(void)
+{
+    printf("Usage: dsp_clk_scale_sim [-p step|ramp|noisy|bursts] [-u percent] [-d percent] [-n count] [-s count]\n");
+    printf("                         [-v]\n");
+
+    return;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+static bsp_driver_if_t sim_driver_if_s =
+{
+    .set_timer = &sim_set_timer,
+    .spi_read = &sim_spi_read,
+    .spi_write = &sim_spi_write,
+};
+
+bsp_driver_if_t *bsp_driver_if_g = &sim_driver_if_s;
+
+/***********************************************************************************************************************
+ * MAIN PROGRAM
+ **********************************************************************************************************************/
+int main(int argc, char *argv[])
+{
+    const sim_profile_t *profile = &sim_profiles[2];
+    dsp_clk_scale_config_t config;
+    cs47l63_dsp_clk_scale_t scale;
+    sim_load_t load;
+    uint32_t samples = SIM_DEFAULT_SAMPLES;
+    uint32_t overrun_count = 0;
+    uint64_t clk_sum = 0;
+    uint64_t load_sum = 0;
+    uint32_t top_hz;
+    bool verbose = false;
+    int opt;
+
+    config.levels_hz = sim_levels_hz;
+    config.n_levels = sizeof(sim_levels_hz) / sizeof(sim_levels_hz[0]);
+    config.up_pct = SIM_DEFAULT_UP_PCT;
+    config.down_pct = SIM_DEFAULT_DOWN_PCT;
+    config.down_samples = SIM_DEFAULT_DOWN_SAMPLES;
+    top_hz = sim_levels_hz[config.n_levels - 1];
+
+    while ((opt = getopt_long(argc, argv, "p:u:d:n:s:v", sim_options, NULL)) != -1)
+    {
+        switch (opt)
+        {
+            case 'p':
+                profile = NULL;
+                for (uint32_t i = 0; i < (sizeof(sim_profiles) / sizeof(sim_profiles[0])); i++)
+                {
+                    if (strcmp(optarg, sim_profiles[i].name) == 0)
+                    {
+                        profile = &sim_profiles[i];
+                    }
+                }
+                if (profile == NULL)
+                {
+                    printf("ERROR: Unsupported profile %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'u':
+                config.up_pct = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'd':
+                config.down_pct = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'n':
+                config.down_samples = strtoul(optarg, NULL, 0);
+                break;
+
+            case 's':
+                samples = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'v':
+                verbose = true;
+                break;
+
+            default:
+                sim_print_usage();
+                return 1;
+        }
+    }
+
+    if (samples == 0)
+    {
+        sim_print_usage();
+        return 1;
+    }
+
+    cs47l63_initialize(&cs47l63_driver);
+    cs47l63_driver.config.bsp_config.cp_config.bus_type = REGMAP_BUS_TYPE_SPI;
+    cs47l63_driver.config.bsp_config.cp_config.spi_pad_len = 4;
+    cs47l63_driver.dsp_info[0].base_addr = CS47L63_DSP_BASE_ADDR;
+
+    // Starts at the highest clock, with no firmware load metric until the simulated load is connected
+    if (cs47l63_dsp_clk_scale_init(&cs47l63_driver, &scale, 1, 0, CS47L63_DSP_LOAD_MIPS, &config) != CS47L63_STATUS_OK)
+    {
+        sim_print_usage();
+        return 1;
+    }
+    load.profile = profile;
+    load.samples = samples;
+    scale.get_load_hz = &sim_get_load_hz;
+    scale.get_load_arg = &load;
+
+    printf("\n");
+    printf("dsp_clk_scale_sim\n");
+    printf("\n");
+    printf("Profile: %s, %lu samples\n", profile->name, (unsigned long) samples);
+    printf("Policy: up above %lu%%, down within %lu%% for %lu samples\n",
+           (unsigned long) config.up_pct, (unsigned long) config.down_pct, (unsigned long) config.down_samples);
+
+    for (load.n = 0; load.n < samples; load.n++)
+    {
+        uint32_t clk_hz = dsp_clk_scale_get_hz(&(scale.policy));
+        uint32_t change_count = scale.policy.change_count;
+
+        if (cs47l63_dsp_clk_scale_process(&cs47l63_driver, &scale) != CS47L63_STATUS_OK)
+        {
+            printf("ERROR: cs47l63_dsp_clk_scale_process failed at sample %lu\n", (unsigned long) load.n);
+            return 1;
+        }
+
+        // The clock chosen from the last sample is what the firmware ran on for this one
+        if (scale.load_hz > clk_hz)
+        {
+            overrun_count++;
+        }
+        clk_sum += clk_hz;
+        load_sum += scale.load_hz;
+
+        if (verbose)
+        {
+            printf("  %5lu: load %7.3f MHz, clock %7.3f MHz%s\n",
+                   (unsigned long) load.n,
+                   scale.load_hz / 1000000.0,
+                   clk_hz / 1000000.0,
+                   (scale.policy.change_count != change_count) ? " -> change" : "");
+        }
+    }
+
+    printf("\n");
+    printf("Clock changes: %lu, %lu DSP_CLOCK1 writes\n",
+           (unsigned long) scale.policy.change_count,
+           (unsigned long) sim_dsp_clock1_writes);
+    printf("Overruns: %lu samples with the load above the running clock\n", (unsigned long) overrun_count);
+    printf("Average load: %.3f MHz\n", (load_sum / (double) samples) / 1000000.0);
+    printf("Average clock: %.3f MHz, %.1f%% of running at %.3f MHz\n",
+           (clk_sum / (double) samples) / 1000000.0,
+           (clk_sum * 100.0) / ((double) top_hz * samples),
+           top_hz / 1000000.0);
+
+    // One write from cs47l63_dsp_clk_scale_init, then one per change
+    if (sim_dsp_clock1_writes != (scale.policy.change_count + 1))
+    {
+        printf("ERROR: DSP clock changes were not all written to the device\n");
+        return 1;
+    }
+    printf("Exit.\n");
+
+    return 0;
+}
@@ -0,0 +1,528 @@
+/**
+ * @file dsp_ring_buf_check.c
+ *
+ * @brief Host check of the Madera codec DSP ring buffer data paths
+ *
+ * Checks madera_dsp_pack_words() and madera_dsp_unpack_words() against the byte-wise conversions they replaced, for
+ * every length remainder.  Then runs each part's ring buffer write and read calls against a simulated DSP at every
+ * start index of a small ring buffer, so every wrap case is covered, checking:
+ * - the data the DSP sees, or the data read back, byte for byte
+ * - the index the driver publishes
+ * - that the index is written before irq_ack
+ * - that reads of a partial DSP word are rejected without moving the read index
+ * Finally checks madera_dsp_telemetry_sample() counts each underrun, overrun and DSP error once, however many samples
+ * see it.
+ *
+ * Usage: dsp_ring_buf_check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "dsp_ring_buf_check.h"
+#include "sdk_version.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define CHECK_MAX_PACK_LEN                  (64)        ///< Longest conversion checked, in bytes
+#define CHECK_BUFFER_WORDS                  (16)        ///< Ring buffer size, small enough to check every start index
+#define CHECK_MAX_DATA_LEN                  ((CHECK_BUFFER_WORDS - 1) * MADERA_DSP_BYTES_PER_WORD)
+#define CHECK_MAX_REPORTS                   (8)         ///< Failures printed per check
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Ring buffer state at a telemetry sample, and the counts expected after it
+ */
+typedef struct
+{
+    uint32_t fill_words;
+    uint32_t end_of_stream;
+    uint32_t error;
+    uint32_t empty_count;
+    uint32_t full_count;
+    uint32_t error_count;
+} check_telemetry_step_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static const check_part_t *check_parts[] =
+{
+    &check_part_cs47l15,
+    &check_part_cs47l35,
+};
+
+static const check_telemetry_step_t check_telemetry_steps[] =
+{
+    // fill                     eos error   empty   full    error
+    { 0,                        0,  0,      1,      0,      0 },
+    { 0,                        0,  0,      1,      0,      0 },
+    { 5,                        0,  0,      1,      0,      0 },
+    { CHECK_BUFFER_WORDS - 1,   0,  0,      1,      1,      0 },
+    { CHECK_BUFFER_WORDS - 1,   0,  1,      1,      1,      1 },
+    { CHECK_BUFFER_WORDS - 1,   0,  1,      1,      1,      1 },
+    { 8,                        0,  0,      1,      1,      1 },
+    { 0,                        0,  2,      2,      1,      2 },
+    { 0,                        0,  1,      2,      1,      3 },
+    { CHECK_BUFFER_WORDS - 1,   0,  1,      2,      2,      3 },
+    { 0,                        1,  0,      2,      2,      3 },
+    { 0,                        0,  0,      3,      2,      3 },
+};
+
+static uint8_t lin_buf[CHECK_LIN_BUF_SIZE];
+static uint32_t report_count;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Print a failure, up to CHECK_MAX_REPORTS per check
+ *
+ */
+static void check_report(const char *check, uint32_t start, uint32_t len, const char *what)
+{
+    if (report_count++ < CHECK_MAX_REPORTS)
+    {
+        printf("    %s: start word %lu, %lu bytes: %s\n", check, (unsigned long) start, (unsigned long) len, what);
+    }
+
+    return;
+}
+
+/**
+ * Test stream data, different at each offset so misplaced bytes are caught
+ *
+ */
+static void check_fill_pattern(uint8_t *data, uint32_t len, uint32_t seed)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        data[i] = (uint8_t) ((seed * 37) + (i * 11) + 1);
+    }
+
+    return;
+}
+
+/**
+ * Pack bytes a byte at a time, as cs47l15_read_array() and cs47l35_read_array() did
+ *
+ */
+static uint32_t check_ref_pack(const uint8_t *array, uint8_t *target, uint32_t length)
+{
+    uint32_t j = 0;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if ((i % 3) == 0)
+        {
+            target[j++] = 0x00;
+        }
+        target[j++] = array[i];
+    }
+
+    while (j % 4)
+    {
+        target[j++] = 0x00;
+    }
+
+    return j;
+}
+
+/**
+ * Unpack words a byte at a time, as cs47l35_write_array() did
+ *
+ */
+static uint32_t check_ref_unpack(const uint8_t *array, uint8_t *target, uint32_t length)
+{
+    uint32_t j = 0;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if ((i % 4) == 0)
+        {
+            continue;
+        }
+        target[j++] = array[i];
+    }
+
+    return j;
+}
+
+/**
+ * Check the word-at-a-time conversions match the byte-wise ones for every length
+ *
+ */
+static uint32_t check_pack_words(void)
+{
+    uint8_t in[CHECK_MAX_PACK_LEN * 2];
+    uint8_t expected[CHECK_MAX_PACK_LEN * 2];
+    uint8_t actual[CHECK_MAX_PACK_LEN * 2];
+    uint32_t fail_count = 0;
+
+    report_count = 0;
+
+    for (uint32_t len = 0; len <= CHECK_MAX_PACK_LEN; len++)
+    {
+        uint32_t expected_len, actual_len = len;
+
+        check_fill_pattern(in, len, len);
+        memset(expected, 0xA5, sizeof(expected));
+        memset(actual, 0xA5, sizeof(actual));
+        expected_len = check_ref_pack(in, expected, len);
+        madera_dsp_pack_words(in, actual, &actual_len);
+        if ((actual_len != expected_len) || memcmp(expected, actual, sizeof(expected)))
+        {
+            check_report("pack", 0, len, "differs from byte-wise packing");
+            fail_count++;
+        }
+
+        memset(expected, 0xA5, sizeof(expected));
+        memset(actual, 0xA5, sizeof(actual));
+        actual_len = len;
+        expected_len = check_ref_unpack(in, expected, len);
+        madera_dsp_unpack_words(in, actual, &actual_len);
+        if ((actual_len != expected_len) || memcmp(expected, actual, sizeof(expected)))
+        {
+            check_report("unpack", 0, len, "differs from byte-wise unpacking");
+            fail_count++;
+        }
+    }
+
+    printf("  pack/unpack, 0 to %u bytes: %s\n", CHECK_MAX_PACK_LEN, (fail_count == 0) ? "OK" : "FAIL");
+
+    return fail_count;
+}
+
+/**
+ * Reset the DSP and driver, and move the driver's write index to 'start' with filler data the DSP then consumes
+ *
+ */
+static uint32_t check_write_setup(const check_part_t *part, uint32_t start)
+{
+    uint8_t filler[CHECK_MAX_DATA_LEN];
+    uint32_t avail;
+
+    if (check_sim_reset(part->xmem_base, CHECK_BUFFER_WORDS) || part->init(lin_buf, sizeof(lin_buf)))
+    {
+        return CHECK_STATUS_FAIL;
+    }
+
+    if (start > 0)
+    {
+        check_fill_pattern(filler, start * MADERA_DSP_BYTES_PER_WORD, 0xFF);
+        if (part->space_avail(&avail) || part->write(filler, start * MADERA_DSP_BYTES_PER_WORD))
+        {
+            return CHECK_STATUS_FAIL;
+        }
+        check_sim_set_element(CHECK_RB_NEXT_READ_INDEX, start);
+    }
+
+    return CHECK_STATUS_OK;
+}
+
+/**
+ * Write every length at every start index, checking what the DSP sees
+ *
+ */
+static uint32_t check_write(const check_part_t *part)
+{
+    uint8_t data[CHECK_MAX_DATA_LEN];
+    uint8_t seen[CHECK_MAX_DATA_LEN + MADERA_DSP_BYTES_PER_WORD];
+    uint32_t fail_count = 0;
+
+    report_count = 0;
+
+    for (uint32_t start = 0; start < CHECK_BUFFER_WORDS; start++)
+    {
+        for (uint32_t len = 1; len <= CHECK_MAX_DATA_LEN; len++)
+        {
+            uint32_t words = (len + MADERA_DSP_BYTES_PER_WORD - 1) / MADERA_DSP_BYTES_PER_WORD;
+            uint32_t avail;
+            bool is_ok = true;
+
+            if (check_write_setup(part, start) || part->space_avail(&avail))
+            {
+                check_report("write", start, len, "setup failed");
+                fail_count++;
+                continue;
+            }
+
+            check_fill_pattern(data, len, (start * CHECK_MAX_DATA_LEN) + len);
+            if (part->write(data, len))
+            {
+                check_report("write", start, len, "write failed");
+                fail_count++;
+                continue;
+            }
+
+            // A trailing partial word is padded with 0s
+            memset(seen, 0xA5, sizeof(seen));
+            check_sim_get_data(start, seen, words * MADERA_DSP_BYTES_PER_WORD);
+            if (memcmp(data, seen, len))
+            {
+                check_report("write", start, len, "DSP sees different data");
+                is_ok = false;
+            }
+            for (uint32_t i = len; i < (words * MADERA_DSP_BYTES_PER_WORD); i++)
+            {
+                if (seen[i] != 0)
+                {
+                    check_report("write", start, len, "partial word not padded with 0s");
+                    is_ok = false;
+                    break;
+                }
+            }
+
+            if (check_sim_get_element(CHECK_RB_NEXT_WRITE_INDEX) != ((start + words) % CHECK_BUFFER_WORDS))
+            {
+                check_report("write", start, len, "wrong next_write_index");
+                is_ok = false;
+            }
+
+            if (check_sim_get_write_seq(CHECK_RB_NEXT_WRITE_INDEX) > check_sim_get_write_seq(CHECK_RB_IRQ_ACK))
+            {
+                check_report("write", start, len, "irq_ack written before next_write_index");
+                is_ok = false;
+            }
+
+            if (!is_ok)
+            {
+                fail_count++;
+            }
+        }
+    }
+
+    printf("  %s write, %u start words x 1 to %u bytes: %s\n",
+           part->name, CHECK_BUFFER_WORDS, CHECK_MAX_DATA_LEN, (fail_count == 0) ? "OK" : "FAIL");
+
+    return fail_count;
+}
+
+/**
+ * Reset the DSP and driver, and move the driver's read index to 'start' by reading filler data the DSP produced
+ *
+ */
+static uint32_t check_read_setup(const check_part_t *part, uint32_t start)
+{
+    uint8_t filler[CHECK_MAX_DATA_LEN];
+    uint32_t avail;
+
+    if (check_sim_reset(part->xmem_base, CHECK_BUFFER_WORDS) || part->init(lin_buf, sizeof(lin_buf)))
+    {
+        return CHECK_STATUS_FAIL;
+    }
+
+    if (start > 0)
+    {
+        check_fill_pattern(filler, start * MADERA_DSP_BYTES_PER_WORD, 0xFF);
+        check_sim_put_data(0, filler, start * MADERA_DSP_BYTES_PER_WORD);
+        check_sim_set_element(CHECK_RB_NEXT_WRITE_INDEX, start);
+        if (part->data_avail(&avail) || part->read(filler, avail))
+        {
+            return CHECK_STATUS_FAIL;
+        }
+    }
+
+    return CHECK_STATUS_OK;
+}
+
+/**
+ * Read every number of words at every start index, and reject every partial word
+ *
+ */
+static uint32_t check_read(const check_part_t *part)
+{
+    uint8_t data[CHECK_MAX_DATA_LEN];
+    uint8_t read[CHECK_MAX_DATA_LEN];
+    uint32_t fail_count = 0;
+
+    if ((part->data_avail == NULL) || (part->read == NULL))
+    {
+        return 0;
+    }
+
+    report_count = 0;
+
+    for (uint32_t start = 0; start < CHECK_BUFFER_WORDS; start++)
+    {
+        for (uint32_t words = 1; words < CHECK_BUFFER_WORDS; words++)
+        {
+            uint32_t len = words * MADERA_DSP_BYTES_PER_WORD;
+            uint32_t avail;
+            bool is_ok = true;
+
+            if (check_read_setup(part, start))
+            {
+                check_report("read", start, len, "setup failed");
+                fail_count++;
+                continue;
+            }
+
+            check_fill_pattern(data, len, (start * CHECK_MAX_DATA_LEN) + len);
+            check_sim_put_data(start, data, len);
+            check_sim_set_element(CHECK_RB_NEXT_WRITE_INDEX, (start + words) % CHECK_BUFFER_WORDS);
+
+            if (part->data_avail(&avail) || (avail != len))
+            {
+                check_report("read", start, len, "wrong data available");
+                fail_count++;
+                continue;
+            }
+
+            // Partial words cannot be read, as the read index moves a word at a time
+            for (uint32_t rem = 1; rem < MADERA_DSP_BYTES_PER_WORD; rem++)
+            {
+                if ((part->read(read, len - rem) == CHECK_STATUS_OK) ||
+                    (check_sim_get_element(CHECK_RB_NEXT_READ_INDEX) != start))
+                {
+                    check_report("read", start, len - rem, "partial word not rejected");
+                    is_ok = false;
+                }
+            }
+
+            memset(read, 0xA5, sizeof(read));
+            if (part->read(read, len))
+            {
+                check_report("read", start, len, "read failed");
+                fail_count++;
+                continue;
+            }
+
+            if (memcmp(data, read, len))
+            {
+                check_report("read", start, len, "read back different data");
+                is_ok = false;
+            }
+
+            if (check_sim_get_element(CHECK_RB_NEXT_READ_INDEX) != ((start + words) % CHECK_BUFFER_WORDS))
+            {
+                check_report("read", start, len, "wrong next_read_index");
+                is_ok = false;
+            }
+
+            if (check_sim_get_write_seq(CHECK_RB_NEXT_READ_INDEX) > check_sim_get_write_seq(CHECK_RB_IRQ_ACK))
+            {
+                check_report("read", start, len, "irq_ack written before next_read_index");
+                is_ok = false;
+            }
+
+            if (!is_ok)
+            {
+                fail_count++;
+            }
+        }
+    }
+
+    printf("  %s read, %u start words x 1 to %u words: %s\n",
+           part->name, CHECK_BUFFER_WORDS, CHECK_BUFFER_WORDS - 1, (fail_count == 0) ? "OK" : "FAIL");
+
+    return fail_count;
+}
+
+/**
+ * Sample ring buffer telemetry through underruns, overruns and errors that last several samples
+ *
+ */
+static uint32_t check_telemetry(void)
+{
+    madera_dsp_telemetry_t telemetry;
+    regmap_cp_config_t cp;
+    uint32_t xmem_base = check_parts[0]->xmem_base;
+    uint32_t fail_count = 0;
+
+    report_count = 0;
+
+    check_sim_reset(xmem_base, CHECK_BUFFER_WORDS);
+    check_sim_get_cp_config(&cp);
+    madera_dsp_telemetry_reset(&telemetry);
+
+    for (uint32_t i = 0; i < (sizeof(check_telemetry_steps) / sizeof(check_telemetry_step_t)); i++)
+    {
+        const check_telemetry_step_t *step = &(check_telemetry_steps[i]);
+        // Move the read index each step, so the fill level wraps the ring buffer
+        uint32_t read_index = (i * 5) % CHECK_BUFFER_WORDS;
+
+        check_sim_set_element(CHECK_RB_NEXT_READ_INDEX, read_index);
+        check_sim_set_element(CHECK_RB_NEXT_WRITE_INDEX, (read_index + step->fill_words) % CHECK_BUFFER_WORDS);
+        check_sim_set_element(CHECK_RB_END_OF_STREAM, step->end_of_stream);
+        check_sim_set_element(CHECK_RB_ERROR, step->error);
+
+        if (madera_dsp_telemetry_sample(&cp,
+                                        xmem_base + (CHECK_DSP_STRUCT_WORD * 2),
+                                        CHECK_BUFFER_WORDS * MADERA_DSP_BYTES_PER_WORD,
+                                        &telemetry))
+        {
+            check_report("telemetry", i, step->fill_words * MADERA_DSP_BYTES_PER_WORD, "sample failed");
+            fail_count++;
+            continue;
+        }
+
+        if ((telemetry.fill_last != (step->fill_words * MADERA_DSP_BYTES_PER_WORD)) ||
+            (telemetry.empty_count != step->empty_count) ||
+            (telemetry.full_count != step->full_count) ||
+            (telemetry.error_count != step->error_count))
+        {
+            check_report("telemetry", i, step->fill_words * MADERA_DSP_BYTES_PER_WORD, "wrong counts");
+            fail_count++;
+        }
+    }
+
+    printf("  telemetry, %u samples: %s\n",
+           (unsigned int) (sizeof(check_telemetry_steps) / sizeof(check_telemetry_step_t)),
+           (fail_count == 0) ? "OK" : "FAIL");
+
+    return fail_count;
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    uint32_t fail_count = 0;
+
+    printf("\n");
+    printf("dsp_ring_buf_check\n");
+    printf("SDK version %d.%d.%d\n", SDK_VERSION_MAJOR, SDK_VERSION_MINOR, SDK_VERSION_UPDATE);
+    printf("\n");
+
+    fail_count += check_pack_words();
+
+    for (uint32_t i = 0; i < (sizeof(check_parts) / sizeof(check_part_t *)); i++)
+    {
+        fail_count += check_write(check_parts[i]);
+        fail_count += check_read(check_parts[i]);
+    }
+
+    fail_count += check_telemetry();
+
+    printf("\n");
+    printf("%s: %lu check(s) failed\n", (fail_count == 0) ? "PASS" : "FAIL", (unsigned long) fail_count);
+    printf("Exit.\n");
+
+    return (fail_count == 0) ? 0 : 1;
+}
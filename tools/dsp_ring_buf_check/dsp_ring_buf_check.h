@@ -0,0 +1,203 @@
+/**
+ * @file dsp_ring_buf_check.h
+ *
+ * @brief Functions and prototypes shared by the DSP ring buffer check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef DSP_RING_BUF_CHECK_H
+#define DSP_RING_BUF_CHECK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmap.h"
+#include "madera.h"
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup CHECK_STATUS_
+ * @brief Return values for all check calls
+ *
+ * @{
+ */
+#define CHECK_STATUS_OK                     (0)
+#define CHECK_STATUS_FAIL                   (1)
+/** @} */
+
+/**
+ * @defgroup CHECK_DSP_
+ * @brief Layout of the simulated DSP XM, in 24-bit DSP words from XMEM_0
+ *
+ * @{
+ */
+#define CHECK_DSP_PTR_WORD                  (0x0)       ///< Word holding the ring buffer struct pointer symbol
+#define CHECK_DSP_STRUCT_WORD               (0x10)      ///< Ring buffer struct
+#define CHECK_DSP_BUFFER_WORD               (0x40)      ///< Ring buffer data
+/** @} */
+
+/**
+ * @defgroup CHECK_RB_
+ * @brief Word offsets of the ring buffer struct elements
+ *
+ * @{
+ */
+#define CHECK_RB_BUFFER_BASE                (0)
+#define CHECK_RB_BUFFER_SIZE                (1)
+#define CHECK_RB_IRQ_ACK                    (2)
+#define CHECK_RB_NEXT_WRITE_INDEX           (3)
+#define CHECK_RB_NEXT_READ_INDEX            (4)
+#define CHECK_RB_ERROR                      (5)
+#define CHECK_RB_END_OF_STREAM              (6)
+#define CHECK_RB_ELEMENTS                   (11)
+/** @} */
+
+#define CHECK_LIN_BUF_SIZE                  (256)       ///< Linear buffer handed to the driver, in bytes
+
+/***********************************************************************************************************************
+ * MACROS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Part under test - each call wraps the driver's extended API for one ring buffer on DSP1
+ */
+typedef struct
+{
+    const char *name;                   ///< Part name
+    uint32_t xmem_base;                 ///< Control port address of DSP1 XMEM_0
+    /**
+     * Initialize the driver and the ring buffer
+     */
+    uint32_t (*init)(uint8_t *lin_buf, uint32_t lin_buf_size);
+    /**
+     * Get the free space in the ring buffer, in bytes
+     */
+    uint32_t (*space_avail)(uint32_t *avail);
+    /**
+     * Write stream data to the ring buffer
+     */
+    uint32_t (*write)(uint8_t *data, uint32_t data_len);
+    /**
+     * Get the data queued in the ring buffer, in bytes - NULL if the part has no read path
+     */
+    uint32_t (*data_avail)(uint32_t *avail);
+    /**
+     * Read data from the ring buffer - NULL if the part has no read path
+     */
+    uint32_t (*read)(uint8_t *data, uint32_t data_len);
+} check_part_t;
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+extern const check_part_t check_part_cs47l15;
+extern const check_part_t check_part_cs47l35;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Reset the simulated DSP to a booted firmware with an empty ring buffer
+ *
+ * @param [in] xmem_base        Control port address of XMEM_0
+ * @param [in] buffer_words     Ring buffer size in 24-bit words
+ *
+ * @return
+ * - CHECK_STATUS_FAIL          if 'buffer_words' does not fit the simulated XM
+ * - CHECK_STATUS_OK            otherwise
+ *
+ */
+uint32_t check_sim_reset(uint32_t xmem_base, uint32_t buffer_words);
+
+/**
+ * Get a ring buffer struct element, as the DSP sees it
+ *
+ * @param [in] element          Word offset of the element - CHECK_RB_*
+ *
+ * @return Element value
+ *
+ */
+uint32_t check_sim_get_element(uint32_t element);
+
+/**
+ * Set a ring buffer struct element from the DSP side
+ *
+ * @param [in] element          Word offset of the element - CHECK_RB_*
+ * @param [in] val              Element value
+ *
+ */
+void check_sim_set_element(uint32_t element, uint32_t val);
+
+/**
+ * Get the order the driver last wrote a ring buffer struct element in
+ *
+ * @param [in] element          Word offset of the element - CHECK_RB_*
+ *
+ * @return Sequence number of the last control port write to the element, or 0 if it has not been written
+ *
+ */
+uint32_t check_sim_get_write_seq(uint32_t element);
+
+/**
+ * Read stream bytes from ring buffer words, as the DSP consumes them
+ *
+ * @param [in] word             First ring buffer word
+ * @param [out] data            Bytes read
+ * @param [in] data_len         Bytes to read
+ *
+ */
+void check_sim_get_data(uint32_t word, uint8_t *data, uint32_t data_len);
+
+/**
+ * Write stream bytes into ring buffer words, as the DSP produces them
+ *
+ * @param [in] word             First ring buffer word
+ * @param [in] data             Bytes to write, padded with 0s to a whole word
+ * @param [in] data_len         Bytes to write
+ *
+ */
+void check_sim_put_data(uint32_t word, const uint8_t *data, uint32_t data_len);
+
+/**
+ * Fill in control port configuration for the simulated bus
+ *
+ * @param [out] cp              Pointer to control port configuration
+ *
+ */
+void check_sim_get_cp_config(regmap_cp_config_t *cp);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSP_RING_BUF_CHECK_H
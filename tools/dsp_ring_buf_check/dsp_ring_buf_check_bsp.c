@@ -0,0 +1,282 @@
+/**
+ * @file dsp_ring_buf_check_bsp.c
+ *
+ * @brief Simulated control port and DSP XM for the DSP ring buffer check
+ *
+ * Implements the BSP-Driver Interface SPI calls used by regmap against a DSP XM holding one ring buffer.  Each write
+ * to a ring buffer struct element is numbered, so the check can verify the order the driver publishes indexes and
+ * acks the IRQ in.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "dsp_ring_buf_check.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define CHECK_SIM_MAX_BUFFER_WORDS          (256)
+#define CHECK_SIM_XM_WORDS                  (CHECK_DSP_BUFFER_WORD + CHECK_SIM_MAX_BUFFER_WORDS)
+#define CHECK_SIM_SPI_PAD_LEN               (2)         ///< As configured in bsp_cs47l15.c and bsp_cs47l35.c
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Simulated DSP state
+ */
+typedef struct
+{
+    uint32_t xmem_base;
+    uint32_t buffer_words;
+    uint32_t xm[CHECK_SIM_XM_WORDS];    ///< DSP XM words
+    uint32_t write_seq;                 ///< Sequence number of the last ring buffer struct write
+    uint32_t element_seq[CHECK_RB_ELEMENTS];
+} check_sim_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static check_sim_t sim;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Get the XM word index at a control port address, or CHECK_SIM_XM_WORDS if outside the simulated XM
+ *
+ */
+static uint32_t check_sim_get_word(uint32_t addr)
+{
+    if ((addr < sim.xmem_base) || ((addr - sim.xmem_base) & 1) ||
+        (((addr - sim.xmem_base) / 2) >= CHECK_SIM_XM_WORDS))
+    {
+        return CHECK_SIM_XM_WORDS;
+    }
+
+    return (addr - sim.xmem_base) / 2;
+}
+
+static void check_sim_write_words(uint32_t addr, const uint8_t *bytes, uint32_t length)
+{
+    for (uint32_t i = 0; (i + 4) <= length; i += 4, addr += 2)
+    {
+        uint32_t word = check_sim_get_word(addr);
+
+        if (word == CHECK_SIM_XM_WORDS)
+        {
+            continue;
+        }
+
+        // DSP words are 24 bits wide
+        sim.xm[word] = (((uint32_t) bytes[i + 1] << 16) | ((uint32_t) bytes[i + 2] << 8) | bytes[i + 3]);
+
+        if ((word >= CHECK_DSP_STRUCT_WORD) && (word < (CHECK_DSP_STRUCT_WORD + CHECK_RB_ELEMENTS)))
+        {
+            sim.element_seq[word - CHECK_DSP_STRUCT_WORD] = ++sim.write_seq;
+        }
+    }
+
+    return;
+}
+
+static void check_sim_read_words(uint32_t addr, uint8_t *bytes, uint32_t length)
+{
+    for (uint32_t i = 0; (i + 4) <= length; i += 4, addr += 2)
+    {
+        uint32_t word = check_sim_get_word(addr);
+        uint32_t val = (word == CHECK_SIM_XM_WORDS) ? 0 : sim.xm[word];
+
+        bytes[i] = GET_BYTE_FROM_WORD(val, 3);
+        bytes[i + 1] = GET_BYTE_FROM_WORD(val, 2);
+        bytes[i + 2] = GET_BYTE_FROM_WORD(val, 1);
+        bytes[i + 3] = GET_BYTE_FROM_WORD(val, 0);
+    }
+
+    return;
+}
+
+/**
+ * Get the control port address from a transfer's address phase
+ *
+ */
+static uint32_t check_sim_get_addr(const uint8_t *addr_buffer)
+{
+    // Mask off the SPI R/W bit
+    return (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+           ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+}
+
+static uint32_t check_set_timer(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg)
+{
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_spi_read(uint32_t bsp_dev_id,
+                               uint8_t *addr_buffer,
+                               uint32_t addr_length,
+                               uint8_t *data_buffer,
+                               uint32_t data_length,
+                               uint32_t pad_len)
+{
+    check_sim_read_words(check_sim_get_addr(addr_buffer), data_buffer, data_length);
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_spi_write(uint32_t bsp_dev_id,
+                                uint8_t *addr_buffer,
+                                uint32_t addr_length,
+                                uint8_t *data_buffer,
+                                uint32_t data_length,
+                                uint32_t pad_len)
+{
+    check_sim_write_words(check_sim_get_addr(addr_buffer), data_buffer, data_length);
+
+    return BSP_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+static bsp_driver_if_t check_driver_if_s =
+{
+    .set_timer = &check_set_timer,
+    .spi_read = &check_spi_read,
+    .spi_write = &check_spi_write,
+};
+
+bsp_driver_if_t *bsp_driver_if_g = &check_driver_if_s;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Reset the simulated DSP to a booted firmware with an empty ring buffer
+ *
+ */
+uint32_t check_sim_reset(uint32_t xmem_base, uint32_t buffer_words)
+{
+    if ((buffer_words == 0) || (buffer_words > CHECK_SIM_MAX_BUFFER_WORDS))
+    {
+        return CHECK_STATUS_FAIL;
+    }
+
+    memset(&sim, 0, sizeof(check_sim_t));
+    sim.xmem_base = xmem_base;
+    sim.buffer_words = buffer_words;
+
+    sim.xm[CHECK_DSP_PTR_WORD] = CHECK_DSP_STRUCT_WORD;
+    sim.xm[CHECK_DSP_STRUCT_WORD + CHECK_RB_BUFFER_BASE] = CHECK_DSP_BUFFER_WORD;
+    sim.xm[CHECK_DSP_STRUCT_WORD + CHECK_RB_BUFFER_SIZE] = buffer_words;
+
+    return CHECK_STATUS_OK;
+}
+
+/**
+ * Get a ring buffer struct element, as the DSP sees it
+ *
+ */
+uint32_t check_sim_get_element(uint32_t element)
+{
+    return sim.xm[CHECK_DSP_STRUCT_WORD + element];
+}
+
+/**
+ * Set a ring buffer struct element from the DSP side
+ *
+ */
+void check_sim_set_element(uint32_t element, uint32_t val)
+{
+    sim.xm[CHECK_DSP_STRUCT_WORD + element] = val & 0xFFFFFF;
+
+    return;
+}
+
+/**
+ * Get the order the driver last wrote a ring buffer struct element in
+ *
+ */
+uint32_t check_sim_get_write_seq(uint32_t element)
+{
+    return sim.element_seq[element];
+}
+
+/**
+ * Read stream bytes from ring buffer words, as the DSP consumes them
+ *
+ */
+void check_sim_get_data(uint32_t word, uint8_t *data, uint32_t data_len)
+{
+    for (uint32_t i = 0; i < data_len; i++)
+    {
+        uint32_t val = sim.xm[CHECK_DSP_BUFFER_WORD + ((word + (i / MADERA_DSP_BYTES_PER_WORD)) % sim.buffer_words)];
+        uint32_t byte = (MADERA_DSP_BYTES_PER_WORD - 1) - (i % MADERA_DSP_BYTES_PER_WORD);
+
+        // Stream bytes are packed MSB first
+        data[i] = GET_BYTE_FROM_WORD(val, byte);
+    }
+
+    return;
+}
+
+/**
+ * Write stream bytes into ring buffer words, as the DSP produces them
+ *
+ */
+void check_sim_put_data(uint32_t word, const uint8_t *data, uint32_t data_len)
+{
+    for (uint32_t i = 0; i < data_len; i += MADERA_DSP_BYTES_PER_WORD, word++)
+    {
+        uint32_t val = 0;
+
+        for (uint32_t j = 0; j < MADERA_DSP_BYTES_PER_WORD; j++)
+        {
+            val = (val << 8) | (((i + j) < data_len) ? data[i + j] : 0);
+        }
+
+        sim.xm[CHECK_DSP_BUFFER_WORD + (word % sim.buffer_words)] = val;
+    }
+
+    return;
+}
+
+/**
+ * Fill in control port configuration for the simulated bus
+ *
+ */
+void check_sim_get_cp_config(regmap_cp_config_t *cp)
+{
+    memset(cp, 0, sizeof(regmap_cp_config_t));
+    cp->bus_type = REGMAP_BUS_TYPE_SPI_3000;
+    cp->spi_pad_len = CHECK_SIM_SPI_PAD_LEN;
+
+    return;
+}
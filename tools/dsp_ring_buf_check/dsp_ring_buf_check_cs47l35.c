@@ -0,0 +1,91 @@
+/**
+ * @file dsp_ring_buf_check_cs47l35.c
+ *
+ * @brief CS47L35 ring buffer calls for the DSP ring buffer check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "dsp_ring_buf_check.h"
+#include "cs47l35.h"
+#include "cs47l35_ext.h"
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static cs47l35_t cs47l35_driver;
+static dsp_buffer_t buffer;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+static uint32_t check_cs47l35_init(uint8_t *lin_buf, uint32_t lin_buf_size)
+{
+    memset(&cs47l35_driver, 0, sizeof(cs47l35_t));
+    check_sim_get_cp_config(REGMAP_GET_CP(&cs47l35_driver));
+
+    if (cs47l35_dsp_buf_init(&cs47l35_driver,
+                             &buffer,
+                             lin_buf,
+                             lin_buf_size,
+                             CS47L35_DSP1_XMEM_0 + (CHECK_DSP_PTR_WORD * 2),
+                             1))
+    {
+        return CHECK_STATUS_FAIL;
+    }
+
+    return CHECK_STATUS_OK;
+}
+
+static uint32_t check_cs47l35_space_avail(uint32_t *avail)
+{
+    return cs47l35_dsp_buf_space_avail(&cs47l35_driver, &buffer, avail);
+}
+
+static uint32_t check_cs47l35_write(uint8_t *data, uint32_t data_len)
+{
+    return cs47l35_dsp_buf_write(&cs47l35_driver, &buffer, data, data_len);
+}
+
+static uint32_t check_cs47l35_data_avail(uint32_t *avail)
+{
+    return cs47l35_dsp_buf_data_avail(&cs47l35_driver, &buffer, avail);
+}
+
+static uint32_t check_cs47l35_read(uint8_t *data, uint32_t data_len)
+{
+    return cs47l35_dsp_buf_read(&cs47l35_driver, &buffer, data, data_len);
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+const check_part_t check_part_cs47l35 =
+{
+    .name = "cs47l35",
+    .xmem_base = CS47L35_DSP1_XMEM_0,
+    .init = &check_cs47l35_init,
+    .space_avail = &check_cs47l35_space_avail,
+    .write = &check_cs47l35_write,
+    .data_avail = &check_cs47l35_data_avail,
+    .read = &check_cs47l35_read,
+};
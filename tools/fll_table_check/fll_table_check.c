@@ -0,0 +1,61 @@
+/**
+ * @file fll_table_check.c
+ *
+ * @brief Host check of the precomputed FLL tables, bit for bit, against the FLL calculation
+ *
+ * The Madera table is checked with the CS47L15 and CS47L35 FLL limits, as both drivers pass their own limits to
+ * madera_calc_fll(), and the CS47L63 table against the CS47L63 driver's calculation.
+ *
+ * Usage: fll_table_check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdio.h>
+#include <stddef.h>
+#include "fll_table_check.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+// No FLL is configured, so nothing reaches the BSP
+bsp_driver_if_t *bsp_driver_if_g = NULL;
+
+/***********************************************************************************************************************
+ * MAIN
+ **********************************************************************************************************************/
+int main(void)
+{
+    uint32_t failures = 0;
+
+    failures += check_madera_fll_table("cs47l15", check_cs47l15_fll_limits);
+    failures += check_madera_fll_table("cs47l35", check_cs47l35_fll_limits);
+    failures += check_cs47l63_fll_table();
+
+    if (failures > 0)
+    {
+        printf("FAIL: %u table entries do not match the calculation\n", failures);
+        return 1;
+    }
+
+    printf("PASS\n");
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file fll_table_check.h
+ *
+ * @brief Functions and prototypes shared by the FLL table check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FLL_TABLE_CHECK_H
+#define FLL_TABLE_CHECK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "madera.h"
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+#define CHECK_MAX_REPORTS                   (8)         ///< Failures printed per table
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+extern const madera_fll_limits_t *check_cs47l15_fll_limits;
+extern const madera_fll_limits_t *check_cs47l35_fll_limits;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Check every madera_fll_table entry against madera_calc_fll_cfg() for a part's FLL limits, returning the failures
+ */
+uint32_t check_madera_fll_table(const char *part, const madera_fll_limits_t *limits);
+
+/**
+ * Check every cs47l63_fll_table entry against cs47l63_fll_calc_cfg(), returning the failures
+ */
+uint32_t check_cs47l63_fll_table(void);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FLL_TABLE_CHECK_H
@@ -0,0 +1,34 @@
+/**
+ * @file fll_table_check_cs47l35.c
+ *
+ * @brief CS47L35 FLL limits for the FLL table check
+ *
+ * The driver is built into this file, so the check uses the limits the driver passes to madera_calc_fll() rather than
+ * a copy of them.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include "cs47l35.c"
+#include "fll_table_check.h"
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+const madera_fll_limits_t *check_cs47l35_fll_limits = &cs47l35_fll_limits;
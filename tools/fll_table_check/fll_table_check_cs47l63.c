@@ -0,0 +1,137 @@
+/**
+ * @file fll_table_check_cs47l63.c
+ *
+ * @brief Check of the CS47L63 precomputed FLL table against the FLL calculation
+ *
+ * The driver is built into this file so the check can reach the table and cs47l63_fll_calc_cfg(), the calculation
+ * the driver falls back to when no table entry applies.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "cs47l63.c"
+#include "fll_table_check.h"
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Compare two FLL configurations field by field
+ *
+ */
+static bool check_cs47l63_fll_cfg_equal(const cs47l63_fll_cfg_t *a, const cs47l63_fll_cfg_t *b)
+{
+    return (a->refdiv == b->refdiv) &&
+           (a->lockdet_thr == b->lockdet_thr) &&
+           (a->n == b->n) &&
+           (a->theta == b->theta) &&
+           (a->lambda == b->lambda) &&
+           (a->gains == b->gains) &&
+           (a->hp == b->hp) &&
+           (a->fbdiv == b->fbdiv);
+}
+
+/**
+ * Print an FLL configuration on one line
+ *
+ */
+static void check_cs47l63_fll_cfg_print(const char *what, const cs47l63_fll_cfg_t *cfg)
+{
+    printf("    %-10s refdiv %u lockdet_thr %u n %u theta %u lambda %u gains 0x%x hp %u fbdiv %u\n",
+           what,
+           cfg->refdiv,
+           cfg->lockdet_thr,
+           cfg->n,
+           cfg->theta,
+           cfg->lambda,
+           cfg->gains,
+           cfg->hp,
+           cfg->fbdiv);
+
+    return;
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Check every cs47l63_fll_table entry against cs47l63_fll_calc_cfg()
+ *
+ * Each entry must pass cs47l63_fll_validate(), as the driver never configures the FLL otherwise, the calculation must
+ * give the entry bit for bit, and cs47l63_fll_find_table_cfg() must return it rather than an earlier duplicate.
+ *
+ */
+uint32_t check_cs47l63_fll_table(void)
+{
+    uint32_t failures = 0;
+
+    for (uint32_t i = 0; i < N_FLL_TABLE_ENTRIES; i++)
+    {
+        const cs47l63_fll_table_entry_t *entry = &(cs47l63_fll_table[i]);
+        cs47l63_fll_t fll;
+        cs47l63_fll_cfg_t calc;
+        cs47l63_fll_cfg_t used;
+        bool ok = true;
+
+        memset(&fll, 0, sizeof(fll));
+        fll.ref_freq = entry->fin;
+        fll.fout = entry->fout;
+
+        // Fill with a pattern so a field the calculation leaves unset shows up as a mismatch
+        memset(&calc, 0xA5, sizeof(calc));
+        memset(&used, 0xA5, sizeof(used));
+
+        if (cs47l63_fll_validate(&fll, entry->fin, entry->fout) != CS47L63_STATUS_OK)
+        {
+            ok = false;
+        }
+
+        if ((cs47l63_fll_calc_cfg(&fll, &calc) != CS47L63_STATUS_OK) ||
+            !check_cs47l63_fll_cfg_equal(&(entry->cfg), &calc))
+        {
+            ok = false;
+        }
+
+        if (!cs47l63_fll_find_table_cfg(entry->fin, entry->fout, &used) ||
+            !check_cs47l63_fll_cfg_equal(&(entry->cfg), &used))
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            if (failures < CHECK_MAX_REPORTS)
+            {
+                printf("  cs47l63: entry %u (fin %u, fout %u) FAIL\n", i, entry->fin, entry->fout);
+                check_cs47l63_fll_cfg_print("table", &(entry->cfg));
+                check_cs47l63_fll_cfg_print("calculated", &calc);
+                check_cs47l63_fll_cfg_print("used", &used);
+            }
+            failures++;
+        }
+    }
+
+    printf("cs47l63: %u table entries, %u failed\n", (uint32_t) N_FLL_TABLE_ENTRIES, failures);
+
+    return failures;
+}
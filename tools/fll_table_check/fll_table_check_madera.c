@@ -0,0 +1,141 @@
+/**
+ * @file fll_table_check_madera.c
+ *
+ * @brief Check of the Madera precomputed FLL table against the FLL calculation
+ *
+ * common/madera.c is built into this file so the check can reach the table and madera_calc_fll_cfg(), the
+ * calculation madera_calc_fll() falls back to when no table entry applies.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "madera.c"
+#include "fll_table_check.h"
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Compare two FLL configurations field by field - padding is not compared
+ *
+ */
+static bool check_madera_fll_cfg_equal(const madera_fll_cfg_t *a, const madera_fll_cfg_t *b)
+{
+    return (a->n == b->n) &&
+           (a->theta == b->theta) &&
+           (a->lambda == b->lambda) &&
+           (a->refdiv == b->refdiv) &&
+           (a->fratio == b->fratio) &&
+           (a->gain == b->gain) &&
+           (a->alt_gain == b->alt_gain);
+}
+
+/**
+ * Print an FLL configuration on one line
+ *
+ */
+static void check_madera_fll_cfg_print(const char *what, const madera_fll_cfg_t *cfg)
+{
+    printf("    %-10s n %d theta %u lambda %u refdiv %d fratio %d gain %d alt_gain %d\n",
+           what,
+           (int) cfg->n,
+           cfg->theta,
+           cfg->lambda,
+           (int) cfg->refdiv,
+           (int) cfg->fratio,
+           (int) cfg->gain,
+           (int) cfg->alt_gain);
+
+    return;
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Check every madera_fll_table entry against madera_calc_fll_cfg() for a part's FLL limits
+ *
+ * Entries outside the part's limits are never returned by madera_calc_fll() for that part, so are only counted.  For
+ * every other entry the calculation must give the entry bit for bit, and madera_calc_fll() must return it.
+ *
+ */
+uint32_t check_madera_fll_table(const char *part, const madera_fll_limits_t *limits)
+{
+    uint32_t failures = 0;
+    uint32_t unused = 0;
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(madera_fll_table); i++)
+    {
+        const madera_fll_table_entry_t *entry = &(madera_fll_table[i]);
+        madera_fll_cfg_t calc;
+        madera_fll_cfg_t used;
+        bool ok = true;
+
+        if (!madera_fll_cfg_in_limits(limits, entry->fref, entry->sync, &(entry->cfg)))
+        {
+            unused++;
+            continue;
+        }
+
+        // Fill with a pattern so a field the calculation leaves unset shows up as a mismatch
+        memset(&calc, 0xA5, sizeof(calc));
+        memset(&used, 0xA5, sizeof(used));
+
+        if ((madera_calc_fll_cfg(limits, entry->fref, entry->fout, entry->sync, &calc) != MADERA_STATUS_OK) ||
+            !check_madera_fll_cfg_equal(&(entry->cfg), &calc))
+        {
+            ok = false;
+        }
+
+        if ((madera_calc_fll(limits, entry->fref, entry->fout, entry->sync, &used) != MADERA_STATUS_OK) ||
+            !check_madera_fll_cfg_equal(&(entry->cfg), &used))
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            if (failures < CHECK_MAX_REPORTS)
+            {
+                printf("  %s: entry %u (fref %u, fout %u, %s) FAIL\n",
+                       part,
+                       i,
+                       entry->fref,
+                       entry->fout,
+                       entry->sync ? "sync" : "main");
+                check_madera_fll_cfg_print("table", &(entry->cfg));
+                check_madera_fll_cfg_print("calculated", &calc);
+                check_madera_fll_cfg_print("used", &used);
+            }
+            failures++;
+        }
+    }
+
+    printf("%s: %u of %u table entries within limits, %u failed\n",
+           part,
+           (uint32_t) ARRAY_SIZE(madera_fll_table) - unused,
+           (uint32_t) ARRAY_SIZE(madera_fll_table),
+           failures);
+
+    return failures;
+}
@@ -0,0 +1,343 @@
+#==========================================================================
+# (c) 2022 Cirrus Logic, Inc.
+#--------------------------------------------------------------------------
+# Project : Generate precomputed FLL configuration tables
+# File    : fll_table_generator.py
+#--------------------------------------------------------------------------
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#--------------------------------------------------------------------------
+#
+# Environment Requirements: None
+#
+# The calculations below mirror madera_calc_fll() (common/madera.c, used by
+# CS47L15 and CS47L35) and cs47l63_fll_do_config() exactly.  If the driver FLL math or gain tables
+# change, this tool must be updated to match and the tables regenerated.
+#
+#==========================================================================
+
+#==========================================================================
+# IMPORTS
+#==========================================================================
+import os
+import sys
+repo_path = os.path.dirname(os.path.abspath(__file__)) + '/../..'
+sys.path.insert(1, (repo_path + '/tools/sdk_version'))
+from sdk_version import print_sdk_version
+import argparse
+
+#==========================================================================
+# VERSION
+#==========================================================================
+
+#==========================================================================
+# CONSTANTS/GLOBALS
+#==========================================================================
+supported_parts = ['madera', 'cs47l63']
+
+# Reference clocks used by nearly every clock plan: 32kHz MCLK, common BCLKs and 44.1k/48k family MCLKs
+default_frefs = [32768, 1536000, 3072000, 11289600, 12288000, 24576000, 49152000]
+
+default_fouts = {
+    'madera': [98304000, 90316800],
+    'cs47l63': [49152000, 45158400],
+}
+
+# Madera (CS47L15/CS47L35) FLL
+MADERA_FLL_MAX_FREF = 13500000
+MADERA_FLL_MIN_FOUT = 90000000
+MADERA_FLL_MAX_FOUT = 100000000
+MADERA_FLL_MAX_REFDIV = 8
+MADERA_FLL_MAX_N = 1023
+
+# (min, max, fratio, ratio)
+madera_fll_sync_fratios = [
+    (      0,    64000, 4, 16),
+    (  64000,   128000, 3,  8),
+    ( 128000,   256000, 2,  4),
+    ( 256000,  1000000, 1,  2),
+    (1000000, 13500000, 0,  1),
+]
+
+# (min, max, gain, alt_gain)
+madera_fll_sync_gains = [
+    (      0,   256000, 0, -1),
+    ( 256000,  1000000, 2, -1),
+    (1000000, 13500000, 4, -1),
+]
+
+madera_fll_main_gains = [
+    (      0,   100000, 0, 2),
+    ( 100000,   375000, 2, 2),
+    ( 375000,   768000, 3, 2),
+    ( 768001,  1500000, 3, 3),
+    (1500000,  6000000, 4, 3),
+    (6000000, 13500000, 5, 3),
+]
+
+# CS47L63 FLLHJ
+FLLHJ_INT_MAX_N = 1023
+FLLHJ_INT_MIN_N = 1
+FLLHJ_FRAC_MAX_N = 255
+FLLHJ_FRAC_MIN_N = 2
+FLLHJ_LP_INT_MODE_THRESH = 100000
+FLLHJ_LOW_THRESH = 192000
+FLLHJ_MID_THRESH = 1152000
+FLLHJ_MAX_THRESH = 13000000
+FLLHJ_LOW_GAINS = 0x23f0
+FLLHJ_MID_GAINS = 0x22f2
+FLLHJ_HIGH_GAINS = 0x21f0
+CS47L63_FLL_MAX_FOUT = 50000000
+
+#==========================================================================
+# CLASSES
+#==========================================================================
+
+#==========================================================================
+# HELPER FUNCTIONS
+#==========================================================================
+def gcd(n1, n2):
+    while (n1 != n2):
+        if (n1 > n2):
+            n1 -= n2
+        else:
+            n2 -= n1
+
+    return n1
+
+def madera_calc_fll(fref, fout, sync):
+    """Return (n, theta, lambda, refdiv, fratio, gain, alt_gain), or None if the driver would fail"""
+    if (fout < MADERA_FLL_MIN_FOUT) or (fout > MADERA_FLL_MAX_FOUT):
+        return None
+
+    div = 1
+    refdiv = 0
+    while (fref > MADERA_FLL_MAX_FREF):
+        div *= 2
+        fref //= 2
+        refdiv += 1
+        if (div > MADERA_FLL_MAX_REFDIV):
+            return None
+
+    if (sync):
+        ratio = -1
+        for (fmin, fmax, f, r) in madera_fll_sync_fratios:
+            if (fmin <= fref) and (fref <= fmax):
+                (fratio, ratio) = (f, r)
+                break
+        if (ratio < 0):
+            return None
+    else:
+        ratio = 1
+        while ((fout // (ratio * fref)) > MADERA_FLL_MAX_N):
+            ratio += 1
+        fratio = ratio - 1
+
+    n = fout // (ratio * fref)
+    if (fout % (ratio * fref)):
+        gcd_fll = gcd(fout, ratio * fref)
+        theta = (fout - (n * ratio * fref)) // gcd_fll
+        lambda_ = (ratio * fref) // gcd_fll
+    else:
+        theta = 0
+        lambda_ = 0
+
+    while (lambda_ >= (1 << 16)):
+        theta >>= 1
+        lambda_ >>= 1
+
+    for (fmin, fmax, g, ag) in (madera_fll_sync_gains if sync else madera_fll_main_gains):
+        if (fmin <= fref) and (fref <= fmax):
+            return (n, theta, lambda_, refdiv, fratio, g, ag)
+
+    return None
+
+def cs47l63_calc_fll(fin, fout):
+    """Return (refdiv, lockdet_thr, n, theta, lambda, gains, hp, fbdiv), or None if the driver would fail"""
+    if (fout > CS47L63_FLL_MAX_FOUT):
+        return None
+
+    for refdiv in range(0, 4):
+        if ((fin // (1 << refdiv)) <= FLLHJ_MAX_THRESH):
+            break
+
+    fref = fin // (1 << refdiv)
+    frac = (fout % fref) != 0
+
+    if (fref < FLLHJ_LOW_THRESH):
+        lockdet_thr = 2
+        gains = FLLHJ_LOW_GAINS
+        fbdiv = 256 if frac else 4
+    elif (fref < FLLHJ_MID_THRESH):
+        lockdet_thr = 8
+        gains = FLLHJ_MID_GAINS
+        fbdiv = 16 if frac else 2
+    else:
+        lockdet_thr = 8
+        gains = FLLHJ_HIGH_GAINS
+        fbdiv = 1
+
+    if (frac):
+        hp = 0x3
+        (min_n, max_n) = (FLLHJ_FRAC_MIN_N, FLLHJ_FRAC_MAX_N)
+    else:
+        hp = 0x0 if (fref < FLLHJ_LP_INT_MODE_THRESH) else 0x1
+        (min_n, max_n) = (FLLHJ_INT_MIN_N, FLLHJ_INT_MAX_N)
+
+    ratio = fout // fref
+    while ((ratio // fbdiv) < min_n):
+        fbdiv //= 2
+        if (fbdiv < min_n):
+            return None
+    while (frac and ((ratio // fbdiv) > max_n)):
+        fbdiv *= 2
+        if (fbdiv >= 1024):
+            return None
+
+    fllgcd = gcd(fout, fbdiv * fref)
+    num = fout // fllgcd
+    lambda_ = (fref * fbdiv) // fllgcd
+    n = num // lambda_
+    theta = num % lambda_
+
+    if (n < min_n) or (n > max_n):
+        return None
+    if (fbdiv < 1) or (frac and (fbdiv >= 1024)) or ((not frac) and (fbdiv >= 256)):
+        return None
+
+    return (refdiv, lockdet_thr, n, theta, lambda_, gains, hp, fbdiv)
+
+def madera_table(frefs, fouts):
+    lines = []
+    lines.append("/*")
+    lines.append(" * Precomputed FLL configurations for common clock plans, checked by madera_calc_fll() before")
+    lines.append(" * falling back to calculation.  Generated by tools/fll_table_generator/fll_table_generator.py - regenerate")
+    lines.append(" * rather than editing by hand.  tools/fll_table_check checks every entry bit for bit against madera_calc_fll_cfg().")
+    lines.append(" */")
+    lines.append("static const madera_fll_table_entry_t madera_fll_table[] = {")
+    lines.append("    /*    fref,      fout,  sync, {    n, theta, lambda, refdiv, fratio, gain, alt_gain } */")
+    for fout in fouts:
+        for fref in frefs:
+            for sync in [False, True]:
+                cfg = madera_calc_fll(fref, fout, sync)
+                if (cfg is None):
+                    continue
+                lines.append("    {{ {:>8}, {:>9}, {:>5}, {{ {:>4}, {:>5}, {:>6}, {:>6}, {:>6}, {:>4}, {:>8} }} }},".format(
+                             fref, fout, 'true' if sync else 'false', *cfg))
+    lines.append("};")
+
+    return lines
+
+def cs47l63_table(frefs, fouts):
+    lines = []
+    lines.append("/*")
+    lines.append(" * Precomputed FLL configurations for common clock plans, checked by cs47l63_fll_do_config() before")
+    lines.append(" * falling back to calculation.  Generated by tools/fll_table_generator/fll_table_generator.py - regenerate")
+    lines.append(" * rather than editing by hand.  tools/fll_table_check checks every entry bit for bit against cs47l63_fll_calc_cfg().")
+    lines.append(" */")
+    lines.append("static const cs47l63_fll_table_entry_t cs47l63_fll_table[] = {")
+    lines.append("    /*     fin,     fout, { refdiv, lockdet_thr,   n, theta, lambda,  gains, hp, fbdiv } */")
+    for fout in fouts:
+        for fin in frefs:
+            cfg = cs47l63_calc_fll(fin, fout)
+            if (cfg is None):
+                continue
+            lines.append("    {{ {:>8}, {:>8}, {{ {:>6}, {:>11}, {:>3}, {:>5}, {:>6}, {:#06x}, {:>2}, {:>5} }} }},".format(
+                         fin, fout, *cfg))
+    lines.append("};")
+
+    return lines
+
+def validate_environment():
+    result = True
+
+    return result
+
+def get_args(args):
+    """Parse arguments"""
+    parser = argparse.ArgumentParser(description='Parse command line arguments')
+    parser.add_argument(dest='part', type=str, choices=supported_parts, help='The part to generate the FLL table for - madera covers CS47L15 and CS47L35.')
+    parser.add_argument('-r', '--fref', dest='frefs', type=int, nargs='*', default=default_frefs,
+                        help='FLL reference frequencies in Hz.')
+    parser.add_argument('-f', '--fout', dest='fouts', type=int, nargs='*', default=None,
+                        help='FLL output frequencies in Hz.  Defaults to the 48k and 44.1k family rates for the part.')
+    parser.add_argument('-o', '--output', dest='output', type=str, default=None,
+                        help='Output file.  Defaults to printing the table.')
+
+    return parser.parse_args(args[1:])
+
+def validate_args(args):
+    if (len(args.frefs) == 0):
+        print("At least one reference frequency is required")
+        return False
+    if (args.fouts is not None) and (len(args.fouts) == 0):
+        print("At least one output frequency is required")
+        return False
+
+    return True
+
+def print_start():
+    print("")
+    print("fll_table_generator")
+    print("SDK version " + print_sdk_version(repo_path + '/sdk_version.h'))
+
+    return
+
+def print_args(args):
+    print("")
+    print("Part: " + args.part)
+    print("fref: " + ', '.join([str(f) for f in args.frefs]))
+    print("fout: " + ', '.join([str(f) for f in args.fouts]))
+
+    return
+
+def error_exit(error_message):
+    print('ERROR: ' + error_message)
+    exit(1)
+
+#==========================================================================
+# MAIN PROGRAM
+#==========================================================================
+def main(argv):
+    print_start()
+
+    if (not validate_environment()):
+        error_exit("Invalid Environment")
+
+    args = get_args(argv)
+    if (not validate_args(args)):
+        error_exit("Invalid Arguments")
+
+    if (args.fouts is None):
+        args.fouts = default_fouts[args.part]
+
+    print_args(args)
+
+    if (args.part == 'cs47l63'):
+        lines = cs47l63_table(args.frefs, args.fouts)
+    else:
+        lines = madera_table(args.frefs, args.fouts)
+
+    if (args.output is None):
+        print("")
+        print('\n'.join(lines))
+    else:
+        with open(args.output, 'w') as f:
+            f.write('\n'.join(lines) + '\n')
+        print("Wrote table to " + args.output)
+
+    print("Exit.")
+
+    return
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,269 @@
+/**
+ * @file halo_mbox_check.c
+ *
+ * @brief Host check of HALO mailbox ack polling and latency statistics
+ *
+ * Sends mailbox commands to a simulated device that acks after a set number of polls, with a BSP timer that overruns
+ * each delay by a fixed amount.  Checks that latencies follow the BSP get_time_ms() clock, including across the clock
+ * wrapping, that they fall back to the sum of polling delays without a clock, that IRQ flag acks are cleared, and
+ * that a command that is never acked times out without changing the latencies.
+ *
+ * Usage: halo_mbox_check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "halo_mbox.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define CHECK_MBOX_REG                      (0x00013020)
+#define CHECK_ACK_REG                       (0x00010014)
+#define CHECK_ACK_MASK                      (0x00000004)
+#define CHECK_CMD                           (0x00000002)
+#define CHECK_NEVER                         (0xFFFFFFFF)    ///< Polls before the ack for a command never acked
+#define CHECK_TIMER_OVERRUN_MS              (1)             ///< Extra time each BSP timer delay takes
+#define CHECK_SPI_PAD_LEN                   (4)
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Simulated device and BSP clock
+ */
+typedef struct
+{
+    uint32_t time_ms;
+    uint32_t mbox;                      ///< Command register - reads back 0 once acked
+    uint32_t ack_flags;                 ///< W1C IRQ flag register
+    uint32_t acked_after;               ///< Polls of the ack before the command is acked
+    uint32_t polls;
+    uint32_t ack_clear_count;           ///< Writes clearing the ack IRQ flag
+} check_sim_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static check_sim_t sim;
+
+static const halo_mbox_config_t check_config_clear =
+{
+    .ack_type = HALO_MBOX_ACK_TYPE_CLEAR,
+    .ack_mask = 0xFFFFFFFF,
+    .ack_val = 0,
+    .poll_delay_max_ms = 2,
+    .timeout_ms = 20,
+};
+
+static const halo_mbox_config_t check_config_irq =
+{
+    .ack_type = HALO_MBOX_ACK_TYPE_IRQ,
+    .ack_reg = CHECK_ACK_REG,
+    .ack_mask = CHECK_ACK_MASK,
+    .ack_val = CHECK_ACK_MASK,
+    .poll_delay_max_ms = 2,
+    .timeout_ms = 20,
+};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+static uint32_t check_get_addr(const uint8_t *addr_buffer)
+{
+    // Mask off the SPI R/W bit
+    return (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+           ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+}
+
+static uint32_t check_set_timer(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg)
+{
+    sim.time_ms += duration_ms + CHECK_TIMER_OVERRUN_MS;
+
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_get_time_ms(void)
+{
+    return sim.time_ms;
+}
+
+static uint32_t check_spi_read(uint32_t bsp_dev_id,
+                               uint8_t *addr_buffer,
+                               uint32_t addr_length,
+                               uint8_t *data_buffer,
+                               uint32_t data_length,
+                               uint32_t pad_len)
+{
+    uint32_t addr = check_get_addr(addr_buffer);
+    uint32_t val = 0;
+
+    // The device acks on the poll after 'acked_after' polls
+    if ((addr == CHECK_MBOX_REG) || (addr == CHECK_ACK_REG))
+    {
+        if ((sim.acked_after != CHECK_NEVER) && (sim.polls >= sim.acked_after))
+        {
+            sim.mbox = 0;
+            sim.ack_flags |= CHECK_ACK_MASK;
+        }
+        sim.polls++;
+        val = (addr == CHECK_MBOX_REG) ? sim.mbox : sim.ack_flags;
+    }
+
+    data_buffer[0] = GET_BYTE_FROM_WORD(val, 3);
+    data_buffer[1] = GET_BYTE_FROM_WORD(val, 2);
+    data_buffer[2] = GET_BYTE_FROM_WORD(val, 1);
+    data_buffer[3] = GET_BYTE_FROM_WORD(val, 0);
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_spi_write(uint32_t bsp_dev_id,
+                                uint8_t *addr_buffer,
+                                uint32_t addr_length,
+                                uint8_t *data_buffer,
+                                uint32_t data_length,
+                                uint32_t pad_len)
+{
+    uint32_t addr = check_get_addr(addr_buffer);
+    uint32_t val = ((uint32_t) data_buffer[0] << 24) | ((uint32_t) data_buffer[1] << 16) |
+                   ((uint32_t) data_buffer[2] << 8) | data_buffer[3];
+
+    if (addr == CHECK_MBOX_REG)
+    {
+        sim.mbox = val;
+    }
+    else if (addr == CHECK_ACK_REG)
+    {
+        sim.ack_flags &= ~val;
+        sim.ack_clear_count += ((val & CHECK_ACK_MASK) != 0);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+static bsp_driver_if_t check_driver_if_s =
+{
+    .set_timer = &check_set_timer,
+    .get_time_ms = &check_get_time_ms,
+    .spi_read = &check_spi_read,
+    .spi_write = &check_spi_write,
+};
+
+bsp_driver_if_t *bsp_driver_if_g = &check_driver_if_s;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Send one command, acked on the poll after 'acked_after' polls, and check its latency
+ *
+ */
+static uint32_t check_command(const char *name,
+                              const halo_mbox_config_t *config,
+                              bool has_clock,
+                              uint32_t start_ms,
+                              uint32_t acked_after,
+                              uint32_t expected_ret,
+                              uint32_t expected_latency_ms)
+{
+    regmap_cp_config_t cp;
+    halo_mbox_t mbox;
+    uint32_t ret;
+    bool ok = true;
+
+    memset(&sim, 0, sizeof(check_sim_t));
+    sim.time_ms = start_ms;
+    sim.acked_after = acked_after;
+    check_driver_if_s.get_time_ms = has_clock ? &check_get_time_ms : NULL;
+
+    memset(&cp, 0, sizeof(regmap_cp_config_t));
+    cp.bus_type = REGMAP_BUS_TYPE_SPI;
+    cp.spi_pad_len = CHECK_SPI_PAD_LEN;
+
+    halo_mbox_initialize(&mbox, &cp, config);
+    // A previous command's latency, which a timeout must leave as it is
+    mbox.stats.last_latency_ms = 1000;
+
+    ret = halo_mbox_send_acked(&mbox, CHECK_MBOX_REG, CHECK_CMD);
+
+    ok &= (ret == expected_ret);
+    ok &= (mbox.stats.cmd_count == 1);
+    ok &= (mbox.stats.fail_count == (expected_ret != HALO_MBOX_STATUS_OK));
+    ok &= (mbox.stats.poll_count == sim.polls);
+    ok &= (mbox.stats.last_latency_ms == expected_latency_ms);
+    if ((config->ack_type == HALO_MBOX_ACK_TYPE_IRQ) && (expected_ret == HALO_MBOX_STATUS_OK))
+    {
+        ok &= (sim.ack_clear_count == 1);
+    }
+
+    printf("  %-40s polls %2u latency %4ums - %s\n",
+           name,
+           mbox.stats.poll_count,
+           mbox.stats.last_latency_ms,
+           ok ? "OK" : "FAIL");
+
+    return ok ? 0 : 1;
+}
+
+/***********************************************************************************************************************
+ * MAIN
+ **********************************************************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t fail_count = 0;
+
+    printf("halo_mbox_check\n");
+
+    // Acked on the first poll, before any delay
+    fail_count += check_command("clear ack, first poll", &check_config_clear, true, 100, 0, HALO_MBOX_STATUS_OK, 0);
+    // Delays of 1, 2 and 2ms before the 4th poll, each overrunning by CHECK_TIMER_OVERRUN_MS
+    fail_count += check_command("clear ack, 4th poll", &check_config_clear, true, 100, 3, HALO_MBOX_STATUS_OK, 8);
+    fail_count += check_command("clear ack, 4th poll, no clock", &check_config_clear, false, 100, 3,
+                                HALO_MBOX_STATUS_OK, 5);
+    fail_count += check_command("clear ack, 4th poll, clock wraps", &check_config_clear, true, 0xFFFFFFFD, 3,
+                                HALO_MBOX_STATUS_OK, 8);
+    fail_count += check_command("IRQ flag ack, 3rd poll", &check_config_irq, true, 100, 2, HALO_MBOX_STATUS_OK, 5);
+    fail_count += check_command("timeout", &check_config_clear, true, 100, CHECK_NEVER, HALO_MBOX_STATUS_FAIL, 1000);
+
+    if (fail_count > 0)
+    {
+        printf("FAIL: %u check(s) failed\n", fail_count);
+        return 1;
+    }
+
+    printf("PASS\n");
+
+    return 0;
+}
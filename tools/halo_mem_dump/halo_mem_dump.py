@@ -0,0 +1,393 @@
+#==========================================================================
+# (c) 2022 Cirrus Logic, Inc.
+#--------------------------------------------------------------------------
+# Project : Dump and diff HALO DSP memory over StudioBridge
+# File    : halo_mem_dump.py
+#--------------------------------------------------------------------------
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#--------------------------------------------------------------------------
+#
+# Environment Requirements: None
+#
+#==========================================================================
+
+#==========================================================================
+# IMPORTS
+#==========================================================================
+import os
+import sys
+repo_path = os.path.dirname(os.path.abspath(__file__)) + '/../..'
+sys.path.insert(1, (repo_path + '/tools/sdk_version'))
+sys.path.insert(1, (repo_path + '/tools/firmware_converter'))
+from sdk_version import print_sdk_version
+from wmfw_parser import wmfw_parser, get_memory_region_from_type
+from firmware_converter import address_resolver, supported_mem_maps
+import argparse
+import socket
+import struct
+
+#==========================================================================
+# VERSION
+#==========================================================================
+
+#==========================================================================
+# CONSTANTS/GLOBALS
+#==========================================================================
+supported_commands = ['dump', 'diff']
+
+BRIDGE_DEFAULT_HOST = '127.0.0.1'
+BRIDGE_DEFAULT_PORT = 22349
+# Must not exceed BRIDGE_MAX_BLOCK_READ_BYTES in common/bridge/bridge.h.  Only MCUs sending BlockRead data in hex are
+# limited to this - with binary negotiated by bridge_agent.py, the MCU streams a read of any length.
+BRIDGE_MAX_BLOCK_READ_BYTES = 800
+# Error the MCU replies with to a hex BlockRead larger than BRIDGE_MAX_BLOCK_READ_BYTES
+BRIDGE_ERROR_UNSUPPORTED = '33'
+BRIDGE_GREETING_LINES = 3
+
+FW_IMG_MAGIC_NUMBER_1 = 0x54b998ff
+FW_IMG_MAGIC_NUMBER_2 = 0x936be2a6
+HALO_WORD_BYTES = 4
+
+#==========================================================================
+# CLASSES
+#==========================================================================
+class bridge_unsupported_excpn(IOError):
+    pass
+
+class bridge_client:
+    """StudioBridge client for reading device memory through bridge_agent.py"""
+    def __init__(self, host, port, device_name=None):
+        self.sock = socket.create_connection((host, port))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.rx_buffer = b''
+        self.seq_num = 0
+
+        for i in range(0, BRIDGE_GREETING_LINES):
+            self.read_line()
+
+        # bridge_agent.py only learns the chip IDs for each device name from a Detect
+        devices = self.command('Detect').split()[1:]
+        names = [d.split(',')[0] for d in devices]
+        if (device_name is None):
+            device_name = names[0]
+        elif (device_name not in names):
+            raise ValueError("Device '{}' not found, detected: {}".format(device_name, ', '.join(names)))
+        self.device_name = device_name
+
+        return
+
+    def close(self):
+        self.sock.close()
+
+    def read_line(self):
+        while (b'\n' not in self.rx_buffer):
+            data = self.sock.recv(4096)
+            if (not data):
+                raise IOError("Bridge closed connection")
+            self.rx_buffer += data
+        line, self.rx_buffer = self.rx_buffer.split(b'\n', 1)
+
+        return str(line, 'UTF-8')
+
+    def command(self, cmd_str):
+        self.sock.sendall((cmd_str + '\n').encode())
+        reply = self.read_line()
+        if (reply.startswith('Error') or (' Error ' in reply)):
+            if (reply.split()[-1] == BRIDGE_ERROR_UNSUPPORTED):
+                raise bridge_unsupported_excpn("Bridge command '{}' not supported: {}".format(cmd_str, reply))
+            raise IOError("Bridge command '{}' failed: {}".format(cmd_str, reply))
+
+        return reply
+
+    def read_block(self, address, length):
+        self.seq_num = (self.seq_num + 1) & 0xFF
+        reply = self.command("[{}:{:x}] BR {:x} {:x}".format(self.device_name, self.seq_num, address, length))
+        # Strip "[<seq>] " prefix
+        data = bytes.fromhex(reply.split()[-1])
+        if (len(data) != length):
+            raise IOError("BlockRead of {} bytes from {:#x} returned {} bytes".format(length, address, len(data)))
+
+        return data
+
+class memory_reader:
+    """Read arbitrary length ranges using the largest block reads the transport allows
+
+    Each range is first read with a single BlockRead, which the MCU streams when bridge_agent.py has negotiated binary
+    BlockRead data.  An MCU sending hex rejects reads over BRIDGE_MAX_BLOCK_READ_BYTES as unsupported, after which
+    ranges are read in chunks of 'block_size'.
+
+    'read_block' is any callable taking (address, length) and returning the bytes in control port order, so a mock
+    can stand in for the bridge.  'bytes_per_addr' is 2 for ADSP2 cores, whose control port addresses 16-bit registers.
+    """
+    def __init__(self, read_block, block_size=BRIDGE_MAX_BLOCK_READ_BYTES, stream=True, bytes_per_addr=1):
+        self.read_block = read_block
+        self.block_size = block_size - (block_size % HALO_WORD_BYTES)
+        self.stream = stream
+        self.bytes_per_addr = bytes_per_addr
+        self.read_count = 0
+        self.bytes_read = 0
+
+        return
+
+    def read_range(self, address, length):
+        if (self.stream and (length > self.block_size)):
+            try:
+                data = self.read_block(address, length)
+                self.read_count += 1
+                self.bytes_read += length
+                return data
+            except bridge_unsupported_excpn:
+                self.stream = False
+
+        data = bytearray()
+        while (length > 0):
+            chunk = min(length, self.block_size)
+            data += self.read_block(address, chunk)
+            self.read_count += 1
+            self.bytes_read += chunk
+            address += chunk // self.bytes_per_addr
+            length -= chunk
+
+        return bytes(data)
+
+#==========================================================================
+# HELPER FUNCTIONS
+#==========================================================================
+def parse_fw_img(fw_img_bytes):
+    """Return the list of (address, payload) data blocks from a binary fw_img"""
+    words = lambda offset, count: struct.unpack_from('<' + 'I' * count, fw_img_bytes, offset)
+
+    (magic_1, format_rev) = words(0, 2)
+    if (magic_1 != FW_IMG_MAGIC_NUMBER_1):
+        raise ValueError("Incorrect fw_img magic number")
+    if (format_rev == 1):
+        header_words = 6
+    elif (format_rev == 2):
+        header_words = 8
+    else:
+        raise ValueError("Unsupported fw_img format revision {}".format(format_rev))
+
+    (img_size, sym_table_size, alg_id_list_size, fw_id, fw_version, data_blocks) = words(8, 6)
+    offset = 8 + (header_words * 4) + (sym_table_size * 8) + (alg_id_list_size * 4)
+
+    blocks = []
+    for i in range(0, data_blocks):
+        (block_size, block_addr) = words(offset, 2)
+        offset += 8
+        blocks.append((block_addr, fw_img_bytes[offset:(offset + block_size)]))
+        offset += block_size
+
+    if (words(offset, 1)[0] != FW_IMG_MAGIC_NUMBER_2):
+        raise ValueError("Incorrect fw_img magic number 2")
+
+    return blocks
+
+def parse_wmfw(filename, part_number):
+    """Return the list of (address, payload) data blocks from a wmfw, and the bytes per control port address
+
+    Addresses are resolved against the part's memory map exactly as firmware_converter.py does when building a fw_img.
+    """
+    res = address_resolver(part_number)
+    if (not hasattr(res, 'mem_map')):
+        raise ValueError("Unsupported part '{}'".format(part_number))
+
+    wmfw = wmfw_parser(filename)
+    wmfw.parse()
+
+    blocks = []
+    for block in wmfw.get_data_blocks():
+        mem_region = get_memory_region_from_type(block.fields['type'])
+        if (mem_region != 'abs'):
+            address = res.resolve(mem_region, block.memory_type, block.fields['start_offset'])
+        else:
+            address = block.fields['start_offset']
+        blocks.append((address, b''.join(block.data)))
+
+    return (blocks, res.bytes_per_addr())
+
+def merge_blocks(blocks, bytes_per_addr=1):
+    """Merge address-contiguous data blocks so that each range is read with the fewest block reads"""
+    ranges = []
+    for (address, payload) in sorted(blocks, key=lambda b: b[0]):
+        if (len(ranges) and (ranges[-1][0] + (len(ranges[-1][1]) // bytes_per_addr) == address)):
+            ranges[-1][1] += payload
+        else:
+            ranges.append([address, bytearray(payload)])
+
+    return [(r[0], bytes(r[1])) for r in ranges]
+
+def diff_range(address, expected, actual, bytes_per_addr=1):
+    """Return the list of (address, expected word, actual word) for each mismatched word"""
+    mismatches = []
+    if (expected != actual):
+        for i in range(0, len(expected), HALO_WORD_BYTES):
+            e = int.from_bytes(expected[i:(i + HALO_WORD_BYTES)], 'big')
+            a = int.from_bytes(actual[i:(i + HALO_WORD_BYTES)], 'big')
+            if (e != a):
+                mismatches.append((address + (i // bytes_per_addr), e, a))
+
+    return mismatches
+
+def diff_blocks(reader, blocks):
+    """Diff the merged data blocks of a fw_img or wmfw, returning (words compared, mismatches)"""
+    mismatches = []
+    words = 0
+    for (address, expected) in merge_blocks(blocks, reader.bytes_per_addr):
+        actual = reader.read_range(address, len(expected))
+        mismatches += diff_range(address, expected, actual, reader.bytes_per_addr)
+        words += len(expected) // HALO_WORD_BYTES
+
+    return (words, mismatches)
+
+def get_parts():
+    parts = []
+    for key in supported_mem_maps.keys():
+        parts += supported_mem_maps[key]['parts']
+
+    return parts
+
+def validate_environment():
+    result = True
+
+    return result
+
+def get_args(args):
+    """Parse arguments"""
+    parser = argparse.ArgumentParser(description='Parse command line arguments')
+    parser.add_argument(dest='command', type=str, choices=supported_commands, help='The command you wish to execute.')
+    parser.add_argument('--host', dest='host', type=str, default=BRIDGE_DEFAULT_HOST, help='bridge_agent host.')
+    parser.add_argument('--port', dest='port', type=int, default=BRIDGE_DEFAULT_PORT, help='bridge_agent port.')
+    parser.add_argument('-d', '--device', dest='device', type=str, default=None,
+                        help='Device name as reported by Detect. Defaults to the first device.')
+    parser.add_argument('-r', '--range', dest='ranges', type=str, nargs='*', default=[],
+                        help='Range(s) to dump. Format: "<hex addr>,<hex length in bytes>"')
+    parser.add_argument('-f', '--fw-img', dest='fw_img', type=str, default=None,
+                        help='Binary fw_img (firmware_converter.py --binary-output) whose data blocks are the '
+                             'ranges to diff or dump.')
+    parser.add_argument('-w', '--wmfw', dest='wmfw', type=str, default=None,
+                        help='wmfw whose data blocks are the ranges to diff or dump. Requires --part.')
+    parser.add_argument('-p', '--part', dest='part', type=str, default=None, choices=get_parts(),
+                        help='Part number, to resolve wmfw addresses and to set the control port address size.')
+    parser.add_argument('-o', '--output', dest='output', type=str, default='halo_mem_dump.txt',
+                        help='Output file for dump command.')
+    parser.add_argument('-b', '--block-size', dest='block_size', type=int, default=BRIDGE_MAX_BLOCK_READ_BYTES,
+                        help='Maximum bytes per BlockRead if the MCU does not stream BlockRead data.')
+    parser.add_argument('--no-stream', dest='stream', action='store_false',
+                        help='Always read in chunks of --block-size, even if the MCU can stream BlockRead data.')
+
+    return parser.parse_args(args[1:])
+
+def validate_args(args):
+    if (args.fw_img is not None) and (args.wmfw is not None):
+        print("Only one of --fw-img and --wmfw may be given")
+        return False
+    if (args.wmfw is not None) and (args.part is None):
+        print("--wmfw requires --part")
+        return False
+    if (args.command == 'diff') and (args.fw_img is None) and (args.wmfw is None):
+        print("diff requires --fw-img or --wmfw")
+        return False
+    if (args.command == 'dump') and (args.fw_img is None) and (args.wmfw is None) and (len(args.ranges) == 0):
+        print("dump requires --range, --fw-img or --wmfw")
+        return False
+    if (args.block_size < HALO_WORD_BYTES) or (args.block_size > BRIDGE_MAX_BLOCK_READ_BYTES):
+        print("Block size must be between {} and {} bytes".format(HALO_WORD_BYTES, BRIDGE_MAX_BLOCK_READ_BYTES))
+        return False
+
+    return True
+
+def print_start():
+    print("")
+    print("halo_mem_dump")
+    print("SDK version " + print_sdk_version(repo_path + '/sdk_version.h'))
+
+    return
+
+def print_args(args):
+    print("")
+    print("Command: " + args.command)
+    print("Bridge: " + args.host + ":" + str(args.port))
+    if (args.fw_img is not None):
+        print("fw_img: " + args.fw_img)
+    if (args.wmfw is not None):
+        print("wmfw: " + args.wmfw + " (" + args.part + ")")
+    for r in args.ranges:
+        print("Range: " + r)
+
+    return
+
+def print_results(reader, words, mismatches):
+    print("")
+    print("Compared {} words with {} BlockReads ({} bytes)".format(words, reader.read_count, reader.bytes_read))
+    for (address, expected, actual) in mismatches:
+        print("    {:#010x}: expected {:#010x} actual {:#010x}".format(address, expected, actual))
+    print("{} mismatches".format(len(mismatches)))
+
+    return
+
+def error_exit(error_message):
+    print('ERROR: ' + error_message)
+    exit(1)
+
+#==========================================================================
+# MAIN PROGRAM
+#==========================================================================
+def main(argv):
+    print_start()
+
+    if (not validate_environment()):
+        error_exit("Invalid Environment")
+
+    args = get_args(argv)
+    if (not validate_args(args)):
+        error_exit("Invalid Arguments")
+
+    print_args(args)
+
+    blocks = []
+    bytes_per_addr = 1
+    if (args.part is not None):
+        bytes_per_addr = address_resolver(args.part).bytes_per_addr()
+    if (args.fw_img is not None):
+        with open(args.fw_img, 'rb') as f:
+            blocks = parse_fw_img(f.read())
+    if (args.wmfw is not None):
+        (blocks, bytes_per_addr) = parse_wmfw(args.wmfw, args.part)
+    ranges = [(a, len(p)) for (a, p) in merge_blocks(blocks, bytes_per_addr)]
+    for r in args.ranges:
+        (address, length) = r.split(',')
+        ranges.append((int(address, 16), int(length, 16)))
+
+    client = bridge_client(args.host, args.port, args.device)
+    reader = memory_reader(client.read_block, args.block_size, args.stream, bytes_per_addr)
+    try:
+        if (args.command == 'diff'):
+            (words, mismatches) = diff_blocks(reader, blocks)
+            print_results(reader, words, mismatches)
+        else:
+            with open(args.output, 'w') as f:
+                for (address, length) in ranges:
+                    data = reader.read_range(address, length)
+                    for i in range(0, len(data), HALO_WORD_BYTES):
+                        f.write("{:08x} {}\n".format(address + (i // bytes_per_addr),
+                                                      data[i:(i + HALO_WORD_BYTES)].hex()))
+            print("Dumped {} bytes with {} BlockReads to {}".format(reader.bytes_read, reader.read_count, args.output))
+    finally:
+        client.close()
+
+    print("Exit.")
+
+    return
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,410 @@
+/**
+ * @file halo_mem_dump_check.c
+ *
+ * @brief Host check of the HALO Core memory dump module
+ *
+ * Runs halo_mem_dump_range() and halo_mem_dump_diff() against a simulated SPI control port backed by a DSP memory
+ * image, checking:
+ * - that a range longer than the scratch buffer is read with the fewest block reads 'receive_max' allows
+ * - that the chunks passed to the callback cover the range in order, in control port byte order
+ * - that a diff against the image finds nothing, and a diff after corrupting words reports exactly those words
+ * - that ranges which are not whole words are rejected
+ * Then repeats the dump and diff against a virtual regmap, whose block reads return host-endian words.
+ *
+ * Usage: halo_mem_dump_check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "halo_mem_dump.h"
+#include "bsp_driver_if.h"
+#include "sdk_version.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define CHECK_MEM_BASE                      (0x02800000)    ///< Control port address of the simulated memory
+#define CHECK_MEM_WORDS                     (64)
+#define CHECK_BUFFER_BYTES                  (64)            ///< Scratch buffer for block reads
+#define CHECK_RECEIVE_MAX                   (42)            ///< Not a whole number of words, as BSPs may configure
+#define CHECK_BLOCK_BYTES                   (40)            ///< Block read size expected from the above
+#define CHECK_SPI_PAD_LEN                   (4)
+#define CHECK_VREG_WORDS                    (8)
+#define CHECK_MAX_REPORTS                   (8)             ///< Mismatches recorded per diff
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Chunks seen by the dump callback
+ */
+typedef struct
+{
+    uint32_t next_addr;                 ///< Address the next chunk should start at
+    uint32_t chunk_count;
+    uint32_t max_chunk;                 ///< Longest chunk, in bytes
+    bool is_ok;                         ///< (False) a chunk was out of order or did not match the memory
+} check_dump_context_t;
+
+/**
+ * Mismatches reported by the diff callback
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t addr[CHECK_MAX_REPORTS];
+    uint32_t expected[CHECK_MAX_REPORTS];
+    uint32_t actual[CHECK_MAX_REPORTS];
+} check_diff_context_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static uint32_t check_mem[CHECK_MEM_WORDS];     ///< Simulated DSP memory
+static uint32_t check_spi_read_count;
+
+static uint32_t check_vreg_read(void *self, uint32_t *val);
+
+#define CHECK_VREG(n) { .address = CHECK_MEM_BASE + ((n) * 4), .on_read = &check_vreg_read }
+
+static regmap_virtual_register_t check_vregs[CHECK_VREG_WORDS] =
+{
+    CHECK_VREG(0), CHECK_VREG(1), CHECK_VREG(2), CHECK_VREG(3),
+    CHECK_VREG(4), CHECK_VREG(5), CHECK_VREG(6), CHECK_VREG(7),
+};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Word at a control port address in the simulated memory, or 0 if outside it
+ *
+ */
+static uint32_t check_mem_get(uint32_t addr)
+{
+    if ((addr < CHECK_MEM_BASE) || (addr >= (CHECK_MEM_BASE + (CHECK_MEM_WORDS * 4))))
+    {
+        return 0;
+    }
+
+    return check_mem[(addr - CHECK_MEM_BASE) / 4];
+}
+
+static uint32_t check_vreg_read(void *self, uint32_t *val)
+{
+    *val = check_mem_get(((regmap_virtual_register_t *) self)->address);
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_spi_read(uint32_t bsp_dev_id,
+                               uint8_t *addr_buffer,
+                               uint32_t addr_length,
+                               uint8_t *data_buffer,
+                               uint32_t data_length,
+                               uint32_t pad_len)
+{
+    // Mask off the SPI R/W bit
+    uint32_t addr = (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+                    ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+
+    check_spi_read_count++;
+    for (uint32_t i = 0; (i + 4) <= data_length; i += 4, addr += 4)
+    {
+        uint32_t val = check_mem_get(addr);
+
+        data_buffer[i] = GET_BYTE_FROM_WORD(val, 3);
+        data_buffer[i + 1] = GET_BYTE_FROM_WORD(val, 2);
+        data_buffer[i + 2] = GET_BYTE_FROM_WORD(val, 1);
+        data_buffer[i + 3] = GET_BYTE_FROM_WORD(val, 0);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+/**
+ * Expected image of a range of the simulated memory, in control port byte order
+ *
+ */
+static void check_get_image(uint32_t addr, uint8_t *image, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i += 4)
+    {
+        uint32_t val = check_mem_get(addr + i);
+
+        image[i] = GET_BYTE_FROM_WORD(val, 3);
+        image[i + 1] = GET_BYTE_FROM_WORD(val, 2);
+        image[i + 2] = GET_BYTE_FROM_WORD(val, 1);
+        image[i + 3] = GET_BYTE_FROM_WORD(val, 0);
+    }
+
+    return;
+}
+
+static uint32_t check_dump_cb(uint32_t addr, uint8_t *bytes, uint32_t length, void *arg)
+{
+    check_dump_context_t *ctx = (check_dump_context_t *) arg;
+    uint8_t image[CHECK_BUFFER_BYTES];
+
+    check_get_image(addr, image, length);
+    if ((addr != ctx->next_addr) || (memcmp(bytes, image, length) != 0))
+    {
+        ctx->is_ok = false;
+    }
+
+    ctx->next_addr = addr + length;
+    ctx->chunk_count++;
+    if (length > ctx->max_chunk)
+    {
+        ctx->max_chunk = length;
+    }
+
+    return HALO_MEM_DUMP_STATUS_OK;
+}
+
+static void check_diff_cb(uint32_t addr, uint32_t expected, uint32_t actual, void *arg)
+{
+    check_diff_context_t *ctx = (check_diff_context_t *) arg;
+
+    if (ctx->count < CHECK_MAX_REPORTS)
+    {
+        ctx->addr[ctx->count] = addr;
+        ctx->expected[ctx->count] = expected;
+        ctx->actual[ctx->count] = actual;
+    }
+    ctx->count++;
+
+    return;
+}
+
+/**
+ * Dump and diff a range of the simulated memory through a control port
+ *
+ * If 'corrupt_word' is less than 'length' / 4, that word of the memory is changed after the expected image is taken,
+ * and the diff must report it and nothing else.
+ *
+ */
+static uint32_t check_dump_and_diff(const char *name,
+                                    regmap_cp_config_t *cp,
+                                    uint32_t addr,
+                                    uint32_t length,
+                                    uint32_t expected_reads,
+                                    uint32_t corrupt_word)
+{
+    halo_mem_dump_t dump;
+    uint8_t buffer[CHECK_BUFFER_BYTES];
+    uint8_t image[CHECK_MEM_WORDS * 4];
+    check_dump_context_t dump_ctx = { .next_addr = addr, .is_ok = true };
+    check_diff_context_t diff_ctx = {0};
+    uint32_t corrupt_addr = addr + (corrupt_word * 4);
+    uint32_t fail_count = 0;
+
+    if (halo_mem_dump_initialize(&dump, cp, buffer, sizeof(buffer)) != HALO_MEM_DUMP_STATUS_OK)
+    {
+        printf("  %s: initialize failed\n", name);
+        return 1;
+    }
+
+    check_spi_read_count = 0;
+    if ((halo_mem_dump_range(&dump, addr, length, &check_dump_cb, &dump_ctx) != HALO_MEM_DUMP_STATUS_OK) ||
+        !dump_ctx.is_ok || (dump_ctx.next_addr != (addr + length)))
+    {
+        printf("  %s: dump of %lu bytes did not match memory\n", name, (unsigned long) length);
+        fail_count++;
+    }
+    if ((dump.stats.read_count != expected_reads) || (dump_ctx.chunk_count != expected_reads) ||
+        (dump.stats.bytes_read != length) || (dump_ctx.max_chunk > dump.block_size))
+    {
+        printf("  %s: dump of %lu bytes took %lu reads, expected %lu\n",
+               name, (unsigned long) length, (unsigned long) dump.stats.read_count, (unsigned long) expected_reads);
+        fail_count++;
+    }
+    if ((cp->bus_type == REGMAP_BUS_TYPE_SPI) && (check_spi_read_count != expected_reads))
+    {
+        printf("  %s: %lu SPI reads for %lu block reads\n",
+               name, (unsigned long) check_spi_read_count, (unsigned long) expected_reads);
+        fail_count++;
+    }
+
+    check_get_image(addr, image, length);
+    if ((corrupt_word * 4) < length)
+    {
+        check_mem[(corrupt_addr - CHECK_MEM_BASE) / 4] ^= 0x00A5A5A5;
+    }
+
+    if (halo_mem_dump_diff(&dump, addr, image, length, &check_diff_cb, &diff_ctx) != HALO_MEM_DUMP_STATUS_OK)
+    {
+        printf("  %s: diff failed\n", name);
+        fail_count++;
+    }
+    else if ((corrupt_word * 4) < length)
+    {
+        const uint8_t *bytes = &(image[corrupt_word * 4]);
+        uint32_t expected = ((uint32_t) bytes[0] << 24) | ((uint32_t) bytes[1] << 16) | ((uint32_t) bytes[2] << 8) |
+                            bytes[3];
+
+        if ((diff_ctx.count != 1) || (dump.stats.mismatch_count != 1) ||
+            (dump.stats.first_mismatch_addr != corrupt_addr) || (diff_ctx.addr[0] != corrupt_addr) ||
+            (diff_ctx.expected[0] != expected) || (diff_ctx.actual[0] != (expected ^ 0x00A5A5A5)))
+        {
+            printf("  %s: diff reported %lu mismatches, expected 1 at 0x%08lX\n",
+                   name, (unsigned long) diff_ctx.count, (unsigned long) corrupt_addr);
+            fail_count++;
+        }
+    }
+    else if ((diff_ctx.count != 0) || (dump.stats.mismatch_count != 0))
+    {
+        printf("  %s: diff reported %lu mismatches against an unchanged image\n", name, (unsigned long) diff_ctx.count);
+        fail_count++;
+    }
+
+    if (dump.stats.words_compared != (length / 4))
+    {
+        printf("  %s: diff compared %lu words\n", name, (unsigned long) dump.stats.words_compared);
+        fail_count++;
+    }
+
+    if ((corrupt_word * 4) < length)
+    {
+        check_mem[(corrupt_addr - CHECK_MEM_BASE) / 4] ^= 0x00A5A5A5;
+    }
+
+    return fail_count;
+}
+
+/**
+ * Check dump and diff over SPI, where block reads are limited by 'receive_max'
+ *
+ */
+static uint32_t check_spi(void)
+{
+    regmap_cp_config_t cp = {0};
+    halo_mem_dump_t dump;
+    uint8_t buffer[CHECK_BUFFER_BYTES];
+    check_dump_context_t dump_ctx = { .next_addr = CHECK_MEM_BASE, .is_ok = true };
+    uint32_t fail_count = 0;
+
+    cp.bus_type = REGMAP_BUS_TYPE_SPI;
+    cp.receive_max = CHECK_RECEIVE_MAX;
+    cp.spi_pad_len = CHECK_SPI_PAD_LEN;
+
+    // Whole memory, one block, a partial last block, and a corrupt word at each end and in the middle
+    fail_count += check_dump_and_diff("SPI", &cp, CHECK_MEM_BASE, CHECK_MEM_WORDS * 4,
+                                      ((CHECK_MEM_WORDS * 4) + CHECK_BLOCK_BYTES - 1) / CHECK_BLOCK_BYTES,
+                                      CHECK_MEM_WORDS);
+    fail_count += check_dump_and_diff("SPI", &cp, CHECK_MEM_BASE + 8, CHECK_BLOCK_BYTES, 1, CHECK_MEM_WORDS);
+    fail_count += check_dump_and_diff("SPI", &cp, CHECK_MEM_BASE + 4, CHECK_BLOCK_BYTES + 4, 2, 0);
+    fail_count += check_dump_and_diff("SPI", &cp, CHECK_MEM_BASE, CHECK_MEM_WORDS * 4,
+                                      ((CHECK_MEM_WORDS * 4) + CHECK_BLOCK_BYTES - 1) / CHECK_BLOCK_BYTES, 33);
+    fail_count += check_dump_and_diff("SPI", &cp, CHECK_MEM_BASE, CHECK_MEM_WORDS * 4,
+                                      ((CHECK_MEM_WORDS * 4) + CHECK_BLOCK_BYTES - 1) / CHECK_BLOCK_BYTES,
+                                      CHECK_MEM_WORDS - 1);
+
+    halo_mem_dump_initialize(&dump, &cp, buffer, sizeof(buffer));
+    if (dump.block_size != CHECK_BLOCK_BYTES)
+    {
+        printf("  SPI: block size %lu, expected %u\n", (unsigned long) dump.block_size, CHECK_BLOCK_BYTES);
+        fail_count++;
+    }
+    if ((halo_mem_dump_range(&dump, CHECK_MEM_BASE, 6, &check_dump_cb, &dump_ctx) != HALO_MEM_DUMP_STATUS_FAIL) ||
+        (halo_mem_dump_range(&dump, CHECK_MEM_BASE, 8, NULL, NULL) != HALO_MEM_DUMP_STATUS_FAIL) ||
+        (halo_mem_dump_diff(&dump, CHECK_MEM_BASE, NULL, 8, NULL, NULL) != HALO_MEM_DUMP_STATUS_FAIL) ||
+        (halo_mem_dump_initialize(&dump, &cp, buffer, 3) != HALO_MEM_DUMP_STATUS_FAIL))
+    {
+        printf("  SPI: invalid arguments accepted\n");
+        fail_count++;
+    }
+
+    printf("  SPI, %u byte block reads: %s\n", CHECK_BLOCK_BYTES, (fail_count == 0) ? "OK" : "FAIL");
+
+    return fail_count;
+}
+
+/**
+ * Check dump and diff over a virtual regmap, whose block reads return host-endian words
+ *
+ */
+static uint32_t check_virtual(void)
+{
+    regmap_cp_config_t cp = {0};
+    uint32_t fail_count = 0;
+
+    // A virtual control port carries the register file address in 'dev_id', so the file must sit below 4GB
+    if ((uintptr_t) check_vregs > UINT32_MAX)
+    {
+        printf("  virtual regmap: SKIPPED - register file not addressable by 'dev_id'\n");
+        return 0;
+    }
+
+    cp.bus_type = REGMAP_BUS_TYPE_VIRTUAL;
+    cp.dev_id = (uint32_t) (uintptr_t) check_vregs;
+    cp.receive_max = CHECK_VREG_WORDS;
+
+    // 'receive_max' is the register file length here, so the block size is set by the scratch buffer alone
+    fail_count += check_dump_and_diff("virtual", &cp, CHECK_MEM_BASE, CHECK_VREG_WORDS * 4, 1, CHECK_VREG_WORDS);
+    fail_count += check_dump_and_diff("virtual", &cp, CHECK_MEM_BASE, CHECK_VREG_WORDS * 4, 1, 5);
+
+    printf("  virtual regmap: %s\n", (fail_count == 0) ? "OK" : "FAIL");
+
+    return fail_count;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+static bsp_driver_if_t check_driver_if_s =
+{
+    .spi_read = &check_spi_read,
+};
+
+bsp_driver_if_t *bsp_driver_if_g = &check_driver_if_s;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    uint32_t fail_count = 0;
+
+    printf("\n");
+    printf("halo_mem_dump_check\n");
+    printf("SDK version %d.%d.%d\n", SDK_VERSION_MAJOR, SDK_VERSION_MINOR, SDK_VERSION_UPDATE);
+    printf("\n");
+
+    // Distinct 24-bit DSP words, so any misplaced or byte-swapped word is caught
+    for (uint32_t i = 0; i < CHECK_MEM_WORDS; i++)
+    {
+        check_mem[i] = (0x123456 + (i * 0x010203)) & 0xFFFFFF;
+    }
+
+    fail_count += check_spi();
+    fail_count += check_virtual();
+
+    printf("\n");
+    printf("%s: %lu check(s) failed\n", (fail_count == 0) ? "PASS" : "FAIL", (unsigned long) fail_count);
+    printf("Exit.\n");
+
+    return (fail_count == 0) ? 0 : 1;
+}
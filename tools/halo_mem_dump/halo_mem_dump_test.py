@@ -0,0 +1,167 @@
+#==========================================================================
+# (c) 2022 Cirrus Logic, Inc.
+#--------------------------------------------------------------------------
+# Project : Dump and diff HALO DSP memory over StudioBridge
+# File    : halo_mem_dump_test.py
+#--------------------------------------------------------------------------
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#--------------------------------------------------------------------------
+#
+# Checks halo_mem_dump.py dump and diff against a mock device memory in
+# place of the bridge, with ranges from a fw_img built here and from the
+# wmfw files in the repo.
+#
+# Usage: python3 halo_mem_dump_test.py
+#
+# Environment Requirements: None
+#
+#==========================================================================
+
+#==========================================================================
+# IMPORTS
+#==========================================================================
+import os
+import sys
+import struct
+import unittest
+from halo_mem_dump import *
+
+#==========================================================================
+# CONSTANTS/GLOBALS
+#==========================================================================
+HALO_WMFW = repo_path + '/cs35l41/fw/halo_cspl_RAM_revB2_29.45.0.wmfw'
+ADSP2_WMFW = repo_path + '/cs47l15/fw/gaines_passthru_030500.wmfw'
+
+#==========================================================================
+# CLASSES
+#==========================================================================
+class mock_device:
+    """Device memory read a word at a time, as BlockRead does, in place of bridge_client.read_block
+
+    With 'max_read' set it behaves as an MCU sending BlockRead data in hex, rejecting longer reads as unsupported.
+    """
+    def __init__(self, bytes_per_addr=1, max_read=None):
+        self.bytes_per_addr = bytes_per_addr
+        self.max_read = max_read
+        self.words = {}
+        self.reads = []
+
+        return
+
+    def load(self, blocks):
+        for (address, payload) in blocks:
+            for i in range(0, len(payload), HALO_WORD_BYTES):
+                self.words[address + (i // self.bytes_per_addr)] = bytes(payload[i:(i + HALO_WORD_BYTES)])
+
+        return
+
+    def read_block(self, address, length):
+        if ((self.max_read is not None) and (length > self.max_read)):
+            raise bridge_unsupported_excpn("BlockRead of {} bytes not supported".format(length))
+        self.reads.append((address, length))
+
+        data = bytearray()
+        for i in range(0, length, HALO_WORD_BYTES):
+            data += self.words.get(address + (i // self.bytes_per_addr), bytes(HALO_WORD_BYTES))
+
+        return bytes(data)
+
+class halo_mem_dump_test(unittest.TestCase):
+    def build_fw_img(self, blocks):
+        """Binary fw_img, format revision 1, with no symbols or algorithms"""
+        body = b''
+        for (address, payload) in blocks:
+            body += struct.pack('<II', len(payload), address) + payload
+        header = struct.pack('<IIIIIIII', FW_IMG_MAGIC_NUMBER_1, 1, 0, 0, 0, 0x1234, 0x010203, len(blocks))
+
+        return header + body + struct.pack('<I', FW_IMG_MAGIC_NUMBER_2)
+
+    def check_diff(self, blocks, device, reader, corrupt_address):
+        device.load(blocks)
+        (words, mismatches) = diff_blocks(reader, blocks)
+        self.assertEqual(words, sum([len(p) for (a, p) in blocks]) // HALO_WORD_BYTES)
+        self.assertEqual(mismatches, [])
+
+        expected = int.from_bytes(device.words[corrupt_address], 'big')
+        device.words[corrupt_address] = (expected ^ 0xA5A5A5).to_bytes(HALO_WORD_BYTES, 'big')
+        (words, mismatches) = diff_blocks(reader, blocks)
+        self.assertEqual(mismatches, [(corrupt_address, expected, expected ^ 0xA5A5A5)])
+
+        return
+
+    def test_fw_img_dump_and_diff(self):
+        blocks = [(0x2800000, bytes(range(0, 16))),
+                  (0x2800010, bytes(range(16, 40))),
+                  (0x3400000, bytes(range(100, 108)))]
+        parsed = parse_fw_img(self.build_fw_img(blocks))
+        self.assertEqual(parsed, blocks)
+        self.assertEqual(merge_blocks(parsed), [(0x2800000, bytes(range(0, 40))), (0x3400000, bytes(range(100, 108)))])
+
+        device = mock_device()
+        reader = memory_reader(device.read_block, 16)
+        device.load(parsed)
+        self.assertEqual(reader.read_range(0x2800000, 40), bytes(range(0, 40)))
+        self.check_diff(parsed, device, reader, 0x2800014)
+
+        return
+
+    def test_stream_fallback(self):
+        blocks = [(0x2800000, bytes(i & 0xFF for i in range(0, 2000)))]
+
+        device = mock_device()
+        device.load(blocks)
+        reader = memory_reader(device.read_block)
+        self.assertEqual(reader.read_range(0x2800000, 2000), blocks[0][1])
+        self.assertEqual(device.reads, [(0x2800000, 2000)])
+
+        # An MCU sending hex rejects the long read, after which every range is read in chunks
+        device = mock_device(max_read=BRIDGE_MAX_BLOCK_READ_BYTES)
+        device.load(blocks)
+        reader = memory_reader(device.read_block)
+        self.assertEqual(reader.read_range(0x2800000, 2000), blocks[0][1])
+        self.assertEqual(device.reads, [(0x2800000, 800), (0x2800320, 800), (0x2800640, 400)])
+        self.assertFalse(reader.stream)
+        self.assertEqual((reader.read_count, reader.bytes_read), (3, 2000))
+
+        return
+
+    def test_wmfw_halo(self):
+        (blocks, bytes_per_addr) = parse_wmfw(HALO_WMFW, 'cs35l41')
+        self.assertEqual(bytes_per_addr, 1)
+        self.assertEqual(blocks[0][0], 0x2000000)
+
+        device = mock_device()
+        reader = memory_reader(device.read_block, BRIDGE_MAX_BLOCK_READ_BYTES, False)
+        (address, payload) = merge_blocks(blocks)[-1]
+        self.check_diff(blocks, device, reader, address + len(payload) - HALO_WORD_BYTES)
+
+        return
+
+    def test_wmfw_adsp2(self):
+        # ADSP2 control port addresses are 16-bit, so each 4-byte word spans 2 addresses
+        (blocks, bytes_per_addr) = parse_wmfw(ADSP2_WMFW, 'cs47l15')
+        self.assertEqual(bytes_per_addr, 2)
+
+        device = mock_device(bytes_per_addr, max_read=64)
+        reader = memory_reader(device.read_block, 64, True, bytes_per_addr)
+        (address, payload) = max(merge_blocks(blocks, bytes_per_addr), key=lambda r: len(r[1]))
+        self.assertGreater(len(payload), 64)
+        self.check_diff(blocks, device, reader, address + ((len(payload) - HALO_WORD_BYTES) // bytes_per_addr))
+
+        return
+
+#==========================================================================
+# MAIN PROGRAM
+#==========================================================================
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,187 @@
+/**
+ * @file irq_txn_bench.c
+ *
+ * @brief Host check of the control port transactions spent handling IRQs in the CS47L63 and CS40L26 drivers
+ *
+ * For each pending event scenario, runs a reference handler that reads and clears the EINT registers one at a time, as
+ * the drivers did before their reads and clears were batched, then runs the driver's own event handler on the same
+ * register file.  Both must leave the registers in the same state - every handled flag cleared and every other flag
+ * still pending - and the driver must not use more transfers than the reference.  Also checks the CS40L26 GPI Event Map
+ * entry encoding, and that cs40l26_set_gpio_event_map() and cs40l26_get_gpio_event_map() transfer every entry to and
+ * from the right register.
+ *
+ * Usage: irq_txn_bench
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "irq_txn_bench.h"
+#include "sdk_version.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define BENCH_SPI_PAD_LEN                   (4)         ///< As configured in bsp_cs47l63.c
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static const bench_part_t *bench_parts[] =
+{
+    &bench_part_cs47l63,
+    &bench_part_cs40l26,
+};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Compare two register files, printing each register that differs
+ *
+ */
+static uint32_t bench_compare_regs(const bench_sim_regs_t *expected, const bench_sim_regs_t *actual)
+{
+    uint32_t mismatch_count = 0;
+
+    for (uint32_t i = 0; i < expected->n_regs; i++)
+    {
+        if (expected->regs[i].val != actual->regs[i].val)
+        {
+            printf("    0x%08lX: expected 0x%08lX, driver left 0x%08lX\n",
+                   (unsigned long) expected->regs[i].addr,
+                   (unsigned long) expected->regs[i].val,
+                   (unsigned long) actual->regs[i].val);
+            mismatch_count++;
+        }
+    }
+
+    return mismatch_count;
+}
+
+/**
+ * Run every scenario for a part, returning the number that fail
+ *
+ */
+static uint32_t bench_run_part(const bench_part_t *part)
+{
+    regmap_cp_config_t cp = {0};
+    bench_sim_result_t ref_result;
+    bench_sim_regs_t ref_regs;
+    const bench_sim_result_t *drv_result;
+    uint32_t ref_flags, drv_flags;
+    uint32_t fail_count = 0;
+
+    cp.bus_type = part->bus_type;
+    cp.receive_max = 256;
+    cp.spi_pad_len = (part->bus_type == REGMAP_BUS_TYPE_I2C) ? 0 : BENCH_SPI_PAD_LEN;
+
+    printf("%s (%s)\n", part->name, (part->bus_type == REGMAP_BUS_TYPE_I2C) ? "I2C" : "SPI");
+    printf("  %-30s %14s %14s %14s  %s\n", "Scenario", "Reads", "Writes", "Bytes", "Result");
+
+    for (uint32_t i = 0; i < part->n_scenarios; i++)
+    {
+        const char *name;
+        bool is_ok = true;
+
+        part->setup(i);
+        if (part->run_reference(&cp, &ref_flags) != BENCH_STATUS_OK)
+        {
+            printf("  ERROR: Reference handler failed\n");
+            return part->n_scenarios;
+        }
+        ref_result = *(bench_sim_get_result());
+        ref_regs = *(bench_sim_get_regs());
+
+        name = part->setup(i);
+        if (part->run_driver(&cp, &drv_flags) != BENCH_STATUS_OK)
+        {
+            printf("  %s: driver event handler failed\n", name);
+            fail_count++;
+            continue;
+        }
+        drv_result = bench_sim_get_result();
+
+        if ((drv_result->read_count + drv_result->write_count) > (ref_result.read_count + ref_result.write_count))
+        {
+            is_ok = false;
+        }
+        if (part->has_reference_flags && (drv_flags != ref_flags))
+        {
+            is_ok = false;
+        }
+
+        printf("  %-30s %6lu -> %-5lu %6lu -> %-5lu %6lu -> %-5lu  %s, flags 0x%08lX\n",
+               name,
+               (unsigned long) ref_result.read_count, (unsigned long) drv_result->read_count,
+               (unsigned long) ref_result.write_count, (unsigned long) drv_result->write_count,
+               (unsigned long) ref_result.bus_bytes, (unsigned long) drv_result->bus_bytes,
+               is_ok ? "OK" : "FAIL", (unsigned long) drv_flags);
+        if (part->has_reference_flags && (drv_flags != ref_flags))
+        {
+            printf("    expected flags 0x%08lX\n", (unsigned long) ref_flags);
+        }
+
+        if (bench_compare_regs(&ref_regs, bench_sim_get_regs()) > 0)
+        {
+            is_ok = false;
+        }
+
+        if (!is_ok)
+        {
+            fail_count++;
+        }
+    }
+
+    printf("\n");
+
+    return fail_count;
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    regmap_cp_config_t cp = {0};
+    uint32_t fail_count = 0;
+
+    printf("\n");
+    printf("irq_txn_bench\n");
+    printf("SDK version %d.%d.%d\n", SDK_VERSION_MAJOR, SDK_VERSION_MINOR, SDK_VERSION_UPDATE);
+    printf("\n");
+
+    for (uint32_t i = 0; i < (sizeof(bench_parts) / sizeof(bench_part_t *)); i++)
+    {
+        fail_count += bench_run_part(bench_parts[i]);
+    }
+
+    cp.bus_type = REGMAP_BUS_TYPE_I2C;
+    cp.receive_max = 256;
+    fail_count += bench_cs40l26_check_event_map(&cp);
+
+    printf("%s: %lu check(s) failed\n", (fail_count == 0) ? "PASS" : "FAIL", (unsigned long) fail_count);
+    printf("Exit.\n");
+
+    return (fail_count == 0) ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file irq_txn_bench.h
+ *
+ * @brief Functions and prototypes shared by the IRQ handling transaction benchmark
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IRQ_TXN_BENCH_H
+#define IRQ_TXN_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmap.h"
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup BENCH_STATUS_
+ * @brief Return values for all bench calls
+ *
+ * @{
+ */
+#define BENCH_STATUS_OK                     (0)
+#define BENCH_STATUS_FAIL                   (1)
+/** @} */
+
+#define BENCH_SIM_MAX_REGS                  (32)
+
+/***********************************************************************************************************************
+ * MACROS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Control port transactions counted by the simulated bus
+ */
+typedef struct
+{
+    uint32_t read_count;                ///< Read transfers
+    uint32_t write_count;               ///< Write transfers
+    uint32_t bus_bytes;                 ///< Bytes clocked on the control port, including address and padding
+} bench_sim_result_t;
+
+/**
+ * One simulated register
+ */
+typedef struct
+{
+    uint32_t addr;
+    uint32_t val;
+    bool is_w1c;                        ///< (True) bits written as 1 are cleared, as for EINT registers
+} bench_sim_reg_t;
+
+/**
+ * Simulated register file
+ */
+typedef struct
+{
+    bench_sim_reg_t regs[BENCH_SIM_MAX_REGS];
+    uint32_t n_regs;
+} bench_sim_regs_t;
+
+/**
+ * Part under test
+ */
+typedef struct
+{
+    const char *name;                   ///< Part name
+    uint8_t bus_type;                   ///< REGMAP_BUS_TYPE_I2C or REGMAP_BUS_TYPE_SPI
+    uint32_t n_scenarios;               ///< Number of pending event scenarios
+    bool has_reference_flags;           ///< (True) the reference handler reports the same event flags as the driver
+    /**
+     * Load the register file for a scenario, returning its name
+     */
+    const char *(*setup)(uint32_t scenario);
+    /**
+     * Handle the pending events the way the driver did before its reads and clears were batched
+     */
+    uint32_t (*run_reference)(regmap_cp_config_t *cp, uint32_t *event_flags);
+    /**
+     * Handle the pending events with the driver's event handler
+     */
+    uint32_t (*run_driver)(regmap_cp_config_t *cp, uint32_t *event_flags);
+} bench_part_t;
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+extern const bench_part_t bench_part_cs47l63;
+extern const bench_part_t bench_part_cs40l26;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Empty the register file and zero the transaction counts
+ */
+void bench_sim_reset(void);
+
+/**
+ * Add a register to the register file - reads of any other address return 0 and writes to it are dropped
+ */
+uint32_t bench_sim_add_reg(uint32_t addr, uint32_t val, bool is_w1c);
+
+/**
+ * Transaction counts since the last bench_sim_reset()
+ */
+const bench_sim_result_t *bench_sim_get_result(void);
+
+/**
+ * Current contents of the register file
+ */
+const bench_sim_regs_t *bench_sim_get_regs(void);
+
+/**
+ * Check the CS40L26 GPI Event Map encoding and register transfer, returning the number of failures
+ */
+uint32_t bench_cs40l26_check_event_map(regmap_cp_config_t *cp);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IRQ_TXN_BENCH_H
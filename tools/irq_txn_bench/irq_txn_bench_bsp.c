@@ -0,0 +1,306 @@
+/**
+ * @file irq_txn_bench_bsp.c
+ *
+ * @brief Simulated control port and register file for the IRQ handling transaction benchmark
+ *
+ * Implements the BSP-Driver Interface control port calls used by regmap, counting each transfer and the bytes it
+ * clocks.  Reads and writes land in a small register file, where EINT registers clear the bits written as 1.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "irq_txn_bench.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Simulated control port and register file state
+ */
+typedef struct
+{
+    bench_sim_regs_t regs;
+    bench_sim_result_t result;
+} bench_sim_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static bench_sim_t sim;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Get a register in the register file, or NULL if it is not simulated
+ *
+ */
+static bench_sim_reg_t *bench_sim_get_reg(uint32_t addr)
+{
+    for (uint32_t i = 0; i < sim.regs.n_regs; i++)
+    {
+        if (sim.regs.regs[i].addr == addr)
+        {
+            return &(sim.regs.regs[i]);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Write words in control port byte order to the register file
+ *
+ */
+static void bench_sim_write_words(uint32_t addr, const uint8_t *bytes, uint32_t length)
+{
+    for (uint32_t i = 0; (i + 4) <= length; i += 4, addr += 4)
+    {
+        bench_sim_reg_t *reg = bench_sim_get_reg(addr);
+        uint32_t val = ((uint32_t) bytes[i] << 24) | ((uint32_t) bytes[i + 1] << 16) |
+                       ((uint32_t) bytes[i + 2] << 8) | bytes[i + 3];
+
+        if (reg == NULL)
+        {
+            continue;
+        }
+
+        if (reg->is_w1c)
+        {
+            reg->val &= ~val;
+        }
+        else
+        {
+            reg->val = val;
+        }
+    }
+
+    return;
+}
+
+/**
+ * Read words in control port byte order from the register file
+ *
+ */
+static void bench_sim_read_words(uint32_t addr, uint8_t *bytes, uint32_t length)
+{
+    for (uint32_t i = 0; (i + 4) <= length; i += 4, addr += 4)
+    {
+        bench_sim_reg_t *reg = bench_sim_get_reg(addr);
+        uint32_t val = (reg != NULL) ? reg->val : 0;
+
+        bytes[i] = GET_BYTE_FROM_WORD(val, 3);
+        bytes[i + 1] = GET_BYTE_FROM_WORD(val, 2);
+        bytes[i + 2] = GET_BYTE_FROM_WORD(val, 1);
+        bytes[i + 3] = GET_BYTE_FROM_WORD(val, 0);
+    }
+
+    return;
+}
+
+/**
+ * Get the control port address from a transfer's address phase
+ *
+ */
+static uint32_t bench_sim_get_addr(const uint8_t *addr_buffer)
+{
+    // Mask off the SPI R/W bit
+    return (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+           ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+}
+
+static uint32_t bench_set_timer(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg)
+{
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_set_gpio(uint32_t gpio_id, uint8_t gpio_state)
+{
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_i2c_read_repeated_start(uint32_t bsp_dev_id,
+                                              uint8_t *write_buffer,
+                                              uint32_t write_length,
+                                              uint8_t *read_buffer,
+                                              uint32_t read_length,
+                                              bsp_callback_t cb,
+                                              void *cb_arg)
+{
+    // Device address, register address, device address, data
+    sim.result.read_count++;
+    sim.result.bus_bytes += 2 + write_length + read_length;
+    bench_sim_read_words(bench_sim_get_addr(write_buffer), read_buffer, read_length);
+
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_i2c_write(uint32_t bsp_dev_id,
+                                uint8_t *write_buffer,
+                                uint32_t write_length,
+                                bsp_callback_t cb,
+                                void *cb_arg)
+{
+    // Device address, register address, data
+    sim.result.write_count++;
+    sim.result.bus_bytes += 1 + write_length;
+    bench_sim_write_words(bench_sim_get_addr(write_buffer), &(write_buffer[4]), write_length - 4);
+
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_i2c_db_write(uint32_t bsp_dev_id,
+                                   uint8_t *write_buffer_0,
+                                   uint32_t write_length_0,
+                                   uint8_t *write_buffer_1,
+                                   uint32_t write_length_1,
+                                   bsp_callback_t cb,
+                                   void *cb_arg)
+{
+    sim.result.write_count++;
+    sim.result.bus_bytes += 1 + write_length_0 + write_length_1;
+    bench_sim_write_words(bench_sim_get_addr(write_buffer_0), write_buffer_1, write_length_1);
+
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_spi_read(uint32_t bsp_dev_id,
+                               uint8_t *addr_buffer,
+                               uint32_t addr_length,
+                               uint8_t *data_buffer,
+                               uint32_t data_length,
+                               uint32_t pad_len)
+{
+    sim.result.read_count++;
+    sim.result.bus_bytes += addr_length + pad_len + data_length;
+    bench_sim_read_words(bench_sim_get_addr(addr_buffer), data_buffer, data_length);
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t bench_spi_write(uint32_t bsp_dev_id,
+                                uint8_t *addr_buffer,
+                                uint32_t addr_length,
+                                uint8_t *data_buffer,
+                                uint32_t data_length,
+                                uint32_t pad_len)
+{
+    sim.result.write_count++;
+    sim.result.bus_bytes += addr_length + pad_len + data_length;
+    bench_sim_write_words(bench_sim_get_addr(addr_buffer), data_buffer, data_length);
+
+    return BSP_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+static bsp_driver_if_t bench_driver_if_s =
+{
+    .set_gpio = &bench_set_gpio,
+    .set_timer = &bench_set_timer,
+    .i2c_read_repeated_start = &bench_i2c_read_repeated_start,
+    .i2c_write = &bench_i2c_write,
+    .i2c_db_write = &bench_i2c_db_write,
+    .spi_read = &bench_spi_read,
+    .spi_write = &bench_spi_write,
+};
+
+bsp_driver_if_t *bsp_driver_if_g = &bench_driver_if_s;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Empty the register file and zero the transaction counts
+ *
+ */
+void bench_sim_reset(void)
+{
+    memset(&sim, 0, sizeof(bench_sim_t));
+
+    return;
+}
+
+/**
+ * Add a register to the register file
+ *
+ */
+uint32_t bench_sim_add_reg(uint32_t addr, uint32_t val, bool is_w1c)
+{
+    if (sim.regs.n_regs >= BENCH_SIM_MAX_REGS)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    sim.regs.regs[sim.regs.n_regs].addr = addr;
+    sim.regs.regs[sim.regs.n_regs].val = val;
+    sim.regs.regs[sim.regs.n_regs].is_w1c = is_w1c;
+    sim.regs.n_regs++;
+
+    return BENCH_STATUS_OK;
+}
+
+/**
+ * Transaction counts since the last bench_sim_reset()
+ *
+ */
+const bench_sim_result_t *bench_sim_get_result(void)
+{
+    return &(sim.result);
+}
+
+/**
+ * Current contents of the register file
+ *
+ */
+const bench_sim_regs_t *bench_sim_get_regs(void)
+{
+    return &(sim.regs);
+}
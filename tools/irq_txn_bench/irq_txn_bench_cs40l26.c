@@ -0,0 +1,347 @@
+/**
+ * @file irq_txn_bench_cs40l26.c
+ *
+ * @brief CS40L26 event handling for the IRQ handling transaction benchmark
+ *
+ * The reference handler reads each IRQ1_EINT_* and IRQ1_MASK_* register on its own and clears each register's unmasked
+ * flags with its own write, as cs40l26_event_handler() did before its reads and clears were batched.  That handler
+ * overwrote the event flags with those of the last register it cleared, so only the register state is compared.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "irq_txn_bench.h"
+#include <stdio.h>
+#include "cs40l26.h"
+#include "cs40l26_ext.h"
+#include "cs40l26_spec.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define BENCH_CS40L26_IRQ1_REG_TOTAL        (4)
+#define BENCH_CS40L26_GUARD_VAL             (0xA5A5A5A5)    ///< Registers either side of the GPI Event Map
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * IRQ1 register contents in a scenario
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t eint[BENCH_CS40L26_IRQ1_REG_TOTAL];
+    uint32_t mask[BENCH_CS40L26_IRQ1_REG_TOTAL];
+} bench_cs40l26_scenario_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static cs40l26_t cs40l26_driver;
+
+static const bench_cs40l26_scenario_t bench_cs40l26_scenarios[] =
+{
+    {
+        "GPIO wake",
+        { IRQ1_IRQ1_EINT_1_WKSRC_STATUS1_EINT1_BITMASK, 0, 0, 0 },
+        { 0, 0, 0, 0 },
+    },
+    {
+        "CP wake, masked flag pending",
+        { IRQ1_IRQ1_EINT_1_WKSRC_STATUS5_EINT1_BITMASK | (1 << 0), 0, 0, 0 },
+        { (1 << 0), 0, 0, 0 },
+    },
+    {
+        "flags in every register",
+        {
+            IRQ1_IRQ1_EINT_1_WKSRC_STATUS2_EINT1_BITMASK | IRQ1_IRQ1_EINT_1_WKSRC_STATUS6_EINT1_BITMASK,
+            (1 << 3),
+            (1 << 7) | (1 << 8),
+            (1 << 0),
+        },
+        { 0, 0, (1 << 8), 0 },
+    },
+};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+static void bench_cs40l26_notification_cb(uint32_t event_flags, void *arg)
+{
+    *((uint32_t *) arg) |= event_flags;
+
+    return;
+}
+
+/**
+ * Load the register file for a scenario
+ *
+ */
+static const char *bench_cs40l26_setup(uint32_t scenario)
+{
+    const bench_cs40l26_scenario_t *s = &(bench_cs40l26_scenarios[scenario]);
+
+    bench_sim_reset();
+
+    bench_sim_add_reg(IRQ1_IRQ1_STATUS_REG, 1, false);
+    for (uint32_t i = 0; i < BENCH_CS40L26_IRQ1_REG_TOTAL; i++)
+    {
+        bench_sim_add_reg(IRQ1_IRQ1_EINT_1_REG + (i * 4), s->eint[i], true);
+        bench_sim_add_reg(IRQ1_IRQ1_MASK_1_REG + (i * 4), s->mask[i], false);
+    }
+
+    return s->name;
+}
+
+/**
+ * Handle events as cs40l26_event_handler() did before batching
+ *
+ */
+static uint32_t bench_cs40l26_run_reference(regmap_cp_config_t *cp, uint32_t *event_flags)
+{
+    uint32_t irq_status;
+    uint32_t irq_mask;
+
+    *event_flags = 0;
+
+    if (regmap_read(cp, IRQ1_IRQ1_STATUS_REG, &irq_status) || (irq_status == 0))
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    for (uint32_t i = 0; i < BENCH_CS40L26_IRQ1_REG_TOTAL; i++)
+    {
+        if (regmap_read(cp, IRQ1_IRQ1_EINT_1_REG + (i * 4), &irq_status) ||
+            regmap_read(cp, IRQ1_IRQ1_MASK_1_REG + (i * 4), &irq_mask))
+        {
+            return BENCH_STATUS_FAIL;
+        }
+
+        irq_status &= ~irq_mask;
+
+        if (irq_status)
+        {
+            if (regmap_write(cp, IRQ1_IRQ1_EINT_1_REG + (i * 4), irq_status))
+            {
+                return BENCH_STATUS_FAIL;
+            }
+        }
+    }
+
+    return BENCH_STATUS_OK;
+}
+
+/**
+ * Handle events with cs40l26_process(), as the BSP does once the IRQ pin has asserted
+ *
+ */
+static uint32_t bench_cs40l26_run_driver(regmap_cp_config_t *cp, uint32_t *event_flags)
+{
+    cs40l26_initialize(&cs40l26_driver);
+
+    *event_flags = 0;
+    cs40l26_driver.config.bsp_config.cp_config = *cp;
+    cs40l26_driver.config.bsp_config.notification_cb = &bench_cs40l26_notification_cb;
+    cs40l26_driver.config.bsp_config.notification_cb_arg = event_flags;
+    cs40l26_driver.mode = CS40L26_MODE_HANDLING_EVENTS;
+
+    cs40l26_process(&cs40l26_driver);
+    if (*event_flags & CS40L26_EVENT_FLAG_STATE_ERROR)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    return BENCH_STATUS_OK;
+}
+
+/**
+ * Check the GPI Event Map entry bitfield against the register encoding
+ *
+ */
+static uint32_t bench_cs40l26_check_event_map_entry(void)
+{
+    cs40l26_gpio_event_map_entry_t entry = {0};
+    uint32_t fail_count = 0;
+
+    entry.bank = CS40L26_EVENT_MAP_BANK_ROM;
+    entry.index = CS40L26_EVENT_MAP_INDEX_DISABLE;
+    if (entry.word != CS40L26_EVENT_MAP_GPI_DISABLE)
+    {
+        printf("    disable entry encodes as 0x%08lX\n", (unsigned long) entry.word);
+        fail_count++;
+    }
+
+    entry.word = CS40L26_EVENT_MAP_GPI_DISABLE;
+    if ((entry.bank != CS40L26_EVENT_MAP_BANK_ROM) || (entry.index != CS40L26_EVENT_MAP_INDEX_DISABLE) ||
+        (entry.reserved != 0))
+    {
+        printf("    CS40L26_EVENT_MAP_GPI_DISABLE decodes as bank %lu index 0x%02lX\n",
+               (unsigned long) entry.bank, (unsigned long) entry.index);
+        fail_count++;
+    }
+
+    for (uint32_t bank = 0; bank <= CS40L26_EVENT_MAP_BANK_OWT; bank++)
+    {
+        for (uint32_t index = 0; index <= CS40L26_EVENT_MAP_INDEX_MASK; index++)
+        {
+            entry.word = 0;
+            entry.bank = bank;
+            entry.index = index;
+            if (entry.word != (((bank << CS40L26_EVENT_MAP_BANK_SHIFT) & CS40L26_EVENT_MAP_BANK_MASK) |
+                               ((index << CS40L26_EVENT_MAP_INDEX_SHIFT) & CS40L26_EVENT_MAP_INDEX_MASK)))
+            {
+                printf("    bank %lu index 0x%02lX encodes as 0x%08lX\n",
+                       (unsigned long) bank, (unsigned long) index, (unsigned long) entry.word);
+                fail_count++;
+            }
+        }
+    }
+
+    return fail_count;
+}
+
+/**
+ * Check cs40l26_set_gpio_event_map() and cs40l26_get_gpio_event_map() against the register file
+ *
+ */
+static uint32_t bench_cs40l26_check_event_map_regs(regmap_cp_config_t *cp)
+{
+    cs40l26_gpio_event_map_t map;
+    const bench_sim_regs_t *regs;
+    uint32_t expected[CS40L26_EVENT_MAP_NUM_REGS + 2];
+    uint32_t fail_count = 0;
+
+    cs40l26_initialize(&cs40l26_driver);
+    cs40l26_driver.config.bsp_config.cp_config = *cp;
+
+    // Map GPIn rise to RAM effect n and fall to OWT effect n, except that GPI3 fall is disabled
+    memset(&map, 0, sizeof(map));
+    for (uint32_t i = 0; i < CS40L26_EVENT_MAP_NUM_GPI; i++)
+    {
+        map.gpi[i].rise.bank = CS40L26_EVENT_MAP_BANK_RAM;
+        map.gpi[i].rise.index = i + 1;
+        map.gpi[i].fall.bank = CS40L26_EVENT_MAP_BANK_OWT;
+        map.gpi[i].fall.index = i + 1;
+    }
+    map.gpi[2].fall.word = CS40L26_EVENT_MAP_GPI_DISABLE;
+
+    bench_sim_reset();
+    expected[0] = BENCH_CS40L26_GUARD_VAL;
+    expected[CS40L26_EVENT_MAP_NUM_REGS + 1] = BENCH_CS40L26_GUARD_VAL;
+    for (uint32_t i = 0; i < CS40L26_EVENT_MAP_NUM_GPI; i++)
+    {
+        expected[(i * 2) + 1] = ((CS40L26_EVENT_MAP_BANK_RAM << CS40L26_EVENT_MAP_BANK_SHIFT) | (i + 1));
+        expected[(i * 2) + 2] = ((CS40L26_EVENT_MAP_BANK_OWT << CS40L26_EVENT_MAP_BANK_SHIFT) | (i + 1));
+    }
+    expected[6] = CS40L26_EVENT_MAP_GPI_DISABLE;
+    for (uint32_t i = 0; i < (CS40L26_EVENT_MAP_NUM_REGS + 2); i++)
+    {
+        bench_sim_add_reg((CS40L26_A1_EVENT_MAP_1 - 4) + (i * 4),
+                          ((i == 0) || (i == (CS40L26_EVENT_MAP_NUM_REGS + 1))) ? BENCH_CS40L26_GUARD_VAL : 0,
+                          false);
+    }
+
+    if (cs40l26_set_gpio_event_map(&cs40l26_driver, &map) != CS40L26_STATUS_OK)
+    {
+        printf("    cs40l26_set_gpio_event_map failed\n");
+        return 1;
+    }
+
+    regs = bench_sim_get_regs();
+    for (uint32_t i = 0; i < (CS40L26_EVENT_MAP_NUM_REGS + 2); i++)
+    {
+        if (regs->regs[i].val != expected[i])
+        {
+            printf("    set: 0x%08lX = 0x%08lX, expected 0x%08lX\n",
+                   (unsigned long) regs->regs[i].addr, (unsigned long) regs->regs[i].val, (unsigned long) expected[i]);
+            fail_count++;
+        }
+    }
+    if (bench_sim_get_result()->write_count != 1)
+    {
+        printf("    set: %lu writes, expected one block write\n", (unsigned long) bench_sim_get_result()->write_count);
+        fail_count++;
+    }
+
+    memset(&map, 0xFF, sizeof(map));
+    if (cs40l26_get_gpio_event_map(&cs40l26_driver, &map) != CS40L26_STATUS_OK)
+    {
+        printf("    cs40l26_get_gpio_event_map failed\n");
+        return fail_count + 1;
+    }
+
+    for (uint32_t i = 0; i < CS40L26_EVENT_MAP_NUM_GPI; i++)
+    {
+        if ((map.gpi[i].rise.word != expected[(i * 2) + 1]) || (map.gpi[i].fall.word != expected[(i * 2) + 2]))
+        {
+            printf("    get: GPI%lu rise 0x%08lX fall 0x%08lX\n",
+                   (unsigned long) (i + 1), (unsigned long) map.gpi[i].rise.word, (unsigned long) map.gpi[i].fall.word);
+            fail_count++;
+        }
+    }
+    if ((map.gpi[2].fall.bank != CS40L26_EVENT_MAP_BANK_ROM) ||
+        (map.gpi[2].fall.index != CS40L26_EVENT_MAP_INDEX_DISABLE))
+    {
+        printf("    get: GPI3 fall does not read back as disabled\n");
+        fail_count++;
+    }
+
+    return fail_count;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+const bench_part_t bench_part_cs40l26 =
+{
+    .name = "CS40L26",
+    .bus_type = REGMAP_BUS_TYPE_I2C,
+    .n_scenarios = sizeof(bench_cs40l26_scenarios) / sizeof(bench_cs40l26_scenario_t),
+    .has_reference_flags = false,
+    .setup = &bench_cs40l26_setup,
+    .run_reference = &bench_cs40l26_run_reference,
+    .run_driver = &bench_cs40l26_run_driver,
+};
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Check the GPI Event Map encoding and its transfer to the register file
+ *
+ */
+uint32_t bench_cs40l26_check_event_map(regmap_cp_config_t *cp)
+{
+    uint32_t fail_count;
+
+    fail_count = bench_cs40l26_check_event_map_entry();
+    fail_count += bench_cs40l26_check_event_map_regs(cp);
+
+    printf("CS40L26 GPI Event Map\n");
+    printf("  encoding and register transfer: %s\n", (fail_count == 0) ? "OK" : "FAIL");
+    printf("\n");
+
+    return fail_count;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file irq_txn_bench_cs47l63.c
+ *
+ * @brief CS47L63 event handling for the IRQ handling transaction benchmark
+ *
+ * The reference handler walks cs47l63_event_data entry by entry, reading an EINT register whenever the offset changes
+ * and clearing each pending event with its own write, as cs47l63_event_handler() did before its reads and clears were
+ * batched.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "irq_txn_bench.h"
+#include "cs47l63.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define BENCH_CS47L63_N_EVENTS              (11)
+#define BENCH_CS47L63_UNHANDLED_BIT         (1 << 31)   ///< Pending EINT bit with no entry in cs47l63_event_data
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Events pending in a scenario
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t events;                    ///< Bit n set if entry n of cs47l63_event_data is pending
+} bench_cs47l63_scenario_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+extern const irq_reg_t cs47l63_event_data[];
+
+static cs47l63_t cs47l63_driver;
+
+/**
+ * EINT registers in the CS47L63 register map, from CS47L63_IRQ1_EINT_1 - EINT_4 and EINT_8 do not exist
+ */
+static const uint32_t bench_cs47l63_eint_regs[] =
+{
+    CS47L63_IRQ1_EINT_1,
+    CS47L63_IRQ1_EINT_2,
+    CS47L63_IRQ1_EINT_3,
+    CS47L63_IRQ1_EINT_5,
+    CS47L63_IRQ1_EINT_6,
+    CS47L63_IRQ1_EINT_7,
+    CS47L63_IRQ1_EINT_9,
+};
+
+static const bench_cs47l63_scenario_t bench_cs47l63_scenarios[] =
+{
+    { "boot done",              (1 << 0) },
+    { "FLL1 and FLL2 lock",     (1 << 9) | (1 << 10) },
+    { "DSP1 errors",            (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8) },
+    { "all events",             (1 << BENCH_CS47L63_N_EVENTS) - 1 },
+};
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+static void bench_cs47l63_notification_cb(uint32_t event_flags, void *arg)
+{
+    *((uint32_t *) arg) |= event_flags;
+
+    return;
+}
+
+/**
+ * Load the register file for a scenario
+ *
+ * Every EINT register also has a pending bit that the driver does not handle, which must be left set.
+ *
+ */
+static const char *bench_cs47l63_setup(uint32_t scenario)
+{
+    const bench_cs47l63_scenario_t *s = &(bench_cs47l63_scenarios[scenario]);
+
+    bench_sim_reset();
+
+    for (uint32_t i = 0; i < (sizeof(bench_cs47l63_eint_regs) / sizeof(uint32_t)); i++)
+    {
+        uint32_t val = BENCH_CS47L63_UNHANDLED_BIT;
+
+        for (uint32_t j = 0; j < BENCH_CS47L63_N_EVENTS; j++)
+        {
+            if ((s->events & (1 << j)) &&
+                ((CS47L63_IRQ1_EINT_1 + cs47l63_event_data[j].irq_reg_offset) == bench_cs47l63_eint_regs[i]))
+            {
+                val |= cs47l63_event_data[j].mask;
+            }
+        }
+
+        bench_sim_add_reg(bench_cs47l63_eint_regs[i], val, true);
+    }
+
+    return s->name;
+}
+
+/**
+ * Handle events as cs47l63_event_handler() did before batching
+ *
+ */
+static uint32_t bench_cs47l63_run_reference(regmap_cp_config_t *cp, uint32_t *event_flags)
+{
+    uint32_t ret;
+    uint32_t temp_reg_val = 0;
+    uint32_t old_reg = 0;
+    uint32_t new_reg;
+
+    *event_flags = 0;
+    for (uint32_t i = 0; i < BENCH_CS47L63_N_EVENTS; i++)
+    {
+        new_reg = CS47L63_IRQ1_EINT_1 + cs47l63_event_data[i].irq_reg_offset;
+        if (old_reg != new_reg)
+        {
+            ret = regmap_read(cp, new_reg, &temp_reg_val);
+            if (ret != REGMAP_STATUS_OK)
+            {
+                return BENCH_STATUS_FAIL;
+            }
+        }
+        old_reg = new_reg;
+
+        if (temp_reg_val & cs47l63_event_data[i].mask)
+        {
+            *event_flags |= cs47l63_event_data[i].event_flag;
+            ret = regmap_write(cp, new_reg, cs47l63_event_data[i].mask);
+            if (ret != REGMAP_STATUS_OK)
+            {
+                return BENCH_STATUS_FAIL;
+            }
+        }
+    }
+
+    return BENCH_STATUS_OK;
+}
+
+/**
+ * Handle events with cs47l63_process(), as the BSP does once the IRQ pin has asserted
+ *
+ */
+static uint32_t bench_cs47l63_run_driver(regmap_cp_config_t *cp, uint32_t *event_flags)
+{
+    cs47l63_initialize(&cs47l63_driver);
+
+    *event_flags = 0;
+    cs47l63_driver.config.bsp_config.cp_config = *cp;
+    cs47l63_driver.config.bsp_config.notification_cb = &bench_cs47l63_notification_cb;
+    cs47l63_driver.config.bsp_config.notification_cb_arg = event_flags;
+    cs47l63_driver.state = CS47L63_STATE_STANDBY;
+    cs47l63_driver.mode = CS47L63_MODE_HANDLING_EVENTS;
+
+    if (cs47l63_process(&cs47l63_driver) != CS47L63_STATUS_OK)
+    {
+        return BENCH_STATUS_FAIL;
+    }
+
+    return BENCH_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+const bench_part_t bench_part_cs47l63 =
+{
+    .name = "CS47L63",
+    .bus_type = REGMAP_BUS_TYPE_SPI,
+    .n_scenarios = sizeof(bench_cs47l63_scenarios) / sizeof(bench_cs47l63_scenario_t),
+    .has_reference_flags = true,
+    .setup = &bench_cs47l63_setup,
+    .run_reference = &bench_cs47l63_run_reference,
+    .run_driver = &bench_cs47l63_run_driver,
+};
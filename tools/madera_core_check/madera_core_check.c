@@ -0,0 +1,354 @@
+/**
+ * @file madera_core_check.c
+ *
+ * @brief Host check that CS47L15 and CS47L35 give identical register output through common/madera.c
+ *
+ * Runs the same steps on both drivers against a simulated control port that logs every register word read and
+ * written, then checks the two parts' logs are identical:
+ * - FLL1 configuration, enable and disable through each driver's fll_config, fll_enable and fll_disable calls, for
+ *   clock plans taken from the precomputed FLL table and for ones madera_calc_fll() has to calculate
+ * - ADSP2 core start, stop and RAM_RDY polling on DSP1, with each driver's control port and DSP base address
+ * - ring buffer telemetry sampling through each driver's extended API
+ *
+ * The DSP power sequences around the core steps differ between the parts (CS47L15 region locks and watchdog,
+ * CS47L35 DSP clock tracking), so they are not compared.
+ *
+ * Usage: madera_core_check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "madera_core_check.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define CHECK_DSP_OFF_CONFIG_1              (0x00)
+#define CHECK_DSP_OFF_STATUS_1              (0x04)
+#define CHECK_DSP_MEM_ENA                   (0x10)
+#define CHECK_DSP_RAM_RDY                   (0x01)
+
+#define CHECK_RB_STRUCT_ADDR                (0x2A0040)  ///< Any XM address, as the sim does not model DSP memory
+#define CHECK_RB_BUFFER_SIZE                (96 * MADERA_DSP_BYTES_PER_WORD)
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * FLL1 clock plan - REFCLK, then SYNCCLK if 'sync_src' is set, then FLL1 enabled, then REFCLK moved to 'new_ref_freq'
+ * while enabled if set, then FLL1 disabled
+ */
+typedef struct
+{
+    const char *name;
+    int32_t ref_src;
+    uint32_t ref_freq;
+    int32_t sync_src;
+    uint32_t sync_freq;
+    uint32_t fout;
+    uint32_t new_ref_freq;
+} check_fll_plan_t;
+
+/**
+ * Register output of one part
+ */
+typedef struct
+{
+    check_sim_txn_t txns[CHECK_SIM_MAX_TXNS];
+    uint32_t n_txns;
+    uint32_t status;                    ///< Status of each step, 1 bit per step
+    bool overflow;                      ///< Set if the words of a step were lost
+} check_trace_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static const check_part_t *check_parts[] = { &check_part_cs47l15, &check_part_cs47l35 };
+
+static const check_fll_plan_t check_fll_plans[] =
+{
+    { "MCLK1 12.288MHz, moved to 24.576MHz", CHECK_FLL_SRC_MCLK1, 12288000, CHECK_FLL_SRC_NONE, 0, 98304000, 24576000 },
+    { "MCLK2 32.768kHz", CHECK_FLL_SRC_MCLK2, 32768, CHECK_FLL_SRC_NONE, 0, 98304000, 0 },
+    { "AIF1BCLK 3.072MHz, MCLK2 sync", CHECK_FLL_SRC_AIF1BCLK, 3072000, CHECK_FLL_SRC_MCLK2, 32768, 98304000, 0 },
+    { "MCLK1 11.2896MHz, AIF1LRCLK sync", CHECK_FLL_SRC_MCLK1, 11289600, CHECK_FLL_SRC_AIF1LRCLK, 44100, 90316800, 0 },
+    // Not in the precomputed table, so calculated
+    { "MCLK1 19.2MHz", CHECK_FLL_SRC_MCLK1, 19200000, CHECK_FLL_SRC_NONE, 0, 98304000, 0 },
+    { "MCLK1 13MHz, moved to 26MHz", CHECK_FLL_SRC_MCLK1, 13000000, CHECK_FLL_SRC_NONE, 0, 90316800, 26000000 },
+};
+
+static check_trace_t check_traces[2];
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Record the result of a step, and the register words it read and wrote
+ *
+ */
+static void check_trace_step(check_trace_t *trace, uint32_t step, uint32_t ret)
+{
+    const check_sim_txn_t *log;
+    uint32_t n_txns;
+
+    log = check_sim_get_log(&n_txns);
+    if ((log == NULL) || ((trace->n_txns + n_txns) > CHECK_SIM_MAX_TXNS))
+    {
+        trace->overflow = true;
+        return;
+    }
+
+    memcpy(&(trace->txns[trace->n_txns]), log, n_txns * sizeof(check_sim_txn_t));
+    trace->n_txns += n_txns;
+    trace->status |= ((ret != 0) << step);
+    check_sim_clear_log();
+
+    return;
+}
+
+/**
+ * Compare the parts' traces, printing the first difference
+ *
+ */
+static uint32_t check_compare_traces(const char *name, bool expect_ok)
+{
+    const check_trace_t *a = &(check_traces[0]);
+    const check_trace_t *b = &(check_traces[1]);
+    uint32_t n = (a->n_txns < b->n_txns) ? a->n_txns : b->n_txns;
+
+    if (a->overflow || b->overflow)
+    {
+        printf("  %s: FAIL - trace overflow\n", name);
+        return CHECK_STATUS_FAIL;
+    }
+
+    if (a->status != b->status)
+    {
+        printf("  %s: FAIL - step status %s 0x%x, %s 0x%x\n",
+               name,
+               check_parts[0]->name,
+               a->status,
+               check_parts[1]->name,
+               b->status);
+        return CHECK_STATUS_FAIL;
+    }
+
+    if (expect_ok && (a->status != 0))
+    {
+        printf("  %s: FAIL - steps failed 0x%x\n", name, a->status);
+        return CHECK_STATUS_FAIL;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (memcmp(&(a->txns[i]), &(b->txns[i]), sizeof(check_sim_txn_t)) != 0)
+        {
+            printf("  %s: FAIL - word %u %s %s 0x%06x 0x%08x, %s %s 0x%06x 0x%08x\n",
+                   name,
+                   i,
+                   check_parts[0]->name,
+                   a->txns[i].is_write ? "W" : "R",
+                   a->txns[i].addr,
+                   a->txns[i].val,
+                   check_parts[1]->name,
+                   b->txns[i].is_write ? "W" : "R",
+                   b->txns[i].addr,
+                   b->txns[i].val);
+            return CHECK_STATUS_FAIL;
+        }
+    }
+
+    if ((a->n_txns != b->n_txns) || (a->n_txns == 0))
+    {
+        printf("  %s: FAIL - %s %u words, %s %u words\n",
+               name,
+               check_parts[0]->name,
+               a->n_txns,
+               check_parts[1]->name,
+               b->n_txns);
+        return CHECK_STATUS_FAIL;
+    }
+
+    printf("  %s: %u words identical\n", name, a->n_txns);
+
+    return CHECK_STATUS_OK;
+}
+
+/**
+ * Start a part's trace with the driver configured on an empty register file
+ *
+ */
+static uint32_t check_start(const check_part_t *part, check_trace_t *trace)
+{
+    memset(trace, 0, sizeof(check_trace_t));
+    check_sim_reset();
+
+    if (part->init() != CHECK_STATUS_OK)
+    {
+        printf("  %s: init failed\n", part->name);
+        return CHECK_STATUS_FAIL;
+    }
+    check_sim_clear_log();
+
+    return CHECK_STATUS_OK;
+}
+
+static uint32_t check_fll(const check_fll_plan_t *plan)
+{
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        const check_part_t *part = check_parts[i];
+        check_trace_t *trace = &(check_traces[i]);
+        uint32_t step = 0;
+
+        if (check_start(part, trace) != CHECK_STATUS_OK)
+        {
+            return CHECK_STATUS_FAIL;
+        }
+
+        check_trace_step(trace, step++, part->fll_config(false, plan->ref_src, plan->ref_freq, plan->fout));
+        if (plan->sync_src != CHECK_FLL_SRC_NONE)
+        {
+            check_trace_step(trace, step++, part->fll_config(true, plan->sync_src, plan->sync_freq, plan->fout));
+        }
+        check_trace_step(trace, step++, part->fll_enable(true));
+        if (plan->new_ref_freq != 0)
+        {
+            check_trace_step(trace,
+                             step++,
+                             part->fll_config(false, plan->ref_src, plan->new_ref_freq, plan->fout));
+        }
+        check_trace_step(trace, step++, part->fll_enable(false));
+    }
+
+    return check_compare_traces(plan->name, true);
+}
+
+static uint32_t check_dsp_core(const char *name, bool ram_ready)
+{
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        const check_part_t *part = check_parts[i];
+        check_trace_t *trace = &(check_traces[i]);
+        uint32_t base;
+
+        if (check_start(part, trace) != CHECK_STATUS_OK)
+        {
+            return CHECK_STATUS_FAIL;
+        }
+
+        // DSP memory enabled by the part's power sequence
+        base = part->get_dsp_base();
+        check_sim_set_reg(base + CHECK_DSP_OFF_CONFIG_1, CHECK_DSP_MEM_ENA);
+        check_sim_set_reg(base + CHECK_DSP_OFF_STATUS_1, ram_ready ? CHECK_DSP_RAM_RDY : 0);
+
+        check_trace_step(trace, 0, part->dsp_core(CHECK_DSP_CORE_WAIT_RAM_READY));
+        check_trace_step(trace, 1, part->dsp_core(CHECK_DSP_CORE_START));
+        check_trace_step(trace, 2, part->dsp_core(CHECK_DSP_CORE_STOP));
+    }
+
+    // RAM_RDY timing out must fail the same way on both parts
+    return check_compare_traces(name, ram_ready);
+}
+
+static uint32_t check_telemetry(void)
+{
+    // Next write index, next read index, error and end of stream for each sample
+    static const uint32_t samples[][4] =
+    {
+        { 10, 4, 0, 0 },
+        { 10, 10, 0, 0 },
+        { 3, 4, 0, 0 },
+        { 20, 4, 0x7, 0 },
+        { 4, 4, 0, 1 },
+    };
+    madera_dsp_telemetry_t telemetry[2];
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        const check_part_t *part = check_parts[i];
+        check_trace_t *trace = &(check_traces[i]);
+
+        if (check_start(part, trace) != CHECK_STATUS_OK)
+        {
+            return CHECK_STATUS_FAIL;
+        }
+
+        madera_dsp_telemetry_reset(&(telemetry[i]));
+        for (uint32_t j = 0; j < (sizeof(samples) / sizeof(samples[0])); j++)
+        {
+            for (uint32_t k = 0; k < 4; k++)
+            {
+                check_sim_set_reg(CHECK_RB_STRUCT_ADDR +
+                                  ((MADERA_DSP_RB_NEXT_WRITE_INDEX + k) * MADERA_DSP_OFFSET_MUL_VALUE),
+                                  samples[j][k]);
+            }
+
+            check_trace_step(trace,
+                             j,
+                             part->telemetry_sample(CHECK_RB_STRUCT_ADDR, CHECK_RB_BUFFER_SIZE, &(telemetry[i])));
+        }
+    }
+
+    if ((telemetry[0].fill_min != telemetry[1].fill_min) ||
+        (telemetry[0].fill_max != telemetry[1].fill_max) ||
+        (telemetry[0].fill_sum != telemetry[1].fill_sum) ||
+        (telemetry[0].empty_count != telemetry[1].empty_count) ||
+        (telemetry[0].full_count != telemetry[1].full_count) ||
+        (telemetry[0].error_count != telemetry[1].error_count) ||
+        (telemetry[0].is_eof != telemetry[1].is_eof))
+    {
+        printf("  ring buffer telemetry: FAIL - telemetry differs\n");
+        return CHECK_STATUS_FAIL;
+    }
+
+    return check_compare_traces("ring buffer telemetry", true);
+}
+
+/***********************************************************************************************************************
+ * MAIN
+ **********************************************************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t failures = 0;
+
+    printf("%s vs %s register output:\n", check_parts[0]->name, check_parts[1]->name);
+
+    for (uint32_t i = 0; i < (sizeof(check_fll_plans) / sizeof(check_fll_plans[0])); i++)
+    {
+        failures += check_fll(&(check_fll_plans[i]));
+    }
+
+    failures += check_dsp_core("DSP1 core start/stop", true);
+    failures += check_dsp_core("DSP1 RAM_RDY timeout", false);
+    failures += check_telemetry();
+
+    if (failures > 0)
+    {
+        printf("FAIL: %u check(s) failed\n", failures);
+        return 1;
+    }
+
+    printf("PASS\n");
+
+    return 0;
+}
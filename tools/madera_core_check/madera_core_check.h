@@ -0,0 +1,168 @@
+/**
+ * @file madera_core_check.h
+ *
+ * @brief Functions and prototypes shared by the Madera codec core check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef MADERA_CORE_CHECK_H
+#define MADERA_CORE_CHECK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmap.h"
+#include "madera.h"
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup CHECK_STATUS_
+ * @brief Return values for all check calls
+ *
+ * @{
+ */
+#define CHECK_STATUS_OK                     (0)
+#define CHECK_STATUS_FAIL                   (1)
+/** @} */
+
+/**
+ * @defgroup CHECK_FLL_SRC_
+ * @brief FLL reference sources, numbered as in both parts' FLL_SRC_ defines
+ *
+ * @{
+ */
+#define CHECK_FLL_SRC_NONE                  (-1)
+#define CHECK_FLL_SRC_MCLK1                 (0)
+#define CHECK_FLL_SRC_MCLK2                 (1)
+#define CHECK_FLL_SRC_AIF1BCLK              (8)
+#define CHECK_FLL_SRC_AIF1LRCLK             (12)
+/** @} */
+
+/**
+ * @defgroup CHECK_DSP_CORE_
+ * @brief Shared ADSP2 core steps, run on DSP1 with the part's control port and DSP base address
+ *
+ * @{
+ */
+#define CHECK_DSP_CORE_WAIT_RAM_READY       (0)
+#define CHECK_DSP_CORE_START                (1)
+#define CHECK_DSP_CORE_STOP                 (2)
+/** @} */
+
+#define CHECK_SIM_MAX_REGS                  (128)
+#define CHECK_SIM_MAX_TXNS                  (256)
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * One register word read or written on the simulated control port, in bus order
+ */
+typedef struct
+{
+    bool is_write;
+    uint32_t addr;
+    uint32_t val;
+} check_sim_txn_t;
+
+/**
+ * Part under test - each call wraps the driver API that reaches common/madera.c
+ */
+typedef struct
+{
+    const char *name;                   ///< Part name
+    /**
+     * Initialize and configure the driver on the simulated control port
+     */
+    uint32_t (*init)(void);
+    /**
+     * Control port address of DSP1's core registers, as configured by the driver
+     */
+    uint32_t (*get_dsp_base)(void);
+    /**
+     * Configure FLL1 REFCLK, or SYNCCLK if 'sync' is set, with the driver's fll_config call
+     */
+    uint32_t (*fll_config)(bool sync, int32_t src, uint32_t freq_in, uint32_t freq_out);
+    /**
+     * Enable or disable FLL1
+     */
+    uint32_t (*fll_enable)(bool enable);
+    /**
+     * Run a shared ADSP2 core step on DSP1 - @see CHECK_DSP_CORE_
+     */
+    uint32_t (*dsp_core)(uint32_t step);
+    /**
+     * Sample ring buffer telemetry with the driver's extended API
+     */
+    uint32_t (*telemetry_sample)(uint32_t rb_struct_base_addr,
+                                 uint32_t buffer_size,
+                                 madera_dsp_telemetry_t *telemetry);
+} check_part_t;
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+extern const check_part_t check_part_cs47l15;
+extern const check_part_t check_part_cs47l35;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Empty the register file and the transaction log
+ */
+void check_sim_reset(void);
+
+/**
+ * Set a register - registers not set or written read as 0
+ */
+uint32_t check_sim_set_reg(uint32_t addr, uint32_t val);
+
+/**
+ * Register words read and written since the last check_sim_reset() or check_sim_clear_log(), in bus order - NULL
+ * with 'n_txns' 0 if the log or the register file overflowed
+ */
+const check_sim_txn_t *check_sim_get_log(uint32_t *n_txns);
+
+/**
+ * Empty the transaction log, leaving the register file as it is
+ */
+void check_sim_clear_log(void);
+
+/**
+ * Fill in control port configuration for the simulated bus
+ */
+void check_sim_get_cp_config(regmap_cp_config_t *cp);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MADERA_CORE_CHECK_H
@@ -0,0 +1,273 @@
+/**
+ * @file madera_core_check_bsp.c
+ *
+ * @brief Simulated control port for the Madera codec core check
+ *
+ * Implements the BSP-Driver Interface SPI calls used by regmap against a register file that holds every register
+ * written.  Every register word read or written is logged in bus order, with block transfers split into their words,
+ * so the check can compare the parts' sequences.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "madera_core_check.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define CHECK_SIM_SPI_PAD_LEN               (2)         ///< As configured in bsp_cs47l15.c and bsp_cs47l35.c
+#define CHECK_SIM_ADDRS_PER_WORD            (2)         ///< Madera control port addresses are 16-bit
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Simulated register
+ */
+typedef struct
+{
+    uint32_t addr;
+    uint32_t val;
+} check_sim_reg_t;
+
+/**
+ * Simulated register file and transaction log
+ */
+typedef struct
+{
+    check_sim_reg_t regs[CHECK_SIM_MAX_REGS];
+    uint32_t n_regs;
+    check_sim_txn_t log[CHECK_SIM_MAX_TXNS];
+    uint32_t n_txns;
+    bool overflow;                      ///< Set if the register file or the log filled up
+} check_sim_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static check_sim_t sim;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Get a register in the register file, adding it if 'add' is set, or NULL if it is not there
+ *
+ */
+static check_sim_reg_t *check_sim_find_reg(uint32_t addr, bool add)
+{
+    for (uint32_t i = 0; i < sim.n_regs; i++)
+    {
+        if (sim.regs[i].addr == addr)
+        {
+            return &(sim.regs[i]);
+        }
+    }
+
+    if (!add || (sim.n_regs >= CHECK_SIM_MAX_REGS))
+    {
+        sim.overflow |= add;
+        return NULL;
+    }
+
+    sim.regs[sim.n_regs].addr = addr;
+    sim.regs[sim.n_regs].val = 0;
+
+    return &(sim.regs[sim.n_regs++]);
+}
+
+static void check_sim_log(bool is_write, uint32_t addr, uint32_t val)
+{
+    if (sim.n_txns >= CHECK_SIM_MAX_TXNS)
+    {
+        sim.overflow = true;
+        return;
+    }
+
+    sim.log[sim.n_txns].is_write = is_write;
+    sim.log[sim.n_txns].addr = addr;
+    sim.log[sim.n_txns].val = val;
+    sim.n_txns++;
+
+    return;
+}
+
+/**
+ * Get the control port address from a transfer's address phase
+ *
+ */
+static uint32_t check_sim_get_addr(const uint8_t *addr_buffer)
+{
+    // Mask off the SPI R/W bit
+    return (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+           ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+}
+
+static uint32_t check_register_gpio_cb(uint32_t gpio_id, bsp_callback_t cb, void *cb_arg)
+{
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_set_timer(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg)
+{
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_spi_read(uint32_t bsp_dev_id,
+                               uint8_t *addr_buffer,
+                               uint32_t addr_length,
+                               uint8_t *data_buffer,
+                               uint32_t data_length,
+                               uint32_t pad_len)
+{
+    uint32_t addr = check_sim_get_addr(addr_buffer);
+
+    for (uint32_t i = 0; (i + 4) <= data_length; i += 4, addr += CHECK_SIM_ADDRS_PER_WORD)
+    {
+        check_sim_reg_t *reg = check_sim_find_reg(addr, false);
+        uint32_t val = (reg != NULL) ? reg->val : 0;
+
+        check_sim_log(false, addr, val);
+
+        data_buffer[i] = GET_BYTE_FROM_WORD(val, 3);
+        data_buffer[i + 1] = GET_BYTE_FROM_WORD(val, 2);
+        data_buffer[i + 2] = GET_BYTE_FROM_WORD(val, 1);
+        data_buffer[i + 3] = GET_BYTE_FROM_WORD(val, 0);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_spi_write(uint32_t bsp_dev_id,
+                                uint8_t *addr_buffer,
+                                uint32_t addr_length,
+                                uint8_t *data_buffer,
+                                uint32_t data_length,
+                                uint32_t pad_len)
+{
+    uint32_t addr = check_sim_get_addr(addr_buffer);
+
+    for (uint32_t i = 0; (i + 4) <= data_length; i += 4, addr += CHECK_SIM_ADDRS_PER_WORD)
+    {
+        check_sim_reg_t *reg = check_sim_find_reg(addr, true);
+        uint32_t val = ((uint32_t) data_buffer[i] << 24) | ((uint32_t) data_buffer[i + 1] << 16) |
+                       ((uint32_t) data_buffer[i + 2] << 8) | data_buffer[i + 3];
+
+        check_sim_log(true, addr, val);
+
+        if (reg != NULL)
+        {
+            reg->val = val;
+        }
+    }
+
+    return BSP_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+static bsp_driver_if_t check_driver_if_s =
+{
+    .register_gpio_cb = &check_register_gpio_cb,
+    .set_timer = &check_set_timer,
+    .spi_read = &check_spi_read,
+    .spi_write = &check_spi_write,
+};
+
+bsp_driver_if_t *bsp_driver_if_g = &check_driver_if_s;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Empty the register file and the transaction log
+ *
+ */
+void check_sim_reset(void)
+{
+    memset(&sim, 0, sizeof(check_sim_t));
+
+    return;
+}
+
+/**
+ * Set a register
+ *
+ */
+uint32_t check_sim_set_reg(uint32_t addr, uint32_t val)
+{
+    check_sim_reg_t *reg = check_sim_find_reg(addr, true);
+
+    if (reg == NULL)
+    {
+        return CHECK_STATUS_FAIL;
+    }
+
+    reg->val = val;
+
+    return CHECK_STATUS_OK;
+}
+
+/**
+ * Register words read and written since the log was last emptied
+ *
+ */
+const check_sim_txn_t *check_sim_get_log(uint32_t *n_txns)
+{
+    // A truncated log must not compare equal to another
+    *n_txns = sim.overflow ? 0 : sim.n_txns;
+
+    return sim.overflow ? NULL : sim.log;
+}
+
+/**
+ * Empty the transaction log
+ *
+ */
+void check_sim_clear_log(void)
+{
+    sim.n_txns = 0;
+
+    return;
+}
+
+/**
+ * Fill in control port configuration for the simulated bus
+ *
+ */
+void check_sim_get_cp_config(regmap_cp_config_t *cp)
+{
+    memset(cp, 0, sizeof(regmap_cp_config_t));
+    cp->bus_type = REGMAP_BUS_TYPE_SPI;
+    cp->spi_pad_len = CHECK_SIM_SPI_PAD_LEN;
+
+    return;
+}
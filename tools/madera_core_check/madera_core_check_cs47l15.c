@@ -0,0 +1,126 @@
+/**
+ * @file madera_core_check_cs47l15.c
+ *
+ * @brief CS47L15 part wrapper for the Madera codec core check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "madera_core_check.h"
+#include "cs47l15.h"
+#include "cs47l15_ext.h"
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static cs47l15_t cs47l15_driver;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+static uint32_t check_cs47l15_init(void)
+{
+    cs47l15_config_t config;
+
+    memset(&config, 0, sizeof(cs47l15_config_t));
+    check_sim_get_cp_config(&(config.bsp_config.cp_config));
+
+    if (cs47l15_initialize(&cs47l15_driver) || cs47l15_configure(&cs47l15_driver, &config))
+    {
+        return CHECK_STATUS_FAIL;
+    }
+
+    return CHECK_STATUS_OK;
+}
+
+static uint32_t check_cs47l15_get_dsp_base(void)
+{
+    return cs47l15_driver.dsp_info[0].base_addr;
+}
+
+static uint32_t check_cs47l15_fll_config(bool sync, int32_t src, uint32_t freq_in, uint32_t freq_out)
+{
+    return cs47l15_fll_config(&cs47l15_driver,
+                              sync ? CS47L15_FLL1_SYNCCLK : CS47L15_FLL1_REFCLK,
+                              src,
+                              freq_in,
+                              freq_out);
+}
+
+static uint32_t check_cs47l15_fll_enable(bool enable)
+{
+    if (enable)
+    {
+        return cs47l15_fll_enable(&cs47l15_driver, CS47L15_FLL1);
+    }
+
+    return cs47l15_fll_disable(&cs47l15_driver, CS47L15_FLL1);
+}
+
+static uint32_t check_cs47l15_dsp_core(uint32_t step)
+{
+    regmap_cp_config_t *cp = REGMAP_GET_CP(&cs47l15_driver);
+    uint32_t base = cs47l15_driver.dsp_info[0].base_addr;
+
+    switch (step)
+    {
+        case CHECK_DSP_CORE_WAIT_RAM_READY:
+            return madera_dsp_wait_ram_ready(cp, base);
+
+        case CHECK_DSP_CORE_START:
+            return madera_dsp_core_start(cp, base);
+
+        case CHECK_DSP_CORE_STOP:
+            return madera_dsp_core_stop(cp, base);
+
+        default:
+            return CHECK_STATUS_FAIL;
+    }
+}
+
+static uint32_t check_cs47l15_telemetry_sample(uint32_t rb_struct_base_addr,
+                                               uint32_t buffer_size,
+                                               madera_dsp_telemetry_t *telemetry)
+{
+    dsp_buffer_t buffer;
+
+    // As left by cs47l15_dsp_buf_init() for a ring buffer of 'buffer_size' bytes
+    memset(&buffer, 0, sizeof(dsp_buffer_t));
+    buffer.rb_struct_base_addr = rb_struct_base_addr;
+    buffer.dsp_buf.buffer_size = buffer_size;
+
+    return cs47l15_dsp_buf_telemetry_sample(&cs47l15_driver, &buffer, telemetry);
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+const check_part_t check_part_cs47l15 =
+{
+    .name = "cs47l15",
+    .init = &check_cs47l15_init,
+    .get_dsp_base = &check_cs47l15_get_dsp_base,
+    .fll_config = &check_cs47l15_fll_config,
+    .fll_enable = &check_cs47l15_fll_enable,
+    .dsp_core = &check_cs47l15_dsp_core,
+    .telemetry_sample = &check_cs47l15_telemetry_sample,
+};
@@ -0,0 +1,126 @@
+/**
+ * @file madera_core_check_cs47l35.c
+ *
+ * @brief CS47L35 part wrapper for the Madera codec core check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "madera_core_check.h"
+#include "cs47l35.h"
+#include "cs47l35_ext.h"
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static cs47l35_t cs47l35_driver;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+static uint32_t check_cs47l35_init(void)
+{
+    cs47l35_config_t config;
+
+    memset(&config, 0, sizeof(cs47l35_config_t));
+    check_sim_get_cp_config(&(config.bsp_config.cp_config));
+
+    if (cs47l35_initialize(&cs47l35_driver) || cs47l35_configure(&cs47l35_driver, &config))
+    {
+        return CHECK_STATUS_FAIL;
+    }
+
+    return CHECK_STATUS_OK;
+}
+
+static uint32_t check_cs47l35_get_dsp_base(void)
+{
+    return cs47l35_driver.dsp_info[0].base_addr;
+}
+
+static uint32_t check_cs47l35_fll_config(bool sync, int32_t src, uint32_t freq_in, uint32_t freq_out)
+{
+    return cs47l35_fll_config(&cs47l35_driver,
+                              sync ? CS47L35_FLL1_SYNCCLK : CS47L35_FLL1_REFCLK,
+                              src,
+                              freq_in,
+                              freq_out);
+}
+
+static uint32_t check_cs47l35_fll_enable(bool enable)
+{
+    if (enable)
+    {
+        return cs47l35_fll_enable(&cs47l35_driver, CS47L35_FLL1);
+    }
+
+    return cs47l35_fll_disable(&cs47l35_driver, CS47L35_FLL1);
+}
+
+static uint32_t check_cs47l35_dsp_core(uint32_t step)
+{
+    regmap_cp_config_t *cp = REGMAP_GET_CP(&cs47l35_driver);
+    uint32_t base = cs47l35_driver.dsp_info[0].base_addr;
+
+    switch (step)
+    {
+        case CHECK_DSP_CORE_WAIT_RAM_READY:
+            return madera_dsp_wait_ram_ready(cp, base);
+
+        case CHECK_DSP_CORE_START:
+            return madera_dsp_core_start(cp, base);
+
+        case CHECK_DSP_CORE_STOP:
+            return madera_dsp_core_stop(cp, base);
+
+        default:
+            return CHECK_STATUS_FAIL;
+    }
+}
+
+static uint32_t check_cs47l35_telemetry_sample(uint32_t rb_struct_base_addr,
+                                               uint32_t buffer_size,
+                                               madera_dsp_telemetry_t *telemetry)
+{
+    dsp_buffer_t buffer;
+
+    // As left by cs47l35_dsp_buf_init() for a ring buffer of 'buffer_size' bytes
+    memset(&buffer, 0, sizeof(dsp_buffer_t));
+    buffer.rb_struct_base_addr = rb_struct_base_addr;
+    buffer.dsp_buf.buffer_size = buffer_size;
+
+    return cs47l35_dsp_buf_telemetry_sample(&cs47l35_driver, &buffer, telemetry);
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+const check_part_t check_part_cs47l35 =
+{
+    .name = "cs47l35",
+    .init = &check_cs47l35_init,
+    .get_dsp_base = &check_cs47l35_get_dsp_base,
+    .fll_config = &check_cs47l35_fll_config,
+    .fll_enable = &check_cs47l35_fll_enable,
+    .dsp_core = &check_cs47l35_dsp_core,
+    .telemetry_sample = &check_cs47l35_telemetry_sample,
+};
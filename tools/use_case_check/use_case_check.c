@@ -0,0 +1,329 @@
+/**
+ * @file use_case_check.c
+ *
+ * @brief Host check of the CS47L63 use case delta engine
+ *
+ * Runs cs47l63_use_case_power_down() and cs47l63_use_case_power_up() for every pair of a set of use cases modelled on
+ * those in bsp_cs47l63.c, against a simulated register file that logs every register word written.  Each sequence is
+ * replayed, checking:
+ * - that no routing, source or output field changes while OUT1L is unmuted
+ * - that every field ends at its target value
+ * - that nothing is written when the use case does not change
+ * - that a change confined to the mute stage, e.g. a volume step, is made without muting
+ *
+ * Usage: use_case_check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "use_case_check.h"
+#include "cs47l63.h"
+#include "sdk_version.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define CHECK_MAX_REPORTS                   (8)         ///< Failures printed per check
+
+// As in bsp_cs47l63.c
+#define CHECK_SRC_TONE_GENERATOR1           (0x4)
+#define CHECK_DSP1_CHANNEL1                 (0x100)
+#define CHECK_DSP1_CHANNEL2                 (0x101)
+
+/**
+ * @defgroup CHECK_STAGE_
+ * @brief Dependency stages of use case register fields, as in bsp_cs47l63.c
+ *
+ * @{
+ */
+#define CHECK_STAGE_ROUTING                 (0)
+#define CHECK_STAGE_SOURCES                 (1)
+#define CHECK_STAGE_OUTPUTS                 (2)
+#define CHECK_STAGE_UNMUTE                  (3)
+/** @} */
+
+#define CHECK_OUT1L_MUTED                   (CS47L63_OUT_VU | CS47L63_OUT1L_MUTE | 0x60)
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Use case register fields - index of each field in check_fields and in check_use_case_t 'regs'
+ */
+typedef enum
+{
+    CHECK_FIELD_DSP1RX1_SRC = 0,
+    CHECK_FIELD_DSP1RX2_SRC,
+    CHECK_FIELD_OUT1L_SRC1,
+    CHECK_FIELD_OUT1L_SRC2,
+    CHECK_FIELD_TONE1_EN,
+    CHECK_FIELD_OUTPUT_ENABLE,
+    CHECK_FIELD_OUT1L_VOLUME,
+    CHECK_N_FIELDS
+} check_field_id_t;
+
+/**
+ * Register state of a use case
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t regs[CHECK_N_FIELDS];
+} check_use_case_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static cs47l63_t cs47l63_driver;
+static cs47l63_use_case_t use_case_state;
+static uint32_t report_count;
+
+static const cs47l63_use_case_field_t check_fields[CHECK_N_FIELDS] =
+{
+    [CHECK_FIELD_DSP1RX1_SRC] =
+        { CS47L63_DSP1RX1_INPUT1,   CS47L63_DSP1RX1_SRC1_MASK,  0,                  CHECK_STAGE_ROUTING },
+    [CHECK_FIELD_DSP1RX2_SRC] =
+        { CS47L63_DSP1RX2_INPUT1,   CS47L63_DSP1RX2_SRC1_MASK,  0,                  CHECK_STAGE_ROUTING },
+    [CHECK_FIELD_OUT1L_SRC1] =
+        { CS47L63_OUT1L_INPUT1,     CS47L63_OUT1L_SRC1_MASK,    0,                  CHECK_STAGE_ROUTING },
+    [CHECK_FIELD_OUT1L_SRC2] =
+        { CS47L63_OUT1L_INPUT2,     CS47L63_OUT1L_SRC1_MASK,    0,                  CHECK_STAGE_ROUTING },
+    [CHECK_FIELD_TONE1_EN] =
+        { CS47L63_TONE_GENERATOR1,  CS47L63_TONE1_EN_MASK,      0,                  CHECK_STAGE_SOURCES },
+    [CHECK_FIELD_OUTPUT_ENABLE] =
+        { CS47L63_OUTPUT_ENABLE_1,  0xFFFFFFFF,                 0,                  CHECK_STAGE_OUTPUTS },
+    [CHECK_FIELD_OUT1L_VOLUME] =
+        { CS47L63_OUT1L_VOLUME_1,   0xFFFFFFFF,                 CHECK_OUT1L_MUTED,  CHECK_STAGE_UNMUTE },
+};
+
+static const check_use_case_t check_use_cases[] =
+{
+    {
+        "off",
+        { 0, 0, 0, 0, 0, 0, CHECK_OUT1L_MUTED },
+    },
+    {
+        "tg_hp",
+        { 0, 0, CHECK_SRC_TONE_GENERATOR1, 0, CS47L63_TONE1_EN, CS47L63_OUT1L_EN_MASK, (CS47L63_OUT_VU | 0x60) },
+    },
+    {
+        "tg_hp_quiet",
+        { 0, 0, CHECK_SRC_TONE_GENERATOR1, 0, CS47L63_TONE1_EN, CS47L63_OUT1L_EN_MASK, (CS47L63_OUT_VU | 0x50) },
+    },
+    {
+        "tg_dsp_hp",
+        {
+            CHECK_SRC_TONE_GENERATOR1, CHECK_SRC_TONE_GENERATOR1, CHECK_DSP1_CHANNEL1, CHECK_DSP1_CHANNEL2,
+            CS47L63_TONE1_EN, CS47L63_OUT1L_EN_MASK, (CS47L63_OUT_VU | 0x60)
+        },
+    },
+    {
+        "tg_dsp_hp_mono",
+        {
+            CHECK_SRC_TONE_GENERATOR1, 0, CHECK_DSP1_CHANNEL1, 0,
+            CS47L63_TONE1_EN, CS47L63_OUT1L_EN_MASK, (CS47L63_OUT_VU | 0x60)
+        },
+    },
+};
+
+#define CHECK_N_USE_CASES                   (sizeof(check_use_cases) / sizeof(check_use_case_t))
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Print a failure, up to CHECK_MAX_REPORTS in all
+ *
+ */
+static void check_report(const check_use_case_t *from, const check_use_case_t *to, const char *what)
+{
+    if (report_count++ < CHECK_MAX_REPORTS)
+    {
+        printf("    %s -> %s: %s\n", from->name, to->name, what);
+    }
+
+    return;
+}
+
+/**
+ * Get the value of the register containing a field, from the field values of a use case
+ *
+ */
+static uint32_t check_get_reg_val(const uint32_t *regs, uint32_t reg)
+{
+    uint32_t val = 0;
+
+    for (uint32_t i = 0; i < CHECK_N_FIELDS; i++)
+    {
+        if (check_fields[i].reg == reg)
+        {
+            val |= regs[i] & check_fields[i].mask;
+        }
+    }
+
+    return val;
+}
+
+/**
+ * (True) if every mute stage field is at its 'off_val' in a register state
+ *
+ */
+static bool check_is_muted(const uint32_t *state)
+{
+    for (uint32_t i = 0; i < CHECK_N_FIELDS; i++)
+    {
+        if ((check_fields[i].stage == CHECK_STAGE_UNMUTE) &&
+            ((state[i] & check_fields[i].mask) != check_fields[i].off_val))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Switch from one use case to another and replay the writes
+ *
+ */
+static uint32_t check_switch(const check_use_case_t *from, const check_use_case_t *to)
+{
+    regmap_cp_config_t cp;
+    const check_sim_write_t *log;
+    uint32_t n_writes;
+    uint32_t state[CHECK_N_FIELDS];
+    bool is_mute_change_only = true;
+    bool is_fail = false;
+
+    check_sim_reset();
+    for (uint32_t i = 0; i < CHECK_N_FIELDS; i++)
+    {
+        if (check_sim_get_reg(check_fields[i].reg) == 0)
+        {
+            check_sim_add_reg(check_fields[i].reg, check_get_reg_val(from->regs, check_fields[i].reg));
+        }
+        state[i] = from->regs[i];
+
+        if ((check_fields[i].stage != CHECK_STAGE_UNMUTE) && (from->regs[i] != to->regs[i]))
+        {
+            is_mute_change_only = false;
+        }
+    }
+
+    cs47l63_initialize(&cs47l63_driver);
+    check_sim_get_cp_config(&cp);
+    cs47l63_driver.config.bsp_config.cp_config = cp;
+
+    if ((cs47l63_use_case_init(&cs47l63_driver, &use_case_state, check_fields, CHECK_N_FIELDS) != CS47L63_STATUS_OK) ||
+        (cs47l63_use_case_power_down(&cs47l63_driver, &use_case_state, to->regs) != CS47L63_STATUS_OK) ||
+        (cs47l63_use_case_power_up(&cs47l63_driver, &use_case_state, to->regs) != CS47L63_STATUS_OK))
+    {
+        check_report(from, to, "driver call failed");
+        return 1;
+    }
+
+    log = check_sim_get_log(&n_writes);
+    if ((from == to) && (n_writes != 0))
+    {
+        check_report(from, to, "registers written with no change of use case");
+        is_fail = true;
+    }
+
+    for (uint32_t w = 0; w < n_writes; w++)
+    {
+        bool is_muted = check_is_muted(state);
+
+        for (uint32_t i = 0; i < CHECK_N_FIELDS; i++)
+        {
+            uint32_t val = log[w].val & check_fields[i].mask;
+
+            if (check_fields[i].reg != log[w].addr)
+            {
+                continue;
+            }
+
+            if ((check_fields[i].stage != CHECK_STAGE_UNMUTE) && (val != (state[i] & check_fields[i].mask)) &&
+                !is_muted)
+            {
+                check_report(from, to, "field changed while unmuted");
+                is_fail = true;
+            }
+
+            if ((check_fields[i].stage == CHECK_STAGE_UNMUTE) && is_mute_change_only &&
+                (val == check_fields[i].off_val) && (val != (to->regs[i] & check_fields[i].mask)))
+            {
+                check_report(from, to, "muted for a change confined to the mute stage");
+                is_fail = true;
+            }
+
+            state[i] = val;
+        }
+    }
+
+    for (uint32_t i = 0; i < CHECK_N_FIELDS; i++)
+    {
+        if (((state[i] & check_fields[i].mask) != (to->regs[i] & check_fields[i].mask)) ||
+            ((check_sim_get_reg(check_fields[i].reg) & check_fields[i].mask) !=
+             (to->regs[i] & check_fields[i].mask)))
+        {
+            check_report(from, to, "field not at its target value");
+            is_fail = true;
+        }
+    }
+
+    return is_fail ? 1 : 0;
+}
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    uint32_t fail_count = 0;
+
+    printf("\n");
+    printf("use_case_check\n");
+    printf("SDK version %d.%d.%d\n", SDK_VERSION_MAJOR, SDK_VERSION_MINOR, SDK_VERSION_UPDATE);
+    printf("\n");
+
+    for (uint32_t i = 0; i < CHECK_N_USE_CASES; i++)
+    {
+        for (uint32_t j = 0; j < CHECK_N_USE_CASES; j++)
+        {
+            fail_count += check_switch(&check_use_cases[i], &check_use_cases[j]);
+        }
+    }
+
+    printf("  %u use cases, %u switches: %s\n",
+           (unsigned int) CHECK_N_USE_CASES,
+           (unsigned int) (CHECK_N_USE_CASES * CHECK_N_USE_CASES),
+           (fail_count == 0) ? "OK" : "FAIL");
+
+    printf("\n");
+    printf("%s: %lu check(s) failed\n", (fail_count == 0) ? "PASS" : "FAIL", (unsigned long) fail_count);
+    printf("Exit.\n");
+
+    return (fail_count == 0) ? 0 : 1;
+}
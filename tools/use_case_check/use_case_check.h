@@ -0,0 +1,106 @@
+/**
+ * @file use_case_check.h
+ *
+ * @brief Functions and prototypes shared by the CS47L63 use case delta engine check
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef USE_CASE_CHECK_H
+#define USE_CASE_CHECK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmap.h"
+
+/***********************************************************************************************************************
+ * LITERALS & CONSTANTS
+ **********************************************************************************************************************/
+
+/**
+ * @defgroup CHECK_STATUS_
+ * @brief Return values for all check calls
+ *
+ * @{
+ */
+#define CHECK_STATUS_OK                     (0)
+#define CHECK_STATUS_FAIL                   (1)
+/** @} */
+
+#define CHECK_SIM_MAX_REGS                  (16)
+#define CHECK_SIM_MAX_WRITES                (64)
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * One register word written on the simulated control port, in bus order
+ */
+typedef struct
+{
+    uint32_t addr;
+    uint32_t val;
+} check_sim_write_t;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Empty the register file and the write log
+ */
+void check_sim_reset(void);
+
+/**
+ * Add a register to the register file - reads of any other address return 0 and writes to it are dropped
+ */
+uint32_t check_sim_add_reg(uint32_t addr, uint32_t val);
+
+/**
+ * Current value of a register, or 0 if it is not simulated
+ */
+uint32_t check_sim_get_reg(uint32_t addr);
+
+/**
+ * Register words written since the last check_sim_reset() or check_sim_clear_log(), in bus order
+ */
+const check_sim_write_t *check_sim_get_log(uint32_t *n_writes);
+
+/**
+ * Empty the write log, leaving the register file as it is
+ */
+void check_sim_clear_log(void);
+
+/**
+ * Fill in control port configuration for the simulated bus
+ */
+void check_sim_get_cp_config(regmap_cp_config_t *cp);
+
+/**********************************************************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif // USE_CASE_CHECK_H
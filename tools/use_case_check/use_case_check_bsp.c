@@ -0,0 +1,243 @@
+/**
+ * @file use_case_check_bsp.c
+ *
+ * @brief Simulated control port for the CS47L63 use case delta engine check
+ *
+ * Implements the BSP-Driver Interface SPI calls used by regmap against a small register file.  Every register word
+ * written is logged in bus order, with block writes split into their words, so the check can replay the sequence.
+ *
+ * @copyright
+ * Copyright (c) Cirrus Logic 2022 All Rights Reserved, http://www.cirrus.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+/***********************************************************************************************************************
+ * INCLUDES
+ **********************************************************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "use_case_check.h"
+#include "bsp_driver_if.h"
+
+/***********************************************************************************************************************
+ * LOCAL LITERAL SUBSTITUTIONS
+ **********************************************************************************************************************/
+#define CHECK_SIM_SPI_PAD_LEN               (4)         ///< As configured in bsp_cs47l63.c
+
+/***********************************************************************************************************************
+ * ENUMS, STRUCTS, UNIONS, TYPEDEFS
+ **********************************************************************************************************************/
+
+/**
+ * Simulated register file and write log
+ */
+typedef struct
+{
+    check_sim_write_t regs[CHECK_SIM_MAX_REGS];
+    uint32_t n_regs;
+    check_sim_write_t log[CHECK_SIM_MAX_WRITES];
+    uint32_t n_writes;
+} check_sim_t;
+
+/***********************************************************************************************************************
+ * LOCAL VARIABLES
+ **********************************************************************************************************************/
+static check_sim_t sim;
+
+/***********************************************************************************************************************
+ * LOCAL FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Get a register in the register file, or NULL if it is not simulated
+ *
+ */
+static check_sim_write_t *check_sim_find_reg(uint32_t addr)
+{
+    for (uint32_t i = 0; i < sim.n_regs; i++)
+    {
+        if (sim.regs[i].addr == addr)
+        {
+            return &(sim.regs[i]);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Get the control port address from a transfer's address phase
+ *
+ */
+static uint32_t check_sim_get_addr(const uint8_t *addr_buffer)
+{
+    // Mask off the SPI R/W bit
+    return (((uint32_t) addr_buffer[0] & 0x7F) << 24) | ((uint32_t) addr_buffer[1] << 16) |
+           ((uint32_t) addr_buffer[2] << 8) | addr_buffer[3];
+}
+
+static uint32_t check_set_timer(uint32_t duration_ms, bsp_callback_t cb, void *cb_arg)
+{
+    if (cb != NULL)
+    {
+        cb(BSP_STATUS_OK, cb_arg);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_spi_read(uint32_t bsp_dev_id,
+                               uint8_t *addr_buffer,
+                               uint32_t addr_length,
+                               uint8_t *data_buffer,
+                               uint32_t data_length,
+                               uint32_t pad_len)
+{
+    uint32_t addr = check_sim_get_addr(addr_buffer);
+
+    for (uint32_t i = 0; (i + 4) <= data_length; i += 4, addr += 4)
+    {
+        uint32_t val = check_sim_get_reg(addr);
+
+        data_buffer[i] = GET_BYTE_FROM_WORD(val, 3);
+        data_buffer[i + 1] = GET_BYTE_FROM_WORD(val, 2);
+        data_buffer[i + 2] = GET_BYTE_FROM_WORD(val, 1);
+        data_buffer[i + 3] = GET_BYTE_FROM_WORD(val, 0);
+    }
+
+    return BSP_STATUS_OK;
+}
+
+static uint32_t check_spi_write(uint32_t bsp_dev_id,
+                                uint8_t *addr_buffer,
+                                uint32_t addr_length,
+                                uint8_t *data_buffer,
+                                uint32_t data_length,
+                                uint32_t pad_len)
+{
+    uint32_t addr = check_sim_get_addr(addr_buffer);
+
+    for (uint32_t i = 0; (i + 4) <= data_length; i += 4, addr += 4)
+    {
+        check_sim_write_t *reg = check_sim_find_reg(addr);
+        uint32_t val = ((uint32_t) data_buffer[i] << 24) | ((uint32_t) data_buffer[i + 1] << 16) |
+                       ((uint32_t) data_buffer[i + 2] << 8) | data_buffer[i + 3];
+
+        if (sim.n_writes >= CHECK_SIM_MAX_WRITES)
+        {
+            return BSP_STATUS_FAIL;
+        }
+        sim.log[sim.n_writes].addr = addr;
+        sim.log[sim.n_writes].val = val;
+        sim.n_writes++;
+
+        if (reg != NULL)
+        {
+            reg->val = val;
+        }
+    }
+
+    return BSP_STATUS_OK;
+}
+
+/***********************************************************************************************************************
+ * GLOBAL VARIABLES
+ **********************************************************************************************************************/
+static bsp_driver_if_t check_driver_if_s =
+{
+    .set_timer = &check_set_timer,
+    .spi_read = &check_spi_read,
+    .spi_write = &check_spi_write,
+};
+
+bsp_driver_if_t *bsp_driver_if_g = &check_driver_if_s;
+
+/***********************************************************************************************************************
+ * API FUNCTIONS
+ **********************************************************************************************************************/
+
+/**
+ * Empty the register file and the write log
+ *
+ */
+void check_sim_reset(void)
+{
+    memset(&sim, 0, sizeof(check_sim_t));
+
+    return;
+}
+
+/**
+ * Add a register to the register file
+ *
+ */
+uint32_t check_sim_add_reg(uint32_t addr, uint32_t val)
+{
+    if (sim.n_regs >= CHECK_SIM_MAX_REGS)
+    {
+        return CHECK_STATUS_FAIL;
+    }
+
+    sim.regs[sim.n_regs].addr = addr;
+    sim.regs[sim.n_regs].val = val;
+    sim.n_regs++;
+
+    return CHECK_STATUS_OK;
+}
+
+/**
+ * Current value of a register
+ *
+ */
+uint32_t check_sim_get_reg(uint32_t addr)
+{
+    check_sim_write_t *reg = check_sim_find_reg(addr);
+
+    return (reg != NULL) ? reg->val : 0;
+}
+
+/**
+ * Register words written since the log was last emptied
+ *
+ */
+const check_sim_write_t *check_sim_get_log(uint32_t *n_writes)
+{
+    *n_writes = sim.n_writes;
+
+    return sim.log;
+}
+
+/**
+ * Empty the write log
+ *
+ */
+void check_sim_clear_log(void)
+{
+    sim.n_writes = 0;
+
+    return;
+}
+
+/**
+ * Fill in control port configuration for the simulated bus
+ *
+ */
+void check_sim_get_cp_config(regmap_cp_config_t *cp)
+{
+    memset(cp, 0, sizeof(regmap_cp_config_t));
+    cp->bus_type = REGMAP_BUS_TYPE_SPI;
+    cp->spi_pad_len = CHECK_SIM_SPI_PAD_LEN;
+
+    return;
+}